@@ -0,0 +1,183 @@
+/*
+ * File: ES_CheckEvents.c
+ *
+ * Runs the user event checkers listed in EVENT_CHECK_LIST (ES_Configure.h),
+ * each rate group when it comes due.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Events.h"
+#include "ES_Framework.h"
+#include "ES_CheckEvents.h"
+#include "ES_Port.h"
+#include EVENT_CHECK_HEADER
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#ifndef EVENT_CHECK_PERIODS
+#define EVENT_CHECK_PERIODS 0
+#endif
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static CheckFunc * const ES_EventList[] = {EVENT_CHECK_LIST};
+
+#define NUM_CHECKERS (sizeof (ES_EventList) / sizeof (ES_EventList[0]))
+// an application without checkers still gets arrays of one
+#define CHECK_ARRAY_SIZE ((NUM_CHECKERS > 0) ? NUM_CHECKERS : 1)
+
+_Static_assert(NUM_CHECKERS <= ES_MAX_CHECKERS, "EVENT_CHECK_LIST is longer than ES_MAX_CHECKERS");
+
+// a checker left out of EVENT_CHECK_PERIODS runs on every pass
+static uint16_t const ES_EventPeriods[CHECK_ARRAY_SIZE] = {EVENT_CHECK_PERIODS};
+
+// the groups of the current context
+#define Order (ES_CurrentContext->Checks.Order)
+#define NumGroups (ES_CurrentContext->Checks.NumGroups)
+#define GroupStart (ES_CurrentContext->Checks.GroupStart)
+#define GroupDue (ES_CurrentContext->Checks.GroupDue)
+#define GroupStats (ES_CurrentContext->Checks.GroupStats)
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t ES_CheckUserEvents(void) {
+    uint8_t i;
+
+    for (i = 0; i < NUM_CHECKERS; i++) {
+        if (ES_EventList[i]() == TRUE) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void ES_InitCheckGroups(void) {
+    uint8_t Placed = 0;
+    uint16_t Period;
+    uint16_t Next = 0;
+    uint8_t i;
+
+    // one group per distinct period, shortest first, list order within
+    NumGroups = 0;
+    while (Placed < NUM_CHECKERS) {
+        Period = Next;
+        Next = UINT16_MAX;
+        GroupStart[NumGroups] = Placed;
+        GroupDue[NumGroups] = 0;
+        GroupStats[NumGroups].Period = Period;
+        GroupStats[NumGroups].NumCheckers = 0;
+        for (i = 0; i < NUM_CHECKERS; i++) {
+            if (ES_EventPeriods[i] == Period) {
+                Order[Placed++] = i;
+                GroupStats[NumGroups].NumCheckers++;
+            } else if ((ES_EventPeriods[i] > Period) && (ES_EventPeriods[i] < Next)) {
+                Next = ES_EventPeriods[i];
+            }
+        }
+        if (GroupStats[NumGroups].NumCheckers > 0) {
+            NumGroups++;
+        }
+    }
+    ES_ResetCheckGroupStats();
+}
+
+uint8_t ES_CheckDueUserEvents(uint32_t Now, uint32_t *pNextDue) {
+    ES_CheckGroupStats_t *pStats;
+    uint32_t NextDue = UINT32_MAX;
+    uint32_t Late;
+    uint32_t Start;
+    uint8_t Found = FALSE;
+    uint8_t g, i;
+
+    // NumGroups is 0 without checkers, the compiler only sees that from the first test
+    for (g = 0; (NUM_CHECKERS > 0) && (g < NumGroups); g++) {
+        pStats = &GroupStats[g];
+        Late = Now - GroupDue[g];
+        if ((pStats->Period > 0) && ((int32_t) Late < 0)) {
+            if ((uint32_t) -Late < NextDue) {
+                NextDue = -Late;
+            }
+            continue;
+        }
+        Start = ES_Port_Timestamp();
+        for (i = GroupStart[g]; i < GroupStart[g] + pStats->NumCheckers; i++) {
+            if (ES_EventList[Order[i]]() == TRUE) {
+                Found = TRUE;
+            }
+        }
+        Start = ES_Port_Timestamp() - Start;
+        pStats->Runs++;
+        ES_Port_CheckGroupRan(g, Now);
+        if (Start > pStats->MaxRunTime) {
+            pStats->MaxRunTime = Start;
+        }
+        if (pStats->Period == 0) {
+            NextDue = 1; // every pass, which while sleeping is every tick
+        } else {
+            if (Late > pStats->MaxLate) {
+                pStats->MaxLate = Late;
+            }
+            GroupDue[g] = Now + pStats->Period;
+            if (pStats->Period < NextDue) {
+                NextDue = pStats->Period;
+            }
+        }
+    }
+    *pNextDue = (NextDue == UINT32_MAX) ? 1 : NextDue;
+    return Found;
+}
+
+uint32_t ES_CheckGroupDueIn(uint8_t Group, uint32_t Now) {
+    return (GroupStats[Group].Period == 0) ? 1 : GroupDue[Group] - Now;
+}
+
+uint32_t ES_SkipCheckGroup(uint8_t Group, uint32_t Now, uint32_t Wake) {
+    ES_CheckGroupStats_t *pStats = &GroupStats[Group];
+    uint32_t Skipped;
+    uint32_t Ran = 0;
+
+    // the group runs again on Wake itself
+    if (pStats->Period == 0) {
+        Skipped = (Wake - Now > 1) ? Wake - Now - 1 : 0;
+        if (Skipped > 0) {
+            Ran = Wake;
+        }
+    } else if ((int32_t) (Wake - GroupDue[Group]) > 0) {
+        Skipped = (Wake - GroupDue[Group] - 1) / pStats->Period + 1;
+        GroupDue[Group] += Skipped * pStats->Period;
+        Ran = GroupDue[Group] - pStats->Period + 1;
+    } else {
+        Skipped = 0;
+    }
+    pStats->Runs += Skipped;
+    return Ran;
+}
+
+uint8_t ES_GetCheckGroupStats(uint8_t Group, ES_CheckGroupStats_t *pStats) {
+    if (Group >= NumGroups) {
+        return FALSE;
+    }
+    *pStats = GroupStats[Group];
+    return TRUE;
+}
+
+void ES_ResetCheckGroupStats(void) {
+    uint8_t g;
+
+    for (g = 0; g < NumGroups; g++) {
+        GroupStats[g].Runs = 0;
+        GroupStats[g].MaxLate = 0;
+        GroupStats[g].MaxRunTime = 0;
+    }
+}
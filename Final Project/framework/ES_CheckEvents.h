@@ -0,0 +1,119 @@
+/*
+ * File: ES_CheckEvents.h
+ *
+ * Runs the user event checkers listed in EVENT_CHECK_LIST (ES_Configure.h).
+ *
+ * EVENT_CHECK_PERIODS gives each checker, in the same order, the number of
+ * ticks between calls; 0, the default for a checker left out, means every pass
+ * of the run loop. Checkers with the same period form a rate group that is run
+ * as a whole when it comes due, so a checker's detection latency is bounded by
+ * its period plus how late its group runs, which the group statistics record.
+ *
+ * Every checker in EVENT_CHECK_LIST must keep to this contract:
+ *
+ *   - it is an edge detector over the inputs the tick hook sets, the sensor
+ *     and board readings: it posts, and returns TRUE, only when what it reads
+ *     differs from what it read on its last run;
+ *   - it keeps no state but that last reading, in particular nothing that
+ *     depends on time or on how often it runs: no call counters, no debounce
+ *     counts, no timestamps, no reads of ES_Timer_GetTime(). Anything timed
+ *     belongs in a service, on an ES_Timer.
+ *
+ * On the host, where the tick hook says how long the inputs will hold
+ * (ES_Port_InputsSteady()), a group that has run since they last changed can
+ * therefore only find nothing until they may change again. The tickless run
+ * loop sleeps through those runs and counts them as if they had happened, see
+ * ES_Port_SteadyTicks(). A checker that breaks the contract makes the host
+ * robot behave differently from one stepped every tick; make VERIFY=1 builds
+ * the host with ES_VERIFY_STEADY, which runs the two side by side and fails at
+ * the first event they were dispatched differently, see ES_Port.h.
+ */
+
+#ifndef ES_CHECKEVENTS_H
+#define ES_CHECKEVENTS_H
+
+#include <stdint.h>
+
+typedef uint8_t CheckFunc(void);
+
+/* Statistics of one rate group, times in ES_Port_Timestamp() units. */
+typedef struct {
+    uint16_t Period; // ticks between runs, 0 for every pass
+    uint8_t NumCheckers;
+    uint32_t Runs;
+    uint32_t MaxLate; // most ticks a run started after it was due
+    uint32_t MaxRunTime; // longest the whole group took
+} ES_CheckGroupStats_t;
+
+// the most checkers EVENT_CHECK_LIST may name
+#ifndef ES_MAX_CHECKERS
+#define ES_MAX_CHECKERS 16
+#endif
+
+// the checker module's part of an ES_Context_t
+typedef struct {
+    uint8_t Order[ES_MAX_CHECKERS]; // the checkers in group order, each group a run of it
+    uint8_t NumGroups;
+    uint8_t GroupStart[ES_MAX_CHECKERS];
+    uint32_t GroupDue[ES_MAX_CHECKERS];
+    ES_CheckGroupStats_t GroupStats[ES_MAX_CHECKERS];
+} ES_CheckContext_t;
+
+/**
+ * @Function ES_CheckUserEvents(void)
+ * @return TRUE if one of the event checkers found an event, FALSE otherwise
+ * @brief Calls the event checkers in the order of EVENT_CHECK_LIST, stopping
+ *        at the first one that returns TRUE. Ignores the periods. */
+uint8_t ES_CheckUserEvents(void);
+
+/**
+ * @Function ES_InitCheckGroups(void)
+ * @return None
+ * @brief Sorts the checkers into rate groups, all due at once. Called by
+ *        ES_Initialize(). */
+void ES_InitCheckGroups(void);
+
+/**
+ * @Function ES_CheckDueUserEvents(uint32_t Now, uint32_t *pNextDue)
+ * @param Now - the current tick, ES_Timer_GetTime()
+ * @param pNextDue - gets the ticks until a group is next due, 1 if there is
+ *                   an every-pass group
+ * @return TRUE if any of the checkers run found an event, FALSE otherwise
+ * @brief Runs every checker of every group that is due, the every-pass group
+ *        included. A group that fell behind runs once and is due again a
+ *        period later; the ticks it missed show up in its MaxLate. */
+uint8_t ES_CheckDueUserEvents(uint32_t Now, uint32_t *pNextDue);
+
+/**
+ * @Function ES_CheckGroupDueIn(uint8_t Group, uint32_t Now)
+ * @param Group - a group ES_GetCheckGroupStats() knows
+ * @param Now - the current tick, the checkers having just run
+ * @return the ticks until the group is next due, 1 for the every-pass group
+ * @brief For a port that sleeps through checker runs, see
+ *        ES_Port_SteadyTicks(). */
+uint32_t ES_CheckGroupDueIn(uint8_t Group, uint32_t Now);
+
+/**
+ * @Function ES_SkipCheckGroup(uint8_t Group, uint32_t Now, uint32_t Wake)
+ * @param Group - a group ES_GetCheckGroupStats() knows
+ * @param Now - the tick the run loop went to sleep on
+ * @param Wake - the tick it woke on
+ * @return the tick of the last run skipped plus one, 0 for none
+ * @brief Counts every run the group would have made in between in its
+ *        statistics and moves it on to its next due tick, as if it had run
+ *        and found nothing. For a port that sleeps through checker runs. */
+uint32_t ES_SkipCheckGroup(uint8_t Group, uint32_t Now, uint32_t Wake);
+
+/**
+ * @Function ES_GetCheckGroupStats(uint8_t Group, ES_CheckGroupStats_t *pStats)
+ * @param Group - 0 for the group with the shortest period, and up from there
+ * @param pStats - where to copy the statistics
+ * @return TRUE, FALSE if there is no such group */
+uint8_t ES_GetCheckGroupStats(uint8_t Group, ES_CheckGroupStats_t *pStats);
+
+/**
+ * @Function ES_ResetCheckGroupStats(void)
+ * @return None */
+void ES_ResetCheckGroupStats(void);
+
+#endif /* ES_CHECKEVENTS_H */
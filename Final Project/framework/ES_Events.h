@@ -0,0 +1,36 @@
+/*
+ * File: ES_Events.h
+ *
+ * Event structure used by every service, state machine and event checker in
+ * the Events and Services Framework (ES_Framework). The event types
+ * themselves are application specific and live in ES_Configure.h.
+ */
+
+#ifndef ES_EVENTS_H
+#define ES_EVENTS_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "ES_Configure.h"
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef struct ES_Event {
+    ES_EventTyp_t EventType; // what kind of event?
+    uint16_t EventParam; // parameter value for use w/ this event
+} ES_Event;
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+static const ES_Event INIT_EVENT = {ES_INIT, 0x0000};
+static const ES_Event ENTRY_EVENT = {ES_ENTRY, 0x0000};
+static const ES_Event EXIT_EVENT = {ES_EXIT, 0x0000};
+
+#endif /* ES_EVENTS_H */
@@ -0,0 +1,679 @@
+/*
+ * File: ES_Framework.c
+ *
+ * The Events and Services Framework run loop. Each service named in
+ * ES_Configure.h gets an event queue; services are numbered by priority with
+ * service 0 the lowest. The Ready variable keeps one bit per service whose
+ * queue is not empty, so finding the next service to run is a single count
+ * leading zeros no matter how many services are configured.
+ *
+ * Once every queue is empty the run loop runs the event checker rate groups
+ * that are due (ES_CheckEvents.c). By default it then goes straight round
+ * again; with USE_TICKLESS_IDLE it sleeps until the next group is due, waking
+ * early for the next timer expiry or an interrupt. Either way the time spent
+ * outside the port's idle calls is counted, giving the CPU load reported by
+ * ES_GetCpuLoad(). With USE_TATTLETALE the state machine trace is drained
+ * just before going idle.
+ *
+ * Every call of a Run function is timed against the run-to-completion budget,
+ * keeping the worst case for each state the service was in and each event
+ * type. A service that busy-waits shows up there rather than only as events
+ * arriving late.
+ *
+ * The queues and everything else the run loop keeps are in the current
+ * ES_Context_t; only the tables built from ES_Configure.h are shared.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "ES_KeyboardInput.h"
+#ifdef ES_TICK_HOOK_HEADER
+#include ES_TICK_HOOK_HEADER
+#endif
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#if NUM_SERVICES > MAX_NUM_SERVICES
+#error NUM_SERVICES must not be larger than MAX_NUM_SERVICES
+#endif
+#if MAX_NUM_SERVICES > ES_MAX_SERVICES
+#error MAX_NUM_SERVICES must not be larger than the ready set of this port
+#endif
+
+#ifndef COALESCED_EVENTS
+#define COALESCED_EVENTS
+#endif
+
+#ifndef ES_SUBSCRIPTIONS
+#define ES_SUBSCRIPTIONS
+#endif
+
+#ifndef ES_SERVICE_STATES
+#define ES_SERVICE_STATES
+#endif
+
+#define STAMPS_PER_TICK ((uint64_t) ES_PORT_STAMPS_PER_US * 1000)
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+
+typedef uint8_t InitFunc_t(uint8_t Priority);
+typedef ES_Event RunFunc_t(ES_Event ThisEvent);
+typedef uint8_t StateFunc_t(void);
+
+typedef struct {
+    InitFunc_t *InitFunc; // Service Init function
+    RunFunc_t *RunFunc; // Service Run function
+} ES_ServDesc_t;
+
+typedef struct {
+    uint32_t MemOffset; // where the queue storage is in an ES_Context_t
+    uint8_t Size; // number of entries, including the header entry
+    uint32_t StampsOffset; // post time of each queued event, one per event entry
+} ES_QueueDesc_t;
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+#define ES_SERVICE(n) {SERV_##n##_INIT, SERV_##n##_RUN},
+static ES_ServDesc_t const ServDescList[] = {
+#include "ES_ServiceList.h"
+};
+#undef ES_SERVICE
+
+#define ES_SERVICE(n) {offsetof(ES_Context_t, Queue##n), \
+    ARRAY_SIZE(((ES_Context_t *) 0)->Queue##n), offsetof(ES_Context_t, Stamps##n)},
+static ES_QueueDesc_t const EventQueues[] = {
+#include "ES_ServiceList.h"
+};
+#undef ES_SERVICE
+
+// event types that are merged into an already queued copy, latest wins
+static ES_EventTyp_t const CoalescedList[] = {COALESCED_EVENTS};
+
+// the services subscribed to each event type, one bit per service like Ready
+#define ES_SUBSCRIBE(Type, Services) [Type] = (Services),
+static ES_ReadySet_t const Subscribers[NUMBEROFEVENTS] = {
+    [ES_NO_EVENT] = 0,
+    ES_SUBSCRIPTIONS
+};
+#undef ES_SUBSCRIBE
+
+// the function each service reports its state through, if it has one
+#define ES_SERVICE_STATE(n, Func) [n] = (Func),
+static StateFunc_t * const StateFuncs[NUM_SERVICES] = {
+    [0] = NULL,
+    ES_SERVICE_STATES
+};
+#undef ES_SERVICE_STATE
+
+ES_THREAD_LOCAL ES_Context_t *ES_CurrentContext;
+
+// the run loop of the current context, see ES_Context_t
+#define Ready (ES_CurrentContext->Ready)
+#define CoalescedSet (ES_CurrentContext->CoalescedSet)
+#define InOrder (ES_CurrentContext->InOrder)
+#define StampHead (ES_CurrentContext->StampHead)
+#define StampTail (ES_CurrentContext->StampTail)
+#define QueueStats (ES_CurrentContext->QueueStats)
+#define LatencyHist (ES_CurrentContext->LatencyHist)
+#define RunStats (ES_CurrentContext->RunStats)
+#define RunBudget (ES_CurrentContext->RunBudget)
+#define BusyStamps (ES_CurrentContext->BusyStamps)
+#define BusySince (ES_CurrentContext->BusySince)
+#define LoadStart (ES_CurrentContext->LoadStart)
+
+// the queue storage of service n in the current context
+#define QUEUE_MEM(n) ((ES_Event *) ((uint8_t *) ES_CurrentContext + EventQueues[n].MemOffset))
+#define QUEUE_STAMPS(n) ((uint32_t *) ((uint8_t *) ES_CurrentContext + EventQueues[n].StampsOffset))
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void ES_RunTimers(void);
+static void ES_NoteDispatch(uint8_t WhichService, ES_EventTyp_t EventType, uint32_t PostedAt);
+static uint8_t ES_NoteRun(uint8_t WhichService, uint8_t State, ES_EventTyp_t EventType,
+        uint32_t RunTime);
+static uint8_t ES_Idle(uint32_t Ticks);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ES_SetContext(ES_Context_t *pContext) {
+    ES_CurrentContext = pContext;
+}
+
+ES_Return_t ES_Initialize(void) {
+    uint8_t i;
+
+    ES_Timer_Init();
+    Ready = 0;
+    InOrder = FALSE;
+    BusyStamps = 0;
+    BusySince = ES_Port_Timestamp();
+    LoadStart = 0;
+    RunBudget = ES_RUN_BUDGET_US * ES_PORT_STAMPS_PER_US;
+    for (i = 0; i < ARRAY_SIZE(EventQueues); i++) {
+        StampHead[i] = 0;
+        StampTail[i] = 0;
+    }
+    for (i = 0; i < ARRAY_SIZE(CoalescedSet); i++) {
+        CoalescedSet[i] = 0;
+    }
+    for (i = 0; i < ARRAY_SIZE(CoalescedList); i++) {
+        if (CoalescedList[i] >= NUMBEROFEVENTS) {
+            return FailedIndex;
+        }
+        CoalescedSet[CoalescedList[i] / 32] |= (uint32_t) 1 << (CoalescedList[i] % 32);
+    }
+    // a subscriber above the highest configured service
+    for (i = 0; i < NUMBEROFEVENTS; i++) {
+        if ((Subscribers[i] >> (ARRAY_SIZE(EventQueues) - 1)) > 1) {
+            return FailedIndex;
+        }
+    }
+    ES_InitCheckGroups();
+    ES_ResetQueueStats();
+    ES_TraceInit();
+    // queues first, Init functions are allowed to post to any service
+    for (i = 0; i < ARRAY_SIZE(EventQueues); i++) {
+        if (ES_InitQueue(QUEUE_MEM(i), EventQueues[i].Size) == 0) {
+            return FailedInit; // SERV_n_QUEUE_SIZE is not a power of two
+        }
+    }
+    for (i = 0; i < ARRAY_SIZE(ServDescList); i++) {
+        if ((ServDescList[i].InitFunc == NULL) || (ServDescList[i].RunFunc == NULL)) {
+            return FailedPointer;
+        }
+        if (ServDescList[i].InitFunc(i) != TRUE) {
+            return FailedInit;
+        }
+    }
+    return Success;
+}
+
+ES_Return_t ES_Run(void) {
+    ES_Event ThisEvent;
+    ES_Event ReturnEvent;
+    uint8_t HighestPrior;
+    uint8_t NumLeft;
+    uint8_t State;
+    ES_ReadySet_t ThisBit;
+    uint32_t NextCheck;
+    uint32_t Started;
+    uint32_t PostedAt;
+#ifdef USE_KEYBOARD_INPUT
+    int key;
+#endif
+
+    while (1) {
+        ES_RunTimers();
+        while (Ready != 0) {
+            HighestPrior = ES_Port_HighestBit(Ready);
+            ThisBit = (ES_ReadySet_t) 1 << HighestPrior;
+            // the stamp is read before the event leaves the queue, a post
+            // from an interrupt may reuse its entry as soon as it has
+            PostedAt = QUEUE_STAMPS(HighestPrior)[
+                    StampTail[HighestPrior] & (EventQueues[HighestPrior].Size - 2)];
+            NumLeft = ES_DeQueue(QUEUE_MEM(HighestPrior), &ThisEvent);
+            ES_NoteDispatch(HighestPrior, ThisEvent.EventType, PostedAt);
+#ifdef ES_VERIFY_STEADY
+            ES_Port_NoteDispatch(HighestPrior, ThisEvent.EventType, ThisEvent.EventParam);
+#endif
+            if (NumLeft == 0) {
+                // mark queue as now empty, then catch a post that raced the clear
+                __atomic_fetch_and(&Ready, ~ThisBit, __ATOMIC_ACQ_REL);
+                if (!ES_IsQueueEmpty(QUEUE_MEM(HighestPrior))) {
+                    __atomic_fetch_or(&Ready, ThisBit, __ATOMIC_ACQ_REL);
+                }
+            }
+            State = (StateFuncs[HighestPrior] != NULL) ? StateFuncs[HighestPrior]() : 0;
+            Started = ES_Port_Timestamp();
+            ReturnEvent = ServDescList[HighestPrior].RunFunc(ThisEvent);
+            if ((ES_NoteRun(HighestPrior, State, ThisEvent.EventType,
+                    ES_Port_Timestamp() - Started) != TRUE)
+                    || (ReturnEvent.EventType == ES_ERROR)) {
+                return FailedRun;
+            }
+            ES_RunTimers();
+        }
+
+        // all the queues are empty, look for new events
+#ifdef USE_KEYBOARD_INPUT
+        key = ES_Port_GetChar();
+        if (key >= 0) {
+            ThisEvent.EventType = ES_KEYINPUT;
+            ThisEvent.EventParam = key;
+            PostKeyboardInput(ThisEvent);
+            continue;
+        }
+#endif
+        if (ES_CheckDueUserEvents(ES_Timer_GetTime(), &NextCheck) == TRUE) {
+            continue;
+        }
+#ifdef USE_TATTLETALE
+        ES_TraceDrain();
+#endif
+#ifdef USE_TICKLESS_IDLE
+        if (ES_Idle(NextCheck) == FALSE) {
+            return Success;
+        }
+#else
+        if ((Ready == 0) && (ES_Idle(0) == FALSE)) {
+            return Success;
+        }
+#endif
+    }
+}
+
+uint8_t ES_PostAll(ES_Event ThisEvent) {
+    uint8_t i;
+    uint8_t returnVal = TRUE;
+
+    for (i = 0; i < ARRAY_SIZE(EventQueues); i++) {
+        if (ES_PostToService(i, ThisEvent) != TRUE) {
+            returnVal = FALSE;
+        }
+    }
+    return returnVal;
+}
+
+uint8_t ES_Publish(ES_Event ThisEvent) {
+    ES_ReadySet_t Pending;
+    uint8_t WhichService;
+    uint8_t returnVal = TRUE;
+
+    if (ThisEvent.EventType >= NUMBEROFEVENTS) {
+        return FALSE;
+    }
+    for (Pending = Subscribers[ThisEvent.EventType]; Pending != 0;
+            Pending &= ~ES_SERVICE_BIT(WhichService)) {
+        WhichService = ES_Port_HighestBit(Pending);
+        if (ES_PostToService(WhichService, ThisEvent) != TRUE) {
+            returnVal = FALSE;
+        }
+    }
+    return returnVal;
+}
+
+uint8_t ES_PostToService(uint8_t WhichService, ES_Event ThisEvent) {
+    ES_QueueStats_t *pStats;
+    uint8_t Depth;
+
+    if (WhichService >= ARRAY_SIZE(EventQueues)) {
+        return FALSE;
+    }
+    pStats = &QueueStats[WhichService];
+    if ((ThisEvent.EventType < NUMBEROFEVENTS) && !InOrder
+            && (CoalescedSet[ThisEvent.EventType / 32] & ((uint32_t) 1 << (ThisEvent.EventType % 32)))
+            && ES_UpdateQueued(QUEUE_MEM(WhichService), ThisEvent)) {
+        pStats->Coalesced++; // the queued copy is still pending, Ready is already set
+        return TRUE;
+    }
+    // stamp first, the run loop may take the event as soon as it is queued,
+    // but not into a full queue, whose next entry is still the oldest event's
+    if (!ES_IsQueueFull(QUEUE_MEM(WhichService))) {
+        QUEUE_STAMPS(WhichService)[StampHead[WhichService]
+                & (EventQueues[WhichService].Size - 2)] = ES_Port_Timestamp();
+    }
+    if (ES_EnQueueFIFO(QUEUE_MEM(WhichService), ThisEvent) != TRUE) {
+        return FALSE;
+    }
+    StampHead[WhichService]++;
+
+    Depth = StampHead[WhichService] - StampTail[WhichService];
+    pStats->Posted++;
+    pStats->DepthSum += Depth;
+    if (Depth > pStats->PeakDepth) {
+        pStats->PeakDepth = Depth;
+    }
+#ifdef USE_QUEUE_TYPE_STATS
+    if ((ThisEvent.EventType < NUMBEROFEVENTS)
+            && (pStats->TypePosted[ThisEvent.EventType] < UINT8_MAX)) {
+        pStats->TypePosted[ThisEvent.EventType]++;
+    }
+#endif
+    // atomic so an interrupt can post without masking the run loop out
+    __atomic_fetch_or(&Ready, (ES_ReadySet_t) 1 << WhichService, __ATOMIC_ACQ_REL);
+    return TRUE;
+}
+
+uint8_t ES_PostInOrder(pPostFunc PostFunc, ES_Event ThisEvent) {
+    uint8_t Posted;
+
+    // an interrupt that posts meanwhile is not coalesced either, which only
+    // costs it a queue entry
+    InOrder = TRUE;
+    Posted = PostFunc(ThisEvent);
+    InOrder = FALSE;
+    return Posted;
+}
+
+uint32_t ES_GetQueueDrops(uint8_t WhichService, ES_EventTyp_t *pLastDropped) {
+    if (WhichService >= ARRAY_SIZE(EventQueues)) {
+        return 0;
+    }
+    return ES_QueueDrops(QUEUE_MEM(WhichService), pLastDropped);
+}
+
+uint8_t ES_GetQueueStats(uint8_t WhichService, ES_QueueStats_t *pStats) {
+    if (WhichService >= ARRAY_SIZE(EventQueues)) {
+        return FALSE;
+    }
+    *pStats = QueueStats[WhichService];
+    return TRUE;
+}
+
+void ES_ResetQueueStats(void) {
+    memset(QueueStats, 0, sizeof (QueueStats));
+#ifdef USE_LATENCY_HISTOGRAMS
+    memset(LatencyHist, 0, sizeof (LatencyHist));
+#endif
+    memset(RunStats, 0, sizeof (RunStats));
+    ES_ResetCheckGroupStats();
+    BusyStamps = 0;
+    BusySince = ES_Port_Timestamp();
+    LoadStart = ES_Timer_GetTime();
+}
+
+uint8_t ES_GetRunStats(uint8_t WhichService, ES_RunStats_t *pStats) {
+    if (WhichService >= ARRAY_SIZE(EventQueues)) {
+        return FALSE;
+    }
+    *pStats = RunStats[WhichService];
+    return TRUE;
+}
+
+void ES_SetRunBudget(uint32_t Micros) {
+    RunBudget = Micros * ES_PORT_STAMPS_PER_US;
+}
+
+uint8_t ES_GetLatencyHistogram(ES_EventTyp_t EventType, uint32_t *pBuckets) {
+#ifdef USE_LATENCY_HISTOGRAMS
+    uint8_t j;
+
+    if (EventType >= NUMBEROFEVENTS) {
+        return FALSE;
+    }
+    for (j = 0; j < ES_LATENCY_BUCKETS; j++) {
+        pBuckets[j] = LatencyHist[EventType][j];
+    }
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+uint16_t ES_GetCpuLoad(void) {
+    uint64_t Elapsed = (uint64_t) (ES_Timer_GetTime() - LoadStart) * STAMPS_PER_TICK;
+    uint64_t Busy = BusyStamps + (uint32_t) (ES_Port_Timestamp() - BusySince);
+
+    if (Elapsed == 0) {
+        return 0;
+    }
+    if (Busy >= Elapsed) {
+        return 1000;
+    }
+    return (uint16_t) (Busy * 1000 / Elapsed);
+}
+
+void ES_PrintQueueStats(void) {
+    ES_QueueStats_t *pStats;
+    ES_EventTyp_t LastDropped;
+    uint32_t Drops;
+    ES_CheckGroupStats_t Group;
+#ifndef ES_HOST
+    uint16_t Load = ES_GetCpuLoad();
+#endif
+    uint8_t i;
+#ifdef USE_QUEUE_TYPE_STATS
+    uint8_t j;
+#endif
+
+#ifdef ES_HOST
+    // wall-clock busy time over virtual ticks says nothing about the board
+    printf("\r\ncpu load n/a over %lu ms", (unsigned long) (ES_Timer_GetTime() - LoadStart));
+#else
+    printf("\r\ncpu load %u.%u%% over %lu ms", Load / 10, Load % 10,
+            (unsigned long) (ES_Timer_GetTime() - LoadStart));
+#endif
+    for (i = 0; ES_GetCheckGroupStats(i, &Group); i++) {
+        if (Group.Period == 0) {
+            printf("\r\ncheckers every pass:");
+        } else {
+            printf("\r\ncheckers every %u ms:", Group.Period);
+        }
+        printf(" %u checkers, runs %lu, worst late %lu ms, worst run %lu us", Group.NumCheckers,
+                (unsigned long) Group.Runs, (unsigned long) Group.MaxLate,
+                (unsigned long) (Group.MaxRunTime / ES_PORT_STAMPS_PER_US));
+    }
+    for (i = 0; i < ARRAY_SIZE(EventQueues); i++) {
+        pStats = &QueueStats[i];
+        Drops = ES_GetQueueDrops(i, &LastDropped);
+        printf("\r\nqueue %u: size %u, posted %lu, coalesced %lu, dropped %lu, "
+                "depth peak %u avg %lu.%02lu, worst wait %lu us", i, EventQueues[i].Size - 1,
+                (unsigned long) pStats->Posted, (unsigned long) pStats->Coalesced,
+                (unsigned long) Drops, pStats->PeakDepth,
+                (unsigned long) (pStats->Posted ? pStats->DepthSum / pStats->Posted : 0),
+                (unsigned long) (pStats->Posted ? (pStats->DepthSum * 100 / pStats->Posted) % 100 : 0),
+                (unsigned long) (pStats->MaxResidency / ES_PORT_STAMPS_PER_US));
+        if (Drops > 0) {
+            printf(", last dropped %s", EventNames[LastDropped]);
+        }
+#ifdef USE_QUEUE_TYPE_STATS
+        for (j = 0; j < NUMBEROFEVENTS; j++) {
+            if (pStats->TypePosted[j] > 0) {
+                printf("\r\n  %-24s %7u%c  worst %u us", EventNames[j], pStats->TypePosted[j],
+                        (pStats->TypePosted[j] == UINT8_MAX) ? '+' : ' ', pStats->TypeWorstUs[j]);
+            }
+        }
+#endif
+    }
+    printf("\r\n");
+}
+
+void ES_PrintLatencyHistograms(void) {
+#ifdef USE_LATENCY_HISTOGRAMS
+    uint32_t Total;
+    uint8_t i, j;
+
+    printf("\r\npost to dispatch latency, events per bucket by upper bound");
+    for (i = 0; i < NUMBEROFEVENTS; i++) {
+        Total = 0;
+        for (j = 0; j < ES_LATENCY_BUCKETS; j++) {
+            Total += LatencyHist[i][j];
+        }
+        if (Total == 0) {
+            continue;
+        }
+        printf("\r\n  %-24s %8lu ", EventNames[i], (unsigned long) Total);
+        for (j = 0; j < ES_LATENCY_BUCKETS - 1; j++) {
+            if (LatencyHist[i][j] > 0) {
+                printf(" <%luus:%u%s", 1ul << (2 * j), LatencyHist[i][j],
+                        (LatencyHist[i][j] == UINT16_MAX) ? "+" : "");
+            }
+        }
+        if (LatencyHist[i][j] > 0) {
+            printf(" >=%luus:%u%s", 1ul << (2 * (j - 1)), LatencyHist[i][j],
+                    (LatencyHist[i][j] == UINT16_MAX) ? "+" : "");
+        }
+    }
+    printf("\r\n");
+#else
+    printf("\r\npost to dispatch latency not kept, see USE_LATENCY_HISTOGRAMS\r\n");
+#endif
+}
+
+void ES_PrintRunStats(void) {
+    ES_RunStats_t *pStats;
+    uint8_t i;
+#ifdef USE_RUN_WORST_CASES
+    uint8_t s, j;
+#endif
+
+    printf("\r\nrun to completion, budget %lu us",
+            (unsigned long) (RunBudget / ES_PORT_STAMPS_PER_US));
+    for (i = 0; i < ARRAY_SIZE(EventQueues); i++) {
+        pStats = &RunStats[i];
+        printf("\r\nservice %u: runs %lu, over budget %lu, worst %lu us", i,
+                (unsigned long) pStats->Runs, (unsigned long) pStats->Overruns,
+                (unsigned long) (pStats->MaxRunTime / ES_PORT_STAMPS_PER_US));
+        if ((pStats->Runs > 0) && (pStats->MaxEvent < NUMBEROFEVENTS)) {
+            printf(" in state %u on %s", pStats->MaxState, EventNames[pStats->MaxEvent]);
+        }
+#ifdef USE_RUN_WORST_CASES
+        for (s = 0; s < ES_RUN_STATES; s++) {
+            for (j = 0; j < NUMBEROFEVENTS; j++) {
+                if (pStats->WorstUs[s][j] > 0) {
+                    printf("\r\n  state %u %-24s worst %u us", s, EventNames[j],
+                            pStats->WorstUs[s][j]);
+                }
+            }
+        }
+#endif
+    }
+    printf("\r\n");
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// called for every event taken off a queue, before it is dispatched, with
+// the time it was posted
+static void ES_NoteDispatch(uint8_t WhichService, ES_EventTyp_t EventType, uint32_t PostedAt) {
+    ES_QueueStats_t *pStats = &QueueStats[WhichService];
+    uint32_t Residency = ES_Port_Timestamp() - PostedAt;
+#if defined(USE_QUEUE_TYPE_STATS) || defined(USE_LATENCY_HISTOGRAMS)
+    uint32_t Micros = Residency / ES_PORT_STAMPS_PER_US;
+#endif
+#ifdef USE_LATENCY_HISTOGRAMS
+    // half the bits of Micros, rounded up, is the least n with Micros < 4^n
+    uint8_t Bucket = (Micros == 0) ? 0 : (uint8_t) ((33 - __builtin_clz(Micros)) / 2);
+#endif
+
+    StampTail[WhichService]++;
+    if (Residency > pStats->MaxResidency) {
+        pStats->MaxResidency = Residency;
+    }
+    if (EventType >= NUMBEROFEVENTS) {
+        return;
+    }
+#ifdef USE_QUEUE_TYPE_STATS
+    if (Micros > pStats->TypeWorstUs[EventType]) {
+        pStats->TypeWorstUs[EventType] = (Micros > UINT16_MAX) ? UINT16_MAX : (uint16_t) Micros;
+    }
+#endif
+#ifdef USE_LATENCY_HISTOGRAMS
+    if (Bucket >= ES_LATENCY_BUCKETS) {
+        Bucket = ES_LATENCY_BUCKETS - 1;
+    }
+    if (LatencyHist[EventType][Bucket] < UINT16_MAX) {
+        LatencyHist[EventType][Bucket]++;
+    }
+#endif
+}
+
+// called for every Run function call, with the state the service was in
+// before it; FALSE stops the run loop
+static uint8_t ES_NoteRun(uint8_t WhichService, uint8_t State, ES_EventTyp_t EventType,
+        uint32_t RunTime) {
+    ES_RunStats_t *pStats = &RunStats[WhichService];
+    uint32_t Micros = RunTime / ES_PORT_STAMPS_PER_US;
+
+    pStats->Runs++;
+    if (RunTime > pStats->MaxRunTime) {
+        pStats->MaxRunTime = RunTime;
+        pStats->MaxState = State;
+        pStats->MaxEvent = EventType;
+    }
+    if (Micros > UINT16_MAX) {
+        Micros = UINT16_MAX;
+    }
+#ifdef USE_RUN_WORST_CASES
+    if (EventType < NUMBEROFEVENTS) {
+        if (State >= ES_RUN_STATES) {
+            State = ES_RUN_STATES - 1;
+        }
+        if (Micros > pStats->WorstUs[State][EventType]) {
+            pStats->WorstUs[State][EventType] = (uint16_t) Micros;
+        }
+    }
+#endif
+    if ((RunBudget == 0) || (RunTime <= RunBudget)) {
+        return TRUE;
+    }
+    pStats->Overruns++;
+#ifdef USE_TATTLETALE
+    ES_TraceAdd(ES_TRACE_OVERRUN, WhichService, State, EventType, (uint16_t) Micros);
+#endif
+#ifdef ES_RUN_BUDGET_FATAL
+    return FALSE;
+#else
+    return TRUE;
+#endif
+}
+
+/**
+ * @Function ES_Idle(uint32_t Ticks)
+ * @param Ticks - ticks until a checker group is next due, 0 to go straight
+ *                back to polling through ES_Port_Idle()
+ * @return the port's answer, FALSE to make ES_Run() return
+ * @brief Sleeps no later than the next timer expiry and books the time since
+ *        the last wakeup as busy. */
+static uint8_t ES_Idle(uint32_t Ticks) {
+    uint32_t Next;
+    uint32_t State;
+    uint8_t KeepRunning = TRUE;
+
+    if (Ticks == 0) {
+        BusyStamps += (uint32_t) (ES_Port_Timestamp() - BusySince);
+        KeepRunning = ES_Port_Idle();
+        BusySince = ES_Port_Timestamp();
+        return KeepRunning;
+    }
+    // sleep through the checker runs that can only find nothing
+    Ticks = ES_Port_SteadyTicks(Ticks);
+    // no timer can expire before the next tick, only look further out
+    if (Ticks > 1) {
+        Next = ES_Timer_NextExpiry();
+        if (Next < Ticks) {
+            Ticks = Next;
+        }
+    }
+    // an interrupt that posts after Ready is read must still end the sleep
+    State = ES_Port_EnterCritical();
+    if (Ready == 0) {
+        BusyStamps += (uint32_t) (ES_Port_Timestamp() - BusySince);
+        KeepRunning = ES_Port_Sleep(Ticks);
+        BusySince = ES_Port_Timestamp();
+    }
+    ES_Port_ExitCritical(State);
+    return KeepRunning;
+}
+
+// the tick interrupt only counts, the timers run here so that every post to a
+// service queue comes from the run loop; so does the ES_TICK_HOOK
+static void ES_RunTimers(void) {
+    uint32_t Ticks;
+
+    for (Ticks = ES_Port_TicksElapsed(); Ticks > 0; Ticks--) {
+#ifdef ES_TICK_HOOK
+        ES_TICK_HOOK();
+#endif
+        ES_Timer_Tick();
+    }
+}
@@ -0,0 +1,313 @@
+/*
+ * File: ES_Framework.h
+ *
+ * Public interface of the Events and Services Framework (ES_Framework). This
+ * is the only framework header an application needs to include, after its own
+ * ES_Configure.h.
+ *
+ * The framework keeps nothing in statics of its own. The service queues, the
+ * timers, the checker groups, the trace ring and everything else it keeps
+ * between calls are in an ES_Context_t, and every function here works on the
+ * context made current with ES_SetContext(). An application does the same
+ * with its services and machines, so that the host can run many instances of
+ * it side by side, one per thread, each with a context of its own.
+ */
+
+#ifndef ES_FRAMEWORK_H
+#define ES_FRAMEWORK_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Events.h"
+#include "ES_Port.h"
+#include "ES_Queue.h"
+#include "ES_Timers.h"
+#include "ES_CheckEvents.h"
+#include "ES_TattleTale.h"
+#include "ES_KeyboardInput.h"
+#include "ES_Hsm.h"
+#include "ES_ServiceHeaders.h"
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// the subscriber set of service n, for ES_SUBSCRIPTIONS in ES_Configure.h
+#define ES_SERVICE_BIT(n) ((ES_ReadySet_t) 1 << (n))
+
+/* Post to dispatch latency histograms, one per event type over all queues,
+ * kept with USE_LATENCY_HISTOGRAMS (ES_Configure.h). Bucket 0 counts the
+ * events dispatched within 1 us of being posted, bucket n those within 4^n us
+ * but not 4^(n-1) us, and the last bucket everything slower, 4 ms and up. The
+ * counts stop at 65535. */
+#define ES_LATENCY_BUCKETS 8
+
+/* Run-to-completion budget. The run loop times every call of a Run function
+ * and counts a call that takes longer than ES_RUN_BUDGET_US as an overrun,
+ * see ES_RunStats_t. The default is one tick: a longer call holds up the
+ * timers and the 1 ms checker groups. Define ES_RUN_BUDGET_FATAL in
+ * ES_Configure.h to have an overrun stop ES_Run() as an ES_ERROR would. */
+#ifndef ES_RUN_BUDGET_US
+#define ES_RUN_BUDGET_US 1000
+#endif
+
+// states of each service told apart in the worst cases, a state reported as
+// ES_RUN_STATES or above is counted as the last of them
+#ifndef ES_RUN_STATES
+#define ES_RUN_STATES 8
+#endif
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef enum {
+    Success = 0,
+    FailedPost = 1,
+    FailedRun,
+    FailedPointer,
+    FailedIndex,
+    FailedInit
+} ES_Return_t;
+
+/* Queue statistics, always compiled in, apart from the counts by event type,
+ * kept with USE_QUEUE_TYPE_STATS (ES_Configure.h). Posted, DepthSum,
+ * PeakDepth and TypePosted are updated by the producer on every successful
+ * post, the residencies by the run loop as it takes each event off the queue.
+ * Times are in ES_Port_Timestamp() units, see ES_PORT_STAMPS_PER_US, except
+ * the worst waits by event type, which keep whole microseconds and top out at
+ * 65535; the posts by event type stop counting at 255. */
+typedef struct {
+    uint32_t Posted; // events accepted by the queue
+    uint32_t Coalesced; // posts merged into a queued event of the same type
+    uint64_t DepthSum; // queue depth just after each post, DepthSum / Posted is the average
+    uint8_t PeakDepth; // deepest the queue has been
+    uint32_t MaxResidency; // longest an event waited between post and dispatch
+#ifdef USE_QUEUE_TYPE_STATS
+    uint8_t TypePosted[NUMBEROFEVENTS]; // events accepted, by event type
+    uint16_t TypeWorstUs[NUMBEROFEVENTS]; // longest wait, by event type
+#endif
+} ES_QueueStats_t;
+
+/* Run function statistics of one service, always compiled in, apart from the
+ * worst case table, kept with USE_RUN_WORST_CASES (ES_Configure.h). The state
+ * of each call is the one the service reported through ES_SERVICE_STATES
+ * (ES_Configure.h) just before it, 0 for a service that reports none. Times
+ * are in ES_Port_Timestamp() units, except the worst case table which keeps
+ * whole microseconds and tops out at 65535. */
+typedef struct {
+    uint32_t Runs; // calls of the Run function
+    uint32_t Overruns; // calls longer than the budget
+    uint32_t MaxRunTime; // longest call
+    uint8_t MaxState; // the state and event type of the longest call
+    uint8_t MaxEvent;
+#ifdef USE_RUN_WORST_CASES
+    uint16_t WorstUs[ES_RUN_STATES][NUMBEROFEVENTS]; // longest call, by state and event type
+#endif
+} ES_RunStats_t;
+
+/* One instance of the framework. A zeroed context is ready for
+ * ES_Initialize(), and so is one left by an earlier run. */
+typedef struct {
+    // the storage of each service queue, one extra entry for the queue header
+#define ES_SERVICE(n) ES_Event Queue##n[SERV_##n##_QUEUE_SIZE + 1]; \
+    uint32_t Stamps##n[SERV_##n##_QUEUE_SIZE];
+#include "ES_ServiceList.h"
+#undef ES_SERVICE
+    // bit n set means the queue of service n holds at least one event
+    volatile ES_ReadySet_t Ready;
+    uint32_t CoalescedSet[(NUMBEROFEVENTS + 31) / 32];
+    uint8_t InOrder; // set while ES_PostInOrder() posts, no post is coalesced
+    // the stamp rings move in step with the queues, Head with every
+    // successful post and Tail with every dispatch
+    uint8_t StampHead[NUM_SERVICES];
+    uint8_t StampTail[NUM_SERVICES];
+    ES_QueueStats_t QueueStats[NUM_SERVICES];
+#ifdef USE_LATENCY_HISTOGRAMS
+    uint16_t LatencyHist[NUMBEROFEVENTS][ES_LATENCY_BUCKETS];
+#endif
+    ES_RunStats_t RunStats[NUM_SERVICES];
+    uint32_t RunBudget; // in ES_Port_Timestamp() units, see ES_SetRunBudget()
+    // run loop time outside the port's idle calls since LoadStart, in
+    // ES_Port_Timestamp() units; BusySince is the stamp of the last wakeup
+    uint64_t BusyStamps;
+    uint32_t BusySince;
+    uint32_t LoadStart;
+    ES_TimerContext_t Timers;
+    ES_CheckContext_t Checks;
+    ES_TraceContext_t Trace;
+    ES_KeyboardContext_t Keyboard;
+#ifdef ES_HOST
+    ES_PortContext_t Port;
+#endif
+} ES_Context_t;
+
+// the context the framework works on, per thread on the host; the framework
+// reads it on every post and every tick, set it with ES_SetContext()
+extern ES_THREAD_LOCAL ES_Context_t *ES_CurrentContext;
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_SetContext(ES_Context_t *pContext)
+ * @param pContext - the instance of the framework to work on from now on
+ * @return None
+ * @brief Must come before ES_Initialize(), and before anything else that
+ *        posts, starts a timer or reads the time. On the host it only applies
+ *        to the calling thread, and a thread can switch between contexts as
+ *        long as it does not do so from inside ES_Run(). */
+void ES_SetContext(ES_Context_t *pContext);
+
+/**
+ * @Function ES_Initialize(void)
+ * @return Success, FailedPointer, FailedIndex or FailedInit
+ * @brief Starts the timers, initializes every service queue and then calls the
+ *        Init function of every service in ES_Configure.h, lowest priority
+ *        first. FailedIndex means COALESCED_EVENTS or ES_SUBSCRIPTIONS names
+ *        an event type or service that does not exist. */
+ES_Return_t ES_Initialize(void);
+
+/**
+ * @Function ES_Run(void)
+ * @return the reason the framework stopped, never returns on the Uno32
+ * @brief The framework main loop. Dispatches queued events to the services,
+ *        highest priority first, and runs the event checker groups that are
+ *        due whenever all the queues are empty. With USE_TICKLESS_IDLE it
+ *        sleeps until the next group is due. */
+ES_Return_t ES_Run(void);
+
+/**
+ * @Function ES_PostAll(ES_Event ThisEvent)
+ * @param ThisEvent - the event (type and param) to be posted
+ * @return TRUE if every queue accepted the event, FALSE otherwise */
+uint8_t ES_PostAll(ES_Event ThisEvent);
+
+/**
+ * @Function ES_PostToService(uint8_t WhichService, ES_Event ThisEvent)
+ * @param WhichService - priority of the service to post to
+ * @param ThisEvent - the event (type and param) to be posted
+ * @return TRUE if the event was queued, FALSE if the queue was full
+ * @brief An event whose type is in COALESCED_EVENTS (ES_Configure.h) is merged
+ *        into the newest queued event if that is of the same type, instead of
+ *        taking another entry, see ES_UpdateQueued(). */
+uint8_t ES_PostToService(uint8_t WhichService, ES_Event ThisEvent);
+
+/**
+ * @Function ES_PostInOrder(pPostFunc PostFunc, ES_Event ThisEvent)
+ * @param PostFunc - the post function of a service, such as PostTopHSM
+ * @param ThisEvent - the event (type and param) to be posted
+ * @return what PostFunc returns
+ * @brief Posts through PostFunc without coalescing, so the event takes an
+ *        entry of its own behind everything already queued. For an event
+ *        older than the ones queued, a deferred one being recalled, which
+ *        merged into a queued copy would overwrite its fresher param. */
+uint8_t ES_PostInOrder(pPostFunc PostFunc, ES_Event ThisEvent);
+
+/**
+ * @Function ES_Publish(ES_Event ThisEvent)
+ * @param ThisEvent - the event (type and param) to be published
+ * @return TRUE if every subscriber's queue accepted the event, or there are no
+ *         subscribers, FALSE otherwise
+ * @brief Posts the event to every service subscribed to its type in
+ *        ES_SUBSCRIPTIONS (ES_Configure.h), highest priority first. The
+ *        subscribers of a type are one ready-set wide mask built at compile
+ *        time, so publishing costs a table lookup and then one post for each
+ *        subscriber. */
+uint8_t ES_Publish(ES_Event ThisEvent);
+
+/**
+ * @Function ES_GetQueueDrops(uint8_t WhichService, ES_EventTyp_t *pLastDropped)
+ * @param WhichService - priority of the service to check
+ * @param pLastDropped - if not NULL, gets the type of the last event that did
+ *                       not fit in the queue
+ * @return the number of posts to the service refused because its queue was
+ *         full */
+uint32_t ES_GetQueueDrops(uint8_t WhichService, ES_EventTyp_t *pLastDropped);
+
+/**
+ * @Function ES_GetQueueStats(uint8_t WhichService, ES_QueueStats_t *pStats)
+ * @param WhichService - priority of the service to check
+ * @param pStats - where to copy the statistics of its queue
+ * @return TRUE, FALSE if there is no such service */
+uint8_t ES_GetQueueStats(uint8_t WhichService, ES_QueueStats_t *pStats);
+
+/**
+ * @Function ES_ResetQueueStats(void)
+ * @return None
+ * @brief Clears the statistics of every queue, Run function and checker
+ *        group and the latency histograms, and restarts the CPU load
+ *        measurement. The drop counts are kept. */
+void ES_ResetQueueStats(void);
+
+/**
+ * @Function ES_GetRunStats(uint8_t WhichService, ES_RunStats_t *pStats)
+ * @param WhichService - priority of the service to check
+ * @param pStats - where to copy the statistics of its Run function
+ * @return TRUE, FALSE if there is no such service */
+uint8_t ES_GetRunStats(uint8_t WhichService, ES_RunStats_t *pStats);
+
+/**
+ * @Function ES_SetRunBudget(uint32_t Micros)
+ * @param Micros - longest a Run function call may take, 0 for no limit
+ * @return None
+ * @brief ES_Initialize() starts every context at ES_RUN_BUDGET_US, call this
+ *        after it to change that. An overrun writes an ES_TRACE_OVERRUN record
+ *        into the state machine trace, with USE_TATTLETALE. */
+void ES_SetRunBudget(uint32_t Micros);
+
+/**
+ * @Function ES_GetLatencyHistogram(ES_EventTyp_t EventType, uint32_t *pBuckets)
+ * @param EventType - event type to look up
+ * @param pBuckets - where to copy its ES_LATENCY_BUCKETS bucket counts
+ * @return TRUE, FALSE if there is no such event type or the histograms are
+ *         not kept, see USE_LATENCY_HISTOGRAMS
+ * @brief Every event is stamped with ES_Port_Timestamp() as it is posted and
+ *        counted in the bucket of its type as the run loop hands it to its
+ *        service, so a service that posts to itself or publishes to several
+ *        subscribers is counted once per post. A bucket that reads 65535
+ *        has stopped counting. */
+uint8_t ES_GetLatencyHistogram(ES_EventTyp_t EventType, uint32_t *pBuckets);
+
+/**
+ * @Function ES_GetCpuLoad(void)
+ * @return the time the run loop spent busy rather than idle, in tenths of a
+ *         percent of the ticks since ES_Initialize() or ES_ResetQueueStats()
+ * @brief On the host the busy time is wall-clock time and the ticks are
+ *        virtual, so this is the load the same work would put on this machine
+ *        in real time, which says nothing about the Uno32, and
+ *        ES_PrintQueueStats() shows it as n/a. Without USE_TICKLESS_IDLE the
+ *        Uno32 never idles and reads close to 100%. */
+uint16_t ES_GetCpuLoad(void);
+
+/**
+ * @Function ES_PrintQueueStats(void)
+ * @return None
+ * @brief Prints the CPU load, the statistics of every checker group and of
+ *        every queue on the console, with a line for each event type that has
+ *        been posted to a queue with USE_QUEUE_TYPE_STATS, its count followed
+ *        by + once it has stopped at 255. */
+void ES_PrintQueueStats(void);
+
+/**
+ * @Function ES_PrintLatencyHistograms(void)
+ * @return None
+ * @brief Prints the latency histogram of every event type that has been
+ *        dispatched on the console, one line per type listing the buckets that
+ *        are not empty by their upper bound, or that they are not kept. */
+void ES_PrintLatencyHistograms(void);
+
+/**
+ * @Function ES_PrintRunStats(void)
+ * @return None
+ * @brief Prints the Run function statistics of every service on the console,
+ *        with a line for each state and event type it has been called with
+ *        and the worst time taken with USE_RUN_WORST_CASES. */
+void ES_PrintRunStats(void);
+
+#endif /* ES_FRAMEWORK_H */
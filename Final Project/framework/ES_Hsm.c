@@ -0,0 +1,380 @@
+/*
+ * File: ES_Hsm.c
+ *
+ * Table driven state machines, see ES_Hsm.h. A transition is run in place
+ * rather than by calling the machine again with ES_EXIT and ES_ENTRY, but the
+ * hooks run in the same order and the trace shows the same nested calls.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Hsm.h"
+#include "ES_Queue.h"
+#include "ES_TattleTale.h"
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#ifdef USE_TATTLETALE
+#define HSM_TRACE(Kind, pHsm, Type, Param) \
+    ES_TraceAdd((Kind), (pHsm)->TraceId, (pHsm)->Current, (Type), (Param))
+#else
+#define HSM_TRACE(Kind, pHsm, Type, Param)
+#endif
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static ES_HsmTransition_t const *FindRow(ES_HsmState_t const *pState, ES_Event ThisEvent);
+static ES_Event React(ES_Hsm_t *pHsm, ES_Event ThisEvent);
+static void Reenter(ES_Hsm_t *pHsm);
+static void Transition(ES_Hsm_t *pHsm, uint8_t Source, ES_HsmTransition_t const *pRow);
+static uint8_t Descend(ES_Hsm_t const *pHsm, uint8_t State, uint8_t History);
+static void EnterChain(ES_Hsm_t *pHsm, uint8_t Leaf, uint8_t Above);
+static void ExitChain(ES_Hsm_t *pHsm, uint8_t Above);
+static uint8_t CommonAncestor(ES_Hsm_t const *pHsm, uint8_t Source, uint8_t Target);
+static void RunHook(ES_Hsm_t *pHsm, uint8_t State, ES_EventTyp_t EventType);
+static void StartTimer(ES_Hsm_t *pHsm, uint8_t State, uint32_t Ticks);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t ES_HsmInit(ES_Hsm_t *pHsm, uint8_t Initial) {
+    ES_HsmState_t const *pState;
+    ES_HsmState_t const *pParent;
+    uint8_t s, r;
+
+    ES_HsmTransition_t const *pRow;
+
+    if ((Initial >= pHsm->NumStates) || (pHsm->pStates[Initial].Initial != ES_HSM_NONE)
+            || ((pHsm->Resume != ES_HSM_DEEP) && (pHsm->Resume != ES_HSM_SHALLOW)
+            && (pHsm->Resume != ES_HSM_RESTART))) {
+        return FALSE;
+    }
+    for (s = 0; s < pHsm->NumStates; s++) {
+        pState = &pHsm->pStates[s];
+        if ((pState->Timeout != 0) && (pHsm->pTimers == NULL)) {
+            return FALSE;
+        }
+        // a parent is listed before its substates, so the depths are checked
+        // top down and a chain of parents always ends at the top level
+        if (pState->Parent == ES_HSM_NONE) {
+            if (pState->Depth != 0) {
+                return FALSE;
+            }
+        } else {
+            if (pState->Parent >= s) {
+                return FALSE;
+            }
+            pParent = &pHsm->pStates[pState->Parent];
+            if ((pState->Depth != pParent->Depth + 1) || (pParent->Initial == ES_HSM_NONE)
+                    || ((pState->Events & pParent->Events) != pParent->Events)) {
+                return FALSE;
+            }
+        }
+        if ((pState->Depth >= ES_HSM_MAX_DEPTH)
+                || ((pState->Always != NULL) && (pState->Events != ES_HSM_ALL_EVENTS))) {
+            return FALSE;
+        }
+        if (pState->Initial != ES_HSM_NONE) {
+            if ((pState->Initial >= pHsm->NumStates)
+                    || (pHsm->pStates[pState->Initial].Parent != s)) {
+                return FALSE;
+            }
+        }
+        for (r = 0; r < pState->NumRows; r++) {
+            pRow = &pState->pRows[r];
+            if (((r > 0) && (pRow->Event < pRow[-1].Event))
+                    || ((pState->Events & ES_HSM_EVENT(pRow->Event)) == 0)) {
+                return FALSE;
+            }
+            if ((pRow->Target >= pHsm->NumStates) && (pRow->Target != ES_HSM_INTERNAL)
+                    && (pRow->Target != ES_HSM_PASS) && (pRow->Target != ES_HSM_DEFER)) {
+                return FALSE;
+            }
+            if ((pRow->Target == ES_HSM_DEFER)
+                    && ((pHsm->pDeferred == NULL) || (pHsm->PostFunc == NULL))) {
+                return FALSE;
+            }
+            if ((pRow->History != ES_HSM_NO_HISTORY)
+                    && ((pRow->History > ES_HSM_DEEP) || (pHsm->pLast == NULL)
+                    || (pRow->Target >= pHsm->NumStates)
+                    || (pHsm->pStates[pRow->Target].Initial == ES_HSM_NONE))) {
+                return FALSE;
+            }
+        }
+        if (pHsm->pLast != NULL) {
+            pHsm->pLast[s] = ES_HSM_NONE;
+        }
+    }
+    if ((pHsm->pDeferred != NULL) && (ES_InitQueue(pHsm->pDeferred, pHsm->DeferredSize) == 0)) {
+        return FALSE;
+    }
+    pHsm->Current = Initial;
+    pHsm->Running = Initial;
+    pHsm->Start = Initial;
+    return TRUE;
+}
+
+ES_Event ES_HsmDispatch(ES_Hsm_t *pHsm, ES_Event ThisEvent) {
+    if (ThisEvent.EventType == ES_ENTRY) {
+        Reenter(pHsm);
+        return ThisEvent;
+    }
+    if (ThisEvent.EventType == ES_EXIT) {
+        ExitChain(pHsm, ES_HSM_NONE);
+        return ThisEvent;
+    }
+    // an event no row of the current state or of the states enclosing it is
+    // for, and that no Always hook wants, is handed back without a walk
+    if ((pHsm->pStates[pHsm->Current].Events & ES_HSM_EVENT(ThisEvent.EventType)) == 0) {
+        HSM_TRACE(ES_TRACE_ENTER, pHsm, ThisEvent.EventType, ThisEvent.EventParam);
+        HSM_TRACE(ES_TRACE_EXIT, pHsm, ThisEvent.EventType, ThisEvent.EventParam);
+        return ThisEvent;
+    }
+    return React(pHsm, ThisEvent);
+}
+
+uint8_t ES_HsmDefer(ES_Hsm_t *pHsm, ES_Event ThisEvent) {
+    return ES_EnQueueFIFO(pHsm->pDeferred, ThisEvent);
+}
+
+uint8_t ES_HsmRecall(ES_Hsm_t *pHsm) {
+    ES_Event Parked;
+    uint8_t Recalled = 0;
+
+    if (pHsm->pDeferred == NULL) {
+        return 0;
+    }
+    while (!ES_IsQueueEmpty(pHsm->pDeferred)) {
+        ES_DeQueue(pHsm->pDeferred, &Parked);
+        if ((pHsm->Recall == NULL) || (pHsm->Recall(Parked) == TRUE)) {
+            ES_PostInOrder(pHsm->PostFunc, Parked);
+            Recalled++;
+        }
+    }
+    return Recalled;
+}
+
+void ES_HsmStartTimer(ES_Hsm_t *pHsm, uint32_t Ticks) {
+    StartTimer(pHsm, pHsm->Running, Ticks);
+}
+
+void ES_HsmStopTimer(ES_Hsm_t *pHsm) {
+    ES_Timer_Cancel(&pHsm->pTimers[pHsm->Running]);
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// offers the event to the current state and out through the ones enclosing it
+static ES_Event React(ES_Hsm_t *pHsm, ES_Event ThisEvent) {
+    ES_HsmState_t const *pStates = pHsm->pStates;
+    ES_HsmState_t const *pState;
+    ES_HsmTransition_t const *pRow;
+    uint32_t Bit = ES_HSM_EVENT(ThisEvent.EventType);
+    uint8_t s = pHsm->Current;
+    uint8_t Consumed = FALSE;
+
+    // a timeout starts at the state whose timer it is, if that is active
+    if ((ThisEvent.EventType == ES_TIMEOUT) && (pHsm->pTimers != NULL)) {
+        while ((s != ES_HSM_NONE) && (ThisEvent.EventParam != pHsm->TimerBase + s)) {
+            s = pStates[s].Parent;
+        }
+        if (s == ES_HSM_NONE) {
+            return ThisEvent;
+        }
+    }
+    HSM_TRACE(ES_TRACE_ENTER, pHsm, ThisEvent.EventType, ThisEvent.EventParam);
+    // ThisEvent is only read in the loop, so it stays in the registers it came in
+    for (; s != ES_HSM_NONE; s = pState->Parent) {
+        pState = &pStates[s];
+        // nor has any state enclosing it a row or an Always hook for it
+        if ((pState->Events & Bit) == 0) {
+            break;
+        }
+        pHsm->Running = s;
+        if (pState->Always != NULL) {
+            pState->Always(ThisEvent);
+        }
+        pRow = FindRow(pState, ThisEvent);
+        if (pRow == NULL) {
+            continue;
+        }
+        if (pRow->Action != NULL) {
+            pRow->Action(ThisEvent);
+        }
+        if (pRow->Target == ES_HSM_PASS) {
+            continue;
+        }
+        if (pRow->Target == ES_HSM_DEFER) {
+            ES_HsmDefer(pHsm, ThisEvent);
+        } else if (pRow->Target != ES_HSM_INTERNAL) {
+            Transition(pHsm, s, pRow);
+        }
+        Consumed = TRUE;
+        break;
+    }
+    if (Consumed) {
+        ThisEvent.EventType = ES_NO_EVENT;
+    }
+    HSM_TRACE(ES_TRACE_EXIT, pHsm, ThisEvent.EventType, ThisEvent.EventParam);
+    return ThisEvent;
+}
+
+// ES_ENTRY from the enclosing machine, as pHsm->Resume says
+static void Reenter(ES_Hsm_t *pHsm) {
+    uint8_t s = pHsm->Current;
+
+    switch (pHsm->Resume) {
+    case ES_HSM_SHALLOW:
+        while (pHsm->pStates[s].Parent != ES_HSM_NONE) {
+            s = pHsm->pStates[s].Parent;
+        }
+        EnterChain(pHsm, Descend(pHsm, s, ES_HSM_NO_HISTORY), ES_HSM_NONE);
+        break;
+    case ES_HSM_RESTART:
+        EnterChain(pHsm, pHsm->Start, ES_HSM_NONE);
+        React(pHsm, INIT_EVENT);
+        break;
+    default:
+        EnterChain(pHsm, s, ES_HSM_NONE);
+        break;
+    }
+}
+
+// the first row of the state for the event whose guard passes, NULL if none;
+// the rows are sorted, so the scan stops at the first row past the event
+static ES_HsmTransition_t const *FindRow(ES_HsmState_t const *pState, ES_Event ThisEvent) {
+    ES_HsmTransition_t const *pRow = pState->pRows;
+    ES_HsmTransition_t const *pEnd = pRow + pState->NumRows;
+
+    for (; (pRow < pEnd) && (pRow->Event <= ThisEvent.EventType); pRow++) {
+        if ((pRow->Event == ThisEvent.EventType)
+                && ((pRow->Guard == NULL) || (pRow->Guard(ThisEvent) == TRUE))) {
+            return pRow;
+        }
+    }
+    return NULL;
+}
+
+// leaves the current state for the row's target through the common ancestor
+// of Source, the state whose row it is, and the target, and settles in the
+// leaf under the target
+static void Transition(ES_Hsm_t *pHsm, uint8_t Source, ES_HsmTransition_t const *pRow) {
+    uint8_t Ancestor = CommonAncestor(pHsm, Source, pRow->Target);
+
+    ExitChain(pHsm, Ancestor);
+    EnterChain(pHsm, Descend(pHsm, pRow->Target, pRow->History), Ancestor);
+}
+
+// the leaf entering State leads to, down its Initial substates or, with
+// History, the ones it was last left in
+static uint8_t Descend(ES_Hsm_t const *pHsm, uint8_t State, uint8_t History) {
+    ES_HsmState_t const *pStates = pHsm->pStates;
+    uint8_t s = State;
+
+    while (pStates[s].Initial != ES_HSM_NONE) {
+        if ((History != ES_HSM_NO_HISTORY) && (pHsm->pLast[s] != ES_HSM_NONE)) {
+            s = pHsm->pLast[s];
+        } else {
+            s = pStates[s].Initial;
+        }
+        if (History == ES_HSM_SHALLOW) {
+            History = ES_HSM_NO_HISTORY;
+        }
+    }
+    return s;
+}
+
+// makes Leaf current and runs the entry hooks from below Above down to it
+static void EnterChain(ES_Hsm_t *pHsm, uint8_t Leaf, uint8_t Above) {
+    uint8_t Path[ES_HSM_MAX_DEPTH];
+    uint8_t Length = 0;
+    uint8_t s;
+
+    for (s = Leaf; s != Above; s = pHsm->pStates[s].Parent) {
+        Path[Length++] = s;
+    }
+    // the trace shows the hooks as calls on the state being entered
+    pHsm->Current = Leaf;
+    while (Length > 0) {
+        RunHook(pHsm, Path[--Length], ES_ENTRY);
+    }
+    pHsm->Running = Leaf;
+}
+
+// runs the exit hooks from the current state up to below Above, noting in
+// each state left the substate it was left from, then recalls the events
+// the states deferred
+static void ExitChain(ES_Hsm_t *pHsm, uint8_t Above) {
+    uint8_t s, Parent;
+
+    for (s = pHsm->Current; s != Above; s = Parent) {
+        RunHook(pHsm, s, ES_EXIT);
+        Parent = pHsm->pStates[s].Parent;
+        if ((pHsm->pLast != NULL) && (Parent != ES_HSM_NONE)) {
+            pHsm->pLast[Parent] = s;
+        }
+    }
+    ES_HsmRecall(pHsm);
+}
+
+// the deepest state enclosing both Source and Target, ES_HSM_NONE if that is
+// the top level; neither counts as enclosing itself
+static uint8_t CommonAncestor(ES_Hsm_t const *pHsm, uint8_t Source, uint8_t Target) {
+    ES_HsmState_t const *pStates = pHsm->pStates;
+    uint8_t a = pStates[Source].Parent;
+    uint8_t b = pStates[Target].Parent;
+
+    while (a != b) {
+        if ((a != ES_HSM_NONE) && ((b == ES_HSM_NONE) || (pStates[a].Depth >= pStates[b].Depth))) {
+            a = pStates[a].Parent;
+        } else {
+            b = pStates[b].Parent;
+        }
+    }
+    return a;
+}
+
+// the Always hook and then the Entry or Exit hook of State, with its timer
+// started before the Entry hook or stopped after the Exit hook
+static void RunHook(ES_Hsm_t *pHsm, uint8_t State, ES_EventTyp_t EventType) {
+    ES_HsmState_t const *pState = &pHsm->pStates[State];
+    ES_Event HookEvent = {EventType, 0x0000};
+
+    HSM_TRACE(ES_TRACE_ENTER, pHsm, EventType, 0);
+    pHsm->Running = State;
+    if (pState->Always != NULL) {
+        pState->Always(HookEvent);
+    }
+    if (EventType == ES_ENTRY) {
+        if (pState->Timeout != 0) {
+            StartTimer(pHsm, State, pState->Timeout);
+        }
+        if (pState->Entry != NULL) {
+            pState->Entry();
+        }
+    } else {
+        if (pState->Exit != NULL) {
+            pState->Exit();
+        }
+        if (pState->Timeout != 0) {
+            ES_Timer_Cancel(&pHsm->pTimers[State]);
+        }
+    }
+    HSM_TRACE(ES_TRACE_EXIT, pHsm, EventType, 0);
+}
+
+static void StartTimer(ES_Hsm_t *pHsm, uint8_t State, uint32_t Ticks) {
+    ES_Timer_Start(&pHsm->pTimers[State], Ticks, pHsm->PostFunc, pHsm->TimerBase + State);
+}
@@ -0,0 +1,280 @@
+/*
+ * File: ES_Hsm.h
+ *
+ * Table driven state machines. A machine is a const array of ES_HsmState_t,
+ * indexed by state number, and each state lists the events it reacts to as a
+ * const array of ES_HsmTransition_t sorted by event type. Rows for the same
+ * event are tried in order and the first whose guard passes is taken, so a
+ * chain of if / else if on the event param becomes a run of guarded rows.
+ * Each state also has the events that it or a state enclosing it has rows
+ * for as a bitmap, so an event none of them reacts to is handed back at once.
+ *
+ * ES_HsmDispatch() gives one event to the current state with the same
+ * semantics as the switch based machines built from the templates:
+ *
+ *  - the state's Always hook runs first, for every event including the
+ *    ES_ENTRY and ES_EXIT of a transition;
+ *  - ES_ENTRY and ES_EXIT run the state's Entry or Exit hook and are handed
+ *    back unconsumed, so an enclosing machine can pass its own entries and
+ *    exits down;
+ *  - the first matching row runs its action and then either moves to its
+ *    target state (exit hooks of the old state, entry hooks of the new one)
+ *    or, for ES_HSM_INTERNAL, stays put, or, for ES_HSM_DEFER, stays put and
+ *    parks the event. Either way the event is consumed;
+ *  - an event the state has no matching row for goes on to the state
+ *    enclosing it, and so on out to the top level, and ES_HSM_PASS runs the
+ *    action and then does the same. An event no state takes is handed back,
+ *    for the enclosing machine. A reaction common to the substates of a state
+ *    is written once, as a row of that state.
+ *
+ * States may nest, up to ES_HSM_MAX_DEPTH deep: each state names its Parent,
+ * its Depth below the top and, if other states are nested in it, the
+ * Initial one of them to enter after it. The current state is always a leaf.
+ * A transition taken by a row of the current state, or of a state enclosing
+ * it, runs the exit hooks from the current state up to, but not including,
+ * the least common ancestor of the row's state and the target, then the entry hooks from below the ancestor down to the target
+ * and on down its Initial substates to a leaf. A state is not its own
+ * ancestor, so a transition to the current state or to an enclosing state
+ * leaves and re-enters it. The chains are walked in a loop over a path of
+ * ES_HSM_MAX_DEPTH bytes, nothing recurses and nothing is dispatched again,
+ * so stack use does not grow with the nesting.
+ *
+ * A row may instead resume its target where it was last left. With
+ * ES_HSM_SHALLOW the target's substate that was active when the target was
+ * last exited is entered, and below that the Initial substates as usual;
+ * with ES_HSM_DEEP the whole chain of substates that was active is. A
+ * target never left yet is entered through its Initial substates. The
+ * machine keeps the substate last left of every state in the array its
+ * pLast points to.
+ *
+ * ES_EXIT from an enclosing machine leaves the whole chain of the current
+ * state. ES_ENTRY from it re-enters the machine as its Resume says:
+ * ES_HSM_DEEP enters the chain of the leaf that was left, ES_HSM_SHALLOW the
+ * top level state that was left and its Initial substates, and
+ * ES_HSM_RESTART the initial state ES_HsmInit() was given, which is then
+ * given ES_INIT. Either way the event is handed back unconsumed. The
+ * machine's own variables are left alone, so a resumed machine carries on
+ * with the context it had.
+ *
+ * A state that cannot handle an event yet, but must not lose it, defers it:
+ * the event is parked in the machine's deferred queue, an ES_Queue.h block,
+ * and the machine recalls every parked event as soon as it leaves a state,
+ * on a transition or on ES_EXIT from the enclosing machine. A recalled event
+ * is posted again through the machine's PostFunc, behind whatever is queued
+ * already and never merged into a queued event of its type, see
+ * ES_PostInOrder(), and reaches the machine in the state it has moved to,
+ * which may defer it once more. Events that do not fit the queue are counted
+ * as its drops, see ES_QueueDrops(). A machine may give its deferred queue a
+ * Recall guard, which every parked event must pass to be posted again; one
+ * that fails is dropped. An event reporting a sensor reading that has changed
+ * since it was parked is one to drop, since the events of the change itself
+ * went by while it waited and the machine would act on a reading that no
+ * longer holds.
+ *
+ * A machine set up with ES_HSM_TIMED_MACHINE() has one ES_Timer_t per state,
+ * whose ES_TIMEOUT carries the machine's timer base plus the state number. A
+ * state with a Timeout has its timer started before its Entry hook and
+ * stopped after its Exit hook; other states may run theirs from their hooks
+ * with ES_HsmStartTimer() and ES_HsmStopTimer(). A timeout is given to the
+ * state whose timer it is, and from there goes outwards like any event; a
+ * timeout for a state that is not active is handed back untouched.
+ *
+ * The state number and the transition tables stay the machine's own; the
+ * engine only needs the ES_Hsm_t that ties them together, set up with
+ * ES_HSM_MACHINE() or ES_HSM_TIMED_MACHINE() and started with ES_HsmInit().
+ * The tables are const and shared, the ES_Hsm_t and its arrays are per robot,
+ * so one machine can run any number of robots, see src/Bot.h. The tables are normally generated from a state chart by
+ * es_chart, see host/tools/StateChart.c.
+ *
+ * The tables buy nesting, history and deferral written once, not speed. An
+ * event a row is for still walks the states and rows and calls every hook,
+ * guard and action through a pointer, where a switch has the compiler lay
+ * out each state's tests inline: Collection1SubHSM takes about 1.8 times the
+ * instructions per event of the switch it replaced, see
+ * host/bench/hsm/HsmBench.c. Only machines whose nesting and deferral are
+ * worth that are written as tables, so far Collection1SubHSM alone; the
+ * others keep their switches, see dispatch in StateChart.c.
+ */
+
+#ifndef ES_HSM_H
+#define ES_HSM_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include "ES_Configure.h"
+#include "ES_Events.h"
+#include "ES_Timers.h"
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// Target values that are not states
+#define ES_HSM_INTERNAL 0xFF // consume the event, no transition
+#define ES_HSM_PASS 0xFE // run the action, hand the event back unconsumed
+#define ES_HSM_DEFER 0xFD // run the action, park the event until a state is left
+
+// the Parent of a top level state, and the Initial of a leaf
+#define ES_HSM_NONE 0xFF
+
+// how a row enters its target, see ES_HsmTransition_t
+#define ES_HSM_NO_HISTORY 0 // down the Initial substates
+#define ES_HSM_SHALLOW 1 // the substate last left, then down the Initial ones
+#define ES_HSM_DEEP 2 // the chain of substates last left
+// and how ES_ENTRY re-enters a machine, see ES_Hsm_t, also ES_HSM_SHALLOW or
+// ES_HSM_DEEP
+#define ES_HSM_RESTART 3 // from the initial state, with ES_INIT
+
+// states nest at most this deep, including the top level
+#ifndef ES_HSM_MAX_DEPTH
+#define ES_HSM_MAX_DEPTH 8
+#endif
+
+// the row array and row count of an ES_HsmState_t
+#define ES_HSM_ROWS(Rows) (Rows), (sizeof (Rows) / sizeof ((Rows)[0]))
+#define ES_HSM_NO_ROWS NULL, 0
+
+// the bit of an event in the Events of an ES_HsmState_t; the event types past
+// 30 share the top bit
+#define ES_HSM_EVENT(Event) (((Event) < 31) ? (1UL << (Event)) : (1UL << 31))
+#define ES_HSM_ALL_EVENTS 0xFFFFFFFFUL
+
+// the deferred queue of an ES_Hsm_t, an array of ES_Event sized as ES_Queue.h
+// asks, and its Recall guard or NULL to recall every parked event; none for a
+// machine without ES_HSM_DEFER rows
+#define ES_HSM_DEFER_QUEUE(Block, Recall) \
+    (Block), (sizeof (Block) / sizeof ((Block)[0])), (Recall)
+#define ES_HSM_NO_DEFER NULL, 0, NULL
+
+// initializers of an ES_Hsm_t from its array of states, see ES_HsmInit();
+// Last is an array of one uint8_t per state or NULL, Resume one of
+// ES_HSM_DEEP, ES_HSM_SHALLOW and ES_HSM_RESTART, Deferred ES_HSM_DEFER_QUEUE()
+// or ES_HSM_NO_DEFER. Recalled events go out through PostFunc, so only a timed
+// machine can defer
+#define ES_HSM_MACHINE(States, TraceId, Last, Resume) \
+    {(States), NULL, (Last), ES_HSM_NO_DEFER, NULL, 0, \
+     (sizeof (States) / sizeof ((States)[0])), (TraceId), (Resume), 0, 0, 0}
+#define ES_HSM_TIMED_MACHINE(States, TraceId, Last, Resume, Timers, TimerBase, PostFunc, Deferred) \
+    {(States), (Timers), (Last), Deferred, (PostFunc), (TimerBase), \
+     (sizeof (States) / sizeof ((States)[0])), (TraceId), (Resume), 0, 0, 0}
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef uint8_t ES_HsmGuard_t(ES_Event ThisEvent);
+typedef void ES_HsmAction_t(ES_Event ThisEvent);
+typedef void ES_HsmHook_t(void);
+
+typedef struct {
+    ES_EventTyp_t Event;
+    ES_HsmGuard_t *Guard; // NULL always passes
+    ES_HsmAction_t *Action; // NULL for none
+    uint8_t Target; // a state, ES_HSM_INTERNAL, ES_HSM_PASS or ES_HSM_DEFER
+    uint8_t History; // ES_HSM_SHALLOW or ES_HSM_DEEP to resume the Target, 0 if not
+} ES_HsmTransition_t;
+
+typedef struct {
+    ES_HsmHook_t *Entry;
+    ES_HsmHook_t *Exit;
+    ES_HsmAction_t *Always; // runs on every event the state is given
+    uint16_t Timeout; // ms, 0 if the state runs its own timer or has none
+    ES_HsmTransition_t const *pRows; // sorted by Event
+    uint8_t NumRows;
+    uint8_t Parent; // the enclosing state, ES_HSM_NONE at the top level
+    uint8_t Depth; // 0 at the top level, one more than the Parent's below it
+    uint8_t Initial; // the substate entered after this one, ES_HSM_NONE for a leaf
+    // ES_HSM_EVENT() of every event it or a state enclosing it has rows for,
+    // ES_HSM_ALL_EVENTS if one of them has an Always hook
+    uint32_t Events;
+} ES_HsmState_t;
+
+typedef struct {
+    ES_HsmState_t const *pStates;
+    ES_Timer_t *pTimers; // one per state, NULL for none
+    uint8_t *pLast; // per state the substate last left, NULL if no row resumes one
+    ES_Event *pDeferred; // the deferred queue, NULL if no row defers
+    uint8_t DeferredSize; // entries in pDeferred, including the queue header
+    ES_HsmGuard_t *Recall; // a parked event it fails is dropped, NULL recalls all
+    pPostFunc PostFunc; // where the state timers post
+    uint16_t TimerBase; // the ES_TIMEOUT param of state s is TimerBase + s
+    uint8_t NumStates;
+    uint8_t TraceId; // ES_TRACE_ID of the machine, see ES_TattleTale.h
+    uint8_t Resume; // how ES_ENTRY re-enters the machine
+    uint8_t Current; // a leaf
+    uint8_t Running; // the state whose hook or row is running, for the timer calls
+    uint8_t Start; // the initial state, for ES_HSM_RESTART
+} ES_Hsm_t;
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_HsmInit(ES_Hsm_t *pHsm, uint8_t Initial)
+ * @param pHsm - the machine
+ * @param Initial - leaf state to start in, normally an initial pseudo-state
+ *                  that takes ES_INIT to the real first state
+ * @return TRUE, FALSE if a state's rows are not sorted by event, a target
+ *         is not a state of the machine, a state has a Timeout in a machine
+ *         without timers, the nesting is deeper than ES_HSM_MAX_DEPTH or does
+ *         not add up, an enclosing state has no Initial substate, a row
+ *         resumes a state without substates or in a machine without pLast,
+ *         a row defers in a machine without a deferred queue or PostFunc,
+ *         or a state's Events leave out the event of one of its rows or one
+ *         of its Parent's Events, or are not ES_HSM_ALL_EVENTS with an
+ *         Always hook
+ * @brief No hooks are run, every state is taken as never left and the
+ *        deferred queue is emptied. */
+uint8_t ES_HsmInit(ES_Hsm_t *pHsm, uint8_t Initial);
+
+/**
+ * @Function ES_HsmDispatch(ES_Hsm_t *pHsm, ES_Event ThisEvent)
+ * @param pHsm - the machine
+ * @param ThisEvent - the event to give the current state
+ * @return ES_NO_EVENT if the event was consumed, otherwise ThisEvent
+ * @brief See the top of this file. Writes ES_Tattle() and ES_Tail() records
+ *        for the call and for each hook call of a transition. */
+ES_Event ES_HsmDispatch(ES_Hsm_t *pHsm, ES_Event ThisEvent);
+
+/**
+ * @Function ES_HsmDefer(ES_Hsm_t *pHsm, ES_Event ThisEvent)
+ * @param pHsm - a machine with a deferred queue
+ * @param ThisEvent - the event to park
+ * @return TRUE, FALSE if the queue was full and the event is lost
+ * @brief What an ES_HSM_DEFER row does, for a hook or an action that decides
+ *        for itself. The event comes back when the machine next leaves a
+ *        state. */
+uint8_t ES_HsmDefer(ES_Hsm_t *pHsm, ES_Event ThisEvent);
+
+/**
+ * @Function ES_HsmRecall(ES_Hsm_t *pHsm)
+ * @param pHsm - a machine with a deferred queue, or without
+ * @return the number of events posted again
+ * @brief Posts every parked event that passes the machine's Recall guard
+ *        again through its PostFunc with ES_PostInOrder(), in the order they
+ *        were deferred, and drops the rest. Run by the machine itself
+ *        whenever it leaves a state, so only needed to recall without a
+ *        transition. */
+uint8_t ES_HsmRecall(ES_Hsm_t *pHsm);
+
+/**
+ * @Function ES_HsmStartTimer(ES_Hsm_t *pHsm, uint32_t Ticks)
+ * @param pHsm - a machine set up with ES_HSM_TIMED_MACHINE()
+ * @param Ticks - milliseconds until the state gets its ES_TIMEOUT
+ * @return None
+ * @brief (Re)starts the timer of the state whose hook or row is running, for
+ *        a state whose timeout is decided by its Entry hook rather than fixed
+ *        in the table. */
+void ES_HsmStartTimer(ES_Hsm_t *pHsm, uint32_t Ticks);
+
+/**
+ * @Function ES_HsmStopTimer(ES_Hsm_t *pHsm)
+ * @param pHsm - a machine set up with ES_HSM_TIMED_MACHINE()
+ * @return None
+ * @brief Cancels the timer of the state whose hook or row is running. */
+void ES_HsmStopTimer(ES_Hsm_t *pHsm);
+
+#endif /* ES_HSM_H */
@@ -0,0 +1,109 @@
+/*
+ * File: ES_KeyboardInput.c
+ *
+ * Service 0 of every ES application, see ES_KeyboardInput.h. ES_Run() posts an
+ * ES_KEYINPUT event for every character received on the console.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_KeyboardInput.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define KEY_BUFFER_SIZE ES_KEY_BUFFER_SIZE
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// the keyboard service of the current context
+#define MyPriority (ES_CurrentContext->Keyboard.MyPriority)
+#define KeyBuffer (ES_CurrentContext->Keyboard.KeyBuffer)
+#define KeyIndex (ES_CurrentContext->Keyboard.KeyIndex)
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t InitKeyboardInput(uint8_t Priority) {
+    MyPriority = Priority;
+    return ES_PostToService(MyPriority, INIT_EVENT);
+}
+
+uint8_t PostKeyboardInput(ES_Event ThisEvent) {
+    return ES_PostToService(MyPriority, ThisEvent);
+}
+
+ES_Event RunKeyboardInput(ES_Event ThisEvent) {
+    ES_Event ReturnEvent;
+    ReturnEvent.EventType = ES_NO_EVENT;
+
+#ifdef USE_KEYBOARD_INPUT
+    ES_Event KeyEvent;
+    char *paramStart;
+    uint8_t i;
+
+    switch (ThisEvent.EventType) {
+        case ES_INIT:
+            printf("\r\nKeyboard input: type \"<event> <param>\" to post, \"?\" to list events, "
+                    "\"s\" for queue stats, \"h\" for latency histograms, \"r\" to reset them");
+            KeyIndex = 0;
+            break;
+
+        case ES_KEYINPUT:
+            if ((ThisEvent.EventParam != '\r') && (ThisEvent.EventParam != '\n')) {
+                if (KeyIndex < (KEY_BUFFER_SIZE - 1)) {
+                    KeyBuffer[KeyIndex++] = (char) ThisEvent.EventParam;
+                }
+                break;
+            }
+            KeyBuffer[KeyIndex] = '\0';
+            if (KeyIndex == 0) {
+                break;
+            }
+            KeyIndex = 0;
+            if (KeyBuffer[0] == '?') {
+                for (i = 0; i < NUMBEROFEVENTS; i++) {
+                    printf("\r\n%2d: %s", i, EventNames[i]);
+                }
+                break;
+            }
+            if (KeyBuffer[0] == 's') {
+                ES_PrintQueueStats();
+                break;
+            }
+            if (KeyBuffer[0] == 'h') {
+                ES_PrintLatencyHistograms();
+                break;
+            }
+            if (KeyBuffer[0] == 'r') {
+                ES_ResetQueueStats();
+                break;
+            }
+            KeyEvent.EventType = (ES_EventTyp_t) strtoul(KeyBuffer, &paramStart, 0);
+            KeyEvent.EventParam = (uint16_t) strtoul(paramStart, NULL, 0);
+            if (KeyEvent.EventType >= NUMBEROFEVENTS) {
+                printf("\r\nKeyboard input: no event %d", KeyEvent.EventType);
+                break;
+            }
+            printf("\r\nKeyboard input: posting %s 0x%X",
+                    EventNames[KeyEvent.EventType], KeyEvent.EventParam);
+            POSTFUNCTION_FOR_KEYBOARD_INPUT(KeyEvent);
+            break;
+
+        default:
+            break;
+    }
+#endif
+    return ReturnEvent;
+}
@@ -0,0 +1,44 @@
+/*
+ * File: ES_KeyboardInput.h
+ *
+ * Service 0 of every ES application. With USE_KEYBOARD_INPUT defined in
+ * ES_Configure.h it lets events be typed on the serial console as
+ * "<event number> <param>" and posts them to POSTFUNCTION_FOR_KEYBOARD_INPUT,
+ * so a state machine can be driven without any sensors attached. Typing "?"
+ * lists the event numbers, "s" prints the queue statistics, "h" the post to
+ * dispatch latency histograms and "r" clears them both.
+ */
+
+#ifndef ES_KEYBOARDINPUT_H
+#define ES_KEYBOARDINPUT_H
+
+#include "ES_Events.h"
+
+#define ES_KEY_BUFFER_SIZE 16
+
+// the keyboard service's part of an ES_Context_t
+typedef struct {
+    uint8_t MyPriority;
+    char KeyBuffer[ES_KEY_BUFFER_SIZE];
+    uint8_t KeyIndex;
+} ES_KeyboardContext_t;
+
+/**
+ * @Function InitKeyboardInput(uint8_t Priority)
+ * @param Priority - internal variable to track which event queue to use
+ * @return TRUE or FALSE */
+uint8_t InitKeyboardInput(uint8_t Priority);
+
+/**
+ * @Function PostKeyboardInput(ES_Event ThisEvent)
+ * @param ThisEvent - the event (type and param) to be posted to queue
+ * @return TRUE or FALSE */
+uint8_t PostKeyboardInput(ES_Event ThisEvent);
+
+/**
+ * @Function RunKeyboardInput(ES_Event ThisEvent)
+ * @param ThisEvent - the event (type and param) to be responded.
+ * @return ES_NO_EVENT */
+ES_Event RunKeyboardInput(ES_Event ThisEvent);
+
+#endif /* ES_KEYBOARDINPUT_H */
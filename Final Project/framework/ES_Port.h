@@ -0,0 +1,294 @@
+/*
+ * File: ES_Port.h
+ *
+ * Hardware specific pieces of the Events and Services Framework. Everything
+ * above this layer (queues, timers, the run loop) is plain C and is shared
+ * between the Uno32 build (ES_Port_PIC32.c) and the Linux host build
+ * (host/ES_Port_Host.c).
+ *
+ * The port owns the 1 ms tick. On the Uno32 the timer interrupt only counts
+ * ticks and the run loop collects them through ES_Port_TicksElapsed(), so
+ * ES_Timer_Tick() and the ES_TIMEOUT posts it makes always run in the run
+ * loop. On the host the port calls ES_Timer_Tick() itself whenever the run loop
+ * goes idle, so that time advances in virtual rather than wall-clock
+ * milliseconds.
+ *
+ * With USE_TICKLESS_IDLE the run loop calls ES_Port_Sleep() instead of
+ * ES_Port_Idle(), asking for as many ticks as it can spare. The Uno32 stretches
+ * the tick period to cover them and halts the core; the host jumps virtual time
+ * ahead. The host also knows, from its tick hook, how long the inputs will
+ * read as they do now, and lets the run loop sleep through the checker runs
+ * that could only find what they found before, see ES_Port_SteadyTicks(); on
+ * the Uno32 those hooks do nothing.
+ *
+ * A host build with ES_VERIFY_STEADY (make VERIFY=1) checks that shortcut: a
+ * context made fixed-tick with ES_Port_SetFixedTick() never trusts the hook's
+ * answer and steps and checks every tick, and every context logs the events
+ * the run loop hands its services, so a fixed-tick twin of a robot can be run
+ * beside it and the two logs compared, see HostMain.c.
+ */
+
+#ifndef ES_PORT_H
+#define ES_PORT_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include <stdint.h>
+#ifdef ES_HOST
+#include <stdio.h>
+#include "ES_CheckEvents.h"
+#endif
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+/* The run loop keeps one ready bit per service in an ES_ReadySet_t and picks
+ * the highest priority ready service with ES_Port_HighestBit(). Both compilers
+ * are gcc based and turn the builtin into a single instruction, clz on the
+ * PIC32's MIPS32 core and lzcnt/bsr on x86. The set must not be empty. */
+/* ES_Port_Timestamp() counts in port specific units, ES_PORT_STAMPS_PER_US of
+ * them to a microsecond. Only differences between stamps mean anything; they
+ * stay correct across the 32-bit wrap for spans under a minute. */
+#ifdef ES_HOST
+#define ES_PORT_STAMPS_PER_US 1000 // CLOCK_MONOTONIC nanoseconds
+#else
+#define ES_PORT_STAMPS_PER_US 40 // the core timer, SYS_FREQ / 2
+#endif
+
+/* Everything the framework keeps between calls is in the ES_Context_t made
+ * current with ES_SetContext(), see ES_Framework.h. On the host the current
+ * context is per thread, so that every thread can run an instance of the
+ * application of its own; the Uno32 only ever has the one. */
+#ifdef ES_HOST
+#define ES_THREAD_LOCAL __thread
+#else
+#define ES_THREAD_LOCAL
+#endif
+
+#ifdef ES_HOST
+typedef uint64_t ES_ReadySet_t;
+#define ES_MAX_SERVICES 64
+#define ES_Port_HighestBit(Set) ((uint8_t) (63 - __builtin_clzll(Set)))
+#else
+typedef uint32_t ES_ReadySet_t;
+#define ES_MAX_SERVICES 32
+#define ES_Port_HighestBit(Set) ((uint8_t) (31 - __builtin_clz(Set)))
+#endif
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+#ifdef ES_HOST
+// moves the world on by Ticks ticks of virtual time, none to only ask, and
+// returns how many ticks after that the inputs it sets will still read as they
+// do now, as long as the outputs stay as they are; see ES_Port_SetTickHook()
+typedef uint32_t ES_PortTickHook_t(void *pArg, uint32_t Ticks);
+
+// what a tick hook returns when only a change of the outputs can change the
+// inputs
+#define ES_PORT_STEADY_FOREVER UINT32_MAX
+
+#ifdef ES_VERIFY_STEADY
+// one event the run loop handed a service, see ES_Port_NoteDispatch()
+typedef struct {
+    uint32_t Tick;
+    uint16_t EventType;
+    uint16_t EventParam;
+    uint8_t Service;
+} ES_PortDispatch_t;
+#endif
+
+// the host port's part of an ES_Context_t; the Uno32 port's tick count
+// belongs to the one core and stays its own
+typedef struct {
+    uint32_t RunLimit; // see ES_Port_SetRunLimit()
+    uint8_t Limited; // a zeroed context runs until ES_Port_SetRunLimit()
+    FILE *pTraceFile;
+    ES_PortTickHook_t *pTickHook;
+    void *pTickArg;
+    // the inputs have read the same from tick SteadySince on and will through
+    // tick SteadyUntil, see ES_Port_InputsSteady()
+    uint32_t SteadySince;
+    uint32_t SteadyUntil;
+    // per checker group the tick of its last run plus one, 0 for none, see
+    // ES_Port_CheckGroupRan()
+    uint32_t GroupRan[ES_MAX_CHECKERS];
+#ifdef ES_VERIFY_STEADY
+    uint8_t FixedTick; // see ES_Port_SetFixedTick()
+    ES_PortDispatch_t *pDispatches; // see ES_Port_GetDispatches()
+    uint32_t NumDispatches;
+    uint32_t MaxDispatches;
+#endif
+} ES_PortContext_t;
+#endif
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_Port_Init(void)
+ * @return None
+ * @brief Starts the 1 ms tick source. Called once from ES_Timer_Init(). */
+void ES_Port_Init(void);
+
+/**
+ * @Function ES_Port_TicksElapsed(void)
+ * @return number of 1 ms ticks since the last call
+ * @brief Called by the run loop, which calls ES_Timer_Tick() that many times.
+ *        Never touches interrupt masks. */
+uint32_t ES_Port_TicksElapsed(void);
+
+/**
+ * @Function ES_Port_Timestamp(void)
+ * @return a free running high resolution count, see ES_PORT_STAMPS_PER_US
+ * @brief Cheap enough to call on every post and dispatch. */
+uint32_t ES_Port_Timestamp(void);
+
+/**
+ * @Function ES_Port_Idle(void)
+ * @return TRUE to keep running the framework, FALSE to make ES_Run() return
+ * @brief Called by ES_Run() whenever all the queues are empty and no event
+ *        checker found anything on the last pass. */
+uint8_t ES_Port_Idle(void);
+
+/**
+ * @Function ES_Port_Sleep(uint32_t Ticks)
+ * @param Ticks - most ticks to sleep for, at least 1
+ * @return TRUE to keep running the framework, FALSE to make ES_Run() return
+ * @brief Called by the tickless run loop with interrupts masked, once it has
+ *        found every queue empty. Returns after Ticks ticks or as soon as any
+ *        interrupt is pending, whichever comes first, still masked. On the
+ *        Uno32 the ticks slept are reported by ES_Port_TicksElapsed() as
+ *        usual; the host runs ES_Timer_Tick() for them itself. */
+uint8_t ES_Port_Sleep(uint32_t Ticks);
+
+/**
+ * @Function ES_Port_SteadyTicks(uint32_t Ticks)
+ * @param Ticks - ticks until a checker group is next due, at least 1
+ * @return Ticks, or longer if every group due before then could only find
+ *         what it found before; the ticks to the first run that might not
+ * @brief Called by the tickless run loop just before it sleeps. The Uno32
+ *        cannot tell, and returns Ticks. The host asks ES_Port_InputsSteady()
+ *        and, when it sleeps longer than Ticks, has ES_Port_Sleep() count the
+ *        checker runs it slept through as if they had found nothing. */
+uint32_t ES_Port_SteadyTicks(uint32_t Ticks);
+
+/**
+ * @Function ES_Port_CheckGroupRan(uint8_t Group, uint32_t Now)
+ * @param Group - the checker group, as ES_GetCheckGroupStats() numbers them
+ * @param Now - the tick it ran on
+ * @return None
+ * @brief Called by ES_CheckDueUserEvents() after every group it runs. Does
+ *        nothing on the Uno32; the host notes which groups have run on the
+ *        inputs as they are for ES_Port_SteadyTicks(). */
+void ES_Port_CheckGroupRan(uint8_t Group, uint32_t Now);
+
+/**
+ * @Function ES_Port_EnterCritical(void)
+ * @return state to be handed back to ES_Port_ExitCritical()
+ * @brief Masks interrupts so application code can update data it shares with
+ *        an interrupt. The framework itself only masks them around
+ *        ES_Port_Sleep(). */
+uint32_t ES_Port_EnterCritical(void);
+
+/**
+ * @Function ES_Port_ExitCritical(uint32_t State)
+ * @param State - value returned by the matching ES_Port_EnterCritical()
+ * @return None */
+void ES_Port_ExitCritical(uint32_t State);
+
+/**
+ * @Function ES_Port_GetChar(void)
+ * @return the next character received on the console, -1 if there is none */
+int ES_Port_GetChar(void);
+
+/**
+ * @Function ES_Port_TraceWrite(const uint8_t *pData, uint8_t Length)
+ * @param pData - one trace frame, see ES_TattleTale.h, or another frame of
+ *                the console's, such as those of SensorRecord.h
+ * @param Length - its size in bytes
+ * @return TRUE if the whole frame was taken, FALSE if it would have had to
+ *         wait, in which case none of it was
+ * @brief The Uno32 sends trace frames on the console serial port, the host
+ *        writes them to the file given to ES_Port_SetTraceFile(). */
+uint8_t ES_Port_TraceWrite(const uint8_t *pData, uint8_t Length);
+
+#ifdef ES_HOST
+/**
+ * @Function ES_Port_SetRunLimit(uint32_t Ticks)
+ * @param Ticks - virtual milliseconds after which ES_Run() returns
+ * @return None
+ * @brief Host build only, the Uno32 runs until the power goes away. Like
+ *        everything else here it applies to the current context. */
+void ES_Port_SetRunLimit(uint32_t Ticks);
+
+/**
+ * @Function ES_Port_SetTraceFile(const char *Path)
+ * @param Path - file to write the trace frames to, replaced if it exists
+ * @return TRUE, FALSE if the file could not be opened
+ * @brief Host build only. Without a trace file the frames are discarded. */
+uint8_t ES_Port_SetTraceFile(const char *Path);
+
+/**
+ * @Function ES_Port_SetTickHook(ES_PortTickHook_t *pHook, void *pArg)
+ * @param pHook - called with pArg just before each tick of virtual time, NULL
+ *                for none
+ * @param pArg - handed to pHook
+ * @return None
+ * @brief Host build only. Lets a simulator move the world on in step with
+ *        the framework's clock: the hook runs on the thread of the current
+ *        context, before the timers of the tick expire. It is called for
+ *        every tick, Ticks 1, unless it last said the inputs would hold; then
+ *        it may be handed up to that many ticks at once while the run loop
+ *        sleeps, and must move the world on by all of them. The promise only
+ *        lasts until the run loop next wakes up and may change the outputs. */
+void ES_Port_SetTickHook(ES_PortTickHook_t *pHook, void *pArg);
+
+/**
+ * @Function ES_Port_InputsSteady(uint32_t *pSince)
+ * @param pSince - gets the first tick the inputs have read as they do now
+ * @return the last tick through which they will, ES_PORT_STEADY_FOREVER
+ *         without a tick hook
+ * @brief Host build only. An event checker run at or after *pSince can only
+ *        find the same again until the tick after, so the tickless run loop
+ *        sleeps through it, see ES_Port_SteadyTicks(). */
+uint32_t ES_Port_InputsSteady(uint32_t *pSince);
+#endif
+
+#ifdef ES_VERIFY_STEADY
+/**
+ * @Function ES_Port_SetFixedTick(void)
+ * @return None
+ * @brief Host build with ES_VERIFY_STEADY only. From here on the current
+ *        context takes the inputs to hold for no ticks at all, whatever the
+ *        tick hook says: the hook gets one tick at a time and the tickless run
+ *        loop wakes for every checker run, as it would without the hook's
+ *        promises. */
+void ES_Port_SetFixedTick(void);
+
+/**
+ * @Function ES_Port_NoteDispatch(uint8_t WhichService, uint16_t EventType,
+ *                                uint16_t EventParam)
+ * @param WhichService - the service the event is handed to
+ * @param EventType - the event
+ * @param EventParam - its parameter
+ * @return None
+ * @brief Host build with ES_VERIFY_STEADY only. Called by ES_Run() for every
+ *        event it dequeues, adds it and the current tick to the current
+ *        context's log. */
+void ES_Port_NoteDispatch(uint8_t WhichService, uint16_t EventType, uint16_t EventParam);
+
+/**
+ * @Function ES_Port_GetDispatches(const ES_PortDispatch_t **ppDispatches)
+ * @param ppDispatches - gets the current context's log, oldest first
+ * @return the number of events in it
+ * @brief Host build with ES_VERIFY_STEADY only. */
+uint32_t ES_Port_GetDispatches(const ES_PortDispatch_t **ppDispatches);
+#endif
+
+#endif /* ES_PORT_H */
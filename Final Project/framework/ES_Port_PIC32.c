@@ -0,0 +1,171 @@
+/*
+ * File: ES_Port_PIC32.c
+ *
+ * Uno32 (PIC32MX320F128H) port of the Events and Services Framework. Timer 1
+ * interrupts every 1 ms and counts the tick; the run loop picks the ticks up
+ * through ES_Port_TicksElapsed(). Do not add this file to the host build.
+ *
+ * For tickless idle ES_Port_Sleep() stretches the Timer 1 period over as many
+ * ticks as fit in its 16-bit count, halts the core with WAIT, and on waking
+ * works out from TMR1 how many whole ticks went by before putting the 1 ms
+ * period back. Timer 1 is stopped whenever it is changed, so that no count
+ * goes by between reading it and writing it back; each stop only loses what
+ * the prescaler had counted, less than one of the 2500 counts of a tick.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include <xc.h>
+#include <sys/attribs.h>
+#include "BOARD.h"
+#include "serial.h"
+#include "ES_Port.h"
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define TICKS_PER_SECOND 1000
+#define TIMER1_PRESCALE 8
+#define STATUS_IE_MASK 0x00000001
+#define TIMER1_MAX_COUNT 0xFFFF
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// counted up by the interrupt, and by ES_Port_Sleep() for the ticks of a
+// stretched period, which it adds inside the run loop's critical section
+static volatile uint32_t TickCount;
+static uint32_t TicksTaken; // written only by the run loop
+static uint32_t TickPeriod; // Timer 1 counts per tick
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ES_Port_Init(void) {
+    TickCount = 0;
+    TicksTaken = 0;
+    T1CON = 0;
+    T1CONbits.TCKPS = 0b01; // 1:8 prescale
+    TMR1 = 0;
+    TickPeriod = BOARD_GetPBClock() / TIMER1_PRESCALE / TICKS_PER_SECOND;
+    PR1 = TickPeriod - 1;
+    IPC1bits.T1IP = 3;
+    IPC1bits.T1IS = 0;
+    IFS0bits.T1IF = 0;
+    IEC0bits.T1IE = 1;
+    T1CONbits.ON = 1;
+}
+
+uint32_t ES_Port_TicksElapsed(void) {
+    uint32_t Now = TickCount; // a single aligned load, no need to mask
+    uint32_t Elapsed = Now - TicksTaken;
+
+    TicksTaken = Now;
+    return Elapsed;
+}
+
+uint32_t ES_Port_Timestamp(void) {
+    return _CP0_GET_COUNT();
+}
+
+uint8_t ES_Port_Idle(void) {
+    // the tick comes from the interrupt, just keep polling
+    return TRUE;
+}
+
+uint8_t ES_Port_Sleep(uint32_t Ticks) {
+    uint32_t Stretch = TIMER1_MAX_COUNT / TickPeriod;
+    uint32_t Whole;
+    uint32_t Count;
+
+    // a tick the run loop has not collected yet is as good as a wakeup
+    if ((TickCount != TicksTaken) || IFS0bits.T1IF) {
+        return TRUE;
+    }
+    if (Ticks < Stretch) {
+        Stretch = Ticks;
+    }
+    if (Stretch > 1) {
+        // a tick that ended after the check above would otherwise be taken
+        // for the end of the whole stretch
+        T1CONbits.ON = 0;
+        if (IFS0bits.T1IF) {
+            T1CONbits.ON = 1;
+            return TRUE;
+        }
+        PR1 = TickPeriod * Stretch - 1; // TMR1 is still inside the first tick
+        T1CONbits.ON = 1;
+    }
+    // with interrupts masked a pending interrupt ends the WAIT without being
+    // taken, its handler runs once the run loop unmasks them
+    _wait();
+    if (Stretch > 1) {
+        T1CONbits.ON = 0;
+        Count = TMR1;
+        // after the end of the stretch TMR1 counts on from 0, and the handler
+        // counts the tick that ended it
+        Whole = Count / TickPeriod;
+        TMR1 = Count - Whole * TickPeriod;
+        if (IFS0bits.T1IF) {
+            Whole += Stretch - 1;
+        }
+        PR1 = TickPeriod - 1;
+        T1CONbits.ON = 1;
+        // interrupts are still masked, the handler cannot count meanwhile
+        TickCount += Whole;
+    }
+    return TRUE;
+}
+
+uint32_t ES_Port_SteadyTicks(uint32_t Ticks) {
+    // nothing says how long the inputs will hold, every checker run happens
+    return Ticks;
+}
+
+void ES_Port_CheckGroupRan(uint8_t Group, uint32_t Now) {
+}
+
+uint32_t ES_Port_EnterCritical(void) {
+    return __builtin_disable_interrupts();
+}
+
+void ES_Port_ExitCritical(uint32_t State) {
+    if (State & STATUS_IE_MASK) {
+        __builtin_enable_interrupts();
+    }
+}
+
+int ES_Port_GetChar(void) {
+    if (IsReceiveEmpty()) {
+        return -1;
+    }
+    return GetChar();
+}
+
+uint8_t ES_Port_TraceWrite(const uint8_t *pData, uint8_t Length) {
+    uint8_t i;
+
+    // PutChar() waits once the transmit buffer is full, only start a frame
+    // when the buffer has drained so the run loop is never held up
+    if (!IsTransmitEmpty()) {
+        return FALSE;
+    }
+    for (i = 0; i < Length; i++) {
+        PutChar(pData[i]);
+    }
+    return TRUE;
+}
+
+/*******************************************************************************
+ * INTERRUPT SERVICE ROUTINES                                                  *
+ ******************************************************************************/
+
+void __ISR(_TIMER_1_VECTOR, ipl3auto) ES_Port_Timer1Handler(void) {
+    IFS0bits.T1IF = 0;
+    TickCount++;
+}
@@ -0,0 +1,133 @@
+/*
+ * File: ES_Queue.c
+ *
+ * FIFO event queues for the Events and Services Framework. The first entry of
+ * each queue array holds the header below, the remaining entries hold the
+ * events in a power-of-two ring.
+ *
+ * Each queue has one producer and one consumer. Head only ever changes in the
+ * producer and Tail only in the consumer, and both run freely with the ring
+ * index taken from their low bits, so neither side needs to lock the other
+ * out. A post from an interrupt is safe as long as that interrupt is the only
+ * producer of the queue.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Queue.h"
+#include <stddef.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define MAX_QUEUE_SIZE 128 // Head - Tail must fit in a uint8_t
+
+typedef struct {
+    uint8_t Head; // free running count of events added, producer only
+    uint8_t Tail; // free running count of events removed, consumer only
+    uint8_t Mask; // queue size - 1
+    uint8_t LastDropped; // type of the most recent event that did not fit
+    uint32_t Dropped; // number of events that did not fit, producer only
+} ES_QueueHeader_t;
+
+_Static_assert(sizeof (ES_QueueHeader_t) <= sizeof (ES_Event),
+        "the queue header must fit in the first entry of the queue");
+_Static_assert(NUMBEROFEVENTS <= 256, "LastDropped holds an 8-bit event type");
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t ES_InitQueue(ES_Event *pBlock, uint8_t BlockSize) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+    uint8_t QueueSize = BlockSize - 1; // the first entry is the header
+
+    if ((QueueSize == 0) || (QueueSize > MAX_QUEUE_SIZE) || (QueueSize & (QueueSize - 1))) {
+        return 0;
+    }
+    pThisQueue->Head = 0;
+    pThisQueue->Tail = 0;
+    pThisQueue->Mask = QueueSize - 1;
+    pThisQueue->LastDropped = ES_NO_EVENT;
+    pThisQueue->Dropped = 0;
+    return QueueSize;
+}
+
+uint8_t ES_EnQueueFIFO(ES_Event *pBlock, ES_Event Event2Add) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+    uint8_t Head = pThisQueue->Head;
+    uint8_t Tail = __atomic_load_n(&pThisQueue->Tail, __ATOMIC_ACQUIRE);
+
+    if ((uint8_t) (Head - Tail) > pThisQueue->Mask) {
+        pThisQueue->LastDropped = Event2Add.EventType;
+        pThisQueue->Dropped++;
+        return FALSE;
+    }
+    // +1 skips over the header entry
+    pBlock[1 + (Head & pThisQueue->Mask)] = Event2Add;
+    // publish the event only after it has been written
+    __atomic_store_n(&pThisQueue->Head, (uint8_t) (Head + 1), __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+uint8_t ES_DeQueue(ES_Event *pBlock, ES_Event *pReturnEvent) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+    uint8_t Head = __atomic_load_n(&pThisQueue->Head, __ATOMIC_ACQUIRE);
+    uint8_t Tail = pThisQueue->Tail;
+
+    if (Head == Tail) {
+        pReturnEvent->EventType = ES_NO_EVENT;
+        pReturnEvent->EventParam = 0;
+        return 0;
+    }
+    *pReturnEvent = pBlock[1 + (Tail & pThisQueue->Mask)];
+    // hand the entry back to the producer only after it has been read
+    __atomic_store_n(&pThisQueue->Tail, (uint8_t) (Tail + 1), __ATOMIC_RELEASE);
+    return (uint8_t) (Head - Tail - 1);
+}
+
+uint8_t ES_UpdateQueued(ES_Event *pBlock, ES_Event NewEvent) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+    uint8_t Head = pThisQueue->Head;
+    uint8_t Tail = __atomic_load_n(&pThisQueue->Tail, __ATOMIC_ACQUIRE);
+    ES_Event *pEntry;
+
+    // only into the newest entry, an older one would be overtaken by the
+    // events of other types queued behind it; and never into the oldest, the
+    // consumer may be copying it
+    if ((uint8_t) (Head - Tail) < 2) {
+        return FALSE;
+    }
+    pEntry = &pBlock[1 + ((uint8_t) (Head - 1) & pThisQueue->Mask)];
+    if (pEntry->EventType != NewEvent.EventType) {
+        return FALSE;
+    }
+    pEntry->EventParam = NewEvent.EventParam;
+    return TRUE;
+}
+
+uint8_t ES_IsQueueEmpty(ES_Event *pBlock) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+
+    return (__atomic_load_n(&pThisQueue->Head, __ATOMIC_ACQUIRE) == pThisQueue->Tail);
+}
+
+uint8_t ES_IsQueueFull(ES_Event *pBlock) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+    uint8_t Tail = __atomic_load_n(&pThisQueue->Tail, __ATOMIC_ACQUIRE);
+
+    return ((uint8_t) (pThisQueue->Head - Tail) > pThisQueue->Mask);
+}
+
+uint32_t ES_QueueDrops(ES_Event *pBlock, ES_EventTyp_t *pLastDropped) {
+    ES_QueueHeader_t *pThisQueue = (ES_QueueHeader_t *) pBlock;
+
+    if (pLastDropped != NULL) {
+        *pLastDropped = pThisQueue->LastDropped;
+    }
+    return pThisQueue->Dropped;
+}
@@ -0,0 +1,90 @@
+/*
+ * File: ES_Queue.h
+ *
+ * FIFO event queues used by the framework to hold the pending events for each
+ * service. A queue is an array of ES_Event whose first entry is used as the
+ * queue header, so the array must be one entry larger than the number of
+ * events it is expected to hold. That number must be a power of two, 128 at
+ * most.
+ *
+ * A queue is single producer, single consumer: all the posts to one queue must
+ * come from the same context (the run loop, or one interrupt) and all the
+ * removals from another, or the same, single context. Neither side ever masks
+ * interrupts.
+ */
+
+#ifndef ES_QUEUE_H
+#define ES_QUEUE_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include "ES_Events.h"
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_InitQueue(ES_Event *pBlock, uint8_t BlockSize)
+ * @param pBlock - array of events to be used as the queue
+ * @param BlockSize - number of entries in pBlock, including the header entry
+ * @return the number of events the queue can hold, 0 if BlockSize - 1 is not a
+ *         power of two up to 128
+ * @brief Initializes the header of the queue to an empty queue. */
+uint8_t ES_InitQueue(ES_Event *pBlock, uint8_t BlockSize);
+
+/**
+ * @Function ES_EnQueueFIFO(ES_Event *pBlock, ES_Event Event2Add)
+ * @param pBlock - queue to add the event to
+ * @param Event2Add - the event (type and param) to add
+ * @return TRUE if the event was added, FALSE if the queue was full
+ * @brief Adds an event at the tail of the queue. Producer side only. An event
+ *        that does not fit is counted, see ES_QueueDrops(). */
+uint8_t ES_EnQueueFIFO(ES_Event *pBlock, ES_Event Event2Add);
+
+/**
+ * @Function ES_DeQueue(ES_Event *pBlock, ES_Event *pReturnEvent)
+ * @param pBlock - queue to take the event from
+ * @param pReturnEvent - where to put the event, ES_NO_EVENT if queue was empty
+ * @return the number of events left in the queue
+ * @brief Removes the event at the head of the queue. Consumer side only. */
+uint8_t ES_DeQueue(ES_Event *pBlock, ES_Event *pReturnEvent);
+
+/**
+ * @Function ES_UpdateQueued(ES_Event *pBlock, ES_Event NewEvent)
+ * @param pBlock - queue to look in
+ * @param NewEvent - the event (type and param) to merge
+ * @return TRUE if the newest queued event is of the same type and now carries
+ *         the new param, FALSE if not and NewEvent still has to be added
+ * @brief Latest-wins update for events that report a state rather than a
+ *        change. Producer side only. Only the newest entry is looked at, so
+ *        the order of events of different types is kept, and never when it is
+ *        also the oldest, which the consumer may be taking off the queue at
+ *        that moment. */
+uint8_t ES_UpdateQueued(ES_Event *pBlock, ES_Event NewEvent);
+
+/**
+ * @Function ES_IsQueueEmpty(ES_Event *pBlock)
+ * @param pBlock - queue to check
+ * @return TRUE if the queue holds no events, FALSE otherwise */
+uint8_t ES_IsQueueEmpty(ES_Event *pBlock);
+
+/**
+ * @Function ES_IsQueueFull(ES_Event *pBlock)
+ * @param pBlock - queue to check
+ * @return TRUE if the queue has no room for another event, FALSE otherwise
+ * @brief Producer side: with only one producer, a queue found not full takes
+ *        the next ES_EnQueueFIFO(). */
+uint8_t ES_IsQueueFull(ES_Event *pBlock);
+
+/**
+ * @Function ES_QueueDrops(ES_Event *pBlock, ES_EventTyp_t *pLastDropped)
+ * @param pBlock - queue to check
+ * @param pLastDropped - if not NULL, gets the type of the most recent event
+ *                       that did not fit, ES_NO_EVENT if none ever dropped
+ * @return the number of events refused because the queue was full */
+uint32_t ES_QueueDrops(ES_Event *pBlock, ES_EventTyp_t *pLastDropped);
+
+#endif /* ES_QUEUE_H */
@@ -0,0 +1,204 @@
+/*
+ * File: ES_ServiceHeaders.h
+ *
+ * Pulls in the public header of every service named in ES_Configure.h so the
+ * framework can see their Init and Run functions.
+ */
+
+#ifndef ES_SERVICEHEADERS_H
+#define ES_SERVICEHEADERS_H
+
+#include "ES_Configure.h"
+
+#include SERV_0_HEADER
+#if NUM_SERVICES > 1
+#include SERV_1_HEADER
+#endif
+#if NUM_SERVICES > 2
+#include SERV_2_HEADER
+#endif
+#if NUM_SERVICES > 3
+#include SERV_3_HEADER
+#endif
+#if NUM_SERVICES > 4
+#include SERV_4_HEADER
+#endif
+#if NUM_SERVICES > 5
+#include SERV_5_HEADER
+#endif
+#if NUM_SERVICES > 6
+#include SERV_6_HEADER
+#endif
+#if NUM_SERVICES > 7
+#include SERV_7_HEADER
+#endif
+#if NUM_SERVICES > 8
+#include SERV_8_HEADER
+#endif
+#if NUM_SERVICES > 9
+#include SERV_9_HEADER
+#endif
+#if NUM_SERVICES > 10
+#include SERV_10_HEADER
+#endif
+#if NUM_SERVICES > 11
+#include SERV_11_HEADER
+#endif
+#if NUM_SERVICES > 12
+#include SERV_12_HEADER
+#endif
+#if NUM_SERVICES > 13
+#include SERV_13_HEADER
+#endif
+#if NUM_SERVICES > 14
+#include SERV_14_HEADER
+#endif
+#if NUM_SERVICES > 15
+#include SERV_15_HEADER
+#endif
+#if NUM_SERVICES > 16
+#include SERV_16_HEADER
+#endif
+#if NUM_SERVICES > 17
+#include SERV_17_HEADER
+#endif
+#if NUM_SERVICES > 18
+#include SERV_18_HEADER
+#endif
+#if NUM_SERVICES > 19
+#include SERV_19_HEADER
+#endif
+#if NUM_SERVICES > 20
+#include SERV_20_HEADER
+#endif
+#if NUM_SERVICES > 21
+#include SERV_21_HEADER
+#endif
+#if NUM_SERVICES > 22
+#include SERV_22_HEADER
+#endif
+#if NUM_SERVICES > 23
+#include SERV_23_HEADER
+#endif
+#if NUM_SERVICES > 24
+#include SERV_24_HEADER
+#endif
+#if NUM_SERVICES > 25
+#include SERV_25_HEADER
+#endif
+#if NUM_SERVICES > 26
+#include SERV_26_HEADER
+#endif
+#if NUM_SERVICES > 27
+#include SERV_27_HEADER
+#endif
+#if NUM_SERVICES > 28
+#include SERV_28_HEADER
+#endif
+#if NUM_SERVICES > 29
+#include SERV_29_HEADER
+#endif
+#if NUM_SERVICES > 30
+#include SERV_30_HEADER
+#endif
+#if NUM_SERVICES > 31
+#include SERV_31_HEADER
+#endif
+#if NUM_SERVICES > 32
+#include SERV_32_HEADER
+#endif
+#if NUM_SERVICES > 33
+#include SERV_33_HEADER
+#endif
+#if NUM_SERVICES > 34
+#include SERV_34_HEADER
+#endif
+#if NUM_SERVICES > 35
+#include SERV_35_HEADER
+#endif
+#if NUM_SERVICES > 36
+#include SERV_36_HEADER
+#endif
+#if NUM_SERVICES > 37
+#include SERV_37_HEADER
+#endif
+#if NUM_SERVICES > 38
+#include SERV_38_HEADER
+#endif
+#if NUM_SERVICES > 39
+#include SERV_39_HEADER
+#endif
+#if NUM_SERVICES > 40
+#include SERV_40_HEADER
+#endif
+#if NUM_SERVICES > 41
+#include SERV_41_HEADER
+#endif
+#if NUM_SERVICES > 42
+#include SERV_42_HEADER
+#endif
+#if NUM_SERVICES > 43
+#include SERV_43_HEADER
+#endif
+#if NUM_SERVICES > 44
+#include SERV_44_HEADER
+#endif
+#if NUM_SERVICES > 45
+#include SERV_45_HEADER
+#endif
+#if NUM_SERVICES > 46
+#include SERV_46_HEADER
+#endif
+#if NUM_SERVICES > 47
+#include SERV_47_HEADER
+#endif
+#if NUM_SERVICES > 48
+#include SERV_48_HEADER
+#endif
+#if NUM_SERVICES > 49
+#include SERV_49_HEADER
+#endif
+#if NUM_SERVICES > 50
+#include SERV_50_HEADER
+#endif
+#if NUM_SERVICES > 51
+#include SERV_51_HEADER
+#endif
+#if NUM_SERVICES > 52
+#include SERV_52_HEADER
+#endif
+#if NUM_SERVICES > 53
+#include SERV_53_HEADER
+#endif
+#if NUM_SERVICES > 54
+#include SERV_54_HEADER
+#endif
+#if NUM_SERVICES > 55
+#include SERV_55_HEADER
+#endif
+#if NUM_SERVICES > 56
+#include SERV_56_HEADER
+#endif
+#if NUM_SERVICES > 57
+#include SERV_57_HEADER
+#endif
+#if NUM_SERVICES > 58
+#include SERV_58_HEADER
+#endif
+#if NUM_SERVICES > 59
+#include SERV_59_HEADER
+#endif
+#if NUM_SERVICES > 60
+#include SERV_60_HEADER
+#endif
+#if NUM_SERVICES > 61
+#include SERV_61_HEADER
+#endif
+#if NUM_SERVICES > 62
+#include SERV_62_HEADER
+#endif
+#if NUM_SERVICES > 63
+#include SERV_63_HEADER
+#endif
+
+#endif /* ES_SERVICEHEADERS_H */
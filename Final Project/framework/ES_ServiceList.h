@@ -0,0 +1,199 @@
+/*
+ * File: ES_ServiceList.h
+ *
+ * One ES_SERVICE(n) entry for every service enabled by NUM_SERVICES in
+ * ES_Configure.h. ES_Framework.c and ES_Context_t in ES_Framework.h define
+ * ES_SERVICE and include this file once per table they build, so there is
+ * deliberately no include guard.
+ */
+
+ES_SERVICE(0)
+#if NUM_SERVICES > 1
+ES_SERVICE(1)
+#endif
+#if NUM_SERVICES > 2
+ES_SERVICE(2)
+#endif
+#if NUM_SERVICES > 3
+ES_SERVICE(3)
+#endif
+#if NUM_SERVICES > 4
+ES_SERVICE(4)
+#endif
+#if NUM_SERVICES > 5
+ES_SERVICE(5)
+#endif
+#if NUM_SERVICES > 6
+ES_SERVICE(6)
+#endif
+#if NUM_SERVICES > 7
+ES_SERVICE(7)
+#endif
+#if NUM_SERVICES > 8
+ES_SERVICE(8)
+#endif
+#if NUM_SERVICES > 9
+ES_SERVICE(9)
+#endif
+#if NUM_SERVICES > 10
+ES_SERVICE(10)
+#endif
+#if NUM_SERVICES > 11
+ES_SERVICE(11)
+#endif
+#if NUM_SERVICES > 12
+ES_SERVICE(12)
+#endif
+#if NUM_SERVICES > 13
+ES_SERVICE(13)
+#endif
+#if NUM_SERVICES > 14
+ES_SERVICE(14)
+#endif
+#if NUM_SERVICES > 15
+ES_SERVICE(15)
+#endif
+#if NUM_SERVICES > 16
+ES_SERVICE(16)
+#endif
+#if NUM_SERVICES > 17
+ES_SERVICE(17)
+#endif
+#if NUM_SERVICES > 18
+ES_SERVICE(18)
+#endif
+#if NUM_SERVICES > 19
+ES_SERVICE(19)
+#endif
+#if NUM_SERVICES > 20
+ES_SERVICE(20)
+#endif
+#if NUM_SERVICES > 21
+ES_SERVICE(21)
+#endif
+#if NUM_SERVICES > 22
+ES_SERVICE(22)
+#endif
+#if NUM_SERVICES > 23
+ES_SERVICE(23)
+#endif
+#if NUM_SERVICES > 24
+ES_SERVICE(24)
+#endif
+#if NUM_SERVICES > 25
+ES_SERVICE(25)
+#endif
+#if NUM_SERVICES > 26
+ES_SERVICE(26)
+#endif
+#if NUM_SERVICES > 27
+ES_SERVICE(27)
+#endif
+#if NUM_SERVICES > 28
+ES_SERVICE(28)
+#endif
+#if NUM_SERVICES > 29
+ES_SERVICE(29)
+#endif
+#if NUM_SERVICES > 30
+ES_SERVICE(30)
+#endif
+#if NUM_SERVICES > 31
+ES_SERVICE(31)
+#endif
+#if NUM_SERVICES > 32
+ES_SERVICE(32)
+#endif
+#if NUM_SERVICES > 33
+ES_SERVICE(33)
+#endif
+#if NUM_SERVICES > 34
+ES_SERVICE(34)
+#endif
+#if NUM_SERVICES > 35
+ES_SERVICE(35)
+#endif
+#if NUM_SERVICES > 36
+ES_SERVICE(36)
+#endif
+#if NUM_SERVICES > 37
+ES_SERVICE(37)
+#endif
+#if NUM_SERVICES > 38
+ES_SERVICE(38)
+#endif
+#if NUM_SERVICES > 39
+ES_SERVICE(39)
+#endif
+#if NUM_SERVICES > 40
+ES_SERVICE(40)
+#endif
+#if NUM_SERVICES > 41
+ES_SERVICE(41)
+#endif
+#if NUM_SERVICES > 42
+ES_SERVICE(42)
+#endif
+#if NUM_SERVICES > 43
+ES_SERVICE(43)
+#endif
+#if NUM_SERVICES > 44
+ES_SERVICE(44)
+#endif
+#if NUM_SERVICES > 45
+ES_SERVICE(45)
+#endif
+#if NUM_SERVICES > 46
+ES_SERVICE(46)
+#endif
+#if NUM_SERVICES > 47
+ES_SERVICE(47)
+#endif
+#if NUM_SERVICES > 48
+ES_SERVICE(48)
+#endif
+#if NUM_SERVICES > 49
+ES_SERVICE(49)
+#endif
+#if NUM_SERVICES > 50
+ES_SERVICE(50)
+#endif
+#if NUM_SERVICES > 51
+ES_SERVICE(51)
+#endif
+#if NUM_SERVICES > 52
+ES_SERVICE(52)
+#endif
+#if NUM_SERVICES > 53
+ES_SERVICE(53)
+#endif
+#if NUM_SERVICES > 54
+ES_SERVICE(54)
+#endif
+#if NUM_SERVICES > 55
+ES_SERVICE(55)
+#endif
+#if NUM_SERVICES > 56
+ES_SERVICE(56)
+#endif
+#if NUM_SERVICES > 57
+ES_SERVICE(57)
+#endif
+#if NUM_SERVICES > 58
+ES_SERVICE(58)
+#endif
+#if NUM_SERVICES > 59
+ES_SERVICE(59)
+#endif
+#if NUM_SERVICES > 60
+ES_SERVICE(60)
+#endif
+#if NUM_SERVICES > 61
+ES_SERVICE(61)
+#endif
+#if NUM_SERVICES > 62
+ES_SERVICE(62)
+#endif
+#if NUM_SERVICES > 63
+ES_SERVICE(63)
+#endif
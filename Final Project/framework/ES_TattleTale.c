@@ -0,0 +1,127 @@
+/*
+ * File: ES_TattleTale.c
+ *
+ * Binary trace of the state machines, see ES_TattleTale.h. Records are added
+ * and drained by the run loop only, so the ring needs no locking.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_TattleTale.h"
+#include "ES_Port.h"
+#include "ES_Timers.h"
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#if (ES_TRACE_RECORDS & (ES_TRACE_RECORDS - 1)) || (ES_TRACE_RECORDS > 32768)
+#error ES_TRACE_RECORDS must be a power of two, 32768 at most
+#endif
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// the ring of the current context
+#define TraceRing (ES_CurrentContext->Trace.Ring)
+#define TraceHead (ES_CurrentContext->Trace.Head)
+#define TraceTail (ES_CurrentContext->Trace.Tail)
+#define TraceSeq (ES_CurrentContext->Trace.Seq)
+#define TraceDropped (ES_CurrentContext->Trace.Dropped)
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static uint8_t PutLittle(uint8_t *pFrame, uint32_t Value, uint8_t Bytes);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ES_TraceInit(void) {
+    TraceHead = 0;
+    TraceTail = 0;
+    TraceSeq = 0;
+    TraceDropped = 0;
+    ES_TraceAdd(ES_TRACE_START, 0, 0, ES_NO_EVENT, ES_PORT_STAMPS_PER_US);
+}
+
+void ES_TraceAdd(uint8_t Kind, uint8_t Machine, uint8_t State, uint8_t Event, uint16_t Param) {
+    ES_TraceRecord_t *pRecord;
+
+#ifdef SUPPRESS_EXIT_ENTRY_IN_TATTLE
+    if ((Kind != ES_TRACE_MARK) && ((Event == ES_ENTRY) || (Event == ES_EXIT))) {
+        return;
+    }
+#endif
+    if ((uint16_t) (TraceHead - TraceTail) >= ES_TRACE_RECORDS) {
+        TraceSeq++;
+        TraceDropped++;
+        return;
+    }
+    pRecord = &TraceRing[TraceHead & (ES_TRACE_RECORDS - 1)];
+    pRecord->Tick = ES_Timer_GetTime();
+    pRecord->Stamp = ES_Port_Timestamp();
+    pRecord->Seq = TraceSeq++;
+    pRecord->Param = Param;
+    pRecord->Kind = Kind;
+    pRecord->Machine = Machine;
+    pRecord->State = State;
+    pRecord->Event = Event;
+    TraceHead++;
+}
+
+void ES_TraceDrain(void) {
+    uint8_t Frame[ES_TRACE_FRAME_SIZE];
+    ES_TraceRecord_t *pRecord;
+    uint8_t Sum;
+    uint8_t i, n;
+
+    while (TraceTail != TraceHead) {
+        pRecord = &TraceRing[TraceTail & (ES_TRACE_RECORDS - 1)];
+        n = 0;
+        Frame[n++] = ES_TRACE_SYNC1;
+        Frame[n++] = ES_TRACE_SYNC2;
+        n += PutLittle(&Frame[n], pRecord->Tick, 4);
+        n += PutLittle(&Frame[n], pRecord->Stamp, 4);
+        n += PutLittle(&Frame[n], pRecord->Seq, 2);
+        n += PutLittle(&Frame[n], pRecord->Param, 2);
+        Frame[n++] = pRecord->Kind;
+        Frame[n++] = pRecord->Machine;
+        Frame[n++] = pRecord->State;
+        Frame[n++] = pRecord->Event;
+        Sum = 0;
+        for (i = 2; i < n; i++) {
+            Sum += Frame[i];
+        }
+        Frame[n++] = (uint8_t) -Sum;
+        if (ES_Port_TraceWrite(Frame, n) != TRUE) {
+            return;
+        }
+        TraceTail++;
+    }
+}
+
+uint32_t ES_TraceDrops(void) {
+    return TraceDropped;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+static uint8_t PutLittle(uint8_t *pFrame, uint32_t Value, uint8_t Bytes) {
+    uint8_t i;
+
+    for (i = 0; i < Bytes; i++) {
+        pFrame[i] = (uint8_t) (Value >> (8 * i));
+    }
+    return Bytes;
+}
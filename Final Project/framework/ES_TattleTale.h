@@ -0,0 +1,130 @@
+/*
+ * File: ES_TattleTale.h
+ *
+ * Binary trace of the state machines. Every Run function of a state machine
+ * calls ES_Tattle() on entry and ES_Tail() on exit, and ES_Trace(Event) marks
+ * a point of interest inside a state handler or hook. With USE_TATTLETALE defined in
+ * ES_Configure.h each call writes one ES_TraceRecord_t into a RAM ring, which
+ * the run loop drains to the port through ES_Port_TraceWrite() whenever the
+ * queues are empty. Nothing is formatted on the robot. Without USE_TATTLETALE
+ * all three macros compile to nothing.
+ *
+ * The macros expect ES_TRACE_ID and CurrentState to be in scope, and ES_Tattle()
+ * and ES_Tail() the ThisEvent of the Run function. ES_Trace() is handed the
+ * event it records, ThisEvent in a handler, ENTRY_EVENT or EXIT_EVENT in a hook
+ * that has none.
+ * ES_TRACE_ID is a #define in each machine naming its entry in the
+ * ES_TraceMachine_t list of ES_Configure.h; machine 0 is the framework itself.
+ *
+ * On the wire each record is one frame of ES_TRACE_FRAME_SIZE bytes:
+ *
+ *   0xA5 0x5A  Tick[4] Stamp[4] Seq[2] Param[2] Kind Machine State Event  Sum
+ *
+ * with the multi-byte fields little endian and Sum chosen so the 16 record
+ * bytes and Sum add up to 0 mod 256. The sync bytes and the sum let a decoder
+ * find the frames among the console text sharing the serial port. The first
+ * record after ES_Initialize() is an ES_TRACE_START whose Param is
+ * ES_PORT_STAMPS_PER_US.
+ */
+
+#ifndef ES_TATTLETALE_H
+#define ES_TATTLETALE_H
+
+#include "ES_Configure.h"
+#include "ES_Events.h"
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// record kinds
+#define ES_TRACE_START 0 // the framework started, Param is the stamp rate
+#define ES_TRACE_ENTER 1 // ES_Tattle(): the state and event a Run function was called with
+#define ES_TRACE_EXIT 2 // ES_Tail(): the state and event it returned with
+#define ES_TRACE_MARK 3 // ES_Trace(Event): a point in a state handler, Param is the source line
+#define ES_TRACE_OVERRUN 4 // a Run function went over its budget, see ES_SetRunBudget():
+                           // Machine is the service, Param the time taken in us
+
+// marks the StateNames[] of a machine, which es_trace reads from the source and
+// the build itself may never use
+#define ES_TRACE_NAMES __attribute__((unused))
+
+#define ES_TRACE_SYNC1 0xA5
+#define ES_TRACE_SYNC2 0x5A
+#define ES_TRACE_FRAME_SIZE 19
+
+#ifdef USE_TATTLETALE
+#define ES_Tattle() ES_TraceAdd(ES_TRACE_ENTER, ES_TRACE_ID, CurrentState, \
+        ThisEvent.EventType, ThisEvent.EventParam)
+#define ES_Tail() ES_TraceAdd(ES_TRACE_EXIT, ES_TRACE_ID, CurrentState, \
+        ThisEvent.EventType, ThisEvent.EventParam)
+#define ES_Trace(Event) ES_TraceAdd(ES_TRACE_MARK, ES_TRACE_ID, CurrentState, \
+        (Event).EventType, __LINE__)
+#else
+#define ES_Tattle()
+#define ES_Tail()
+#define ES_Trace(Event)
+#endif
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef struct {
+    uint32_t Tick; // ES_Timer_GetTime(), ms
+    uint32_t Stamp; // ES_Port_Timestamp(), for the time within the tick
+    uint16_t Seq; // counts every record, a gap means the ring was full
+    uint16_t Param;
+    uint8_t Kind;
+    uint8_t Machine;
+    uint8_t State;
+    uint8_t Event;
+} ES_TraceRecord_t;
+
+// records the ring holds, a power of two
+#ifndef ES_TRACE_RECORDS
+#define ES_TRACE_RECORDS 64
+#endif
+
+// the trace's part of an ES_Context_t
+typedef struct {
+    ES_TraceRecord_t Ring[ES_TRACE_RECORDS];
+    uint16_t Head; // free running count of records added
+    uint16_t Tail; // free running count of records drained
+    uint16_t Seq;
+    uint32_t Dropped;
+} ES_TraceContext_t;
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_TraceInit(void)
+ * @return None
+ * @brief Empties the ring and records an ES_TRACE_START. Called by
+ *        ES_Initialize(). */
+void ES_TraceInit(void);
+
+/**
+ * @Function ES_TraceAdd(uint8_t Kind, uint8_t Machine, uint8_t State,
+ *                       uint8_t Event, uint16_t Param)
+ * @return None
+ * @brief Writes one record into the ring, use the macros above instead. A
+ *        record that does not fit is counted and lost. Run loop only. */
+void ES_TraceAdd(uint8_t Kind, uint8_t Machine, uint8_t State, uint8_t Event, uint16_t Param);
+
+/**
+ * @Function ES_TraceDrain(void)
+ * @return None
+ * @brief Hands frames to ES_Port_TraceWrite() until the ring is empty or the
+ *        port can take no more without waiting. Called by the run loop when
+ *        the queues are empty. */
+void ES_TraceDrain(void);
+
+/**
+ * @Function ES_TraceDrops(void)
+ * @return the number of records lost because the ring was full */
+uint32_t ES_TraceDrops(void);
+
+#endif /* ES_TATTLETALE_H */
@@ -0,0 +1,282 @@
+/*
+ * File: ES_Timers.c
+ *
+ * Software timers for the Events and Services Framework. ES_Timer_Tick() is
+ * called from the run loop, the same context as every other function here, so
+ * the timer state needs no protection from interrupts. The wheel and the
+ * numbered timers are those of the current ES_Context_t.
+ *
+ * Running timers hang off a hierarchical timing wheel of WHEEL_LEVELS levels,
+ * each with WHEEL_SLOTS slots. Level 0 holds the timers due in the next
+ * WHEEL_SLOTS ticks, one slot per tick. Each level above covers WHEEL_SLOTS
+ * times the span of the one below, and whenever the level below wraps the next
+ * slot of the level above is emptied and its timers are filed again, each one
+ * a level lower than before. Starting and cancelling a timer is a list insert
+ * or unlink, a tick only looks at the slot that is due, and no timer is moved
+ * more than WHEEL_LEVELS - 1 times on its way down.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "ES_Timers.h"
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define NUM_TIMERS ES_NUM_TIMERS
+
+#define WHEEL_BITS ES_TIMER_WHEEL_BITS
+#define WHEEL_LEVELS ES_TIMER_WHEEL_LEVELS
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static pPostFunc const Timer_PostFunctions[NUM_TIMERS] = {
+    TIMER0_RESP_FUNC, TIMER1_RESP_FUNC, TIMER2_RESP_FUNC, TIMER3_RESP_FUNC,
+    TIMER4_RESP_FUNC, TIMER5_RESP_FUNC, TIMER6_RESP_FUNC, TIMER7_RESP_FUNC,
+    TIMER8_RESP_FUNC, TIMER9_RESP_FUNC, TIMER10_RESP_FUNC, TIMER11_RESP_FUNC,
+    TIMER12_RESP_FUNC, TIMER13_RESP_FUNC, TIMER14_RESP_FUNC, TIMER15_RESP_FUNC
+};
+
+// the timers of the current context
+#define NumberedTimers (ES_CurrentContext->Timers.NumberedTimers)
+#define NumberedTimes (ES_CurrentContext->Timers.NumberedTimes)
+#define Wheel (ES_CurrentContext->Timers.Wheel)
+#define FreeRunningTimer (ES_CurrentContext->Timers.FreeRunningTimer)
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void Link(ES_Timer_t *pTimer);
+static void Unlink(ES_Timer_t *pTimer);
+static void Cascade(uint8_t Level);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ES_Timer_Init(void) {
+    uint8_t Level;
+    uint8_t Slot;
+    uint8_t i;
+
+    for (Level = 0; Level < WHEEL_LEVELS; Level++) {
+        for (Slot = 0; Slot < WHEEL_SLOTS; Slot++) {
+            Wheel[Level][Slot] = NULL;
+        }
+    }
+    for (i = 0; i < NUM_TIMERS; i++) {
+        NumberedTimers[i].ppPrev = NULL;
+        NumberedTimes[i] = 0;
+    }
+    FreeRunningTimer = 0;
+    ES_Port_Init();
+}
+
+void ES_Timer_Start(ES_Timer_t *pTimer, uint32_t Ticks, pPostFunc PostFunc, uint16_t Param) {
+    if (pTimer->ppPrev != NULL) {
+        Unlink(pTimer);
+    }
+    if (Ticks == 0) {
+        Ticks = 1;
+    } else if (Ticks > ES_TIMER_MAX_TICKS) {
+        Ticks = ES_TIMER_MAX_TICKS;
+    }
+    pTimer->Expiry = FreeRunningTimer + Ticks;
+    pTimer->PostFunc = PostFunc;
+    pTimer->Param = Param;
+    Link(pTimer);
+}
+
+void ES_Timer_Cancel(ES_Timer_t *pTimer) {
+    if (pTimer->ppPrev != NULL) {
+        Unlink(pTimer);
+    }
+}
+
+uint8_t ES_Timer_IsRunning(ES_Timer_t const *pTimer) {
+    return (pTimer->ppPrev != NULL);
+}
+
+uint32_t ES_Timer_Remaining(ES_Timer_t const *pTimer) {
+    if (pTimer->ppPrev == NULL) {
+        return 0;
+    }
+    return pTimer->Expiry - FreeRunningTimer;
+}
+
+uint32_t ES_Timer_NextExpiry(void) {
+    uint32_t Next = ES_TIMER_MAX_TICKS;
+    uint32_t Index;
+    uint32_t Due;
+    uint8_t Level;
+    uint8_t i;
+
+    // level 0 holds exact expiries, at most one lap ahead
+    for (i = 1; i < WHEEL_SLOTS; i++) {
+        if (Wheel[0][(FreeRunningTimer + i) & WHEEL_MASK] != NULL) {
+            Next = i;
+            break;
+        }
+    }
+    // above it the first occupied slot says when its timers next move, which
+    // can be sooner than anything on level 0
+    for (Level = 1; Level < WHEEL_LEVELS; Level++) {
+        Index = FreeRunningTimer >> (WHEEL_BITS * Level);
+        for (i = 1; i <= WHEEL_SLOTS; i++) {
+            if (Wheel[Level][(Index + i) & WHEEL_MASK] != NULL) {
+                Due = ((Index + i) << (WHEEL_BITS * Level)) - FreeRunningTimer;
+                if (Due < Next) {
+                    Next = Due;
+                }
+                break;
+            }
+        }
+    }
+    return Next;
+}
+
+int8_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime) {
+    ES_Event ThisEvent;
+
+    if ((Num >= NUM_TIMERS) || (Timer_PostFunctions[Num] == TIMER_UNUSED) || (NewTime == 0)) {
+        return ERROR;
+    }
+    NumberedTimes[Num] = NewTime;
+    ES_Timer_Start(&NumberedTimers[Num], NewTime, Timer_PostFunctions[Num], Num);
+
+    ThisEvent.EventType = ES_TIMERACTIVE;
+    ThisEvent.EventParam = Num;
+    Timer_PostFunctions[Num](ThisEvent);
+    return SUCCESS;
+}
+
+int8_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime) {
+
+    if ((Num >= NUM_TIMERS) || (Timer_PostFunctions[Num] == TIMER_UNUSED) || (NewTime == 0)) {
+        return ERROR;
+    }
+    NumberedTimes[Num] = NewTime;
+    return SUCCESS;
+}
+
+int8_t ES_Timer_StartTimer(uint8_t Num) {
+    ES_Event ThisEvent;
+
+    if ((Num >= NUM_TIMERS) || (Timer_PostFunctions[Num] == TIMER_UNUSED) || (NumberedTimes[Num] == 0)) {
+        return ERROR;
+    }
+    ES_Timer_Start(&NumberedTimers[Num], NumberedTimes[Num], Timer_PostFunctions[Num], Num);
+
+    ThisEvent.EventType = ES_TIMERACTIVE;
+    ThisEvent.EventParam = Num;
+    Timer_PostFunctions[Num](ThisEvent);
+    return SUCCESS;
+}
+
+int8_t ES_Timer_StopTimer(uint8_t Num) {
+    ES_Event ThisEvent;
+
+    if ((Num >= NUM_TIMERS) || (Timer_PostFunctions[Num] == TIMER_UNUSED)) {
+        return ERROR;
+    }
+    ES_Timer_Cancel(&NumberedTimers[Num]);
+
+    ThisEvent.EventType = ES_TIMERSTOPPED;
+    ThisEvent.EventParam = Num;
+    Timer_PostFunctions[Num](ThisEvent);
+    return SUCCESS;
+}
+
+uint32_t ES_Timer_GetTime(void) {
+    return FreeRunningTimer;
+}
+
+void ES_Timer_Tick(void) {
+    ES_Timer_t **ppSlot;
+    ES_Timer_t *pTimer;
+    ES_Event ThisEvent;
+
+    FreeRunningTimer++;
+    if ((FreeRunningTimer & WHEEL_MASK) == 0) {
+        Cascade(1);
+    }
+
+    // a post function may start the timer again, always into another slot
+    ThisEvent.EventType = ES_TIMEOUT;
+    ppSlot = &Wheel[0][FreeRunningTimer & WHEEL_MASK];
+    while ((pTimer = *ppSlot) != NULL) {
+        Unlink(pTimer);
+        ThisEvent.EventParam = pTimer->Param;
+        pTimer->PostFunc(ThisEvent);
+    }
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/**
+ * @Function Link(ES_Timer_t *pTimer)
+ * @param pTimer - a stopped timer with its Expiry set
+ * @return None
+ * @brief Files the timer in the lowest level whose span reaches its expiry. A
+ *        timer that expires this very tick, which only happens while
+ *        cascading, goes into the level 0 slot about to be expired. */
+static void Link(ES_Timer_t *pTimer) {
+    uint32_t Delta = pTimer->Expiry - FreeRunningTimer;
+    ES_Timer_t **ppSlot;
+    uint8_t Level = 0;
+
+    while ((Level < WHEEL_LEVELS - 1) && (Delta >= (1UL << (WHEEL_BITS * (Level + 1))))) {
+        Level++;
+    }
+    ppSlot = &Wheel[Level][(pTimer->Expiry >> (WHEEL_BITS * Level)) & WHEEL_MASK];
+
+    pTimer->pNext = *ppSlot;
+    if (pTimer->pNext != NULL) {
+        pTimer->pNext->ppPrev = &pTimer->pNext;
+    }
+    pTimer->ppPrev = ppSlot;
+    *ppSlot = pTimer;
+}
+
+static void Unlink(ES_Timer_t *pTimer) {
+    *pTimer->ppPrev = pTimer->pNext;
+    if (pTimer->pNext != NULL) {
+        pTimer->pNext->ppPrev = pTimer->ppPrev;
+    }
+    pTimer->ppPrev = NULL;
+}
+
+/**
+ * @Function Cascade(uint8_t Level)
+ * @param Level - the level whose next slot has come due, 1 or above
+ * @return None
+ * @brief Called when every level below has just wrapped. The level above is
+ *        cascaded first if this one wraps too, so that its timers are filed
+ *        in time to be cascaded again. */
+static void Cascade(uint8_t Level) {
+    uint32_t Index = FreeRunningTimer >> (WHEEL_BITS * Level);
+    ES_Timer_t **ppSlot = &Wheel[Level][Index & WHEEL_MASK];
+    ES_Timer_t *pTimer;
+
+    if (((Index & WHEEL_MASK) == 0) && (Level < WHEEL_LEVELS - 1)) {
+        Cascade(Level + 1);
+    }
+    while ((pTimer = *ppSlot) != NULL) {
+        Unlink(pTimer);
+        Link(pTimer);
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ * File: ES_Timers.h
+ *
+ * Software timers for the Events and Services Framework, with a resolution of
+ * 1 ms.
+ *
+ * Any number of ES_Timer_t timers can be allocated by the code that owns them,
+ * typically one per state. Each carries its own post function and parameter:
+ * when it expires an ES_TIMEOUT event with that parameter is posted to that
+ * function. The timers live on a hierarchical timing wheel so that starting,
+ * cancelling and expiring a timer take constant time however many are running.
+ *
+ * The 16 numbered timers of the original framework are still there, built on
+ * the same wheel. When one expires an ES_TIMEOUT event, with the timer number
+ * as the parameter, is posted to the function named by the matching
+ * TIMERn_RESP_FUNC in ES_Configure.h.
+ */
+
+#ifndef ES_TIMERS_H
+#define ES_TIMERS_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include "ES_Events.h"
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef uint8_t(*pPostFunc)(ES_Event);
+
+/* Owned by the caller and handed to ES_Timer_Start(), usually as a static. The
+ * fields belong to the timer module; a zeroed timer is a stopped timer. */
+typedef struct ES_Timer {
+    struct ES_Timer *pNext;
+    struct ES_Timer **ppPrev; // the link pointing at this timer, NULL if stopped
+    uint32_t Expiry;
+    pPostFunc PostFunc;
+    uint16_t Param;
+} ES_Timer_t;
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// the longest time ES_Timer_Start() can count, about 4.6 hours
+#define ES_TIMER_MAX_TICKS ((1UL << 24) - 1)
+
+#define ES_NUM_TIMERS 16 // the numbered timers
+
+// the timing wheel, ES_TIMER_WHEEL_LEVELS levels of 2^ES_TIMER_WHEEL_BITS slots
+#define ES_TIMER_WHEEL_BITS 6
+#define ES_TIMER_WHEEL_LEVELS 4
+
+// the timer module's part of an ES_Context_t
+typedef struct {
+    ES_Timer_t NumberedTimers[ES_NUM_TIMERS];
+    uint32_t NumberedTimes[ES_NUM_TIMERS];
+    ES_Timer_t *Wheel[ES_TIMER_WHEEL_LEVELS][1 << ES_TIMER_WHEEL_BITS];
+    uint32_t FreeRunningTimer;
+} ES_TimerContext_t;
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function ES_Timer_Init(void)
+ * @return None
+ * @brief Clears all timers and starts the tick through the port layer. */
+void ES_Timer_Init(void);
+
+/**
+ * @Function ES_Timer_Start(ES_Timer_t *pTimer, uint32_t Ticks, pPostFunc PostFunc, uint16_t Param)
+ * @param pTimer - the timer, restarted if it is already running
+ * @param Ticks - the number of milliseconds to be counted, 0 is taken as 1 and
+ *                anything over ES_TIMER_MAX_TICKS as ES_TIMER_MAX_TICKS
+ * @param PostFunc - where to post the ES_TIMEOUT event
+ * @param Param - the EventParam of the ES_TIMEOUT event
+ * @return None
+ * @brief Unlike ES_Timer_InitTimer() nothing is posted when the timer starts. */
+void ES_Timer_Start(ES_Timer_t *pTimer, uint32_t Ticks, pPostFunc PostFunc, uint16_t Param);
+
+/**
+ * @Function ES_Timer_Cancel(ES_Timer_t *pTimer)
+ * @param pTimer - the timer to stop, may already be stopped
+ * @return None
+ * @brief An ES_TIMEOUT the timer posted before it was cancelled stays queued. */
+void ES_Timer_Cancel(ES_Timer_t *pTimer);
+
+/**
+ * @Function ES_Timer_IsRunning(ES_Timer_t const *pTimer)
+ * @return TRUE if the timer has been started and has neither expired nor been
+ *         cancelled */
+uint8_t ES_Timer_IsRunning(ES_Timer_t const *pTimer);
+
+/**
+ * @Function ES_Timer_Remaining(ES_Timer_t const *pTimer)
+ * @return milliseconds until the timer expires, 0 if it is not running */
+uint32_t ES_Timer_Remaining(ES_Timer_t const *pTimer);
+
+/**
+ * @Function ES_Timer_NextExpiry(void)
+ * @return milliseconds until the wheel next has work to do, at most
+ *         ES_TIMER_MAX_TICKS
+ * @brief No timer can expire sooner, so the run loop may sleep this long. A
+ *        timer due more than 64 ms out only counts from the tick on which it
+ *        moves down the wheel, which can make the answer early but never late. */
+uint32_t ES_Timer_NextExpiry(void);
+
+/**
+ * @Function ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime)
+ * @param Num - the number of the timer to start
+ * @param NewTime - the number of milliseconds to be counted
+ * @return ERROR or SUCCESS
+ * @brief Sets the time for a timer and starts it. An ES_TIMERACTIVE event is
+ *        posted to the timer's response function. */
+int8_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime);
+
+/**
+ * @Function ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime)
+ * @param Num - the number of the timer to set
+ * @param NewTime - the number of milliseconds to be counted
+ * @return ERROR or SUCCESS
+ * @brief Sets the time for a timer without starting it. */
+int8_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime);
+
+/**
+ * @Function ES_Timer_StartTimer(uint8_t Num)
+ * @param Num - the number of the timer to start
+ * @return ERROR or SUCCESS
+ * @brief Starts a timer with the time it was last given by
+ *        ES_Timer_InitTimer() or ES_Timer_SetTimer(). */
+int8_t ES_Timer_StartTimer(uint8_t Num);
+
+/**
+ * @Function ES_Timer_StopTimer(uint8_t Num)
+ * @param Num - the number of the timer to stop
+ * @return ERROR or SUCCESS
+ * @brief Stops a timer. An ES_TIMERSTOPPED event is posted to the timer's
+ *        response function. */
+int8_t ES_Timer_StopTimer(uint8_t Num);
+
+/**
+ * @Function ES_Timer_GetTime(void)
+ * @return the number of milliseconds since the framework was started */
+uint32_t ES_Timer_GetTime(void);
+
+/**
+ * @Function ES_Timer_Tick(void)
+ * @return None
+ * @brief Advances time by 1 ms and posts ES_TIMEOUT for every timer that
+ *        expires. Called only from the run loop, once for every tick the port
+ *        reports, and on the host from ES_Port_Idle(). */
+void ES_Timer_Tick(void);
+
+#endif /* ES_TIMERS_H */
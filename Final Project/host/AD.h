@@ -0,0 +1,43 @@
+/*
+ * File: AD.h
+ *
+ * Linux host stand-in for the Uno32 A/D library. Readings are 10-bit values
+ * held in memory and set by the host harness through HostBoard_SetAD().
+ */
+
+#ifndef AD_H
+#define AD_H
+
+#include <stdint.h>
+
+#define AD_PORTV3 ((uint16_t)(1 << 0))
+#define AD_PORTV4 ((uint16_t)(1 << 1))
+#define AD_PORTV5 ((uint16_t)(1 << 2))
+#define AD_PORTV6 ((uint16_t)(1 << 3))
+#define AD_PORTV7 ((uint16_t)(1 << 4))
+#define AD_PORTV8 ((uint16_t)(1 << 5))
+#define AD_PORTW3 ((uint16_t)(1 << 6))
+#define AD_PORTW4 ((uint16_t)(1 << 7))
+#define AD_PORTW5 ((uint16_t)(1 << 8))
+#define AD_PORTW6 ((uint16_t)(1 << 9))
+#define AD_PORTW7 ((uint16_t)(1 << 10))
+#define AD_PORTW8 ((uint16_t)(1 << 11))
+#define BAT_VOLTAGE ((uint16_t)(1 << 12))
+
+#define AD_NUM_PINS 13
+
+char AD_Init(void);
+
+char AD_AddPins(unsigned int AddPins);
+
+char AD_RemovePins(unsigned int RemovePins);
+
+unsigned int AD_ActivePins(void);
+
+char AD_IsNewDataReady(void);
+
+unsigned int AD_ReadADPin(unsigned int Pin);
+
+void AD_End(void);
+
+#endif /* AD_H */
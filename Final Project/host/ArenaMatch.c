@@ -0,0 +1,95 @@
+/*
+ * File: ArenaMatch.c
+ *
+ * Plays one match of a robot in the simulated arena, see ArenaMatch.h.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "ArenaMatch.h"
+#include "sensors.h"
+#include "motors.h"
+#include "pwm.h"
+#include "LED.h"
+#include <math.h>
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+// how far the arena of a match strays from ArenaSim_DefaultConfig()
+#define NOISE_WHEEL_SPEED 0.05 // of the speed, either way
+#define NOISE_MOTOR_LAG 0.2
+#define NOISE_RIGHT_GAIN 0.03
+#define NOISE_START 30.0 // mm
+#define NOISE_HEADING (3.0 * M_PI / 180.0)
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ArenaMatch_Config(ArenaConfig_t *pConfig, uint64_t Seed, uint32_t Match) {
+    uint64_t State = Seed ^ (0xa7eaULL << 48) ^ Match;
+
+    ArenaSim_DefaultConfig(pConfig);
+    pConfig->MaxWheelSpeed *= ArenaMatch_Uniform(&State, 1.0 - NOISE_WHEEL_SPEED,
+            1.0 + NOISE_WHEEL_SPEED);
+    pConfig->MotorLag *= ArenaMatch_Uniform(&State, 1.0 - NOISE_MOTOR_LAG, 1.0 + NOISE_MOTOR_LAG);
+    pConfig->RightGain *= ArenaMatch_Uniform(&State, 1.0 - NOISE_RIGHT_GAIN,
+            1.0 + NOISE_RIGHT_GAIN);
+    pConfig->StartX += ArenaMatch_Uniform(&State, -NOISE_START, NOISE_START);
+    pConfig->StartY += ArenaMatch_Uniform(&State, -NOISE_START, NOISE_START);
+    pConfig->StartHeading += ArenaMatch_Uniform(&State, -NOISE_HEADING, NOISE_HEADING);
+}
+
+uint32_t ArenaMatch_Play(ArenaMatch_t *pMatch, const BotTimings_t *pTimings,
+        const BotTuning_t *pTuning, const ArenaConfig_t *pConfig, uint32_t RunTicks) {
+    memset(&pMatch->Bot, 0, sizeof (Bot_t));
+    memset(&pMatch->Board, 0, sizeof (HostBoard_t));
+    if (pTimings != NULL) {
+        pMatch->Bot.Timings = *pTimings;
+    }
+    if (pTuning != NULL) {
+        pMatch->Bot.Tuning = *pTuning;
+    }
+    ES_SetContext(&pMatch->Bot.Framework);
+    HostBoard_Select(&pMatch->Board);
+    BOARD_Init();
+    PWM_Init();
+    motors_Init();
+    sensors_Init();
+    LED_Init();
+    LED_AddBanks(LED_BANK1 | LED_BANK2 | LED_BANK3);
+    LED_OnBank(LED_BANK1, 0xF);
+    LED_OnBank(LED_BANK2, 0xF);
+    LED_OnBank(LED_BANK3, 0xF);
+    ArenaSim_Init(&pMatch->Arena, pConfig);
+    ES_Port_SetTickHook(ArenaSim_Tick, &pMatch->Arena);
+
+    ES_Port_SetRunLimit(RunTicks);
+    if (ES_Initialize() != Success) {
+        return 0;
+    }
+    ES_SetRunBudget(0); // the other threads would blow it, and it costs nothing here
+    ES_Run();
+    return pMatch->Arena.Stats.FirstDeposit;
+}
+
+uint64_t ArenaMatch_Random(uint64_t *pState) {
+    uint64_t z = (*pState += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double ArenaMatch_Uniform(uint64_t *pState, double Low, double High) {
+    return Low + (High - Low) * ((ArenaMatch_Random(pState) >> 11) * (1.0 / 9007199254740992.0));
+}
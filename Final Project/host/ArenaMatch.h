@@ -0,0 +1,63 @@
+/*
+ * File: ArenaMatch.h
+ *
+ * One match of a robot in the simulated arena, as the host's sweep and tuner
+ * play them by the thousand: a fresh robot brought up the way HostMain.c
+ * does, with the timings and tuning to try, in an arena jittered by the
+ * number of the match. The same seed and match number always make the same
+ * arena, so every candidate can be played on the same matches.
+ */
+
+#ifndef ARENAMATCH_H
+#define ARENAMATCH_H
+
+#include "ArenaSim.h"
+#include "Bot.h"
+#include "HostBoard.h"
+#include <stdint.h>
+
+// what a worker thread plays its matches on, reused from match to match
+typedef struct {
+    Bot_t Bot;
+    HostBoard_t Board;
+    ArenaSim_t Arena;
+} ArenaMatch_t;
+
+/**
+ * @Function ArenaMatch_Config(ArenaConfig_t *pConfig, uint64_t Seed, uint32_t Match)
+ * @param pConfig - filled with the arena of the match
+ * @param Seed - of the run
+ * @param Match - the number of the match
+ * @return None
+ * @brief The robot as built, its motors and its starting pose jittered. */
+void ArenaMatch_Config(ArenaConfig_t *pConfig, uint64_t Seed, uint32_t Match);
+
+/**
+ * @Function ArenaMatch_Play(ArenaMatch_t *pMatch, const BotTimings_t *pTimings,
+ *           const BotTuning_t *pTuning, const ArenaConfig_t *pConfig,
+ *           uint32_t RunTicks)
+ * @param pMatch - the robot, board and arena to play it on
+ * @param pTimings - the robot's timings, NULL for the ones as built
+ * @param pTuning - its speeds and thresholds, NULL for the ones as built
+ * @param pConfig - the arena, see ArenaMatch_Config()
+ * @param RunTicks - how long the match lasts
+ * @return the mission time, the tick of the first deposit, or 0 if there was
+ *         none; the rest is in pMatch->Arena.Stats
+ * @brief Plays the match on the calling thread. */
+uint32_t ArenaMatch_Play(ArenaMatch_t *pMatch, const BotTimings_t *pTimings,
+        const BotTuning_t *pTuning, const ArenaConfig_t *pConfig, uint32_t RunTicks);
+
+/**
+ * @Function ArenaMatch_Random(uint64_t *pState)
+ * @param pState - the generator, seeded by setting it to anything
+ * @return the next of its numbers
+ * @brief splitmix64, so the numbers drawn depend only on the seed. */
+uint64_t ArenaMatch_Random(uint64_t *pState);
+
+/**
+ * @Function ArenaMatch_Uniform(uint64_t *pState, double Low, double High)
+ * @param pState - the generator
+ * @return a number drawn evenly from Low up to High */
+double ArenaMatch_Uniform(uint64_t *pState, double Low, double High);
+
+#endif /* ARENAMATCH_H */
@@ -0,0 +1,432 @@
+/*
+ * File: ArenaSim.c
+ *
+ * The arena model behind the host's stand-in peripherals, see ArenaSim.h.
+ *
+ * The arena is an 8 ft square with low walls all round. The beacon tower
+ * stands in the far corner, ringed with tape, and is tall enough to reach
+ * the top bumpers; a low obstacle sits by the left wall, and a tape line runs
+ * up the middle from the near wall. The trap door is in the left wall, with
+ * the track wire along it. The robot is an 11 in square, seen from above
+ * with +x ahead and +y to its left, and is stopped short by anything it
+ * would run into rather than pushed along it.
+ *
+ * Every sensor is a point, or a few points, on the robot: a tape sensor is on
+ * tape when its point is within half a tape width of a tape line, a bumper is
+ * pressed when one of its points is inside a wall or an obstacle, and a wall
+ * sensor sees whatever is within its range off the side of the robot. The
+ * beacon detector looks straight ahead and reads brighter the closer and the
+ * more squarely it faces the beacon; each track wire coil reads the field of
+ * the wire, falling off with the distance from it.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ArenaSim.h"
+#include "ES_Port.h"
+#include "HostBoard.h"
+#include <math.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define STEP 0.001 // s, one tick
+
+#define ARENA_SIZE 2440.0 // the walls are at 0 and ARENA_SIZE on both axes
+#define TAPE_WIDTH 50.0
+
+#define HALF_LENGTH 140.0 // the robot, 280 mm square
+#define HALF_WIDTH 140.0
+#define PROBE 5.0 // how far the bumpers stand off the body
+
+#define WALL_RANGE 60.0 // off the side of the robot
+#define BEACON_X 1800.0
+#define BEACON_Y 1800.0
+#define BEACON_RANGE 1200.0 // full scale out to here, then falling off as 1 / d^2
+#define BEACON_HALF_ANGLE 0.35 // the detector sees nothing further off its axis
+#define TRACK_WIRE_GAIN 35000.0 // reading times mm, 700 at 50 mm from the wire
+#define MAX_READING 1023
+
+// the pins sensors.c reads
+#define TAPE_FL 0x8 // PORTX05
+#define TAPE_FR 0x4 // PORTX04
+#define TAPE_RL 0x2 // PORTX03
+#define TAPE_RR 0x1 // PORTX06
+
+// the trap door opens when the wall actuator is run forward, over the wire
+#define DEPOSIT_TRACK_READING 400
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    double X0, Y0, X1, Y1;
+    uint8_t Tall; // reaches the top bumpers
+} Box_t;
+
+typedef struct {
+    double X0, Y0, X1, Y1;
+} Segment_t;
+
+// a point on the robot
+typedef struct {
+    double X, Y;
+} Point_t;
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static const Box_t Boxes[] = {
+    {1650.0, 1650.0, 1950.0, 1950.0, TRUE}, // the beacon tower
+    {450.0, 1500.0, 750.0, 1800.0, FALSE}, // an obstacle
+};
+
+static const Segment_t Tapes[] = {
+    // the ring round the tower, 150 mm out
+    {1500.0, 1500.0, 2100.0, 1500.0},
+    {2100.0, 1500.0, 2100.0, 2100.0},
+    {2100.0, 2100.0, 1500.0, 2100.0},
+    {1500.0, 2100.0, 1500.0, 1500.0},
+    // up the middle from the near wall
+    {1220.0, 0.0, 1220.0, 1300.0},
+};
+
+// along the trap door in the left wall
+static const Segment_t TrackWire = {20.0, 1050.0, 20.0, 1390.0};
+
+// in botReadTape() bit order, high bit first
+static const Point_t TapeSensors[] = {
+    {120.0, 100.0}, // front left
+    {120.0, -100.0}, // front right
+    {-120.0, 100.0}, // rear left
+    {-120.0, -100.0}, // rear right
+};
+
+// three points across each half of the bumper bars, front left first
+#define POINTS_PER_BUMPER 3
+static const Point_t BumperPoints[][POINTS_PER_BUMPER] = {
+    {{HALF_LENGTH + PROBE, 20.0}, {HALF_LENGTH + PROBE, 80.0}, {HALF_LENGTH + PROBE, HALF_WIDTH}},
+    {{HALF_LENGTH + PROBE, -20.0}, {HALF_LENGTH + PROBE, -80.0}, {HALF_LENGTH + PROBE, -HALF_WIDTH}},
+    {{-HALF_LENGTH - PROBE, 20.0}, {-HALF_LENGTH - PROBE, 80.0}, {-HALF_LENGTH - PROBE, HALF_WIDTH}},
+    {{-HALF_LENGTH - PROBE, -20.0}, {-HALF_LENGTH - PROBE, -80.0}, {-HALF_LENGTH - PROBE, -HALF_WIDTH}},
+};
+
+// left then right, high on the front
+static const Point_t TopBumperPoints[] = {
+    {HALF_LENGTH + PROBE, 60.0},
+    {HALF_LENGTH + PROBE, -60.0},
+};
+
+// the outline the robot is stopped by
+static const Point_t Body[] = {
+    {HALF_LENGTH, HALF_WIDTH}, {HALF_LENGTH, 0.0}, {HALF_LENGTH, -HALF_WIDTH},
+    {0.0, -HALF_WIDTH}, {-HALF_LENGTH, -HALF_WIDTH}, {-HALF_LENGTH, 0.0},
+    {-HALF_LENGTH, HALF_WIDTH}, {0.0, HALF_WIDTH},
+};
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static double WheelSpeed(ArenaSim_t *pSim, unsigned char Channel, uint8_t Forward,
+        uint8_t Backward);
+static double Approach(double Speed, double Target, double Factor);
+static uint8_t Move(ArenaSim_t *pSim);
+static uint8_t Collides(double X, double Y, double Heading);
+static uint8_t InSolid(double X, double Y, uint8_t TallOnly);
+static void ToWorld(const ArenaSim_t *pSim, Point_t Point, double *pX, double *pY);
+static double SegmentDistance(const Segment_t *pSegment, double X, double Y);
+static void WriteSensors(ArenaSim_t *pSim);
+static uint8_t DoorOpen(const ArenaSim_t *pSim);
+static void CheckDeposit(ArenaSim_t *pSim);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ArenaSim_DefaultConfig(ArenaConfig_t *pConfig) {
+    pConfig->MaxWheelSpeed = 460.0; // a 90 degree spin at SPIN_SPEED takes 650 ms
+    pConfig->TrackWidth = 230.0;
+    pConfig->MotorLag = 0.06;
+    pConfig->RightGain = 100.0 / 92.0; // what SCALE in motors.c makes up for
+    pConfig->StartX = 300.0;
+    pConfig->StartY = 300.0;
+    pConfig->StartHeading = 0.0;
+}
+
+void ArenaSim_Init(ArenaSim_t *pSim, const ArenaConfig_t *pConfig) {
+    pSim->Config = *pConfig;
+    pSim->X = pConfig->StartX;
+    pSim->Y = pConfig->StartY;
+    pSim->Heading = pConfig->StartHeading;
+    pSim->Cos = cos(pSim->Heading);
+    pSim->Sin = sin(pSim->Heading);
+    pSim->SpeedL = 0.0;
+    pSim->SpeedR = 0.0;
+    pSim->LagFactor = (pConfig->MotorLag > 0.0) ? 1.0 - exp(-STEP / pConfig->MotorLag) : 1.0;
+    pSim->Tape = 0;
+    pSim->Blocked = FALSE;
+    pSim->Depositing = FALSE;
+    pSim->Stats = (ArenaStats_t) {0};
+    WriteSensors(pSim);
+}
+
+uint32_t ArenaSim_Tick(void *pArg, uint32_t Ticks) {
+    ArenaSim_t *pSim = pArg;
+    double TargetL = WheelSpeed(pSim, PWM_PORTZ06, PORTZ07_LAT, PORTZ08_LAT);
+    double TargetR = WheelSpeed(pSim, PWM_PORTY04, PORTY03_LAT, PORTY05_LAT)
+            * pSim->Config.RightGain;
+    uint8_t Moved = FALSE;
+
+    if (Ticks == 1) {
+        pSim->SpeedL = Approach(pSim->SpeedL, TargetL, pSim->LagFactor);
+        pSim->SpeedR = Approach(pSim->SpeedR, TargetR, pSim->LagFactor);
+        // standing still or held up, the sensors read what they did
+        Moved = Move(pSim);
+        if (Moved) {
+            WriteSensors(pSim);
+        }
+    }
+    // more than one only when the last call said nothing would change
+    pSim->Stats.Ticks += Ticks;
+    if (Ticks > 0) {
+        CheckDeposit(pSim);
+    }
+    if (!Moved && (pSim->SpeedL == TargetL) && (pSim->SpeedR == TargetR)
+            && (((TargetL == 0.0) && (TargetR == 0.0)) || pSim->Blocked)
+            && (DoorOpen(pSim) == pSim->Depositing)) {
+        return ES_PORT_STEADY_FOREVER;
+    }
+    return 0;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// what a wheel would run at on its duty and direction pins, mm/s
+static double WheelSpeed(ArenaSim_t *pSim, unsigned char Channel, uint8_t Forward,
+        uint8_t Backward) {
+    double Speed = pSim->Config.MaxWheelSpeed * PWM_GetDutyCycle(Channel) / MAX_PWM;
+
+    if (Forward == Backward) {
+        return 0.0; // both low is off, both high is braked
+    }
+    return Forward ? Speed : -Speed;
+}
+
+// one step of a wheel's lag towards the speed it is driven at
+static double Approach(double Speed, double Target, double Factor) {
+    Speed += (Target - Speed) * Factor;
+    return (fabs(Target - Speed) < SPEED_SNAP) ? Target : Speed;
+}
+
+// one step along the arc the wheels describe, unless it runs into something;
+// TRUE if the robot moved
+static uint8_t Move(ArenaSim_t *pSim) {
+    double Speed = (pSim->SpeedL + pSim->SpeedR) / 2.0;
+    double Turn = (pSim->SpeedR - pSim->SpeedL) / pSim->Config.TrackWidth * STEP;
+    double Middle = pSim->Heading + Turn / 2.0;
+    double X = pSim->X + Speed * STEP * cos(Middle);
+    double Y = pSim->Y + Speed * STEP * sin(Middle);
+    double Heading = pSim->Heading + Turn;
+
+    if ((Speed == 0.0) && (Turn == 0.0)) {
+        return FALSE;
+    }
+    if (Collides(X, Y, Heading)) {
+        if (!pSim->Blocked) {
+            pSim->Blocked = TRUE;
+            pSim->Stats.Collisions++;
+        }
+        return FALSE;
+    }
+    pSim->Blocked = FALSE;
+    pSim->X = X;
+    pSim->Y = Y;
+    if (Heading > M_PI) {
+        Heading -= 2.0 * M_PI;
+    } else if (Heading < -M_PI) {
+        Heading += 2.0 * M_PI;
+    }
+    pSim->Heading = Heading;
+    pSim->Cos = cos(Heading);
+    pSim->Sin = sin(Heading);
+    pSim->Stats.Distance += fabs(Speed) * STEP;
+    return TRUE;
+}
+
+// whether the robot at this pose overlaps a wall or an obstacle
+static uint8_t Collides(double X, double Y, double Heading) {
+    double Cos = cos(Heading), Sin = sin(Heading);
+    double Corner[2][2];
+    double Dx, Dy;
+    int i, j, k;
+
+    for (i = 0; i < ARRAY_SIZE(Body); i++) {
+        if (InSolid(X + Body[i].X * Cos - Body[i].Y * Sin,
+                Y + Body[i].X * Sin + Body[i].Y * Cos, FALSE)) {
+            return TRUE;
+        }
+    }
+    // a corner of an obstacle poking in between the points of the outline
+    for (i = 0; i < ARRAY_SIZE(Boxes); i++) {
+        Corner[0][0] = Boxes[i].X0;
+        Corner[0][1] = Boxes[i].X1;
+        Corner[1][0] = Boxes[i].Y0;
+        Corner[1][1] = Boxes[i].Y1;
+        for (j = 0; j < 2; j++) {
+            for (k = 0; k < 2; k++) {
+                Dx = Corner[0][j] - X;
+                Dy = Corner[1][k] - Y;
+                if ((fabs(Dx * Cos + Dy * Sin) < HALF_LENGTH)
+                        && (fabs(-Dx * Sin + Dy * Cos) < HALF_WIDTH)) {
+                    return TRUE;
+                }
+            }
+        }
+    }
+    return FALSE;
+}
+
+// beyond the walls or inside an obstacle; the walls are too low for TallOnly
+static uint8_t InSolid(double X, double Y, uint8_t TallOnly) {
+    int i;
+
+    if (!TallOnly && ((X < 0.0) || (Y < 0.0) || (X > ARENA_SIZE) || (Y > ARENA_SIZE))) {
+        return TRUE;
+    }
+    for (i = 0; i < ARRAY_SIZE(Boxes); i++) {
+        if ((!TallOnly || Boxes[i].Tall) && (X > Boxes[i].X0) && (X < Boxes[i].X1)
+                && (Y > Boxes[i].Y0) && (Y < Boxes[i].Y1)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void ToWorld(const ArenaSim_t *pSim, Point_t Point, double *pX, double *pY) {
+    *pX = pSim->X + Point.X * pSim->Cos - Point.Y * pSim->Sin;
+    *pY = pSim->Y + Point.X * pSim->Sin + Point.Y * pSim->Cos;
+}
+
+static double SegmentDistance(const Segment_t *pSegment, double X, double Y) {
+    double Dx = pSegment->X1 - pSegment->X0;
+    double Dy = pSegment->Y1 - pSegment->Y0;
+    double Length2 = Dx * Dx + Dy * Dy;
+    double t = 0.0;
+
+    if (Length2 > 0.0) {
+        t = ((X - pSegment->X0) * Dx + (Y - pSegment->Y0) * Dy) / Length2;
+        t = (t < 0.0) ? 0.0 : (t > 1.0) ? 1.0 : t;
+    }
+    return hypot(X - (pSegment->X0 + t * Dx), Y - (pSegment->Y0 + t * Dy));
+}
+
+// sets every input sensors.c reads from where the robot now is
+static void WriteSensors(ArenaSim_t *pSim) {
+    uint8_t Tape = 0, Bumpers = 0, TopBumpers = 0;
+    double X, Y, Dx, Dy, Distance, Angle, Reading;
+    int i, j;
+
+    for (i = 0; i < ARRAY_SIZE(TapeSensors); i++) {
+        ToWorld(pSim, TapeSensors[i], &X, &Y);
+        for (j = 0; j < ARRAY_SIZE(Tapes); j++) {
+            if (SegmentDistance(&Tapes[j], X, Y) <= TAPE_WIDTH / 2.0) {
+                Tape |= 0x8 >> i;
+                break;
+            }
+        }
+    }
+    for (i = 0; i < 4; i++) {
+        if (Tape & ~pSim->Tape & (1 << i)) {
+            pSim->Stats.TapeCrossings++;
+        }
+    }
+    pSim->Tape = Tape;
+    PORTX05_BIT = (Tape & TAPE_FL) ? 1 : 0;
+    PORTX04_BIT = (Tape & TAPE_FR) ? 1 : 0;
+    PORTX03_BIT = (Tape & TAPE_RL) ? 1 : 0;
+    PORTX06_BIT = (Tape & TAPE_RR) ? 1 : 0;
+
+    for (i = 0; i < ARRAY_SIZE(BumperPoints); i++) {
+        for (j = 0; j < POINTS_PER_BUMPER; j++) {
+            ToWorld(pSim, BumperPoints[i][j], &X, &Y);
+            if (InSolid(X, Y, FALSE)) {
+                Bumpers |= 0x8 >> i;
+                break;
+            }
+        }
+    }
+    PORTV06_BIT = (Bumpers >> 3) & 1; // front left
+    PORTV05_BIT = (Bumpers >> 2) & 1;
+    PORTV08_BIT = (Bumpers >> 1) & 1;
+    PORTV07_BIT = Bumpers & 1;
+
+    for (i = 0; i < ARRAY_SIZE(TopBumperPoints); i++) {
+        ToWorld(pSim, TopBumperPoints[i], &X, &Y);
+        if (InSolid(X, Y, TRUE)) {
+            TopBumpers |= 0x2 >> i;
+        }
+    }
+    PORTW04_BIT = (TopBumpers >> 1) & 1; // top left
+    PORTW03_BIT = TopBumpers & 1;
+
+    // active low, the right side's is wallTape()
+    ToWorld(pSim, (Point_t) {60.0, -HALF_WIDTH - WALL_RANGE}, &X, &Y);
+    PORTW05_BIT = InSolid(X, Y, FALSE) ? 0 : 1;
+    ToWorld(pSim, (Point_t) {60.0, HALF_WIDTH + WALL_RANGE}, &X, &Y);
+    PORTW06_BIT = InSolid(X, Y, FALSE) ? 0 : 1;
+
+    Dx = BEACON_X - pSim->X;
+    Dy = BEACON_Y - pSim->Y;
+    Distance = hypot(Dx, Dy);
+    Angle = atan2(Dy, Dx) - pSim->Heading;
+    Angle = fabs(atan2(sin(Angle), cos(Angle)));
+    Reading = 0.0;
+    if (Angle < BEACON_HALF_ANGLE) {
+        Reading = MAX_READING * cos(Angle / BEACON_HALF_ANGLE * M_PI / 2.0);
+        if (Distance > BEACON_RANGE) {
+            Reading *= (BEACON_RANGE / Distance) * (BEACON_RANGE / Distance);
+        }
+    }
+    HostBoard_SetAD(AD_PORTW8, (unsigned int) Reading);
+
+    // right coil on V3, left on V4
+    for (i = 0; i < 2; i++) {
+        ToWorld(pSim, (Point_t) {130.0, (i == 0) ? -120.0 : 120.0}, &X, &Y);
+        Distance = SegmentDistance(&TrackWire, X, Y);
+        Reading = TRACK_WIRE_GAIN / ((Distance > 1.0) ? Distance : 1.0);
+        pSim->TrackWire[i] = (Reading > MAX_READING) ? MAX_READING : (unsigned int) Reading;
+        HostBoard_SetAD((i == 0) ? AD_PORTV3 : AD_PORTV4, pSim->TrackWire[i]);
+    }
+}
+
+// the wall actuator run forward is the trap door opening, over the wire
+static uint8_t DoorOpen(const ArenaSim_t *pSim) {
+    return (PORTX10_LAT == 1) && (PORTX08_LAT == 0) && (PWM_GetDutyCycle(PWM_PORTX11) > 0)
+            && ((pSim->TrackWire[0] > DEPOSIT_TRACK_READING)
+            || (pSim->TrackWire[1] > DEPOSIT_TRACK_READING));
+}
+
+static void CheckDeposit(ArenaSim_t *pSim) {
+    if (DoorOpen(pSim)) {
+        if (!pSim->Depositing) {
+            pSim->Depositing = TRUE;
+            pSim->Stats.Deposits++;
+            if (pSim->Stats.FirstDeposit == 0) {
+                pSim->Stats.FirstDeposit = pSim->Stats.Ticks;
+            }
+        }
+    } else {
+        pSim->Depositing = FALSE;
+    }
+}
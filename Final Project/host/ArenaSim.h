@@ -0,0 +1,95 @@
+/*
+ * File: ArenaSim.h
+ *
+ * A 2-D model of the arena behind the host's stand-in peripherals. Once a
+ * tick it reads what the application commanded through the PWM duty cycles
+ * and direction pins motors.c drives, moves the robot by differential-drive
+ * kinematics and sets the pins and A/D readings sensors.c reads: the tape
+ * sensors, the bumpers and top bumpers, the two wall sensors, the beacon
+ * detector and the track wire coils. sensors.c, motors.c and every machine
+ * above them run unchanged.
+ *
+ * Lengths are in mm, angles in radians counterclockwise from +x and time in
+ * the framework's 1 ms ticks, which is also the fixed integration step. The
+ * layout of the arena is in ArenaSim.c.
+ *
+ * A wheel within SPEED_SNAP of the speed it is driven at is taken to be at
+ * it, so a robot told to stop does come to rest, and one left pushing into a
+ * wall stays put. Either way nothing the sensors read can change until the
+ * outputs do, which the tick hook reports so the run loop can sleep it out.
+ */
+
+#ifndef ARENASIM_H
+#define ARENASIM_H
+
+#include <stdint.h>
+
+// mm/s, see above
+#define SPEED_SNAP 0.01
+
+// the robot, and where it starts
+typedef struct {
+    double MaxWheelSpeed; // mm/s of a wheel at full duty
+    double TrackWidth; // mm between the wheels
+    double MotorLag; // s, first order time constant of the wheel speeds
+    double RightGain; // right wheel speed over left on the same duty
+    double StartX;
+    double StartY;
+    double StartHeading;
+} ArenaConfig_t;
+
+typedef struct {
+    uint32_t Ticks; // since ArenaSim_Init()
+    double Distance; // mm driven
+    uint32_t Collisions; // times the robot ran into a wall or an obstacle
+    uint32_t TapeCrossings; // times a tape sensor went onto tape
+    uint32_t Deposits; // times the trap door was opened over the track wire
+    uint32_t FirstDeposit; // tick of the first deposit, 0 if there was none
+} ArenaStats_t;
+
+// one robot in its own arena; every robot of a run has one
+typedef struct {
+    ArenaConfig_t Config;
+    double X;
+    double Y;
+    double Heading;
+    double Cos; // of Heading
+    double Sin;
+    double SpeedL; // mm/s
+    double SpeedR;
+    double LagFactor; // of each step, from MotorLag
+    uint8_t Tape; // as botReadTape() reads it
+    unsigned int TrackWire[2]; // the right coil's reading, then the left's
+    uint8_t Blocked; // the last step ran into something
+    uint8_t Depositing;
+    ArenaStats_t Stats;
+} ArenaSim_t;
+
+/**
+ * @Function ArenaSim_DefaultConfig(ArenaConfig_t *pConfig)
+ * @param pConfig - filled with the robot as built, in its starting corner
+ * @return None */
+void ArenaSim_DefaultConfig(ArenaConfig_t *pConfig);
+
+/**
+ * @Function ArenaSim_Init(ArenaSim_t *pSim, const ArenaConfig_t *pConfig)
+ * @param pSim - the arena to set up
+ * @param pConfig - the robot and its starting pose
+ * @return None
+ * @brief Puts the robot at rest at its start and sets every sensor input to
+ *        match, on the board made current with HostBoard_Select(). Call it
+ *        after BOARD_Init() and sensors_Init(), and hand ArenaSim_Tick() and
+ *        pSim to ES_Port_SetTickHook(). */
+void ArenaSim_Init(ArenaSim_t *pSim, const ArenaConfig_t *pConfig);
+
+/**
+ * @Function ArenaSim_Tick(void *pSim, uint32_t Ticks)
+ * @param pSim - the ArenaSim_t to step
+ * @param Ticks - how many ticks to move the world on by, 0 to only ask
+ * @return ES_PORT_STEADY_FOREVER if the robot is at rest or held up with its
+ *         wheels at speed and nothing is left to change, 0 otherwise
+ * @brief An ES_PortTickHook_t, it works on the board of the calling thread.
+ *        More than one tick at a time only while the robot is steady. */
+uint32_t ArenaSim_Tick(void *pSim, uint32_t Ticks);
+
+#endif /* ARENASIM_H */
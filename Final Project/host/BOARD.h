@@ -0,0 +1,36 @@
+/*
+ * File: BOARD.h
+ *
+ * Linux host stand-in for the Uno32 BOARD library. Provides the common types
+ * and return codes the application code relies on.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TRUE ((int8_t)1)
+#define FALSE ((int8_t)0)
+#define SUCCESS ((int8_t)1)
+#define ERROR ((int8_t)-1)
+
+#define SYS_FREQ 80000000L
+#define PB_FREQ 20000000L
+
+/**
+ * @Function BOARD_Init(void)
+ * @brief Resets every stand-in peripheral to its power-on state. */
+void BOARD_Init(void);
+
+/**
+ * @Function BOARD_End(void)
+ * @brief Does nothing on the host, the process simply exits. */
+void BOARD_End(void);
+
+unsigned int BOARD_GetSysClock(void);
+
+unsigned int BOARD_GetPBClock(void);
+
+#endif /* BOARD_H */
@@ -0,0 +1,312 @@
+/*
+ * File: ES_Port_Host.c
+ *
+ * Linux host port of the Events and Services Framework. There is no timer
+ * interrupt: whenever the run loop goes idle the port advances virtual time by
+ * one tick, or by every tick the tickless run loop can spare, so a run is as
+ * fast as the CPU allows and identical from run to run. The run limit, the
+ * trace file and the tick hook are those of the current context, so every
+ * thread runs to a limit of its own. Do not add this file to the Uno32 build.
+ *
+ * Whatever the tick hook says of how long the inputs will hold is kept as the
+ * stretch ES_Port_InputsSteady() reports. Through that stretch the hook is
+ * handed all the ticks of a sleep at once. Every wakeup cuts it short at the
+ * current tick, since the run loop may change the outputs the hook works from,
+ * and the next ES_Port_InputsSteady() asks the hook again with no ticks.
+ * ES_Port_SteadyTicks() lets the run loop sleep through the checker runs
+ * that fall inside the stretch, and ES_Port_Sleep() counts them as run.
+ *
+ * With ES_VERIFY_STEADY a fixed-tick context takes every answer of the hook as
+ * no ticks, so it steps one tick at a time, and every context logs what the run
+ * loop dispatches.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "ES_CheckEvents.h"
+#include "ES_Timers.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void Tick(ES_PortContext_t *pPort, uint32_t Ticks);
+static void Wake(ES_PortContext_t *pPort);
+static void SkipChecks(ES_PortContext_t *pPort, uint32_t Start, uint32_t Now);
+static uint32_t SteadyUntil(uint32_t Now, uint32_t Steady);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void ES_Port_Init(void) {
+    int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+
+    // no checker group has run yet
+    memset(ES_CurrentContext->Port.GroupRan, 0, sizeof (ES_CurrentContext->Port.GroupRan));
+    if (flags != -1) {
+        fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+uint32_t ES_Port_TicksElapsed(void) {
+    // virtual time only moves in ES_Port_Idle()
+    return 0;
+}
+
+uint32_t ES_Port_Timestamp(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) (now.tv_sec * 1000000000ull + now.tv_nsec);
+}
+
+uint8_t ES_Port_Idle(void) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+
+    if (pPort->Limited && (ES_Timer_GetTime() >= pPort->RunLimit)) {
+        return FALSE;
+    }
+    Tick(pPort, 1);
+    Wake(pPort);
+    return TRUE;
+}
+
+uint8_t ES_Port_Sleep(uint32_t Ticks) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+    uint32_t Now = ES_Timer_GetTime();
+    uint32_t Start = Now;
+    uint32_t Step;
+
+    if (pPort->Limited) {
+        if (Now >= pPort->RunLimit) {
+            return FALSE;
+        }
+        // nothing can interrupt, so the whole stretch goes by at once
+        if (Ticks > pPort->RunLimit - Now) {
+            Ticks = pPort->RunLimit - Now;
+        }
+    }
+    while (Ticks > 0) {
+        // the ticks the hook has vouched for go by at once
+        Step = 1;
+        if (pPort->pTickHook == NULL) {
+            Step = Ticks;
+        } else if (pPort->SteadyUntil > Now + 1) {
+            Step = pPort->SteadyUntil - Now;
+            if (Step > Ticks) {
+                Step = Ticks;
+            }
+        }
+        Tick(pPort, Step);
+        Now += Step;
+        Ticks -= Step;
+    }
+    SkipChecks(pPort, Start, Now);
+    Wake(pPort);
+    return TRUE;
+}
+
+uint32_t ES_Port_SteadyTicks(uint32_t Ticks) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+    ES_CheckGroupStats_t Group;
+    uint32_t Now = ES_Timer_GetTime();
+    uint32_t Since;
+    uint32_t Until = ES_Port_InputsSteady(&Since);
+    uint32_t Steady;
+    uint32_t Due;
+    uint8_t g;
+
+    // the inputs may read differently on the tick after Until
+    Steady = (Until - Now >= UINT32_MAX - 1) ? UINT32_MAX : Until + 1 - Now;
+    for (g = 0; (Steady > Ticks) && ES_GetCheckGroupStats(g, &Group); g++) {
+        if ((pPort->GroupRan[g] != 0) && (pPort->GroupRan[g] - 1 >= Since)) {
+            continue; // ran on the inputs as they are, would find nothing
+        }
+        // has to run on them first
+        Due = ES_CheckGroupDueIn(g, Now);
+        if (Due < Steady) {
+            Steady = Due;
+        }
+    }
+    return (Steady > Ticks) ? Steady : Ticks;
+}
+
+void ES_Port_CheckGroupRan(uint8_t Group, uint32_t Now) {
+    ES_CurrentContext->Port.GroupRan[Group] = Now + 1;
+}
+
+uint32_t ES_Port_EnterCritical(void) {
+    // nothing preempts the run loop, and other threads run other contexts
+    return 0;
+}
+
+void ES_Port_ExitCritical(uint32_t State) {
+    (void) State;
+}
+
+int ES_Port_GetChar(void) {
+    unsigned char ch;
+
+    if (read(STDIN_FILENO, &ch, 1) != 1) {
+        return -1;
+    }
+    return ch;
+}
+
+uint8_t ES_Port_TraceWrite(const uint8_t *pData, uint8_t Length) {
+    FILE *pFile = ES_CurrentContext->Port.pTraceFile;
+
+    if (pFile != NULL) {
+        fwrite(pData, 1, Length, pFile);
+    }
+    return TRUE;
+}
+
+void ES_Port_SetRunLimit(uint32_t Ticks) {
+    ES_CurrentContext->Port.RunLimit = Ticks;
+    ES_CurrentContext->Port.Limited = TRUE;
+}
+
+uint8_t ES_Port_SetTraceFile(const char *Path) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+
+    if (pPort->pTraceFile != NULL) {
+        fclose(pPort->pTraceFile);
+    }
+    pPort->pTraceFile = fopen(Path, "wb");
+    return (pPort->pTraceFile != NULL);
+}
+
+void ES_Port_SetTickHook(ES_PortTickHook_t *pHook, void *pArg) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+
+    pPort->pTickHook = pHook;
+    pPort->pTickArg = pArg;
+    // whatever set the inputs so far, nothing is known of them from here on
+    pPort->SteadySince = ES_Timer_GetTime();
+    pPort->SteadyUntil = pPort->SteadySince;
+}
+
+uint32_t ES_Port_InputsSteady(uint32_t *pSince) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+    uint32_t Now = ES_Timer_GetTime();
+    uint32_t Steady;
+
+#ifdef ES_VERIFY_STEADY
+    if (pPort->FixedTick) {
+        *pSince = Now;
+        return Now;
+    }
+#endif
+    if (pPort->pTickHook == NULL) {
+        *pSince = 0;
+        return ES_PORT_STEADY_FOREVER;
+    }
+    // since the last wakeup, ask again with the outputs as they are now
+    if (pPort->SteadyUntil <= Now) {
+        Steady = pPort->pTickHook(pPort->pTickArg, 0);
+        pPort->SteadyUntil = SteadyUntil(Now, Steady);
+    }
+    *pSince = pPort->SteadySince;
+    return pPort->SteadyUntil;
+}
+
+#ifdef ES_VERIFY_STEADY
+void ES_Port_SetFixedTick(void) {
+    ES_CurrentContext->Port.FixedTick = TRUE;
+}
+
+void ES_Port_NoteDispatch(uint8_t WhichService, uint16_t EventType, uint16_t EventParam) {
+    ES_PortContext_t *pPort = &ES_CurrentContext->Port;
+    ES_PortDispatch_t *pDispatch;
+
+    if (pPort->NumDispatches == pPort->MaxDispatches) {
+        pPort->MaxDispatches = (pPort->MaxDispatches == 0) ? 4096 : 2 * pPort->MaxDispatches;
+        pPort->pDispatches = realloc(pPort->pDispatches,
+                pPort->MaxDispatches * sizeof (ES_PortDispatch_t));
+        if (pPort->pDispatches == NULL) {
+            perror("ES_Port_NoteDispatch");
+            exit(EXIT_FAILURE);
+        }
+    }
+    pDispatch = &pPort->pDispatches[pPort->NumDispatches++];
+    pDispatch->Tick = ES_Timer_GetTime();
+    pDispatch->EventType = EventType;
+    pDispatch->EventParam = EventParam;
+    pDispatch->Service = WhichService;
+}
+
+uint32_t ES_Port_GetDispatches(const ES_PortDispatch_t **ppDispatches) {
+    *ppDispatches = ES_CurrentContext->Port.pDispatches;
+    return ES_CurrentContext->Port.NumDispatches;
+}
+#endif
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// Ticks ticks of virtual time, the world first; more than one only through a
+// stretch the hook has vouched for, or without a hook
+static void Tick(ES_PortContext_t *pPort, uint32_t Ticks) {
+    uint32_t Now = ES_Timer_GetTime() + Ticks;
+    uint32_t Steady;
+
+    if (pPort->pTickHook != NULL) {
+        Steady = pPort->pTickHook(pPort->pTickArg, Ticks);
+#ifdef ES_VERIFY_STEADY
+        if (pPort->FixedTick) {
+            Steady = 0;
+        }
+#endif
+        if (Now > pPort->SteadyUntil) {
+            pPort->SteadySince = Now; // they may have changed
+        }
+        pPort->SteadyUntil = SteadyUntil(Now, Steady);
+    }
+    while (Ticks-- > 0) {
+        ES_Timer_Tick();
+    }
+}
+
+// the checker runs due after Start and before Now were slept through, and
+// would have found nothing
+static void SkipChecks(ES_PortContext_t *pPort, uint32_t Start, uint32_t Now) {
+    ES_CheckGroupStats_t Group;
+    uint32_t Ran;
+    uint8_t g;
+
+    for (g = 0; ES_GetCheckGroupStats(g, &Group); g++) {
+        Ran = ES_SkipCheckGroup(g, Start, Now);
+        if (Ran != 0) {
+            pPort->GroupRan[g] = Ran;
+        }
+    }
+}
+
+// the run loop is about to run and may change the outputs
+static void Wake(ES_PortContext_t *pPort) {
+    uint32_t Now = ES_Timer_GetTime();
+
+    if (pPort->SteadyUntil > Now) {
+        pPort->SteadyUntil = Now;
+    }
+}
+
+// the last tick of Steady more after Now, without running past forever
+static uint32_t SteadyUntil(uint32_t Now, uint32_t Steady) {
+    return (Steady > ES_PORT_STEADY_FOREVER - Now) ? ES_PORT_STEADY_FOREVER : Now + Steady;
+}
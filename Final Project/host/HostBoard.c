@@ -0,0 +1,349 @@
+/*
+ * File: HostBoard.c
+ *
+ * Linux host implementations of the Uno32 BOARD, A/D, IO port, PWM, RC servo,
+ * serial and LED libraries. Nothing here touches real hardware: outputs are
+ * recorded and inputs return whatever the host harness last set, on the
+ * HostBoard_t of the calling thread.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "AD.h"
+#include "IO_Ports.h"
+#include "pwm.h"
+#include "RC_Servo.h"
+#include "serial.h"
+#include "LED.h"
+#include "HostBoard.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+// a charged battery, well above the 175 BATTERY_DISCONNECT_THRESHOLD
+#define DEFAULT_BATTERY_READING 325
+#define MAX_AD_READING 1023
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+__thread IO_HostPin_t *IO_HostPins;
+
+static __thread HostBoard_t *pCurrent;
+
+// the peripherals of the current board
+#define ADActivePins (pCurrent->ADActivePins)
+#define ADReadings (pCurrent->ADReadings)
+#define PWMActivePins (pCurrent->PWMActivePins)
+#define PWMDutyCycles (pCurrent->PWMDutyCycles)
+#define PWMFrequency (pCurrent->PWMFrequency)
+#define RCActivePins (pCurrent->RCActivePins)
+#define RCPulseTimes (pCurrent->RCPulseTimes)
+#define LEDActiveBanks (pCurrent->LEDActiveBanks)
+#define LEDBanks (pCurrent->LEDBanks)
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static int PinIndex(unsigned int Pin, int NumPins);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+/// BOARD ----------------------------------------------------------------------
+
+void HostBoard_Select(HostBoard_t *pBoard) {
+    pCurrent = pBoard;
+    IO_HostPins = pBoard->Pins;
+}
+
+void BOARD_Init(void) {
+    int i;
+
+    for (i = 0; i < IO_NUM_PINS; i++) {
+        IO_HostPins[i].TRIS = 1;
+        IO_HostPins[i].LAT = 0;
+        IO_HostPins[i].BIT = 0;
+    }
+    // the wall tape sensors read high when there is no wall
+    PORTW05_BIT = 1;
+    PORTW06_BIT = 1;
+
+    ADActivePins = 0;
+    memset(ADReadings, 0, sizeof (ADReadings));
+    HostBoard_SetAD(BAT_VOLTAGE, DEFAULT_BATTERY_READING);
+
+    PWMActivePins = 0;
+    memset(PWMDutyCycles, 0, sizeof (PWMDutyCycles));
+    PWMFrequency = PWM_DEFAULT_FREQUENCY;
+
+    RCActivePins = 0;
+    memset(RCPulseTimes, 0, sizeof (RCPulseTimes));
+
+    LEDActiveBanks = 0;
+    memset(LEDBanks, 0, sizeof (LEDBanks));
+}
+
+void BOARD_End(void) {
+}
+
+unsigned int BOARD_GetSysClock(void) {
+    return SYS_FREQ;
+}
+
+unsigned int BOARD_GetPBClock(void) {
+    return PB_FREQ;
+}
+
+/// A/D ------------------------------------------------------------------------
+
+char AD_Init(void) {
+    return SUCCESS;
+}
+
+char AD_AddPins(unsigned int AddPins) {
+    ADActivePins |= AddPins;
+    return SUCCESS;
+}
+
+char AD_RemovePins(unsigned int RemovePins) {
+    ADActivePins &= ~RemovePins;
+    return SUCCESS;
+}
+
+unsigned int AD_ActivePins(void) {
+    return ADActivePins | BAT_VOLTAGE;
+}
+
+char AD_IsNewDataReady(void) {
+    return TRUE;
+}
+
+unsigned int AD_ReadADPin(unsigned int Pin) {
+    int i = PinIndex(Pin, AD_NUM_PINS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    return ADReadings[i];
+}
+
+void AD_End(void) {
+    ADActivePins = 0;
+}
+
+void HostBoard_SetAD(unsigned int Pin, unsigned int Value) {
+    int i = PinIndex(Pin, AD_NUM_PINS);
+
+    if (i >= 0) {
+        ADReadings[i] = (Value > MAX_AD_READING) ? MAX_AD_READING : Value;
+    }
+}
+
+/// PWM ------------------------------------------------------------------------
+
+char PWM_Init(void) {
+    PWMActivePins = 0;
+    PWMFrequency = PWM_DEFAULT_FREQUENCY;
+    return SUCCESS;
+}
+
+char PWM_SetFrequency(unsigned int NewFrequency) {
+    PWMFrequency = NewFrequency;
+    return SUCCESS;
+}
+
+unsigned int PWM_GetFrequency(void) {
+    return PWMFrequency;
+}
+
+char PWM_AddPins(unsigned short int AddPins) {
+    PWMActivePins |= AddPins;
+    return SUCCESS;
+}
+
+char PWM_RemovePins(unsigned short int RemovePins) {
+    PWMActivePins &= ~RemovePins;
+    return SUCCESS;
+}
+
+char PWM_SetDutyCycle(unsigned char Channel, unsigned int Duty) {
+    int i = PinIndex(Channel, PWM_NUM_PINS);
+
+    if ((i < 0) || (Duty > MAX_PWM)) {
+        return ERROR;
+    }
+    PWMDutyCycles[i] = Duty;
+    return SUCCESS;
+}
+
+unsigned int PWM_GetDutyCycle(unsigned char Channel) {
+    int i = PinIndex(Channel, PWM_NUM_PINS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    return PWMDutyCycles[i];
+}
+
+char PWM_End(void) {
+    PWMActivePins = 0;
+    return SUCCESS;
+}
+
+/// RC SERVO -------------------------------------------------------------------
+
+char RC_Init(void) {
+    RCActivePins = 0;
+    return SUCCESS;
+}
+
+char RC_AddPins(unsigned short int RCpins) {
+    RCActivePins |= RCpins;
+    return SUCCESS;
+}
+
+char RC_RemovePins(unsigned short int RCpins) {
+    RCActivePins &= ~RCpins;
+    return SUCCESS;
+}
+
+unsigned short int RC_ActivePins(void) {
+    return RCActivePins;
+}
+
+char RC_SetPulseTime(unsigned short int RCpin, unsigned short int pulseTime) {
+    int i = PinIndex(RCpin, RC_NUM_PINS);
+
+    if ((i < 0) || (pulseTime < MINPULSE) || (pulseTime > MAXPULSE)) {
+        return ERROR;
+    }
+    RCPulseTimes[i] = pulseTime;
+    return SUCCESS;
+}
+
+unsigned short int RC_GetPulseTime(unsigned short int RCpin) {
+    int i = PinIndex(RCpin, RC_NUM_PINS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    return RCPulseTimes[i];
+}
+
+char RC_End(void) {
+    RCActivePins = 0;
+    return SUCCESS;
+}
+
+/// SERIAL ---------------------------------------------------------------------
+
+void SERIAL_Init(void) {
+}
+
+void PutChar(char ch) {
+    putchar(ch);
+}
+
+char GetChar(void) {
+    return 0;
+}
+
+char IsTransmitEmpty(void) {
+    return TRUE;
+}
+
+char IsReceiveEmpty(void) {
+    return TRUE;
+}
+
+/// LED ------------------------------------------------------------------------
+
+char LED_Init(void) {
+    LEDActiveBanks = 0;
+    return SUCCESS;
+}
+
+char LED_AddBanks(uint8_t bank) {
+    LEDActiveBanks |= bank;
+    return SUCCESS;
+}
+
+char LED_RemoveBanks(uint8_t bank) {
+    LEDActiveBanks &= ~bank;
+    return SUCCESS;
+}
+
+char LED_OnBank(uint8_t bank, uint8_t pattern) {
+    int i = PinIndex(bank, NUM_LED_BANKS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    LEDBanks[i] |= pattern;
+    return SUCCESS;
+}
+
+char LED_OffBank(uint8_t bank, uint8_t pattern) {
+    int i = PinIndex(bank, NUM_LED_BANKS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    LEDBanks[i] &= ~pattern;
+    return SUCCESS;
+}
+
+char LED_InvertBank(uint8_t bank, uint8_t pattern) {
+    int i = PinIndex(bank, NUM_LED_BANKS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    LEDBanks[i] ^= pattern;
+    return SUCCESS;
+}
+
+char LED_SetBank(uint8_t bank, uint8_t pattern) {
+    int i = PinIndex(bank, NUM_LED_BANKS);
+
+    if (i < 0) {
+        return ERROR;
+    }
+    LEDBanks[i] = pattern;
+    return SUCCESS;
+}
+
+uint8_t LED_GetBank(uint8_t bank) {
+    int i = PinIndex(bank, NUM_LED_BANKS);
+
+    if (i < 0) {
+        return 0;
+    }
+    return LEDBanks[i];
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// the libraries name pins with one-hot masks, storage is indexed by bit number
+static int PinIndex(unsigned int Pin, int NumPins) {
+    int i;
+
+    for (i = 0; i < NumPins; i++) {
+        if (Pin == (1u << i)) {
+            return i;
+        }
+    }
+    return -1;
+}
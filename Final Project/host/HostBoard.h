@@ -0,0 +1,52 @@
+/*
+ * File: HostBoard.h
+ *
+ * Host-only access to the stand-in peripherals, for harnesses and simulators
+ * that need to set what the application reads or check what it commanded.
+ * Digital inputs are set directly through the PORTxnn_BIT macros of
+ * IO_Ports.h; duty cycles and pulse times are read back through
+ * PWM_GetDutyCycle() and RC_GetPulseTime(). Everything applies to the board
+ * made current with HostBoard_Select().
+ */
+
+#ifndef HOSTBOARD_H
+#define HOSTBOARD_H
+
+#include "IO_Ports.h"
+#include "AD.h"
+#include "pwm.h"
+#include "RC_Servo.h"
+
+#define NUM_LED_BANKS 3
+
+// one robot's peripherals; a zeroed board is fine for BOARD_Init()
+typedef struct {
+    IO_HostPin_t Pins[IO_NUM_PINS];
+    unsigned int ADActivePins;
+    unsigned int ADReadings[AD_NUM_PINS];
+    unsigned short int PWMActivePins;
+    unsigned int PWMDutyCycles[PWM_NUM_PINS];
+    unsigned int PWMFrequency;
+    unsigned short int RCActivePins;
+    unsigned short int RCPulseTimes[RC_NUM_PINS];
+    uint8_t LEDActiveBanks;
+    uint8_t LEDBanks[NUM_LED_BANKS];
+} HostBoard_t;
+
+/**
+ * @Function HostBoard_Select(HostBoard_t *pBoard)
+ * @param pBoard - the board the libraries work on from now on
+ * @return None
+ * @brief Per thread, like ES_SetContext(), and needed before BOARD_Init(). A
+ *        thread running a robot selects its board and its ES_Context_t
+ *        together. */
+void HostBoard_Select(HostBoard_t *pBoard);
+
+/**
+ * @Function HostBoard_SetAD(unsigned int Pin, unsigned int Value)
+ * @param Pin - one of the AD_PORTxx or BAT_VOLTAGE defines
+ * @param Value - 10-bit reading to return from AD_ReadADPin()
+ * @return None */
+void HostBoard_SetAD(unsigned int Pin, unsigned int Value);
+
+#endif /* HOSTBOARD_H */
@@ -0,0 +1,467 @@
+/*
+ * File: HostMain.c
+ *
+ * Linux host entry point. Brings the bot up the same way ES_Main.c does on the
+ * Uno32 and runs the framework for a fixed stretch of virtual time. Each robot
+ * has its own Bot_t and HostBoard_t, so several can run side by side, one per
+ * thread, without seeing each other. By default the sensors read whatever
+ * BOARD_Init() left them at; with -a every robot drives round an arena of its
+ * own, see ArenaSim.h. What the sensors read can be recorded, and played back
+ * in place of the arena, see SensorTrace.h.
+ *
+ *   es_host [-t <ms>] [-r <robots>] [-a] [-b <us>] [-q] [-s] [-l] [-T <file>]
+ *           [-R <file> | -P <file>]
+ *     -t  virtual milliseconds to run (default 120000, one match, or the
+ *         length of the recording played back)
+ *     -r  robots to run at once, each on its own thread (default 1)
+ *     -a  run the robots in the simulated arena and report how they did
+ *     -b  run-to-completion budget in wall-clock microseconds, 0 for none
+ *         (default ES_RUN_BUDGET_US)
+ *     -q  discard the application's printf output
+ *     -s  print the queue and Run function statistics at the end of the run
+ *     -l  print the post to dispatch latency histograms at the end of the run
+ *     -T  write the state machine trace of the first robot to a file, needs a
+ *         build with USE_TATTLETALE (make TRACE=1)
+ *     -R  record what the sensors read every tick to a file, one robot only
+ *     -P  play a recording back into the sensors instead, one robot only;
+ *         the robot posts the same events it did when it was recorded, so
+ *         with -b 0 its -T trace decodes to the same records
+ *
+ * Built with ES_VERIFY_STEADY (make VERIFY=1) every robot runs beside a twin
+ * that steps every tick, with the tick hook's promises ignored, on a thread of
+ * its own; the twin records nothing and writes no trace. At the end the events
+ * the two were dispatched are compared, and the run fails at the first
+ * difference, which would mean a checker that does not live up to the contract
+ * in ES_CheckEvents.h.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "HostBoard.h"
+#include "ArenaSim.h"
+#include "SensorTrace.h"
+#include "Bot.h"
+#include "sensors.h"
+#include "motors.h"
+#include "pwm.h"
+#include "LED.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define DEFAULT_RUN_TICKS 120000
+#define MAX_ROBOTS 256
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    Bot_t *pBot;
+    HostBoard_t *pBoard;
+    uint32_t RunTicks;
+    uint32_t RunBudget; // us
+    uint8_t UseArena;
+    ArenaSim_t Arena;
+    const char *RecordPath;
+    const char *PlayPath;
+    SensorTrace_t Sensors;
+    ES_Return_t ErrorType;
+#ifdef ES_VERIFY_STEADY
+    uint8_t FixedTick;
+#endif
+} Robot_t;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void *RunRobot(void *pArg);
+static uint32_t RobotTick(void *pArg, uint32_t Ticks);
+static void SelectRobot(Robot_t *pRobot);
+static double WallSeconds(void);
+static void ReportQueueDrops(void);
+static void ReportOverruns(void);
+static void ReportArena(const ArenaSim_t *pArena);
+#ifdef ES_VERIFY_STEADY
+static int CompareTwins(Robot_t *pRobot, Robot_t *pTwin);
+#endif
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(int argc, char **argv) {
+    Robot_t *pRobots;
+    pthread_t *pThreads;
+    uint32_t RunTicks = DEFAULT_RUN_TICKS;
+    uint32_t RunBudget = ES_RUN_BUDGET_US;
+    int NumRobots = 1;
+    int NumRuns;
+    int UseArena = FALSE;
+    const char *TracePath = NULL;
+    const char *RecordPath = NULL;
+    const char *PlayPath = NULL;
+    int RunTicksSet = FALSE;
+    double Start, Elapsed;
+    int ConsoleFd = -1;
+    int PrintStats = FALSE;
+    int PrintLatency = FALSE;
+    int Failed = FALSE;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+            RunTicks = strtoul(argv[++i], NULL, 0);
+            RunTicksSet = TRUE;
+        } else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc)) {
+            NumRobots = atoi(argv[++i]);
+            if ((NumRobots < 1) || (NumRobots > MAX_ROBOTS)) {
+                fprintf(stderr, "%s: 1 to %d robots\n", argv[0], MAX_ROBOTS);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-a") == 0) {
+            UseArena = TRUE;
+        } else if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc)) {
+            RunBudget = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-q") == 0) {
+            ConsoleFd = dup(STDOUT_FILENO); // kept for the statistics
+            if (freopen("/dev/null", "w", stdout) == NULL) {
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-s") == 0) {
+            PrintStats = TRUE;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            PrintLatency = TRUE;
+        } else if ((strcmp(argv[i], "-T") == 0) && (i + 1 < argc)) {
+            TracePath = argv[++i];
+        } else if ((strcmp(argv[i], "-R") == 0) && (i + 1 < argc)) {
+            RecordPath = argv[++i];
+        } else if ((strcmp(argv[i], "-P") == 0) && (i + 1 < argc)) {
+            PlayPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-t <ms>] [-r <robots>] [-a] [-b <us>] [-q] [-s] [-l] "
+                    "[-T <file>] [-R <file> | -P <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (((RecordPath != NULL) || (PlayPath != NULL)) && (NumRobots > 1)) {
+        fprintf(stderr, "%s: -R and -P run one robot\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((PlayPath != NULL) && ((RecordPath != NULL) || UseArena)) {
+        fprintf(stderr, "%s: -P drives the sensors itself, without -R or -a\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((PlayPath != NULL) && !RunTicksSet) {
+        RunTicks = SensorTrace_Length(PlayPath);
+        if (RunTicks == 0) {
+            fprintf(stderr, "%s: %s is not a sensor recording\n", argv[0], PlayPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // with ES_VERIFY_STEADY the twins follow the robots
+    NumRuns = NumRobots;
+#ifdef ES_VERIFY_STEADY
+    NumRuns = 2 * NumRobots;
+#endif
+    pRobots = calloc(NumRuns, sizeof (Robot_t));
+    pThreads = calloc(NumRuns, sizeof (pthread_t));
+    if ((pRobots == NULL) || (pThreads == NULL)) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < NumRuns; i++) {
+        pRobots[i].pBot = calloc(1, sizeof (Bot_t));
+        pRobots[i].pBoard = calloc(1, sizeof (HostBoard_t));
+        if ((pRobots[i].pBot == NULL) || (pRobots[i].pBoard == NULL)) {
+            return EXIT_FAILURE;
+        }
+        pRobots[i].RunTicks = RunTicks;
+        pRobots[i].RunBudget = RunBudget;
+        pRobots[i].UseArena = UseArena;
+        pRobots[i].RecordPath = RecordPath;
+        pRobots[i].PlayPath = PlayPath;
+#ifdef ES_VERIFY_STEADY
+        if (i >= NumRobots) {
+            pRobots[i].RecordPath = NULL;
+            pRobots[i].FixedTick = TRUE;
+        }
+#endif
+    }
+    if (TracePath != NULL) {
+        SelectRobot(&pRobots[0]);
+        if (ES_Port_SetTraceFile(TracePath) != TRUE) {
+            perror(TracePath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    Start = WallSeconds();
+    if (NumRuns == 1) {
+        RunRobot(&pRobots[0]);
+    } else {
+        for (i = 0; i < NumRuns; i++) {
+            if (pthread_create(&pThreads[i], NULL, RunRobot, &pRobots[i]) != 0) {
+                perror("pthread_create");
+                return EXIT_FAILURE;
+            }
+        }
+        for (i = 0; i < NumRuns; i++) {
+            pthread_join(pThreads[i], NULL);
+        }
+    }
+    Elapsed = WallSeconds() - Start;
+    fflush(stdout);
+
+    for (i = 0; i < NumRuns; i++) {
+        if (pRobots[i].ErrorType != Success) {
+            fprintf(stderr, "robot %d: ES_Run failed: %d\n", i, pRobots[i].ErrorType);
+            Failed = TRUE;
+        }
+    }
+    if (Failed) {
+        return EXIT_FAILURE;
+    }
+    if (NumRobots == 1) {
+        fprintf(stderr, "ran %lu virtual ms in %.3f s (%.0fx real time)\n",
+                (unsigned long) RunTicks, Elapsed,
+                (Elapsed > 0) ? (RunTicks / 1000.0) / Elapsed : 0.0);
+    } else {
+        fprintf(stderr, "ran %d robots for %lu virtual ms each in %.3f s (%.0fx real time)\n",
+                NumRobots, (unsigned long) RunTicks, Elapsed,
+                (Elapsed > 0) ? (NumRobots * (RunTicks / 1000.0)) / Elapsed : 0.0);
+    }
+#ifdef ES_VERIFY_STEADY
+    for (i = 0; i < NumRobots; i++) {
+        if (NumRobots > 1) {
+            fprintf(stderr, "robot %d: ", i);
+        }
+        if (!CompareTwins(&pRobots[i], &pRobots[NumRobots + i])) {
+            Failed = TRUE;
+        }
+    }
+    if (Failed) {
+        return EXIT_FAILURE;
+    }
+#endif
+    if ((ConsoleFd >= 0) && (PrintStats || PrintLatency)) {
+        dup2(ConsoleFd, STDOUT_FILENO);
+    }
+    for (i = 0; i < NumRobots; i++) {
+        SelectRobot(&pRobots[i]);
+        ReportQueueDrops();
+        ReportOverruns();
+        if (UseArena) {
+            if (NumRobots > 1) {
+                fprintf(stderr, "robot %d: ", i);
+            }
+            ReportArena(&pRobots[i].Arena);
+        }
+        if (RecordPath != NULL) {
+            if (!SensorTrace_Close(&pRobots[i].Sensors)) {
+                perror(RecordPath);
+                return EXIT_FAILURE;
+            }
+            fprintf(stderr, "recorded %lu samples to %s\n",
+                    (unsigned long) pRobots[i].Sensors.Samples, RecordPath);
+        }
+        if (PlayPath != NULL) {
+            fprintf(stderr, "played back %lu samples of %s\n",
+                    (unsigned long) pRobots[i].Sensors.Samples, PlayPath);
+            SensorTrace_Close(&pRobots[i].Sensors);
+        }
+        ES_TraceDrain(); // whatever the last pass of the run loop left behind
+        if (ES_TraceDrops() > 0) {
+            fprintf(stderr, "trace lost %lu records\n", (unsigned long) ES_TraceDrops());
+        }
+        if ((NumRobots > 1) && (PrintStats || PrintLatency)) {
+            printf("robot %d:\n", i);
+        }
+        if (PrintStats) {
+            ES_PrintQueueStats();
+            ES_PrintRunStats();
+        }
+        if (PrintLatency) {
+            ES_PrintLatencyHistograms();
+        }
+    }
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// brings one robot up and runs it, on the thread it is given to
+static void *RunRobot(void *pArg) {
+    Robot_t *pRobot = pArg;
+    ArenaConfig_t Config;
+
+    SelectRobot(pRobot);
+#ifdef ES_VERIFY_STEADY
+    if (pRobot->FixedTick) {
+        ES_Port_SetFixedTick();
+    }
+#endif
+    BOARD_Init();
+    PWM_Init();
+    motors_Init();
+    sensors_Init();
+    LED_Init();
+    LED_AddBanks(LED_BANK1 | LED_BANK2 | LED_BANK3);
+    LED_OnBank(LED_BANK1, 0xF);
+    LED_OnBank(LED_BANK2, 0xF);
+    LED_OnBank(LED_BANK3, 0xF);
+    if (pRobot->UseArena) {
+        ArenaSim_DefaultConfig(&Config);
+        ArenaSim_Init(&pRobot->Arena, &Config);
+    }
+    if ((pRobot->PlayPath != NULL) && !SensorTrace_Play(&pRobot->Sensors, pRobot->PlayPath)) {
+        fprintf(stderr, "%s: not a sensor recording\n", pRobot->PlayPath);
+        exit(EXIT_FAILURE);
+    }
+    if ((pRobot->RecordPath != NULL)
+            && !SensorTrace_Record(&pRobot->Sensors, pRobot->RecordPath)) {
+        perror(pRobot->RecordPath);
+        exit(EXIT_FAILURE);
+    }
+    if (pRobot->UseArena || (pRobot->PlayPath != NULL) || (pRobot->RecordPath != NULL)) {
+        ES_Port_SetTickHook(RobotTick, pRobot);
+    }
+
+    ES_Port_SetRunLimit(pRobot->RunTicks);
+    pRobot->ErrorType = ES_Initialize();
+    if (pRobot->ErrorType == Success) {
+        ES_SetRunBudget(pRobot->RunBudget);
+        pRobot->ErrorType = ES_Run();
+    }
+    return NULL;
+}
+
+// what drives the sensors, then what records them; the inputs hold as long as
+// all of them say
+static uint32_t RobotTick(void *pArg, uint32_t Ticks) {
+    Robot_t *pRobot = pArg;
+    uint32_t Steady = ES_PORT_STEADY_FOREVER;
+    uint32_t Hook;
+
+    if (pRobot->UseArena) {
+        Steady = ArenaSim_Tick(&pRobot->Arena, Ticks);
+    }
+    if (pRobot->PlayPath != NULL) {
+        Hook = SensorTrace_PlayTick(&pRobot->Sensors, Ticks);
+        Steady = (Hook < Steady) ? Hook : Steady;
+    }
+    if (pRobot->RecordPath != NULL) {
+        SensorTrace_RecordTick(&pRobot->Sensors, Ticks);
+    }
+    return Steady;
+}
+
+// makes the robot's framework context and board the calling thread's
+static void SelectRobot(Robot_t *pRobot) {
+    ES_SetContext(&pRobot->pBot->Framework);
+    HostBoard_Select(pRobot->pBoard);
+}
+
+static double WallSeconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void ReportQueueDrops(void) {
+    ES_EventTyp_t LastDropped;
+    uint32_t Drops;
+    uint8_t i;
+
+    for (i = 0; i < NUM_SERVICES; i++) {
+        Drops = ES_GetQueueDrops(i, &LastDropped);
+        if (Drops > 0) {
+            fprintf(stderr, "service %u dropped %lu events, last %s\n", i,
+                    (unsigned long) Drops, EventNames[LastDropped]);
+        }
+    }
+}
+
+static void ReportOverruns(void) {
+    ES_RunStats_t Stats;
+    uint8_t i;
+
+    for (i = 0; ES_GetRunStats(i, &Stats); i++) {
+        if (Stats.Overruns > 0) {
+            fprintf(stderr, "service %u went over its run budget %lu times, worst %lu us "
+                    "in state %u on %s\n", i, (unsigned long) Stats.Overruns,
+                    (unsigned long) (Stats.MaxRunTime / ES_PORT_STAMPS_PER_US), Stats.MaxState,
+                    EventNames[Stats.MaxEvent]);
+        }
+    }
+}
+
+static void ReportArena(const ArenaSim_t *pArena) {
+    const ArenaStats_t *pStats = &pArena->Stats;
+
+    fprintf(stderr, "arena: %.1f m driven, %lu collisions, %lu tape crossings, %lu deposits",
+            pStats->Distance / 1000.0, (unsigned long) pStats->Collisions,
+            (unsigned long) pStats->TapeCrossings, (unsigned long) pStats->Deposits);
+    if (pStats->Deposits > 0) {
+        fprintf(stderr, ", the first at %lu ms", (unsigned long) pStats->FirstDeposit);
+    }
+    fprintf(stderr, ", ended at (%.0f, %.0f) facing %.0f deg\n", pArena->X, pArena->Y,
+            pArena->Heading * 180.0 / M_PI);
+}
+
+#ifdef ES_VERIFY_STEADY
+// the events the robot was dispatched against those of its fixed-tick twin;
+// FALSE, with the first difference on stderr, if they are not the same
+static int CompareTwins(Robot_t *pRobot, Robot_t *pTwin) {
+    const ES_PortDispatch_t *pLog;
+    const ES_PortDispatch_t *pTwinLog;
+    const ES_PortDispatch_t *pOne;
+    const ES_PortDispatch_t *pOther;
+    uint32_t Num, TwinNum, i;
+
+    SelectRobot(pRobot);
+    Num = ES_Port_GetDispatches(&pLog);
+    SelectRobot(pTwin);
+    TwinNum = ES_Port_GetDispatches(&pTwinLog);
+    for (i = 0; (i < Num) && (i < TwinNum); i++) {
+        pOne = &pLog[i];
+        pOther = &pTwinLog[i];
+        if ((pOne->Tick != pOther->Tick) || (pOne->Service != pOther->Service)
+                || (pOne->EventType != pOther->EventType)
+                || (pOne->EventParam != pOther->EventParam)) {
+            fprintf(stderr, "dispatch %lu was service %u %s(%u) at %lu ms, stepping every tick "
+                    "service %u %s(%u) at %lu ms\n", (unsigned long) i, pOne->Service,
+                    EventNames[pOne->EventType], pOne->EventParam, (unsigned long) pOne->Tick,
+                    pOther->Service, EventNames[pOther->EventType], pOther->EventParam,
+                    (unsigned long) pOther->Tick);
+            return FALSE;
+        }
+    }
+    if (Num != TwinNum) {
+        fprintf(stderr, "%lu dispatches, stepping every tick %lu\n", (unsigned long) Num,
+                (unsigned long) TwinNum);
+        return FALSE;
+    }
+    fprintf(stderr, "%lu dispatches, the same as stepping every tick\n", (unsigned long) Num);
+    return TRUE;
+}
+#endif
@@ -0,0 +1,197 @@
+/*
+ * File: IO_Ports.h
+ *
+ * Linux host stand-in for the Uno32 IO_Ports library. Every pin of the V, W,
+ * X, Y and Z headers is a plain struct in memory instead of a register bit:
+ * the application writes PORTxnn_TRIS and PORTxnn_LAT, and reads PORTxnn_BIT,
+ * which the host harness (or a simulator) drives.
+ */
+
+#ifndef IO_PORTS_H
+#define IO_PORTS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t TRIS; // 1 = input, 0 = output
+    uint8_t LAT; // output latch written by the application
+    uint8_t BIT; // input value read by the application
+} IO_HostPin_t;
+
+typedef enum {
+    IO_PIN_V03,
+    IO_PIN_V04,
+    IO_PIN_V05,
+    IO_PIN_V06,
+    IO_PIN_V07,
+    IO_PIN_V08,
+    IO_PIN_W03,
+    IO_PIN_W04,
+    IO_PIN_W05,
+    IO_PIN_W06,
+    IO_PIN_W07,
+    IO_PIN_W08,
+    IO_PIN_X03,
+    IO_PIN_X04,
+    IO_PIN_X05,
+    IO_PIN_X06,
+    IO_PIN_X07,
+    IO_PIN_X08,
+    IO_PIN_X09,
+    IO_PIN_X10,
+    IO_PIN_X11,
+    IO_PIN_X12,
+    IO_PIN_Y03,
+    IO_PIN_Y04,
+    IO_PIN_Y05,
+    IO_PIN_Y06,
+    IO_PIN_Y07,
+    IO_PIN_Y08,
+    IO_PIN_Y09,
+    IO_PIN_Y10,
+    IO_PIN_Y11,
+    IO_PIN_Y12,
+    IO_PIN_Z03,
+    IO_PIN_Z04,
+    IO_PIN_Z05,
+    IO_PIN_Z06,
+    IO_PIN_Z07,
+    IO_PIN_Z08,
+    IO_PIN_Z09,
+    IO_PIN_Z10,
+    IO_PIN_Z11,
+    IO_PIN_Z12,
+    IO_NUM_PINS
+} IO_HostPinNum_t;
+
+// the pins of the board HostBoard_Select() made current, per thread
+extern __thread IO_HostPin_t *IO_HostPins;
+
+#define PORTV03_TRIS IO_HostPins[IO_PIN_V03].TRIS
+#define PORTV03_LAT IO_HostPins[IO_PIN_V03].LAT
+#define PORTV03_BIT IO_HostPins[IO_PIN_V03].BIT
+#define PORTV04_TRIS IO_HostPins[IO_PIN_V04].TRIS
+#define PORTV04_LAT IO_HostPins[IO_PIN_V04].LAT
+#define PORTV04_BIT IO_HostPins[IO_PIN_V04].BIT
+#define PORTV05_TRIS IO_HostPins[IO_PIN_V05].TRIS
+#define PORTV05_LAT IO_HostPins[IO_PIN_V05].LAT
+#define PORTV05_BIT IO_HostPins[IO_PIN_V05].BIT
+#define PORTV06_TRIS IO_HostPins[IO_PIN_V06].TRIS
+#define PORTV06_LAT IO_HostPins[IO_PIN_V06].LAT
+#define PORTV06_BIT IO_HostPins[IO_PIN_V06].BIT
+#define PORTV07_TRIS IO_HostPins[IO_PIN_V07].TRIS
+#define PORTV07_LAT IO_HostPins[IO_PIN_V07].LAT
+#define PORTV07_BIT IO_HostPins[IO_PIN_V07].BIT
+#define PORTV08_TRIS IO_HostPins[IO_PIN_V08].TRIS
+#define PORTV08_LAT IO_HostPins[IO_PIN_V08].LAT
+#define PORTV08_BIT IO_HostPins[IO_PIN_V08].BIT
+#define PORTW03_TRIS IO_HostPins[IO_PIN_W03].TRIS
+#define PORTW03_LAT IO_HostPins[IO_PIN_W03].LAT
+#define PORTW03_BIT IO_HostPins[IO_PIN_W03].BIT
+#define PORTW04_TRIS IO_HostPins[IO_PIN_W04].TRIS
+#define PORTW04_LAT IO_HostPins[IO_PIN_W04].LAT
+#define PORTW04_BIT IO_HostPins[IO_PIN_W04].BIT
+#define PORTW05_TRIS IO_HostPins[IO_PIN_W05].TRIS
+#define PORTW05_LAT IO_HostPins[IO_PIN_W05].LAT
+#define PORTW05_BIT IO_HostPins[IO_PIN_W05].BIT
+#define PORTW06_TRIS IO_HostPins[IO_PIN_W06].TRIS
+#define PORTW06_LAT IO_HostPins[IO_PIN_W06].LAT
+#define PORTW06_BIT IO_HostPins[IO_PIN_W06].BIT
+#define PORTW07_TRIS IO_HostPins[IO_PIN_W07].TRIS
+#define PORTW07_LAT IO_HostPins[IO_PIN_W07].LAT
+#define PORTW07_BIT IO_HostPins[IO_PIN_W07].BIT
+#define PORTW08_TRIS IO_HostPins[IO_PIN_W08].TRIS
+#define PORTW08_LAT IO_HostPins[IO_PIN_W08].LAT
+#define PORTW08_BIT IO_HostPins[IO_PIN_W08].BIT
+#define PORTX03_TRIS IO_HostPins[IO_PIN_X03].TRIS
+#define PORTX03_LAT IO_HostPins[IO_PIN_X03].LAT
+#define PORTX03_BIT IO_HostPins[IO_PIN_X03].BIT
+#define PORTX04_TRIS IO_HostPins[IO_PIN_X04].TRIS
+#define PORTX04_LAT IO_HostPins[IO_PIN_X04].LAT
+#define PORTX04_BIT IO_HostPins[IO_PIN_X04].BIT
+#define PORTX05_TRIS IO_HostPins[IO_PIN_X05].TRIS
+#define PORTX05_LAT IO_HostPins[IO_PIN_X05].LAT
+#define PORTX05_BIT IO_HostPins[IO_PIN_X05].BIT
+#define PORTX06_TRIS IO_HostPins[IO_PIN_X06].TRIS
+#define PORTX06_LAT IO_HostPins[IO_PIN_X06].LAT
+#define PORTX06_BIT IO_HostPins[IO_PIN_X06].BIT
+#define PORTX07_TRIS IO_HostPins[IO_PIN_X07].TRIS
+#define PORTX07_LAT IO_HostPins[IO_PIN_X07].LAT
+#define PORTX07_BIT IO_HostPins[IO_PIN_X07].BIT
+#define PORTX08_TRIS IO_HostPins[IO_PIN_X08].TRIS
+#define PORTX08_LAT IO_HostPins[IO_PIN_X08].LAT
+#define PORTX08_BIT IO_HostPins[IO_PIN_X08].BIT
+#define PORTX09_TRIS IO_HostPins[IO_PIN_X09].TRIS
+#define PORTX09_LAT IO_HostPins[IO_PIN_X09].LAT
+#define PORTX09_BIT IO_HostPins[IO_PIN_X09].BIT
+#define PORTX10_TRIS IO_HostPins[IO_PIN_X10].TRIS
+#define PORTX10_LAT IO_HostPins[IO_PIN_X10].LAT
+#define PORTX10_BIT IO_HostPins[IO_PIN_X10].BIT
+#define PORTX11_TRIS IO_HostPins[IO_PIN_X11].TRIS
+#define PORTX11_LAT IO_HostPins[IO_PIN_X11].LAT
+#define PORTX11_BIT IO_HostPins[IO_PIN_X11].BIT
+#define PORTX12_TRIS IO_HostPins[IO_PIN_X12].TRIS
+#define PORTX12_LAT IO_HostPins[IO_PIN_X12].LAT
+#define PORTX12_BIT IO_HostPins[IO_PIN_X12].BIT
+#define PORTY03_TRIS IO_HostPins[IO_PIN_Y03].TRIS
+#define PORTY03_LAT IO_HostPins[IO_PIN_Y03].LAT
+#define PORTY03_BIT IO_HostPins[IO_PIN_Y03].BIT
+#define PORTY04_TRIS IO_HostPins[IO_PIN_Y04].TRIS
+#define PORTY04_LAT IO_HostPins[IO_PIN_Y04].LAT
+#define PORTY04_BIT IO_HostPins[IO_PIN_Y04].BIT
+#define PORTY05_TRIS IO_HostPins[IO_PIN_Y05].TRIS
+#define PORTY05_LAT IO_HostPins[IO_PIN_Y05].LAT
+#define PORTY05_BIT IO_HostPins[IO_PIN_Y05].BIT
+#define PORTY06_TRIS IO_HostPins[IO_PIN_Y06].TRIS
+#define PORTY06_LAT IO_HostPins[IO_PIN_Y06].LAT
+#define PORTY06_BIT IO_HostPins[IO_PIN_Y06].BIT
+#define PORTY07_TRIS IO_HostPins[IO_PIN_Y07].TRIS
+#define PORTY07_LAT IO_HostPins[IO_PIN_Y07].LAT
+#define PORTY07_BIT IO_HostPins[IO_PIN_Y07].BIT
+#define PORTY08_TRIS IO_HostPins[IO_PIN_Y08].TRIS
+#define PORTY08_LAT IO_HostPins[IO_PIN_Y08].LAT
+#define PORTY08_BIT IO_HostPins[IO_PIN_Y08].BIT
+#define PORTY09_TRIS IO_HostPins[IO_PIN_Y09].TRIS
+#define PORTY09_LAT IO_HostPins[IO_PIN_Y09].LAT
+#define PORTY09_BIT IO_HostPins[IO_PIN_Y09].BIT
+#define PORTY10_TRIS IO_HostPins[IO_PIN_Y10].TRIS
+#define PORTY10_LAT IO_HostPins[IO_PIN_Y10].LAT
+#define PORTY10_BIT IO_HostPins[IO_PIN_Y10].BIT
+#define PORTY11_TRIS IO_HostPins[IO_PIN_Y11].TRIS
+#define PORTY11_LAT IO_HostPins[IO_PIN_Y11].LAT
+#define PORTY11_BIT IO_HostPins[IO_PIN_Y11].BIT
+#define PORTY12_TRIS IO_HostPins[IO_PIN_Y12].TRIS
+#define PORTY12_LAT IO_HostPins[IO_PIN_Y12].LAT
+#define PORTY12_BIT IO_HostPins[IO_PIN_Y12].BIT
+#define PORTZ03_TRIS IO_HostPins[IO_PIN_Z03].TRIS
+#define PORTZ03_LAT IO_HostPins[IO_PIN_Z03].LAT
+#define PORTZ03_BIT IO_HostPins[IO_PIN_Z03].BIT
+#define PORTZ04_TRIS IO_HostPins[IO_PIN_Z04].TRIS
+#define PORTZ04_LAT IO_HostPins[IO_PIN_Z04].LAT
+#define PORTZ04_BIT IO_HostPins[IO_PIN_Z04].BIT
+#define PORTZ05_TRIS IO_HostPins[IO_PIN_Z05].TRIS
+#define PORTZ05_LAT IO_HostPins[IO_PIN_Z05].LAT
+#define PORTZ05_BIT IO_HostPins[IO_PIN_Z05].BIT
+#define PORTZ06_TRIS IO_HostPins[IO_PIN_Z06].TRIS
+#define PORTZ06_LAT IO_HostPins[IO_PIN_Z06].LAT
+#define PORTZ06_BIT IO_HostPins[IO_PIN_Z06].BIT
+#define PORTZ07_TRIS IO_HostPins[IO_PIN_Z07].TRIS
+#define PORTZ07_LAT IO_HostPins[IO_PIN_Z07].LAT
+#define PORTZ07_BIT IO_HostPins[IO_PIN_Z07].BIT
+#define PORTZ08_TRIS IO_HostPins[IO_PIN_Z08].TRIS
+#define PORTZ08_LAT IO_HostPins[IO_PIN_Z08].LAT
+#define PORTZ08_BIT IO_HostPins[IO_PIN_Z08].BIT
+#define PORTZ09_TRIS IO_HostPins[IO_PIN_Z09].TRIS
+#define PORTZ09_LAT IO_HostPins[IO_PIN_Z09].LAT
+#define PORTZ09_BIT IO_HostPins[IO_PIN_Z09].BIT
+#define PORTZ10_TRIS IO_HostPins[IO_PIN_Z10].TRIS
+#define PORTZ10_LAT IO_HostPins[IO_PIN_Z10].LAT
+#define PORTZ10_BIT IO_HostPins[IO_PIN_Z10].BIT
+#define PORTZ11_TRIS IO_HostPins[IO_PIN_Z11].TRIS
+#define PORTZ11_LAT IO_HostPins[IO_PIN_Z11].LAT
+#define PORTZ11_BIT IO_HostPins[IO_PIN_Z11].BIT
+#define PORTZ12_TRIS IO_HostPins[IO_PIN_Z12].TRIS
+#define PORTZ12_LAT IO_HostPins[IO_PIN_Z12].LAT
+#define PORTZ12_BIT IO_HostPins[IO_PIN_Z12].BIT
+
+#endif /* IO_PORTS_H */
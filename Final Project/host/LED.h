@@ -0,0 +1,32 @@
+/*
+ * File: LED.h
+ *
+ * Linux host stand-in for the Uno32 LED bank library.
+ */
+
+#ifndef LED_H
+#define LED_H
+
+#include <stdint.h>
+
+#define LED_BANK1 0x01
+#define LED_BANK2 0x02
+#define LED_BANK3 0x04
+
+char LED_Init(void);
+
+char LED_AddBanks(uint8_t bank);
+
+char LED_RemoveBanks(uint8_t bank);
+
+char LED_OnBank(uint8_t bank, uint8_t pattern);
+
+char LED_OffBank(uint8_t bank, uint8_t pattern);
+
+char LED_InvertBank(uint8_t bank, uint8_t pattern);
+
+char LED_SetBank(uint8_t bank, uint8_t pattern);
+
+uint8_t LED_GetBank(uint8_t bank);
+
+#endif /* LED_H */
@@ -0,0 +1,41 @@
+/*
+ * File: RC_Servo.h
+ *
+ * Linux host stand-in for the Uno32 RC servo library. Pulse times are kept in
+ * memory so the host harness can read back what the application commanded.
+ */
+
+#ifndef RC_SERVO_H
+#define RC_SERVO_H
+
+#include <stdint.h>
+
+#define RC_PORTX03 ((uint16_t)(1 << 0))
+#define RC_PORTY06 ((uint16_t)(1 << 1))
+#define RC_PORTZ08 ((uint16_t)(1 << 2))
+#define RC_PORTZ09 ((uint16_t)(1 << 3))
+#define RC_PORTV03 ((uint16_t)(1 << 4))
+#define RC_PORTV04 ((uint16_t)(1 << 5))
+#define RC_PORTW07 ((uint16_t)(1 << 6))
+#define RC_PORTW08 ((uint16_t)(1 << 7))
+
+#define RC_NUM_PINS 8
+
+#define MINPULSE 1000
+#define MAXPULSE 2000
+
+char RC_Init(void);
+
+char RC_AddPins(unsigned short int RCpins);
+
+char RC_RemovePins(unsigned short int RCpins);
+
+unsigned short int RC_ActivePins(void);
+
+char RC_SetPulseTime(unsigned short int RCpin, unsigned short int pulseTime);
+
+unsigned short int RC_GetPulseTime(unsigned short int RCpin);
+
+char RC_End(void);
+
+#endif /* RC_SERVO_H */
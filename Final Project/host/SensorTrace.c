@@ -0,0 +1,209 @@
+/*
+ * File: SensorTrace.c
+ *
+ * Records sensor samples to a file and plays them back into the stand-in
+ * peripherals, see SensorTrace.h.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Port.h"
+#include "HostBoard.h"
+#include "SensorTrace.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void WriteSample(SensorTrace_t *pTrace, const SensorSample_t *pSample);
+static uint8_t NextSample(SensorTrace_t *pTrace, SensorSample_t *pSample);
+static void SetInputs(const SensorSample_t *pSample);
+static uint8_t Load(SensorTrace_t *pTrace, const char *Path);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t SensorTrace_Record(SensorTrace_t *pTrace, const char *Path) {
+    static const uint8_t Header[SENSOR_TRACE_HEADER_LENGTH] = {'E', 'S', 'S', 'L',
+        SENSOR_TRACE_VERSION};
+    SensorSample_t Sample;
+
+    memset(pTrace, 0, sizeof (SensorTrace_t));
+    pTrace->pFile = fopen(Path, "wb");
+    if (pTrace->pFile == NULL) {
+        return FALSE;
+    }
+    fwrite(Header, 1, SENSOR_TRACE_HEADER_LENGTH, pTrace->pFile);
+    SensorLog_Begin(&pTrace->Log);
+    SensorLog_Read(&Sample);
+    WriteSample(pTrace, &Sample);
+    return TRUE;
+}
+
+uint32_t SensorTrace_RecordTick(void *pArg, uint32_t Ticks) {
+    SensorTrace_t *pTrace = pArg;
+    SensorSample_t Sample;
+
+    // more than one tick only while the inputs hold, so they all read the same
+    if (Ticks > 0) {
+        SensorLog_Read(&Sample);
+    }
+    while (Ticks-- > 0) {
+        WriteSample(pTrace, &Sample);
+    }
+    return ES_PORT_STEADY_FOREVER;
+}
+
+uint8_t SensorTrace_Play(SensorTrace_t *pTrace, const char *Path) {
+    SensorSample_t Sample;
+
+    memset(pTrace, 0, sizeof (SensorTrace_t));
+    if (!Load(pTrace, Path)) {
+        return FALSE;
+    }
+    if (!NextSample(pTrace, &Sample)) {
+        SensorTrace_Close(pTrace);
+        return FALSE;
+    }
+    SetInputs(&Sample);
+    return TRUE;
+}
+
+uint32_t SensorTrace_PlayTick(void *pArg, uint32_t Ticks) {
+    SensorTrace_t *pTrace = pArg;
+    SensorSample_t Sample;
+    uint8_t Changed = FALSE;
+
+    while ((Ticks-- > 0) && NextSample(pTrace, &Sample)) {
+        Changed = TRUE;
+    }
+    if (Changed) {
+        SetInputs(&Sample);
+    }
+    // the rest of a run of samples is known to be the same
+    return pTrace->Ended ? ES_PORT_STEADY_FOREVER : pTrace->Log.Repeats;
+}
+
+uint32_t SensorTrace_Length(const char *Path) {
+    SensorTrace_t Trace;
+    SensorSample_t Sample;
+
+    memset(&Trace, 0, sizeof (SensorTrace_t));
+    if (!Load(&Trace, Path)) {
+        return 0;
+    }
+    while (NextSample(&Trace, &Sample)) {
+    }
+    SensorTrace_Close(&Trace);
+    return (Trace.Samples > 0) ? Trace.Samples - 1 : 0;
+}
+
+uint8_t SensorTrace_Close(SensorTrace_t *pTrace) {
+    uint8_t Record[SENSOR_LOG_MAX_RECORD];
+    uint8_t Length;
+    uint8_t Written = TRUE;
+
+    if (pTrace->pFile != NULL) {
+        Length = SensorLog_Flush(&pTrace->Log, Record);
+        fwrite(Record, 1, Length, pTrace->pFile);
+        Written = (ferror(pTrace->pFile) == 0);
+        if (fclose(pTrace->pFile) != 0) {
+            Written = FALSE;
+        }
+        pTrace->pFile = NULL;
+    }
+    free(pTrace->pData);
+    pTrace->pData = NULL;
+    return Written;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+static void WriteSample(SensorTrace_t *pTrace, const SensorSample_t *pSample) {
+    uint8_t Record[SENSOR_LOG_MAX_RECORD];
+    uint8_t Length = SensorLog_Encode(&pTrace->Log, pSample, Record);
+
+    if (Length > 0) {
+        fwrite(Record, 1, Length, pTrace->pFile);
+    }
+    pTrace->Samples++;
+}
+
+// FALSE once the recording has ended
+static uint8_t NextSample(SensorTrace_t *pTrace, SensorSample_t *pSample) {
+    int Used;
+
+    if (pTrace->Ended) {
+        return FALSE;
+    }
+    Used = SensorLog_Decode(&pTrace->Log, &pTrace->pData[pTrace->Position],
+            pTrace->Length - pTrace->Position, pSample);
+    if (Used < 0) {
+        pTrace->Ended = TRUE;
+        return FALSE;
+    }
+    pTrace->Position += Used;
+    pTrace->Samples++;
+    return TRUE;
+}
+
+// the inverse of what sensors.c reads
+static void SetInputs(const SensorSample_t *pSample) {
+    HostBoard_SetAD(AD_PORTV3, pSample->TrackWireR);
+    HostBoard_SetAD(AD_PORTV4, pSample->TrackWireL);
+    HostBoard_SetAD(AD_PORTW8, pSample->Beacon);
+    HostBoard_SetAD(BAT_VOLTAGE, pSample->Battery);
+    PORTX05_BIT = (pSample->Tape >> 3) & 1; // front left
+    PORTX04_BIT = (pSample->Tape >> 2) & 1;
+    PORTX03_BIT = (pSample->Tape >> 1) & 1;
+    PORTX06_BIT = pSample->Tape & 1;
+    PORTV06_BIT = (pSample->Bumpers >> 3) & 1; // front left
+    PORTV05_BIT = (pSample->Bumpers >> 2) & 1;
+    PORTV08_BIT = (pSample->Bumpers >> 1) & 1;
+    PORTV07_BIT = pSample->Bumpers & 1;
+    PORTW04_BIT = (pSample->TopBumpers >> 1) & 1; // top left
+    PORTW03_BIT = pSample->TopBumpers & 1;
+    PORTW05_BIT = pSample->Walls & 1;
+    PORTW06_BIT = (pSample->Walls >> 1) & 1;
+}
+
+// reads the whole recording and checks its header
+static uint8_t Load(SensorTrace_t *pTrace, const char *Path) {
+    FILE *pFile = fopen(Path, "rb");
+    long Length;
+
+    if (pFile == NULL) {
+        return FALSE;
+    }
+    if ((fseek(pFile, 0, SEEK_END) != 0) || ((Length = ftell(pFile)) < SENSOR_TRACE_HEADER_LENGTH)
+            || (fseek(pFile, 0, SEEK_SET) != 0)) {
+        fclose(pFile);
+        return FALSE;
+    }
+    pTrace->pData = malloc(Length);
+    if ((pTrace->pData == NULL) || (fread(pTrace->pData, 1, Length, pFile) != Length)) {
+        fclose(pFile);
+        free(pTrace->pData);
+        pTrace->pData = NULL;
+        return FALSE;
+    }
+    fclose(pFile);
+    if ((memcmp(pTrace->pData, SENSOR_TRACE_MAGIC, SENSOR_TRACE_MAGIC_LENGTH) != 0)
+            || (pTrace->pData[SENSOR_TRACE_MAGIC_LENGTH] != SENSOR_TRACE_VERSION)) {
+        free(pTrace->pData);
+        pTrace->pData = NULL;
+        return FALSE;
+    }
+    pTrace->Length = Length;
+    pTrace->Position = SENSOR_TRACE_HEADER_LENGTH;
+    SensorLog_Begin(&pTrace->Log);
+    return TRUE;
+}
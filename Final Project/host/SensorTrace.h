@@ -0,0 +1,92 @@
+/*
+ * File: SensorTrace.h
+ *
+ * Sensor recordings on the host: a file of the samples of SensorLog.h, one a
+ * tick, recorded from whatever drives the stand-in peripherals or played back
+ * into them. A recording starts with the four bytes "ESSL" and a version
+ * byte, then the records of SensorLog.h; its first sample is what the
+ * sensors read before the framework starts, every other one what they read
+ * through one tick. Played back, the samples set the pins and A/D readings
+ * sensors.c reads, so BotService and the event checkers see exactly what
+ * they saw when it was recorded and post the same events.
+ */
+
+#ifndef SENSORTRACE_H
+#define SENSORTRACE_H
+
+#include "SensorLog.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// what a recording starts with, es_trace -r writes it too
+#define SENSOR_TRACE_MAGIC "ESSL"
+#define SENSOR_TRACE_MAGIC_LENGTH 4
+#define SENSOR_TRACE_VERSION 1
+#define SENSOR_TRACE_HEADER_LENGTH (SENSOR_TRACE_MAGIC_LENGTH + 1)
+
+typedef struct {
+    SensorLog_t Log;
+    FILE *pFile; // being recorded to
+    uint8_t *pData; // being played back, the whole recording
+    long Length;
+    long Position;
+    uint32_t Samples; // recorded or played back so far
+    uint8_t Ended; // played back to the end, the last sample holds
+} SensorTrace_t;
+
+/**
+ * @Function SensorTrace_Record(SensorTrace_t *pTrace, const char *Path)
+ * @param pTrace - the recording to start
+ * @param Path - the file to write it to
+ * @return TRUE, or FALSE with errno set if the file cannot be written
+ * @brief Records the first sample, from the board made current with
+ *        HostBoard_Select(). Call it once the sensors read what they should,
+ *        just before ES_Initialize(), and hand SensorTrace_RecordTick() and
+ *        pTrace to ES_Port_SetTickHook() after whatever sets the inputs. */
+uint8_t SensorTrace_Record(SensorTrace_t *pTrace, const char *Path);
+
+/**
+ * @Function SensorTrace_RecordTick(void *pTrace, uint32_t Ticks)
+ * @param pTrace - the SensorTrace_t recording
+ * @param Ticks - how many ticks have gone by
+ * @return ES_PORT_STEADY_FOREVER, a recording never changes the inputs
+ * @brief Records a sample of the board of the calling thread for each tick.
+ *        An ES_PortTickHook_t, or part of one after whatever sets the
+ *        inputs. */
+uint32_t SensorTrace_RecordTick(void *pTrace, uint32_t Ticks);
+
+/**
+ * @Function SensorTrace_Play(SensorTrace_t *pTrace, const char *Path)
+ * @param pTrace - the recording to play back
+ * @param Path - the file it is in
+ * @return TRUE, or FALSE if the file cannot be read or is not a recording
+ * @brief Sets the inputs of the current board to the first sample. Call it
+ *        where SensorTrace_Record() was called, and hand
+ *        SensorTrace_PlayTick() and pTrace to ES_Port_SetTickHook(). */
+uint8_t SensorTrace_Play(SensorTrace_t *pTrace, const char *Path);
+
+/**
+ * @Function SensorTrace_PlayTick(void *pTrace, uint32_t Ticks)
+ * @param pTrace - the SensorTrace_t playing
+ * @param Ticks - how many samples to play
+ * @return the ticks the last of them repeats for, ES_PORT_STEADY_FOREVER once
+ *         the recording has ended
+ * @brief Sets the inputs of the board of the calling thread to the sample
+ *        Ticks on, or leaves them once the recording has ended. An
+ *        ES_PortTickHook_t. */
+uint32_t SensorTrace_PlayTick(void *pTrace, uint32_t Ticks);
+
+/**
+ * @Function SensorTrace_Length(const char *Path)
+ * @param Path - a recording
+ * @return the ticks it covers, its samples less the first, or 0 if it cannot
+ *         be read */
+uint32_t SensorTrace_Length(const char *Path);
+
+/**
+ * @Function SensorTrace_Close(SensorTrace_t *pTrace)
+ * @param pTrace - a recording or a playback
+ * @return TRUE, or FALSE if the end of a recording could not be written */
+uint8_t SensorTrace_Close(SensorTrace_t *pTrace);
+
+#endif /* SENSORTRACE_H */
@@ -0,0 +1,353 @@
+/*
+ * File: SweepMain.c
+ *
+ * Monte-Carlo sweep of the robot's maneuver timings in the simulated arena.
+ * Every parameter set is a BotTimings_t drawn at random around the timings as
+ * built, set 0 being the timings as built, and every set plays the same
+ * matches: match m of every set starts in an arena whose motors and starting
+ * pose are jittered by the same seed, so the sets are compared on equal
+ * terms. A match is won by the first deposit and its mission time is the
+ * virtual ms that took.
+ *
+ * The matches are handed out one at a time to worker threads, each with a
+ * robot and a board of its own and nothing shared but the counter of the
+ * next match and the slot of each result, so the sweep scales with the cores
+ * it is given. The results do not depend on how many threads there are.
+ *
+ *   es_sweep [-n <sets>] [-m <matches>] [-j <threads>] [-t <ms>] [-p <percent>]
+ *            [-s <seed>] [-k <sets>]
+ *     -n  parameter sets to try (default 64)
+ *     -m  matches per set (default 16)
+ *     -j  worker threads (default one per online core)
+ *     -t  virtual ms per match (default 120000)
+ *     -p  how far a timing is drawn from the one as built, in percent either
+ *         way (default 30)
+ *     -s  seed of the parameter sets and the arena noise (default 1)
+ *     -k  best sets to report (default 5)
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ArenaMatch.h"
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define DEFAULT_SETS 64
+#define DEFAULT_MATCHES 16
+#define DEFAULT_RUN_TICKS 120000
+#define DEFAULT_SPREAD 30 // percent
+#define DEFAULT_BEST 5
+#define MAX_THREADS 256
+
+#define HISTOGRAM_BIN 10000 // ms
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+// a field of BotTimings_t and the timing the machines have built in for it
+typedef struct {
+    const char *Name;
+    size_t Offset;
+    uint16_t AsBuilt;
+} Timing_t;
+
+typedef struct {
+    uint32_t Finished; // matches with a deposit
+    double MeanTime; // ms, of those
+    uint32_t MedianTime;
+    uint32_t WorstTime;
+} SetResult_t;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void *Worker(void *pArg);
+static void DrawTimings(BotTimings_t *pTimings, uint32_t Set);
+static int CompareTimes(const void *pA, const void *pB);
+static int CompareSets(const void *pA, const void *pB);
+static void Summarize(uint32_t Set, SetResult_t *pResult);
+static void PrintSet(uint32_t Set);
+static double WallSeconds(void);
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// the timings as built are in the machines that read them
+static const Timing_t Timings[] = {
+    {"Collection1Reverse", offsetof(BotTimings_t, Collection1Reverse), 400},
+    {"Collection2Reverse", offsetof(BotTimings_t, Collection2Reverse), 600},
+    {"Collection2Turn90", offsetof(BotTimings_t, Collection2Turn90), 650},
+    {"DepositDump", offsetof(BotTimings_t, DepositDump), 9500},
+    {"SearchSpin", offsetof(BotTimings_t, SearchSpin), 3000},
+    {"SearchReverse", offsetof(BotTimings_t, SearchReverse), 750},
+    {"SearchTurn", offsetof(BotTimings_t, SearchTurn), 1000},
+    {"SearchShortDrive", offsetof(BotTimings_t, SearchShortDrive), 1000},
+    {"SearchTurn90", offsetof(BotTimings_t, SearchTurn90), 1000},
+    {"SearchInfinity", offsetof(BotTimings_t, SearchInfinity), 4500},
+    {"SearchPark", offsetof(BotTimings_t, SearchPark), 4000},
+};
+
+static uint32_t NumSets = DEFAULT_SETS;
+static uint32_t NumMatches = DEFAULT_MATCHES;
+static uint32_t RunTicks = DEFAULT_RUN_TICKS;
+static uint32_t Spread = DEFAULT_SPREAD;
+static uint64_t Seed = 1;
+
+static BotTimings_t *pSets;
+static uint32_t *pTimes; // set by set, 0 for a match without a deposit
+static uint32_t NextMatch; // taken by the workers with __atomic_fetch_add()
+
+static SetResult_t *pResults;
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(int argc, char **argv) {
+    pthread_t Threads[MAX_THREADS];
+    long NumThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t NumBest = DEFAULT_BEST;
+    uint32_t *pOrder, *pSorted;
+    uint32_t Total, Finished, Bin, NumBins, Count, Width;
+    uint32_t i;
+    double Start, Elapsed;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc)) {
+            NumSets = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+            NumMatches = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc)) {
+            NumThreads = atol(argv[++i]);
+        } else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+            RunTicks = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc)) {
+            Spread = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+            Seed = strtoull(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-k") == 0) && (i + 1 < argc)) {
+            NumBest = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-n <sets>] [-m <matches>] [-j <threads>] [-t <ms>] "
+                    "[-p <percent>] [-s <seed>] [-k <sets>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((NumSets < 1) || (NumMatches < 1) || (Spread > 90)) {
+        fprintf(stderr, "%s: at least one set and one match, a spread of at most 90%%\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (NumThreads < 1) {
+        NumThreads = 1;
+    } else if (NumThreads > MAX_THREADS) {
+        NumThreads = MAX_THREADS;
+    }
+    Total = NumSets * NumMatches;
+
+    pSets = calloc(NumSets, sizeof (BotTimings_t));
+    pTimes = calloc(Total, sizeof (uint32_t));
+    pResults = calloc(NumSets, sizeof (SetResult_t));
+    pOrder = calloc(NumSets, sizeof (uint32_t));
+    pSorted = calloc(Total, sizeof (uint32_t));
+    if ((pSets == NULL) || (pTimes == NULL) || (pResults == NULL) || (pOrder == NULL)
+            || (pSorted == NULL)) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < NumSets; i++) {
+        DrawTimings(&pSets[i], i);
+    }
+    // the machines print as they go; nobody reads it here
+    if (freopen("/dev/null", "w", stdout) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    Start = WallSeconds();
+    for (i = 0; i < NumThreads; i++) {
+        if (pthread_create(&Threads[i], NULL, Worker, NULL) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < NumThreads; i++) {
+        pthread_join(Threads[i], NULL);
+    }
+    Elapsed = WallSeconds() - Start;
+
+    fprintf(stderr, "%lu sets x %lu matches of %lu ms on %ld threads in %.2f s "
+            "(%.0f matches/s, %.0fx real time)\n", (unsigned long) NumSets,
+            (unsigned long) NumMatches, (unsigned long) RunTicks, NumThreads, Elapsed,
+            (Elapsed > 0) ? Total / Elapsed : 0.0,
+            (Elapsed > 0) ? (Total * (RunTicks / 1000.0)) / Elapsed : 0.0);
+
+    // the mission times of every match
+    for (i = 0, Finished = 0; i < Total; i++) {
+        if (pTimes[i] != 0) {
+            pSorted[Finished++] = pTimes[i];
+        }
+    }
+    qsort(pSorted, Finished, sizeof (uint32_t), CompareTimes);
+    fprintf(stderr, "mission time: %lu of %lu matches deposited (%.1f%%)",
+            (unsigned long) Finished, (unsigned long) Total, 100.0 * Finished / Total);
+    if (Finished > 0) {
+        fprintf(stderr, ", p10 %.1f s, p50 %.1f s, p90 %.1f s, best %.1f s",
+                pSorted[Finished / 10] / 1000.0, pSorted[Finished / 2] / 1000.0,
+                pSorted[(Finished * 9) / 10] / 1000.0, pSorted[0] / 1000.0);
+    }
+    fprintf(stderr, "\n");
+    NumBins = (RunTicks + HISTOGRAM_BIN - 1) / HISTOGRAM_BIN;
+    for (Bin = 0, i = 0; (Finished > 0) && (Bin < NumBins); Bin++) {
+        for (Count = 0; (i < Finished) && (pSorted[i] < (Bin + 1) * HISTOGRAM_BIN); i++) {
+            Count++;
+        }
+        Width = (Count * 50 + Finished - 1) / Finished;
+        fprintf(stderr, "  %4lu-%4lu s %6lu %.*s\n", (unsigned long) (Bin * HISTOGRAM_BIN / 1000),
+                (unsigned long) ((Bin + 1) * HISTOGRAM_BIN / 1000), (unsigned long) Count,
+                (int) Width, "##################################################");
+    }
+
+    // the sets, most deposits first and the quickest of those first
+    for (i = 0; i < NumSets; i++) {
+        Summarize(i, &pResults[i]);
+        pOrder[i] = i;
+    }
+    qsort(pOrder, NumSets, sizeof (uint32_t), CompareSets);
+    fprintf(stderr, "best sets:\n");
+    for (i = 0; (i < NumBest) && (i < NumSets); i++) {
+        PrintSet(pOrder[i]);
+    }
+    fprintf(stderr, "as built:\n");
+    PrintSet(0);
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// plays matches until there are none left
+static void *Worker(void *pArg) {
+    ArenaMatch_t *pMatch = malloc(sizeof (ArenaMatch_t));
+    ArenaConfig_t Config;
+    uint32_t i;
+
+    if (pMatch == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for (;;) {
+        i = __atomic_fetch_add(&NextMatch, 1, __ATOMIC_RELAXED);
+        if (i >= NumSets * NumMatches) {
+            break;
+        }
+        ArenaMatch_Config(&Config, Seed, i % NumMatches);
+        pTimes[i] = ArenaMatch_Play(pMatch, &pSets[i / NumMatches], NULL, &Config, RunTicks);
+    }
+    free(pMatch);
+    return NULL;
+}
+
+// set 0 is the robot as built, the rest draw every timing within Spread of it
+static void DrawTimings(BotTimings_t *pTimings, uint32_t Set) {
+    uint64_t State = Seed ^ (0x5e7ULL << 48) ^ Set;
+    uint16_t *pField;
+    double Low, High;
+    int i;
+
+    memset(pTimings, 0, sizeof (BotTimings_t));
+    if (Set == 0) {
+        return;
+    }
+    for (i = 0; i < ARRAY_SIZE(Timings); i++) {
+        pField = (uint16_t *) ((char *) pTimings + Timings[i].Offset);
+        Low = Timings[i].AsBuilt * (100.0 - Spread) / 100.0;
+        High = Timings[i].AsBuilt * (100.0 + Spread) / 100.0;
+        *pField = (uint16_t) lround(ArenaMatch_Uniform(&State, Low, High));
+        if (*pField == 0) {
+            *pField = 1;
+        }
+    }
+}
+
+static int CompareTimes(const void *pA, const void *pB) {
+    uint32_t A = *(const uint32_t *) pA, B = *(const uint32_t *) pB;
+
+    return (A > B) - (A < B);
+}
+
+static int CompareSets(const void *pA, const void *pB) {
+    const SetResult_t *pResultA = &pResults[*(const uint32_t *) pA];
+    const SetResult_t *pResultB = &pResults[*(const uint32_t *) pB];
+
+    if (pResultA->Finished != pResultB->Finished) {
+        return (pResultA->Finished < pResultB->Finished) ? 1 : -1;
+    }
+    if (pResultA->MedianTime != pResultB->MedianTime) {
+        return (pResultA->MedianTime > pResultB->MedianTime) ? 1 : -1;
+    }
+    return (*(const uint32_t *) pA > *(const uint32_t *) pB) ? 1 : -1;
+}
+
+static void Summarize(uint32_t Set, SetResult_t *pResult) {
+    uint32_t Times[NumMatches];
+    uint32_t i;
+    double Sum = 0.0;
+
+    pResult->Finished = 0;
+    for (i = 0; i < NumMatches; i++) {
+        if (pTimes[Set * NumMatches + i] != 0) {
+            Times[pResult->Finished++] = pTimes[Set * NumMatches + i];
+            Sum += pTimes[Set * NumMatches + i];
+        }
+    }
+    qsort(Times, pResult->Finished, sizeof (uint32_t), CompareTimes);
+    pResult->MeanTime = (pResult->Finished > 0) ? Sum / pResult->Finished : 0.0;
+    pResult->MedianTime = (pResult->Finished > 0) ? Times[pResult->Finished / 2] : 0;
+    pResult->WorstTime = (pResult->Finished > 0) ? Times[pResult->Finished - 1] : 0;
+}
+
+static void PrintSet(uint32_t Set) {
+    const SetResult_t *pResult = &pResults[Set];
+    const BotTimings_t *pTimings = &pSets[Set];
+    uint16_t Value;
+    int i;
+
+    fprintf(stderr, "  set %lu: %lu of %lu deposited", (unsigned long) Set,
+            (unsigned long) pResult->Finished, (unsigned long) NumMatches);
+    if (pResult->Finished > 0) {
+        fprintf(stderr, ", mean %.1f s, median %.1f s, worst %.1f s",
+                pResult->MeanTime / 1000.0, pResult->MedianTime / 1000.0,
+                pResult->WorstTime / 1000.0);
+    }
+    fprintf(stderr, "\n   ");
+    for (i = 0; i < ARRAY_SIZE(Timings); i++) {
+        Value = *(const uint16_t *) ((const char *) pTimings + Timings[i].Offset);
+        fprintf(stderr, " %s %u", Timings[i].Name, (Value != 0) ? Value : Timings[i].AsBuilt);
+    }
+    fprintf(stderr, "\n");
+}
+
+static double WallSeconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
@@ -0,0 +1,767 @@
+/*
+ * File: TuneMain.c
+ *
+ * CMA-ES search of the robot's drive speeds and sensor thresholds in the
+ * simulated arena. Each candidate is a BotTuning_t, DRIVE_SPEED and
+ * SPIN_SPEED of TopHSM.h and the beacon and track wire hysteresis of
+ * BotService.c, and its cost is what its matches cost on average: the
+ * mission time, the virtual ms to the first deposit, plus a fixed cost for
+ * every collision, up to the length of the match. A match without a deposit
+ * costs three match lengths whatever it hit, more than any match with one,
+ * so a candidate cannot come out ahead by driving too little to collide.
+ * ROLLER_SPEED is kept as built, since the arena has no balls for the roller
+ * to take in and a search would only wander over it.
+ *
+ * The search works on every value scaled to 0 to 1 over the range it may
+ * take. A generation draws its candidates around the mean, plays every one
+ * of them on the same matches, new ones each generation, and moves the mean,
+ * the step size and the covariance of the draws towards the better half
+ * (Hansen, The CMA Evolution Strategy: A Tutorial). Values drawn outside
+ * their range are played at its edge and cost the more the further out they
+ * were drawn. A hysteresis whose low level comes within MIN_HYSTERESIS of
+ * its high level is played with the low level moved down.
+ *
+ * The matches of a generation are handed out to worker threads as es_sweep
+ * hands out its own, and the results do not depend on how many threads there
+ * are. With -c the whole state of the search is written to a checkpoint
+ * after every generation, and read back from it on the next run with the
+ * same options, which picks up where it stopped. At the end the final mean,
+ * the best candidate of any generation and the robot as built are played on
+ * matches none of them has seen, and the cheapest of them is written out as
+ * a header just like ../src/BotTuned.h, to be copied over it; everything
+ * else goes to stderr, so es_tune > ../src/BotTuned.h drops it straight in.
+ *
+ *   es_tune [-g <generations>] [-l <candidates>] [-m <matches>] [-v <matches>]
+ *           [-j <threads>] [-t <ms>] [-w <ms>] [-d <step>] [-s <seed>]
+ *           [-c <checkpoint>] [-o <header>]
+ *     -g  generations in all, a resumed search included (default 20)
+ *     -l  candidates a generation (default 4 + 3 ln of the values searched)
+ *     -m  matches a candidate plays each generation (default 8)
+ *     -v  matches of the final comparison (default 32)
+ *     -j  worker threads (default one per online core)
+ *     -t  virtual ms per match (default 120000)
+ *     -w  what a collision costs, in ms of mission time (default 1000), at
+ *         most a match length in all
+ *     -d  the first step size, as a part of every range (default 0.2)
+ *     -s  seed of the draws and the arena noise (default 1)
+ *     -c  checkpoint file, resumed from if it is there
+ *     -o  write the header to a file instead of stdout
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ArenaMatch.h"
+#include "BotTuned.h"
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define DEFAULT_GENERATIONS 20
+#define DEFAULT_MATCHES 8
+#define DEFAULT_FINAL_MATCHES 32
+#define DEFAULT_RUN_TICKS 120000
+#define DEFAULT_COLLISION_COST 1000.0 // ms
+#define DEFAULT_STEP 0.2
+#define MAX_THREADS 256
+#define MAX_CANDIDATES 256
+
+#define MIN_HYSTERESIS 50
+#define RANGE_PENALTY 1.0e6 // ms for a value drawn a whole range outside, squared
+
+// the matches of the final comparison, apart from every generation's
+#define FINAL_MATCH 0x80000000UL
+
+#define CHECKPOINT_MAGIC "es_tune checkpoint 1"
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+#define NUM_PARAMS 6 // searched, the entries of Params
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+// a field of BotTuning_t, the macro of BotTuned.h it defaults to, and the
+// range it is searched over
+typedef struct {
+    const char *Name;
+    const char *Macro;
+    size_t Offset;
+    uint16_t AsBuilt;
+    uint16_t Low;
+    uint16_t High;
+} Param_t;
+
+// a candidate played on one match
+typedef struct {
+    const BotTuning_t *pTuning;
+    uint32_t Match;
+    uint32_t Mission; // 0 for no deposit
+    uint32_t Collisions;
+} Job_t;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void Generation(void);
+static void Update(double X[][NUM_PARAMS], const uint32_t *pOrder,
+        double B[][NUM_PARAMS], const double *pD);
+static void Eigen(double B[][NUM_PARAMS], double *pD);
+static void Decode(const double *pX, BotTuning_t *pTuning, double *pPenalty);
+static void Hysteresis(BotTuning_t *pTuning, size_t Found, size_t Lost);
+static void PlayAll(Job_t *pJobs, uint32_t NumJobs);
+static void *Worker(void *pArg);
+static double JobCost(const Job_t *pJob);
+static double Normal(uint64_t *pState);
+static int CompareCosts(const void *pA, const void *pB);
+static void PrintTuning(const char *Label, const BotTuning_t *pTuning);
+static uint16_t Value(const BotTuning_t *pTuning, const Param_t *pParam);
+static uint8_t SaveCheckpoint(const char *Path);
+static uint8_t LoadCheckpoint(const char *Path);
+static uint8_t WriteHeader(FILE *pFile, const BotTuning_t *pTuning, const char *Note1,
+        const char *Note2);
+static double WallSeconds(void);
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static const Param_t Params[] = {
+    {"DriveSpeed", "TUNED_DRIVE_SPEED", offsetof(BotTuning_t, DriveSpeed),
+        TUNED_DRIVE_SPEED, 500, 1000},
+    {"SpinSpeed", "TUNED_SPIN_SPEED", offsetof(BotTuning_t, SpinSpeed),
+        TUNED_SPIN_SPEED, 300, 1000},
+    {"BeaconFound", "TUNED_BEACON_FOUND", offsetof(BotTuning_t, BeaconFound),
+        TUNED_BEACON_FOUND, 400, 1000},
+    {"BeaconLost", "TUNED_BEACON_LOST", offsetof(BotTuning_t, BeaconLost),
+        TUNED_BEACON_LOST, 100, 700},
+    {"TrackWireFound", "TUNED_TRACK_WIRE_FOUND", offsetof(BotTuning_t, TrackWireFound),
+        TUNED_TRACK_WIRE_FOUND, 150, 800},
+    {"TrackWireLost", "TUNED_TRACK_WIRE_LOST", offsetof(BotTuning_t, TrackWireLost),
+        TUNED_TRACK_WIRE_LOST, 100, 700},
+};
+
+_Static_assert(ARRAY_SIZE(Params) == NUM_PARAMS, "NUM_PARAMS is not the number of Params");
+
+static uint32_t Generations = DEFAULT_GENERATIONS;
+static uint32_t NumCandidates;
+static uint32_t NumMatches = DEFAULT_MATCHES;
+static uint32_t RunTicks = DEFAULT_RUN_TICKS;
+static double CollisionCost = DEFAULT_COLLISION_COST;
+static uint64_t Seed = 1;
+static long NumThreads;
+
+// the weights of the better half and the rates the state moves at, from the
+// tutorial's defaults
+static uint32_t Mu;
+static double Weights[MAX_CANDIDATES];
+static double MuEff, Cc, Cs, C1, CMu, Damps, ChiN;
+
+// the state of the search, all of it in the checkpoint
+static uint32_t Done; // generations
+static uint32_t Played; // matches
+static double Sigma;
+static double Mean[NUM_PARAMS];
+static double Ps[NUM_PARAMS];
+static double Pc[NUM_PARAMS];
+static double C[NUM_PARAMS][NUM_PARAMS];
+static double Best[NUM_PARAMS];
+static double BestCost = HUGE_VAL;
+
+static const double *pCosts; // of the candidates being sorted
+
+static Job_t *pJobs; // being played
+static uint32_t NumJobs;
+static uint32_t NextJob; // taken by the workers with __atomic_fetch_add()
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(int argc, char **argv) {
+    const char *CheckpointPath = NULL;
+    const char *HeaderPath = NULL;
+    FILE *pHeader;
+    int Out;
+    uint32_t FinalMatches = DEFAULT_FINAL_MATCHES;
+    double Step = DEFAULT_STEP;
+    BotTuning_t Final[3]; // as built, the mean, the best
+    static const char *FinalNames[] = {"as built", "mean", "best"};
+    double FinalCost[3];
+    uint32_t FinalDeposits[3];
+    double FinalMission[3], FinalCollisions[3];
+    double Penalty, Start, Weight, Sum;
+    char Note1[80], Note2[80];
+    uint32_t i, j, Pick;
+
+    NumThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    NumCandidates = 4 + (uint32_t) floor(3.0 * log(NUM_PARAMS));
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc)) {
+            Generations = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-l") == 0) && (i + 1 < argc)) {
+            NumCandidates = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+            NumMatches = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-v") == 0) && (i + 1 < argc)) {
+            FinalMatches = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc)) {
+            NumThreads = atol(argv[++i]);
+        } else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+            RunTicks = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+            CollisionCost = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+            Step = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+            Seed = strtoull(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) {
+            CheckpointPath = argv[++i];
+        } else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc)) {
+            HeaderPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-g <generations>] [-l <candidates>] [-m <matches>] "
+                    "[-v <matches>] [-j <threads>] [-t <ms>] [-w <ms>] [-d <step>] "
+                    "[-s <seed>] [-c <checkpoint>] [-o <header>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((NumCandidates < 4) || (NumCandidates > MAX_CANDIDATES) || (NumMatches < 1)
+            || (FinalMatches < 1) || (Step <= 0.0) || (CollisionCost < 0.0)) {
+        fprintf(stderr, "%s: 4 to %d candidates, at least one match, a step and a "
+                "collision cost above 0\n", argv[0], MAX_CANDIDATES);
+        return EXIT_FAILURE;
+    }
+    if (NumThreads < 1) {
+        NumThreads = 1;
+    } else if (NumThreads > MAX_THREADS) {
+        NumThreads = MAX_THREADS;
+    }
+
+    // log weights over the better half
+    Mu = NumCandidates / 2;
+    for (i = 0, Sum = 0.0; i < Mu; i++) {
+        Weights[i] = log(Mu + 0.5) - log(i + 1);
+        Sum += Weights[i];
+    }
+    for (i = 0, Weight = 0.0; i < Mu; i++) {
+        Weights[i] /= Sum;
+        Weight += Weights[i] * Weights[i];
+    }
+    MuEff = 1.0 / Weight;
+    Cc = (4.0 + MuEff / NUM_PARAMS) / (NUM_PARAMS + 4.0 + 2.0 * MuEff / NUM_PARAMS);
+    Cs = (MuEff + 2.0) / (NUM_PARAMS + MuEff + 5.0);
+    C1 = 2.0 / ((NUM_PARAMS + 1.3) * (NUM_PARAMS + 1.3) + MuEff);
+    CMu = 2.0 * (MuEff - 2.0 + 1.0 / MuEff) / ((NUM_PARAMS + 2.0) * (NUM_PARAMS + 2.0) + MuEff);
+    CMu = (CMu < 1.0 - C1) ? CMu : 1.0 - C1;
+    Damps = 1.0 + Cs + 2.0 * fmax(0.0, sqrt((MuEff - 1.0) / (NUM_PARAMS + 1.0)) - 1.0);
+    ChiN = sqrt(NUM_PARAMS) * (1.0 - 1.0 / (4.0 * NUM_PARAMS)
+            + 1.0 / (21.0 * NUM_PARAMS * NUM_PARAMS));
+
+    // from the robot as built, unless there is a search to pick up
+    Sigma = Step;
+    for (i = 0; i < NUM_PARAMS; i++) {
+        Mean[i] = (double) (Params[i].AsBuilt - Params[i].Low) / (Params[i].High - Params[i].Low);
+        C[i][i] = 1.0;
+    }
+    if ((CheckpointPath != NULL) && (access(CheckpointPath, F_OK) == 0)) {
+        if (!LoadCheckpoint(CheckpointPath)) {
+            fprintf(stderr, "%s: %s is not a checkpoint of a search with these options\n",
+                    argv[0], CheckpointPath);
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "resumed from %s after %lu generations\n", CheckpointPath,
+                (unsigned long) Done);
+    }
+    pJobs = calloc(((NumCandidates > 3) ? NumCandidates : 3)
+            * ((NumMatches > FinalMatches) ? NumMatches : FinalMatches), sizeof (Job_t));
+    if (pJobs == NULL) {
+        return EXIT_FAILURE;
+    }
+    // the machines print as they go; nobody reads it here, the header aside
+    fflush(stdout);
+    Out = dup(STDOUT_FILENO);
+    if ((Out < 0) || (freopen("/dev/null", "w", stdout) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    Start = WallSeconds();
+    while (Done < Generations) {
+        Generation();
+        if ((CheckpointPath != NULL) && !SaveCheckpoint(CheckpointPath)) {
+            perror(CheckpointPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the three contenders on matches none of them was chosen on
+    memset(&Final[0], 0, sizeof (BotTuning_t));
+    Decode(Mean, &Final[1], &Penalty);
+    if (BestCost < HUGE_VAL) {
+        Decode(Best, &Final[2], &Penalty);
+    } else {
+        Final[2] = Final[1];
+    }
+    for (i = 0, NumJobs = 0; i < 3; i++) {
+        for (j = 0; j < FinalMatches; j++, NumJobs++) {
+            pJobs[NumJobs].pTuning = &Final[i];
+            pJobs[NumJobs].Match = FINAL_MATCH + j;
+        }
+    }
+    PlayAll(pJobs, NumJobs);
+    fprintf(stderr, "%lu matches of %lu ms on %ld threads in %.2f s\n",
+            (unsigned long) Played, (unsigned long) RunTicks, NumThreads, WallSeconds() - Start);
+    fprintf(stderr, "on %lu new matches:\n", (unsigned long) FinalMatches);
+    for (i = 0, Pick = 0; i < 3; i++) {
+        FinalCost[i] = 0.0;
+        FinalDeposits[i] = 0;
+        FinalMission[i] = 0.0;
+        FinalCollisions[i] = 0.0;
+        for (j = i * FinalMatches; j < (i + 1) * FinalMatches; j++) {
+            FinalCost[i] += JobCost(&pJobs[j]) / FinalMatches;
+            FinalCollisions[i] += (double) pJobs[j].Collisions / FinalMatches;
+            if (pJobs[j].Mission != 0) {
+                FinalDeposits[i]++;
+                FinalMission[i] += pJobs[j].Mission;
+            }
+        }
+        if (FinalDeposits[i] > 0) {
+            FinalMission[i] /= FinalDeposits[i];
+        }
+        if (FinalCost[i] < FinalCost[Pick]) {
+            Pick = i;
+        }
+        fprintf(stderr, "  %-8s cost %.1f s, %lu of %lu deposited", FinalNames[i],
+                FinalCost[i] / 1000.0, (unsigned long) FinalDeposits[i],
+                (unsigned long) FinalMatches);
+        if (FinalDeposits[i] > 0) {
+            fprintf(stderr, " in %.1f s on average", FinalMission[i] / 1000.0);
+        }
+        fprintf(stderr, ", %.1f collisions a match\n", FinalCollisions[i]);
+        PrintTuning("   ", &Final[i]);
+    }
+
+    snprintf(Note1, sizeof (Note1), "%lu generations of %lu candidates on %lu matches, seed %llu",
+            (unsigned long) Done, (unsigned long) NumCandidates, (unsigned long) NumMatches,
+            (unsigned long long) Seed);
+    snprintf(Note2, sizeof (Note2), "the %s, costing %.1f s a match against %.1f s as built",
+            FinalNames[Pick], FinalCost[Pick] / 1000.0, FinalCost[0] / 1000.0);
+    pHeader = (HeaderPath != NULL) ? fopen(HeaderPath, "wb") : fdopen(Out, "wb");
+    if ((pHeader == NULL) || !WriteHeader(pHeader, &Final[Pick], Note1, Note2)) {
+        perror((HeaderPath != NULL) ? HeaderPath : "stdout");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "wrote the %s to %s\n", FinalNames[Pick],
+            (HeaderPath != NULL) ? HeaderPath : "stdout");
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// draws a generation around the mean, plays it and moves the search on
+static void Generation(void) {
+    static double X[MAX_CANDIDATES][NUM_PARAMS];
+    static BotTuning_t Tunings[MAX_CANDIDATES];
+    double Penalty[MAX_CANDIDATES];
+    double Cost[MAX_CANDIDATES];
+    uint32_t Order[MAX_CANDIDATES];
+    double B[NUM_PARAMS][NUM_PARAMS];
+    double D[NUM_PARAMS], Z[NUM_PARAMS];
+    uint64_t State = Seed ^ (0xc3aULL << 48) ^ Done;
+    uint32_t i, j, k;
+
+    Eigen(B, D);
+    for (k = 0, NumJobs = 0; k < NumCandidates; k++) {
+        for (i = 0; i < NUM_PARAMS; i++) {
+            Z[i] = D[i] * Normal(&State);
+        }
+        for (i = 0; i < NUM_PARAMS; i++) {
+            for (j = 0, X[k][i] = Mean[i]; j < NUM_PARAMS; j++) {
+                X[k][i] += Sigma * B[i][j] * Z[j];
+            }
+        }
+        Decode(X[k], &Tunings[k], &Penalty[k]);
+        // every candidate on the same matches, new ones every generation
+        for (j = 0; j < NumMatches; j++, NumJobs++) {
+            pJobs[NumJobs].pTuning = &Tunings[k];
+            pJobs[NumJobs].Match = Done * NumMatches + j;
+        }
+    }
+    PlayAll(pJobs, NumJobs);
+
+    for (k = 0; k < NumCandidates; k++) {
+        Cost[k] = Penalty[k];
+        for (j = k * NumMatches; j < (k + 1) * NumMatches; j++) {
+            Cost[k] += JobCost(&pJobs[j]) / NumMatches;
+        }
+        Order[k] = k;
+    }
+    pCosts = Cost;
+    qsort(Order, NumCandidates, sizeof (uint32_t), CompareCosts);
+    if (Cost[Order[0]] < BestCost) {
+        BestCost = Cost[Order[0]];
+        memcpy(Best, X[Order[0]], sizeof (Best));
+    }
+    fprintf(stderr, "generation %lu: best %.1f s, median %.1f s, step %.3f\n",
+            (unsigned long) Done + 1, Cost[Order[0]] / 1000.0,
+            Cost[Order[NumCandidates / 2]] / 1000.0, Sigma);
+    PrintTuning("  best", &Tunings[Order[0]]);
+
+    Update(X, Order, B, D);
+    Done++;
+}
+
+// moves the mean, the paths, the covariance and the step size towards the
+// better half of the generation
+static void Update(double X[][NUM_PARAMS], const uint32_t *pOrder,
+        double B[][NUM_PARAMS], const double *pD) {
+    double Old[NUM_PARAMS], Y[NUM_PARAMS], W[NUM_PARAMS];
+    double Norm, Hsig, Yi, Yj;
+    uint32_t i, j, k;
+
+    memcpy(Old, Mean, sizeof (Old));
+    for (i = 0; i < NUM_PARAMS; i++) {
+        for (k = 0, Mean[i] = 0.0; k < Mu; k++) {
+            Mean[i] += Weights[k] * X[pOrder[k]][i];
+        }
+        Y[i] = (Mean[i] - Old[i]) / Sigma;
+    }
+
+    // the step path runs in the space the draws are whitened in, C^-1/2 Y,
+    // with the B and D the generation was drawn with
+    for (j = 0; j < NUM_PARAMS; j++) {
+        for (i = 0, W[j] = 0.0; i < NUM_PARAMS; i++) {
+            W[j] += B[i][j] * Y[i];
+        }
+        W[j] /= pD[j];
+    }
+    for (i = 0, Norm = 0.0; i < NUM_PARAMS; i++) {
+        for (j = 0, Yi = 0.0; j < NUM_PARAMS; j++) {
+            Yi += B[i][j] * W[j];
+        }
+        Ps[i] = (1.0 - Cs) * Ps[i] + sqrt(Cs * (2.0 - Cs) * MuEff) * Yi;
+        Norm += Ps[i] * Ps[i];
+    }
+    Norm = sqrt(Norm);
+    Hsig = (Norm / sqrt(1.0 - pow(1.0 - Cs, 2.0 * (Done + 1))) / ChiN
+            < 1.4 + 2.0 / (NUM_PARAMS + 1.0)) ? 1.0 : 0.0;
+    for (i = 0; i < NUM_PARAMS; i++) {
+        Pc[i] = (1.0 - Cc) * Pc[i] + Hsig * sqrt(Cc * (2.0 - Cc) * MuEff) * Y[i];
+    }
+
+    // rank one from the path, rank mu from the better half
+    for (i = 0; i < NUM_PARAMS; i++) {
+        for (j = 0; j <= i; j++) {
+            C[i][j] *= 1.0 - C1 - CMu + (1.0 - Hsig) * C1 * Cc * (2.0 - Cc);
+            C[i][j] += C1 * Pc[i] * Pc[j];
+            for (k = 0; k < Mu; k++) {
+                Yi = (X[pOrder[k]][i] - Old[i]) / Sigma;
+                Yj = (X[pOrder[k]][j] - Old[j]) / Sigma;
+                C[i][j] += CMu * Weights[k] * Yi * Yj;
+            }
+            C[j][i] = C[i][j];
+        }
+    }
+    Sigma *= exp((Cs / Damps) * (Norm / ChiN - 1.0));
+}
+
+// C = B diag(D)^2 B', by Jacobi rotations; D are the square roots
+static void Eigen(double B[][NUM_PARAMS], double *pD) {
+    double A[NUM_PARAMS][NUM_PARAMS];
+    double Off, Theta, T, Cos, Sin, Aip, Aiq, Bip, Biq;
+    uint32_t i, p, q, Sweep;
+
+    memcpy(A, C, sizeof (A));
+    for (p = 0; p < NUM_PARAMS; p++) {
+        for (q = 0; q < NUM_PARAMS; q++) {
+            B[p][q] = (p == q) ? 1.0 : 0.0;
+        }
+    }
+    for (Sweep = 0; Sweep < 50; Sweep++) {
+        for (p = 0, Off = 0.0; p < NUM_PARAMS; p++) {
+            for (q = p + 1; q < NUM_PARAMS; q++) {
+                Off += A[p][q] * A[p][q];
+            }
+        }
+        if (Off < 1e-30) {
+            break;
+        }
+        for (p = 0; p < NUM_PARAMS; p++) {
+            for (q = p + 1; q < NUM_PARAMS; q++) {
+                if (A[p][q] == 0.0) {
+                    continue;
+                }
+                Theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+                T = ((Theta >= 0.0) ? 1.0 : -1.0) / (fabs(Theta) + sqrt(Theta * Theta + 1.0));
+                Cos = 1.0 / sqrt(T * T + 1.0);
+                Sin = T * Cos;
+                for (i = 0; i < NUM_PARAMS; i++) {
+                    Aip = A[i][p];
+                    Aiq = A[i][q];
+                    A[i][p] = Cos * Aip - Sin * Aiq;
+                    A[i][q] = Sin * Aip + Cos * Aiq;
+                }
+                for (i = 0; i < NUM_PARAMS; i++) {
+                    Aip = A[p][i];
+                    Aiq = A[q][i];
+                    A[p][i] = Cos * Aip - Sin * Aiq;
+                    A[q][i] = Sin * Aip + Cos * Aiq;
+                }
+                for (i = 0; i < NUM_PARAMS; i++) {
+                    Bip = B[i][p];
+                    Biq = B[i][q];
+                    B[i][p] = Cos * Bip - Sin * Biq;
+                    B[i][q] = Sin * Bip + Cos * Biq;
+                }
+            }
+        }
+    }
+    for (i = 0; i < NUM_PARAMS; i++) {
+        pD[i] = sqrt((A[i][i] > 1e-20) ? A[i][i] : 1e-20);
+    }
+}
+
+// the values a point of the search plays with, and what it costs for lying
+// outside the ranges
+static void Decode(const double *pX, BotTuning_t *pTuning, double *pPenalty) {
+    double X;
+    uint32_t i;
+
+    memset(pTuning, 0, sizeof (BotTuning_t));
+    *pPenalty = 0.0;
+    for (i = 0; i < NUM_PARAMS; i++) {
+        X = (pX[i] < 0.0) ? 0.0 : (pX[i] > 1.0) ? 1.0 : pX[i];
+        *pPenalty += RANGE_PENALTY * (pX[i] - X) * (pX[i] - X);
+        *(uint16_t *) ((char *) pTuning + Params[i].Offset) =
+                (uint16_t) lround(Params[i].Low + X * (Params[i].High - Params[i].Low));
+    }
+    Hysteresis(pTuning, offsetof(BotTuning_t, BeaconFound), offsetof(BotTuning_t, BeaconLost));
+    Hysteresis(pTuning, offsetof(BotTuning_t, TrackWireFound),
+            offsetof(BotTuning_t, TrackWireLost));
+}
+
+static void Hysteresis(BotTuning_t *pTuning, size_t Found, size_t Lost) {
+    uint16_t *pFound = (uint16_t *) ((char *) pTuning + Found);
+    uint16_t *pLost = (uint16_t *) ((char *) pTuning + Lost);
+
+    if (*pLost + MIN_HYSTERESIS > *pFound) {
+        *pLost = *pFound - MIN_HYSTERESIS;
+    }
+}
+
+// plays every job on the worker threads
+static void PlayAll(Job_t *pJobsToPlay, uint32_t Count) {
+    pthread_t Threads[MAX_THREADS];
+    long i;
+
+    NextJob = 0;
+    for (i = 0; i < NumThreads; i++) {
+        if (pthread_create(&Threads[i], NULL, Worker, NULL) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < NumThreads; i++) {
+        pthread_join(Threads[i], NULL);
+    }
+    Played += Count;
+}
+
+// plays jobs until there are none left
+static void *Worker(void *pArg) {
+    ArenaMatch_t *pMatch = malloc(sizeof (ArenaMatch_t));
+    ArenaConfig_t Config;
+    Job_t *pJob;
+    uint32_t i;
+
+    if (pMatch == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for (;;) {
+        i = __atomic_fetch_add(&NextJob, 1, __ATOMIC_RELAXED);
+        if (i >= NumJobs) {
+            break;
+        }
+        pJob = &pJobs[i];
+        ArenaMatch_Config(&Config, Seed, pJob->Match);
+        pJob->Mission = ArenaMatch_Play(pMatch, NULL, pJob->pTuning, &Config, RunTicks);
+        pJob->Collisions = pMatch->Arena.Stats.Collisions;
+    }
+    free(pMatch);
+    return NULL;
+}
+
+// ms: the mission time and the collisions, at most a match's worth, or three
+// matches without a deposit, which no match with one comes to
+static double JobCost(const Job_t *pJob) {
+    double Collisions = CollisionCost * pJob->Collisions;
+
+    if (pJob->Mission == 0) {
+        return 3.0 * RunTicks;
+    }
+    if (Collisions > RunTicks) {
+        Collisions = RunTicks;
+    }
+    return pJob->Mission + Collisions;
+}
+
+// Box-Muller, one of the pair
+static double Normal(uint64_t *pState) {
+    double U = ArenaMatch_Uniform(pState, 0.0, 1.0);
+    double V = ArenaMatch_Uniform(pState, 0.0, 1.0);
+
+    return sqrt(-2.0 * log(1.0 - U)) * cos(2.0 * M_PI * V);
+}
+
+// cheapest first, the earlier candidate of a tie first
+static int CompareCosts(const void *pA, const void *pB) {
+    uint32_t A = *(const uint32_t *) pA, B = *(const uint32_t *) pB;
+
+    if (pCosts[A] != pCosts[B]) {
+        return (pCosts[A] > pCosts[B]) ? 1 : -1;
+    }
+    return (A > B) - (A < B);
+}
+
+static void PrintTuning(const char *Label, const BotTuning_t *pTuning) {
+    uint32_t i;
+
+    fprintf(stderr, "%s", Label);
+    for (i = 0; i < NUM_PARAMS; i++) {
+        fprintf(stderr, " %s %u", Params[i].Name, Value(pTuning, &Params[i]));
+    }
+    fprintf(stderr, "\n");
+}
+
+// what the robot plays with, the value as built where the field is 0
+static uint16_t Value(const BotTuning_t *pTuning, const Param_t *pParam) {
+    uint16_t Field = *(const uint16_t *) ((const char *) pTuning + pParam->Offset);
+
+    return (Field != 0) ? Field : pParam->AsBuilt;
+}
+
+// the options the search depends on, then its state; written beside the file
+// and renamed over it, so a run stopped halfway leaves the last one whole
+static uint8_t SaveCheckpoint(const char *Path) {
+    char Temp[4096];
+    FILE *pFile;
+    uint32_t i, j;
+
+    snprintf(Temp, sizeof (Temp), "%s.tmp", Path);
+    pFile = fopen(Temp, "w");
+    if (pFile == NULL) {
+        return FALSE;
+    }
+    fprintf(pFile, "%s\n", CHECKPOINT_MAGIC);
+    fprintf(pFile, "params %lu candidates %lu matches %lu ticks %lu collision %.17g seed %llu\n",
+            (unsigned long) NUM_PARAMS, (unsigned long) NumCandidates,
+            (unsigned long) NumMatches, (unsigned long) RunTicks, CollisionCost,
+            (unsigned long long) Seed);
+    fprintf(pFile, "done %lu played %lu sigma %.17g best %.17g\n", (unsigned long) Done,
+            (unsigned long) Played, Sigma, BestCost);
+    for (i = 0; i < NUM_PARAMS; i++) {
+        fprintf(pFile, "%.17g %.17g %.17g %.17g", Mean[i], Ps[i], Pc[i], Best[i]);
+        for (j = 0; j < NUM_PARAMS; j++) {
+            fprintf(pFile, " %.17g", C[i][j]);
+        }
+        fprintf(pFile, "\n");
+    }
+    if ((fclose(pFile) != 0) || (rename(Temp, Path) != 0)) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// FALSE if the file is not a checkpoint, or of a search with other options
+static uint8_t LoadCheckpoint(const char *Path) {
+    char Magic[sizeof (CHECKPOINT_MAGIC)];
+    unsigned long Params, Candidates, Matches, Ticks, Generations, Count;
+    unsigned long long FileSeed;
+    double Collision;
+    FILE *pFile = fopen(Path, "r");
+    uint8_t Read = FALSE;
+    uint32_t i, j;
+
+    if (pFile == NULL) {
+        return FALSE;
+    }
+    if ((fgets(Magic, sizeof (Magic), pFile) != NULL)
+            && (strcmp(Magic, CHECKPOINT_MAGIC) == 0)
+            && (fscanf(pFile, " params %lu candidates %lu matches %lu ticks %lu collision %lf "
+            "seed %llu", &Params, &Candidates, &Matches, &Ticks, &Collision, &FileSeed) == 6)
+            && (Params == NUM_PARAMS) && (Candidates == NumCandidates)
+            && (Matches == NumMatches) && (Ticks == RunTicks)
+            && (Collision == CollisionCost) && (FileSeed == Seed)
+            && (fscanf(pFile, " done %lu played %lu sigma %lf best %lf", &Generations,
+            &Count, &Sigma, &BestCost) == 4)) {
+        Read = TRUE;
+        for (i = 0; Read && (i < NUM_PARAMS); i++) {
+            Read = (fscanf(pFile, "%lf %lf %lf %lf", &Mean[i], &Ps[i], &Pc[i], &Best[i]) == 4);
+            for (j = 0; Read && (j < NUM_PARAMS); j++) {
+                Read = (fscanf(pFile, "%lf", &C[i][j]) == 1);
+            }
+        }
+        Done = Generations;
+        Played = Count;
+    }
+    fclose(pFile);
+    return Read;
+}
+
+// a BotTuned.h, with the line ends of the rest of ../src; closes the file
+static uint8_t WriteHeader(FILE *pFile, const BotTuning_t *pTuning, const char *Note1,
+        const char *Note2) {
+    uint32_t i;
+
+    fprintf(pFile, "/*\r\n"
+            " * File: BotTuned.h\r\n"
+            " *\r\n"
+            " * The drive speeds and sensor thresholds the robot is built with. The host's\r\n"
+            " * es_tune writes a file just like this one with the values it found best in\r\n"
+            " * the simulated arena; copy it over this one to build them in. The machines\r\n"
+            " * read the values through BOT_TUNING(), which on the board is the value\r\n"
+            " * here, as a constant, and on the host lets es_tune try others without a\r\n"
+            " * rebuild.\r\n"
+            " *\r\n"
+            " * Written by es_tune, %s:\r\n"
+            " * %s.\r\n"
+            " */\r\n"
+            "\r\n"
+            "#ifndef BOTTUNED_H\r\n"
+            "#define BOTTUNED_H\r\n"
+            "\r\n"
+            "// motor duty, out of 1000\r\n", Note1, Note2);
+    fprintf(pFile, "#define %s %u\r\n", Params[0].Macro, Value(pTuning, &Params[0]));
+    fprintf(pFile, "#define %s %u\r\n", Params[1].Macro, Value(pTuning, &Params[1]));
+    fprintf(pFile, "#define TUNED_ROLLER_SPEED %u\r\n", TUNED_ROLLER_SPEED);
+    fprintf(pFile, "\r\n"
+            "// the hysteresis of BotService on beaconVal() and the track wire coils: found\r\n"
+            "// above the first, lost below the second\r\n");
+    for (i = 2; i < NUM_PARAMS; i++) {
+        fprintf(pFile, "#define %s %u\r\n", Params[i].Macro, Value(pTuning, &Params[i]));
+    }
+    fprintf(pFile, "\r\n#endif /* BOTTUNED_H */\r\n");
+    return (ferror(pFile) == 0) & (fclose(pFile) == 0);
+}
+
+static double WallSeconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
@@ -0,0 +1,179 @@
+/*
+ * File: DispatchBench.c
+ *
+ * Measures what the run loop costs per event as the number of ready services
+ * grows. For each count K the benchmark posts one event to each of K services
+ * spread over all 64 priorities and lets ES_Run() drain them, then times the
+ * find-highest-ready step alone, once with the port's count leading zeros and
+ * once with a top-down scan of the ready bits for comparison. A last row
+ * reaches all the services with one ES_Publish() instead of one post each.
+ *
+ *   es_dispatch_bench [rounds]
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_Port.h"
+#include "DispatchBench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define DEFAULT_ROUNDS 200000
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static ES_Context_t Context;
+static uint32_t Dispatched;
+static volatile uint32_t Sink;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static double Now(void);
+static ES_ReadySet_t SpreadSet(int NumReady);
+static uint8_t ScanHighestBit(ES_ReadySet_t Set) __attribute__((noinline));
+static uint8_t ClzHighestBit(ES_ReadySet_t Set) __attribute__((noinline));
+static double TimeFind(uint8_t (*Find)(ES_ReadySet_t), ES_ReadySet_t Set, long Rounds);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t InitBenchService(uint8_t Priority) {
+    (void) Priority;
+    return TRUE;
+}
+
+ES_Event RunBenchService(ES_Event ThisEvent) {
+    Dispatched++;
+    ThisEvent.EventType = ES_NO_EVENT;
+    return ThisEvent;
+}
+
+int main(int argc, char **argv) {
+    ES_Event BenchEvent = {BENCH_EVENT, 0};
+    long Rounds = (argc > 1) ? atol(argv[1]) : DEFAULT_ROUNDS;
+    ES_ReadySet_t Set;
+    double Start, Run;
+    long r;
+    int k, i;
+
+    ES_SetContext(&Context);
+    if (ES_Initialize() != Success) {
+        fprintf(stderr, "ES_Initialize failed\n");
+        return EXIT_FAILURE;
+    }
+    // with a run limit of 0 ES_Run() returns as soon as the queues drain
+    ES_Port_SetRunLimit(0);
+    ES_Run();
+
+    printf("%d services, %ld rounds\n", NUM_SERVICES, Rounds);
+    printf("ready  ns/event(ES_Run)  ns/find(clz)  ns/find(scan)\n");
+    for (k = 1; k <= NUM_SERVICES; k <<= 1) {
+        Set = SpreadSet(k);
+        Dispatched = 0;
+        Start = Now();
+        for (r = 0; r < Rounds; r++) {
+            for (i = 0; i < NUM_SERVICES; i++) {
+                if (Set & ((ES_ReadySet_t) 1 << i)) {
+                    ES_PostToService(i, BenchEvent);
+                }
+            }
+            ES_Run();
+        }
+        Run = Now() - Start;
+        if (Dispatched != (uint32_t) (Rounds * k)) {
+            fprintf(stderr, "dispatched %lu events, expected %ld\n",
+                    (unsigned long) Dispatched, Rounds * k);
+            return EXIT_FAILURE;
+        }
+        printf("%5d  %17.1f  %12.2f  %13.2f\n", k, Run * 1e9 / (Rounds * k),
+                TimeFind(ClzHighestBit, Set, Rounds), TimeFind(ScanHighestBit, Set, Rounds));
+    }
+
+    Dispatched = 0;
+    Start = Now();
+    for (r = 0; r < Rounds; r++) {
+        ES_Publish(BenchEvent);
+        ES_Run();
+    }
+    Run = Now() - Start;
+    if (Dispatched != (uint32_t) (Rounds * NUM_SERVICES)) {
+        fprintf(stderr, "published %lu events, expected %ld\n",
+                (unsigned long) Dispatched, Rounds * NUM_SERVICES);
+        return EXIT_FAILURE;
+    }
+    printf("%5d  %17.1f  (one ES_Publish per round)\n", NUM_SERVICES,
+            Run * 1e9 / (Rounds * NUM_SERVICES));
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+static double Now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// NumReady services evenly spaced from the highest priority down
+static ES_ReadySet_t SpreadSet(int NumReady) {
+    ES_ReadySet_t Set = 0;
+    int i;
+
+    for (i = 0; i < NumReady; i++) {
+        Set |= (ES_ReadySet_t) 1 << (NUM_SERVICES - 1 - i * (NUM_SERVICES / NumReady));
+    }
+    return Set;
+}
+
+static uint8_t ScanHighestBit(ES_ReadySet_t Set) {
+    uint8_t i = ES_MAX_SERVICES - 1;
+
+    while ((Set & ((ES_ReadySet_t) 1 << i)) == 0) {
+        i--;
+    }
+    return i;
+}
+
+static uint8_t ClzHighestBit(ES_ReadySet_t Set) {
+    return ES_Port_HighestBit(Set);
+}
+
+// ns per lookup while draining Set highest bit first, the way ES_Run() does
+static double TimeFind(uint8_t (*Find)(ES_ReadySet_t), ES_ReadySet_t Set, long Rounds) {
+    ES_ReadySet_t Pending;
+    uint32_t Total = 0;
+    uint32_t Finds = 0;
+    double Start = Now();
+    long r;
+    uint8_t Bit;
+
+    for (r = 0; r < Rounds; r++) {
+        Pending = Set;
+        while (Pending != 0) {
+            Bit = Find(Pending);
+            Pending &= ~((ES_ReadySet_t) 1 << Bit);
+            Total += Bit;
+            Finds++;
+        }
+    }
+    Sink = Total;
+    return (Now() - Start) * 1e9 / Finds;
+}
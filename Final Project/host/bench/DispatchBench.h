@@ -0,0 +1,17 @@
+/*
+ * File: DispatchBench.h
+ *
+ * The do-nothing service that fills every slot of the dispatch benchmark.
+ */
+
+#ifndef DISPATCHBENCH_H
+#define DISPATCHBENCH_H
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+
+uint8_t InitBenchService(uint8_t Priority);
+
+ES_Event RunBenchService(ES_Event ThisEvent);
+
+#endif /* DISPATCHBENCH_H */
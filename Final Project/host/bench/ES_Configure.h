@@ -0,0 +1,338 @@
+/*
+ * File: ES_Configure.h
+ *
+ * Framework configuration for the dispatch benchmark (DispatchBench.c). It
+ * replaces the bot's ES_Configure.h and fills every one of the host's 64
+ * service slots with the same do-nothing service.
+ */
+
+#ifndef CONFIGURE_H
+#define CONFIGURE_H
+
+/****************************************************************************/
+// Name/define the events of interest
+// Universal events occupy the lowest entries, followed by user-defined events
+/****************************************************************************/
+typedef enum {
+    ES_NO_EVENT, ES_ERROR, /* used to indicate an error from the service */
+    ES_INIT, /* used to transition from initial pseudo-state */
+    ES_ENTRY, /* used to enter a state*/
+    ES_EXIT, /* used to exit a state*/
+    ES_KEYINPUT, /* used to signify a key has been pressed*/
+    ES_LISTEVENTS, /* used to list events in keyboard input, does not get posted to fsm*/
+    ES_TIMEOUT, /* signals that the timer has expired */
+    ES_TIMERACTIVE, /* signals that a timer has become active */
+    ES_TIMERSTOPPED, /* signals that a timer has stopped*/
+    /* User-defined events start here */
+    BENCH_EVENT,
+    /* User-defined events end here */
+    NUMBEROFEVENTS,
+} ES_EventTyp_t;
+
+static const char *const EventNames[] = {
+    "ES_NO_EVENT",
+    "ES_ERROR",
+    "ES_INIT",
+    "ES_ENTRY",
+    "ES_EXIT",
+    "ES_KEYINPUT",
+    "ES_LISTEVENTS",
+    "ES_TIMEOUT",
+    "ES_TIMERACTIVE",
+    "ES_TIMERSTOPPED",
+    "BENCH_EVENT",
+    "NUMBEROFEVENTS",
+};
+
+/****************************************************************************/
+// no event checkers, every event comes from the benchmark itself
+#define EVENT_CHECK_HEADER "DispatchBench.h"
+#define EVENT_CHECK_LIST
+
+/****************************************************************************/
+// no timers
+#define TIMER_UNUSED ((pPostFunc)0)
+#define TIMER0_RESP_FUNC TIMER_UNUSED
+#define TIMER1_RESP_FUNC TIMER_UNUSED
+#define TIMER2_RESP_FUNC TIMER_UNUSED
+#define TIMER3_RESP_FUNC TIMER_UNUSED
+#define TIMER4_RESP_FUNC TIMER_UNUSED
+#define TIMER5_RESP_FUNC TIMER_UNUSED
+#define TIMER6_RESP_FUNC TIMER_UNUSED
+#define TIMER7_RESP_FUNC TIMER_UNUSED
+#define TIMER8_RESP_FUNC TIMER_UNUSED
+#define TIMER9_RESP_FUNC TIMER_UNUSED
+#define TIMER10_RESP_FUNC TIMER_UNUSED
+#define TIMER11_RESP_FUNC TIMER_UNUSED
+#define TIMER12_RESP_FUNC TIMER_UNUSED
+#define TIMER13_RESP_FUNC TIMER_UNUSED
+#define TIMER14_RESP_FUNC TIMER_UNUSED
+#define TIMER15_RESP_FUNC TIMER_UNUSED
+
+/****************************************************************************/
+#define MAX_NUM_SERVICES 64
+#define NUM_SERVICES 64
+
+#define SERV_0_HEADER "DispatchBench.h"
+#define SERV_0_INIT InitBenchService
+#define SERV_0_RUN RunBenchService
+#define SERV_0_QUEUE_SIZE 4
+#define SERV_1_HEADER "DispatchBench.h"
+#define SERV_1_INIT InitBenchService
+#define SERV_1_RUN RunBenchService
+#define SERV_1_QUEUE_SIZE 4
+#define SERV_2_HEADER "DispatchBench.h"
+#define SERV_2_INIT InitBenchService
+#define SERV_2_RUN RunBenchService
+#define SERV_2_QUEUE_SIZE 4
+#define SERV_3_HEADER "DispatchBench.h"
+#define SERV_3_INIT InitBenchService
+#define SERV_3_RUN RunBenchService
+#define SERV_3_QUEUE_SIZE 4
+#define SERV_4_HEADER "DispatchBench.h"
+#define SERV_4_INIT InitBenchService
+#define SERV_4_RUN RunBenchService
+#define SERV_4_QUEUE_SIZE 4
+#define SERV_5_HEADER "DispatchBench.h"
+#define SERV_5_INIT InitBenchService
+#define SERV_5_RUN RunBenchService
+#define SERV_5_QUEUE_SIZE 4
+#define SERV_6_HEADER "DispatchBench.h"
+#define SERV_6_INIT InitBenchService
+#define SERV_6_RUN RunBenchService
+#define SERV_6_QUEUE_SIZE 4
+#define SERV_7_HEADER "DispatchBench.h"
+#define SERV_7_INIT InitBenchService
+#define SERV_7_RUN RunBenchService
+#define SERV_7_QUEUE_SIZE 4
+#define SERV_8_HEADER "DispatchBench.h"
+#define SERV_8_INIT InitBenchService
+#define SERV_8_RUN RunBenchService
+#define SERV_8_QUEUE_SIZE 4
+#define SERV_9_HEADER "DispatchBench.h"
+#define SERV_9_INIT InitBenchService
+#define SERV_9_RUN RunBenchService
+#define SERV_9_QUEUE_SIZE 4
+#define SERV_10_HEADER "DispatchBench.h"
+#define SERV_10_INIT InitBenchService
+#define SERV_10_RUN RunBenchService
+#define SERV_10_QUEUE_SIZE 4
+#define SERV_11_HEADER "DispatchBench.h"
+#define SERV_11_INIT InitBenchService
+#define SERV_11_RUN RunBenchService
+#define SERV_11_QUEUE_SIZE 4
+#define SERV_12_HEADER "DispatchBench.h"
+#define SERV_12_INIT InitBenchService
+#define SERV_12_RUN RunBenchService
+#define SERV_12_QUEUE_SIZE 4
+#define SERV_13_HEADER "DispatchBench.h"
+#define SERV_13_INIT InitBenchService
+#define SERV_13_RUN RunBenchService
+#define SERV_13_QUEUE_SIZE 4
+#define SERV_14_HEADER "DispatchBench.h"
+#define SERV_14_INIT InitBenchService
+#define SERV_14_RUN RunBenchService
+#define SERV_14_QUEUE_SIZE 4
+#define SERV_15_HEADER "DispatchBench.h"
+#define SERV_15_INIT InitBenchService
+#define SERV_15_RUN RunBenchService
+#define SERV_15_QUEUE_SIZE 4
+#define SERV_16_HEADER "DispatchBench.h"
+#define SERV_16_INIT InitBenchService
+#define SERV_16_RUN RunBenchService
+#define SERV_16_QUEUE_SIZE 4
+#define SERV_17_HEADER "DispatchBench.h"
+#define SERV_17_INIT InitBenchService
+#define SERV_17_RUN RunBenchService
+#define SERV_17_QUEUE_SIZE 4
+#define SERV_18_HEADER "DispatchBench.h"
+#define SERV_18_INIT InitBenchService
+#define SERV_18_RUN RunBenchService
+#define SERV_18_QUEUE_SIZE 4
+#define SERV_19_HEADER "DispatchBench.h"
+#define SERV_19_INIT InitBenchService
+#define SERV_19_RUN RunBenchService
+#define SERV_19_QUEUE_SIZE 4
+#define SERV_20_HEADER "DispatchBench.h"
+#define SERV_20_INIT InitBenchService
+#define SERV_20_RUN RunBenchService
+#define SERV_20_QUEUE_SIZE 4
+#define SERV_21_HEADER "DispatchBench.h"
+#define SERV_21_INIT InitBenchService
+#define SERV_21_RUN RunBenchService
+#define SERV_21_QUEUE_SIZE 4
+#define SERV_22_HEADER "DispatchBench.h"
+#define SERV_22_INIT InitBenchService
+#define SERV_22_RUN RunBenchService
+#define SERV_22_QUEUE_SIZE 4
+#define SERV_23_HEADER "DispatchBench.h"
+#define SERV_23_INIT InitBenchService
+#define SERV_23_RUN RunBenchService
+#define SERV_23_QUEUE_SIZE 4
+#define SERV_24_HEADER "DispatchBench.h"
+#define SERV_24_INIT InitBenchService
+#define SERV_24_RUN RunBenchService
+#define SERV_24_QUEUE_SIZE 4
+#define SERV_25_HEADER "DispatchBench.h"
+#define SERV_25_INIT InitBenchService
+#define SERV_25_RUN RunBenchService
+#define SERV_25_QUEUE_SIZE 4
+#define SERV_26_HEADER "DispatchBench.h"
+#define SERV_26_INIT InitBenchService
+#define SERV_26_RUN RunBenchService
+#define SERV_26_QUEUE_SIZE 4
+#define SERV_27_HEADER "DispatchBench.h"
+#define SERV_27_INIT InitBenchService
+#define SERV_27_RUN RunBenchService
+#define SERV_27_QUEUE_SIZE 4
+#define SERV_28_HEADER "DispatchBench.h"
+#define SERV_28_INIT InitBenchService
+#define SERV_28_RUN RunBenchService
+#define SERV_28_QUEUE_SIZE 4
+#define SERV_29_HEADER "DispatchBench.h"
+#define SERV_29_INIT InitBenchService
+#define SERV_29_RUN RunBenchService
+#define SERV_29_QUEUE_SIZE 4
+#define SERV_30_HEADER "DispatchBench.h"
+#define SERV_30_INIT InitBenchService
+#define SERV_30_RUN RunBenchService
+#define SERV_30_QUEUE_SIZE 4
+#define SERV_31_HEADER "DispatchBench.h"
+#define SERV_31_INIT InitBenchService
+#define SERV_31_RUN RunBenchService
+#define SERV_31_QUEUE_SIZE 4
+#define SERV_32_HEADER "DispatchBench.h"
+#define SERV_32_INIT InitBenchService
+#define SERV_32_RUN RunBenchService
+#define SERV_32_QUEUE_SIZE 4
+#define SERV_33_HEADER "DispatchBench.h"
+#define SERV_33_INIT InitBenchService
+#define SERV_33_RUN RunBenchService
+#define SERV_33_QUEUE_SIZE 4
+#define SERV_34_HEADER "DispatchBench.h"
+#define SERV_34_INIT InitBenchService
+#define SERV_34_RUN RunBenchService
+#define SERV_34_QUEUE_SIZE 4
+#define SERV_35_HEADER "DispatchBench.h"
+#define SERV_35_INIT InitBenchService
+#define SERV_35_RUN RunBenchService
+#define SERV_35_QUEUE_SIZE 4
+#define SERV_36_HEADER "DispatchBench.h"
+#define SERV_36_INIT InitBenchService
+#define SERV_36_RUN RunBenchService
+#define SERV_36_QUEUE_SIZE 4
+#define SERV_37_HEADER "DispatchBench.h"
+#define SERV_37_INIT InitBenchService
+#define SERV_37_RUN RunBenchService
+#define SERV_37_QUEUE_SIZE 4
+#define SERV_38_HEADER "DispatchBench.h"
+#define SERV_38_INIT InitBenchService
+#define SERV_38_RUN RunBenchService
+#define SERV_38_QUEUE_SIZE 4
+#define SERV_39_HEADER "DispatchBench.h"
+#define SERV_39_INIT InitBenchService
+#define SERV_39_RUN RunBenchService
+#define SERV_39_QUEUE_SIZE 4
+#define SERV_40_HEADER "DispatchBench.h"
+#define SERV_40_INIT InitBenchService
+#define SERV_40_RUN RunBenchService
+#define SERV_40_QUEUE_SIZE 4
+#define SERV_41_HEADER "DispatchBench.h"
+#define SERV_41_INIT InitBenchService
+#define SERV_41_RUN RunBenchService
+#define SERV_41_QUEUE_SIZE 4
+#define SERV_42_HEADER "DispatchBench.h"
+#define SERV_42_INIT InitBenchService
+#define SERV_42_RUN RunBenchService
+#define SERV_42_QUEUE_SIZE 4
+#define SERV_43_HEADER "DispatchBench.h"
+#define SERV_43_INIT InitBenchService
+#define SERV_43_RUN RunBenchService
+#define SERV_43_QUEUE_SIZE 4
+#define SERV_44_HEADER "DispatchBench.h"
+#define SERV_44_INIT InitBenchService
+#define SERV_44_RUN RunBenchService
+#define SERV_44_QUEUE_SIZE 4
+#define SERV_45_HEADER "DispatchBench.h"
+#define SERV_45_INIT InitBenchService
+#define SERV_45_RUN RunBenchService
+#define SERV_45_QUEUE_SIZE 4
+#define SERV_46_HEADER "DispatchBench.h"
+#define SERV_46_INIT InitBenchService
+#define SERV_46_RUN RunBenchService
+#define SERV_46_QUEUE_SIZE 4
+#define SERV_47_HEADER "DispatchBench.h"
+#define SERV_47_INIT InitBenchService
+#define SERV_47_RUN RunBenchService
+#define SERV_47_QUEUE_SIZE 4
+#define SERV_48_HEADER "DispatchBench.h"
+#define SERV_48_INIT InitBenchService
+#define SERV_48_RUN RunBenchService
+#define SERV_48_QUEUE_SIZE 4
+#define SERV_49_HEADER "DispatchBench.h"
+#define SERV_49_INIT InitBenchService
+#define SERV_49_RUN RunBenchService
+#define SERV_49_QUEUE_SIZE 4
+#define SERV_50_HEADER "DispatchBench.h"
+#define SERV_50_INIT InitBenchService
+#define SERV_50_RUN RunBenchService
+#define SERV_50_QUEUE_SIZE 4
+#define SERV_51_HEADER "DispatchBench.h"
+#define SERV_51_INIT InitBenchService
+#define SERV_51_RUN RunBenchService
+#define SERV_51_QUEUE_SIZE 4
+#define SERV_52_HEADER "DispatchBench.h"
+#define SERV_52_INIT InitBenchService
+#define SERV_52_RUN RunBenchService
+#define SERV_52_QUEUE_SIZE 4
+#define SERV_53_HEADER "DispatchBench.h"
+#define SERV_53_INIT InitBenchService
+#define SERV_53_RUN RunBenchService
+#define SERV_53_QUEUE_SIZE 4
+#define SERV_54_HEADER "DispatchBench.h"
+#define SERV_54_INIT InitBenchService
+#define SERV_54_RUN RunBenchService
+#define SERV_54_QUEUE_SIZE 4
+#define SERV_55_HEADER "DispatchBench.h"
+#define SERV_55_INIT InitBenchService
+#define SERV_55_RUN RunBenchService
+#define SERV_55_QUEUE_SIZE 4
+#define SERV_56_HEADER "DispatchBench.h"
+#define SERV_56_INIT InitBenchService
+#define SERV_56_RUN RunBenchService
+#define SERV_56_QUEUE_SIZE 4
+#define SERV_57_HEADER "DispatchBench.h"
+#define SERV_57_INIT InitBenchService
+#define SERV_57_RUN RunBenchService
+#define SERV_57_QUEUE_SIZE 4
+#define SERV_58_HEADER "DispatchBench.h"
+#define SERV_58_INIT InitBenchService
+#define SERV_58_RUN RunBenchService
+#define SERV_58_QUEUE_SIZE 4
+#define SERV_59_HEADER "DispatchBench.h"
+#define SERV_59_INIT InitBenchService
+#define SERV_59_RUN RunBenchService
+#define SERV_59_QUEUE_SIZE 4
+#define SERV_60_HEADER "DispatchBench.h"
+#define SERV_60_INIT InitBenchService
+#define SERV_60_RUN RunBenchService
+#define SERV_60_QUEUE_SIZE 4
+#define SERV_61_HEADER "DispatchBench.h"
+#define SERV_61_INIT InitBenchService
+#define SERV_61_RUN RunBenchService
+#define SERV_61_QUEUE_SIZE 4
+#define SERV_62_HEADER "DispatchBench.h"
+#define SERV_62_INIT InitBenchService
+#define SERV_62_RUN RunBenchService
+#define SERV_62_QUEUE_SIZE 4
+#define SERV_63_HEADER "DispatchBench.h"
+#define SERV_63_INIT InitBenchService
+#define SERV_63_RUN RunBenchService
+#define SERV_63_QUEUE_SIZE 4
+
+#define POST_KEY_FUNC ES_PostAll
+
+// every service subscribes, for the publish row of the benchmark
+#define ES_SUBSCRIPTIONS ES_SUBSCRIBE(BENCH_EVENT, ~(ES_ReadySet_t) 0)
+
+#endif /* CONFIGURE_H */
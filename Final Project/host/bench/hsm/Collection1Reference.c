@@ -0,0 +1,152 @@
+/*
+ * File: Collection1Reference.c
+ *
+ * The reference HsmBench.c checks the table driven Collection1SubHSM against.
+ * Collection1Baseline.c is src/Collection1SubHSM.c as it was before the
+ * machine moved to transition tables, byte for byte; it is not to be edited,
+ * so that the check never drifts along with the tables. It is compiled here
+ * under other names, against stand-ins for what the framework has dropped
+ * since: its shared timer numbers and its console output.
+ *
+ * The tables were meant to change the machine's behaviour in two ways, and
+ * each is an expected difference, made explicit here or in HsmBench.c rather
+ * than edited into the baseline:
+ *
+ *  - every state has a timer of its own, whose ES_TIMEOUT reaches only that
+ *    state. The baseline's states share timer numbers and most take any
+ *    ES_TIMEOUT as theirs, Reverse moving to a state it never set on one
+ *    that is not; HsmBench.c maps each timeout to the timer the machine
+ *    started and gives the tables alone the timeouts of states that are not
+ *    active, which they must hand back untouched.
+ *  - TAPE_SENSED during the reverses and turns is deferred until the state
+ *    is left, then posted again if the tape sensors still read it, where the
+ *    baseline dropped it or handed it back. RunCollection1Reference() parks
+ *    it the same way and recalls it when the baseline changes state or is
+ *    sent ES_EXIT.
+ *
+ * Events bubbling from the wall states to WallFollowing change nothing: its
+ * rows are what each of them did in its own case.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "Bot.h" // DRIVE_SPEED and SPIN_SPEED read the robot's BotTuning_t
+#include "HsmBench.h"
+#include "sensors.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+// the baseline's timer numbers, from its ES_Configure.h
+#define COLLISION_TIMER 2
+#define FOLLOW_TIMER 5
+#define REVERSE_TIMER 7
+#define CHECK_TIMER 8
+
+// its functions under names of their own, and its printf output dropped
+#define InitCollection1SubHSM InitCollection1Baseline
+#define RunCollection1SubHSM RunCollection1Baseline
+#define printf BaselinePrintf
+
+static int BaselinePrintf(const char *Format, ...) {
+    return 0;
+}
+
+// the baseline as it was, warnings and all: MyPriority and StateNames go
+// unused, and a timeout Reverse does not expect leaves nextState unset
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "Collection1Baseline.c"
+#pragma GCC diagnostic pop
+
+#undef printf
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// TAPE_SENSED held while a reverse or turn runs, as many as the tables hold
+static ES_Event Parked[COLLECTION1SUBHSM_DEFERRED];
+static uint8_t NumParked;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static uint8_t Defers(Collection1SubHSMState_t State);
+static void Recall(void);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t InitCollection1Reference(void) {
+    // the baseline left these to the C start-up, which only runs once
+    collisionFrom = START;
+    alignCounter = 0;
+    bumperCounter = 0;
+    rightBumped = 0;
+    leftBumped = 0;
+    NumParked = 0;
+    return InitCollection1Baseline();
+}
+
+ES_Event RunCollection1Reference(ES_Event ThisEvent, ES_Event *pGiven) {
+    Collection1SubHSMState_t Before = CurrentState;
+
+    if ((ThisEvent.EventType == TAPE_SENSED) && Defers(CurrentState)) {
+        // a full queue loses the event, and the row still consumes it
+        if (NumParked < COLLECTION1SUBHSM_DEFERRED) {
+            Parked[NumParked++] = ThisEvent;
+        }
+        pGiven->EventType = ES_NO_EVENT;
+        ThisEvent.EventType = ES_NO_EVENT;
+        return ThisEvent;
+    }
+    *pGiven = ThisEvent;
+    ThisEvent = RunCollection1Baseline(ThisEvent);
+    if ((CurrentState != Before) || (pGiven->EventType == ES_EXIT)) {
+        Recall();
+    }
+    return ThisEvent;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// the states whose chart rows defer TAPE_SENSED
+static uint8_t Defers(Collection1SubHSMState_t State) {
+    switch (State) {
+    case Reverse:
+    case CollisionReverse:
+    case StuckReverse:
+    case Turn90Left:
+    case Turn90Right:
+    case Turn45Left:
+    case Turn45Right:
+    case Adjust90Left:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+// what ES_HsmRecall() does with the machine's IsTapeCurrent guard
+static void Recall(void) {
+    uint8_t i;
+
+    for (i = 0; i < NumParked; i++) {
+        if (Parked[i].EventParam == botReadTape()) {
+            ES_PostInOrder(PostTopHSM, Parked[i]);
+        }
+    }
+    NumParked = 0;
+}
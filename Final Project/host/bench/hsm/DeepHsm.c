@@ -0,0 +1,174 @@
+/*
+ * File: DeepHsm.c
+ *
+ * The nested machine es_hsm_bench times transitions through. It does nothing
+ * but log the hooks ES_Hsm runs, see DeepHsm.chart.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "DeepHsm.h"
+#include <stdio.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define MAX_HOOKS 32
+#define EXIT_HOOK 0x80 // or'd into the state of an exit hook
+
+/* es_chart begin: generated from DeepHsm.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_COLLECTION1
+
+typedef enum {
+    Init,
+    A,
+    B,
+    C,
+    D,
+    D2,
+    C2,
+    B2,
+    Z,
+} DeepHsmState_t;
+
+static const char *const StateNames[] ES_TRACE_NAMES = {
+	"Init",
+	"A",
+	"B",
+	"C",
+	"D",
+	"D2",
+	"C2",
+	"B2",
+	"Z",
+};
+
+// the machine in this robot's context, see HSM_MACHINE
+#define Hsm (Me->Hsm)
+
+// the state the machine is in, for ES_Trace()
+#define CurrentState ((DeepHsmState_t) Hsm.Current)
+
+// always hooks
+static void Log(ES_Event ThisEvent);
+
+static ES_HsmTransition_t const InitRows[] = {
+    {ES_INIT, NULL, NULL, A},
+};
+
+static ES_HsmTransition_t const ARows[] = {
+    {TOP_BUMPER_CHANGED, NULL, NULL, Z},
+};
+
+static ES_HsmTransition_t const DRows[] = {
+    {TAPE_NOT_SENSED, NULL, NULL, C2},
+    {TAPE_SENSED, NULL, NULL, D2},
+    {BUMPER_CHANGED, NULL, NULL, B2},
+    {WALL_FOUND, NULL, NULL, D},
+    {WALL_NOT_FOUND, NULL, NULL, A},
+};
+
+static ES_HsmTransition_t const D2Rows[] = {
+    {TAPE_SENSED, NULL, NULL, D},
+};
+
+static ES_HsmTransition_t const C2Rows[] = {
+    {TAPE_NOT_SENSED, NULL, NULL, D},
+};
+
+static ES_HsmTransition_t const B2Rows[] = {
+    {BUMPER_CHANGED, NULL, NULL, D},
+};
+
+static ES_HsmTransition_t const ZRows[] = {
+    {TOP_BUMPER_CHANGED, NULL, NULL, D},
+    {WALL_FOUND, NULL, NULL, A, ES_HSM_DEEP},
+    {WALL_NOT_FOUND, NULL, NULL, A, ES_HSM_SHALLOW},
+};
+
+// in DeepHsmState_t order: entry, exit, always, timeout, rows, parent, depth,
+// initial substate, the events it and the states enclosing it have rows for
+static ES_HsmState_t const States[] = {
+    [Init] = {NULL, NULL, Log, 0, ES_HSM_ROWS(InitRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [A] = {NULL, NULL, Log, 0, ES_HSM_ROWS(ARows), ES_HSM_NONE, 0, B,
+            ES_HSM_ALL_EVENTS},
+    [B] = {NULL, NULL, Log, 0, ES_HSM_NO_ROWS, A, 1, C,
+            ES_HSM_ALL_EVENTS},
+    [C] = {NULL, NULL, Log, 0, ES_HSM_NO_ROWS, B, 2, D,
+            ES_HSM_ALL_EVENTS},
+    [D] = {NULL, NULL, Log, 0, ES_HSM_ROWS(DRows), C, 3, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [D2] = {NULL, NULL, Log, 0, ES_HSM_ROWS(D2Rows), C, 3, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [C2] = {NULL, NULL, Log, 0, ES_HSM_ROWS(C2Rows), B, 2, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [B2] = {NULL, NULL, Log, 0, ES_HSM_ROWS(B2Rows), A, 1, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [Z] = {NULL, NULL, Log, 0, ES_HSM_ROWS(ZRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+};
+
+// the initializer of Hsm, whose arrays are in the same context
+#define HSM_MACHINE ES_HSM_MACHINE(States, ES_TRACE_ID, Me->LastSubstates, ES_HSM_DEEP)
+/* es_chart end */
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static DeepHsmContext_t Context;
+#define Me (&Context)
+
+// the hooks run, in order
+static uint8_t Hooks[MAX_HOOKS];
+static uint8_t NumHooks;
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+uint8_t InitDeepHsm(void) {
+    NumHooks = 0;
+    Hsm = (ES_Hsm_t) HSM_MACHINE;
+    if (ES_HsmInit(&Hsm, Init) != TRUE) {
+        return FALSE;
+    }
+    return (ES_HsmDispatch(&Hsm, INIT_EVENT).EventType == ES_NO_EVENT);
+}
+
+ES_Event RunDeepHsm(ES_Event ThisEvent) {
+    return ES_HsmDispatch(&Hsm, ThisEvent);
+}
+
+void DeepHsmHooks(char *pText, int Size) {
+    int i, n = 0;
+
+    if (Size > 0) {
+        pText[0] = '\0';
+    }
+    for (i = 0; (i < NumHooks) && (n < Size); i++) {
+        n += snprintf(pText + n, Size - n, "%s%c%s", (i > 0) ? " " : "",
+                (Hooks[i] & EXIT_HOOK) ? '-' : '+', StateNames[Hooks[i] & ~EXIT_HOOK]);
+    }
+    NumHooks = 0;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// the always hook of every state, which ES_Hsm has just made the running one
+static void Log(ES_Event ThisEvent) {
+    if ((NumHooks < MAX_HOOKS)
+            && ((ThisEvent.EventType == ES_ENTRY) || (ThisEvent.EventType == ES_EXIT))) {
+        Hooks[NumHooks++] = Hsm.Running | ((ThisEvent.EventType == ES_EXIT) ? EXIT_HOOK : 0);
+    }
+}
@@ -0,0 +1,33 @@
+/*
+ * File: DeepHsm.h
+ *
+ * The nested machine es_hsm_bench times transitions through, see
+ * DeepHsm.chart.
+ */
+
+#ifndef DEEPHSM_H
+#define DEEPHSM_H
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+
+/* es_chart begin: generated from DeepHsm.chart by es_chart, edit the chart and run make -C host charts */
+// the states of the machine, for the arrays of its context
+#define DEEPHSM_NUM_STATES 9
+/* es_chart end */
+
+// the machine and what it resumes, in a context as the robot's machines are
+typedef struct {
+    ES_Hsm_t Hsm;
+    uint8_t LastSubstates[DEEPHSM_NUM_STATES];
+} DeepHsmContext_t;
+
+uint8_t InitDeepHsm(void);
+
+ES_Event RunDeepHsm(ES_Event ThisEvent);
+
+// the hooks run since the last call, as "-D -C +C2", into pText, and forgets
+// them; a Size of 0 only forgets them
+void DeepHsmHooks(char *pText, int Size);
+
+#endif /* DEEPHSM_H */
@@ -0,0 +1,572 @@
+/*
+ * File: HsmBench.c
+ *
+ * Checks the table driven Collection1SubHSM against the switch version it
+ * replaced, and times the two. The reference is the baseline's own source,
+ * never edited, with the two changes the tables were meant to make to its
+ * behaviour, per-state timeouts and deferred tape, spelled out around it as
+ * expected differences, see Collection1Reference.c.
+ *
+ * The two run side by side, each on a robot and board of its own, and are fed
+ * the same pseudo-random stream of the events the top level hands down: tape
+ * and bumper changes with every param the machine tests, wall events,
+ * ES_EXIT / ES_ENTRY pairs, and timeouts. A timeout is either that of the
+ * timer the machines last started, which each gets with its own param, or one
+ * for a state of the tables that is not active, which only the tables get and
+ * must hand back. Tape events set the tape sensors, so a deferred tape event
+ * is recalled only if no other came after it; the recalled events are handed
+ * to both machines ahead of the stream, as the top level would, and checked
+ * like any other. After every event the returned event, the motor outputs,
+ * the timer last started and the events recalled must match, otherwise the
+ * benchmark stops at the first difference.
+ *
+ * Each machine's part of the stream is then replayed to it for the timing,
+ * the baseline without the reference around it. The timers are stubbed here,
+ * so the times are the machines' own work plus the motor calls, without the
+ * timer wheel or the queues.
+ *
+ * Then DeepHsm, nested four deep, is taken from its innermost leaf through
+ * each kind of transition and back, checking the exit and entry hooks run
+ * against the least common ancestor rule of ES_Hsm.h and timing each kind,
+ * and out of A and back in through its shallow and deep history.
+ *
+ *   es_hsm_bench [events]
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "Collection1SubHSM.h"
+#include "TopHSM.h"
+#include "HsmBench.h"
+#include "DeepHsm.h"
+#include "Bot.h"
+#include "HostBoard.h"
+#include "motors.h"
+#include "pwm.h"
+#include "IO_Ports.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define DEFAULT_EVENTS 20000000
+#define STREAM_EVENTS 1000000 // compared, then replayed for the timing
+#define ROUNDS 5
+
+// the two machines, and their robots and boards
+#define REFERENCE 0
+#define TABLES 1
+
+// recalled events waiting to be handed back, at most a deferred queue's worth
+#define MAX_PENDING 8
+
+#define DEEP_ROUND_TRIPS 2000000
+#define MAX_HOOK_TEXT 128
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    uint8_t (*Init)(void);
+    ES_Event (*Run)(ES_Event);
+    const char *Name;
+} Machine_t;
+
+// the timer a machine last started
+typedef struct {
+    uint16_t Param; // of its ES_TIMEOUT
+    uint32_t Ticks;
+    uint32_t Started; // the event it was started on
+    uint8_t Running;
+} BenchTimer_t;
+
+// a transition of DeepHsm from D and the one back to D
+typedef struct {
+    ES_EventTyp_t Event;
+    const char *Ancestor;
+    const char *There; // the hooks run, see DeepHsmHooks()
+    const char *Back;
+} DeepTrip_t;
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// timed as they were on the robot, the baseline without the reference's
+// parking, which only the check needs
+static const Machine_t Machines[] = {
+    [REFERENCE] = {InitCollection1Reference, RunCollection1Baseline, "switch"},
+    [TABLES] = {InitCollection1SubHSM, RunCollection1SubHSM, "tables"},
+};
+
+static const DeepTrip_t DeepTrips[] = {
+    {TAPE_SENSED, "C", "-D +D2", "-D2 +D"},
+    {TAPE_NOT_SENSED, "B", "-D -C +C2", "-C2 +C +D"},
+    {BUMPER_CHANGED, "A", "-D -C -B +B2", "-B2 +B +C +D"},
+    {TOP_BUMPER_CHANGED, "top", "-D -C -B -A +Z", "-Z +A +B +C +D"},
+    {WALL_FOUND, "self", "-D +D", "-D +D"},
+    {WALL_NOT_FOUND, "top", "-D -C -B -A +A +B +C +D", "-D -C -B -A +A +B +C +D"},
+};
+
+#define NUM_DEEP_TRIPS (sizeof (DeepTrips) / sizeof (DeepTrips[0]))
+
+// from D, in turn
+static const DeepTrip_t HistoryTrips[] = {
+    {TAPE_SENSED, "C", "-D +D2", NULL},
+    {TOP_BUMPER_CHANGED, "top", "-D2 -C -B -A +Z", NULL},
+    {WALL_FOUND, "deep", "-Z +A +B +C +D2", NULL},
+    {TOP_BUMPER_CHANGED, "top", "-D2 -C -B -A +Z", NULL},
+    {WALL_NOT_FOUND, "shallow", "-Z +A +B +C +D", NULL},
+};
+
+#define NUM_HISTORY_TRIPS (sizeof (HistoryTrips) / sizeof (HistoryTrips[0]))
+
+// the robots the machines run in and their boards; the framework is not
+// linked in, so the context pointer is defined here
+ES_THREAD_LOCAL ES_Context_t *ES_CurrentContext;
+static Bot_t Bots[2];
+static HostBoard_t Boards[2];
+
+static BenchTimer_t Timers[2];
+static uint32_t Step;
+// the machine running, whose recalls PostTopHSM() keeps while checking
+static uint8_t Running;
+static uint8_t Checking;
+static ES_Event Pending[2][MAX_PENDING];
+static uint8_t NumPending[2];
+static uint32_t Seed;
+static volatile uint32_t Sink;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static double Now(void);
+static void Select(uint8_t Machine);
+static void Reset(uint8_t Machine);
+static uint32_t Random(void);
+static void NextEvents(ES_Event Events[2]);
+static uint16_t StrayTimeout(uint32_t r);
+static void SetTape(uint16_t Tape);
+static uint32_t Outputs(void);
+static int CheckCollection1(ES_Event *pStreams[2], long Lengths[2]);
+static double TimeMachine(uint8_t Machine, const ES_Event *pEvents, long Length, long Events);
+static int CheckHooks(ES_Event ThisEvent, const char *Expected);
+static int BenchDeepHsm(void);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+// the state timers of the tables, the only part of the framework they use here
+void ES_Timer_Start(ES_Timer_t *pTimer, uint32_t Ticks, pPostFunc PostFunc, uint16_t Param) {
+    pTimer->Param = Param;
+    Timers[TABLES] = (BenchTimer_t) {Param, Ticks, Step, TRUE};
+}
+
+void ES_Timer_Cancel(ES_Timer_t *pTimer) {
+    if (pTimer->Param == Timers[TABLES].Param) {
+        Timers[TABLES].Running = FALSE;
+    }
+}
+
+// and the numbered timers the baseline shares between its states
+int8_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime) {
+    Timers[REFERENCE] = (BenchTimer_t) {Num, NewTime, Step, TRUE};
+    return SUCCESS;
+}
+
+int8_t ES_Timer_StopTimer(uint8_t Num) {
+    if (Num == Timers[REFERENCE].Param) {
+        Timers[REFERENCE].Running = FALSE;
+    }
+    return SUCCESS;
+}
+
+// where the timers and the recalled events go; only the recalls are kept, and
+// only while checking
+uint8_t PostTopHSM(ES_Event ThisEvent) {
+    if (Checking) {
+        if (NumPending[Running] == MAX_PENDING) {
+            return FALSE;
+        }
+        Pending[Running][NumPending[Running]++] = ThisEvent;
+    }
+    return TRUE;
+}
+
+// how the recalls are posted, without the queues there is nothing to coalesce
+uint8_t ES_PostInOrder(pPostFunc PostFunc, ES_Event ThisEvent) {
+    return PostFunc(ThisEvent);
+}
+
+int main(int argc, char **argv) {
+    long Events = (argc > 1) ? atol(argv[1]) : DEFAULT_EVENTS;
+    ES_Event *pStreams[2];
+    long Lengths[2];
+    double Time[2], Best[2] = {1e9, 1e9};
+    int m, r;
+
+    pStreams[REFERENCE] = malloc(STREAM_EVENTS * sizeof (ES_Event));
+    pStreams[TABLES] = malloc(STREAM_EVENTS * sizeof (ES_Event));
+    if ((pStreams[REFERENCE] == NULL) || (pStreams[TABLES] == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    if (CheckCollection1(pStreams, Lengths) != TRUE) {
+        return EXIT_FAILURE;
+    }
+
+    // each machine's events again, alternating the two, best of ROUNDS
+    for (r = 0; r < ROUNDS; r++) {
+        for (m = 0; m < 2; m++) {
+            Time[m] = TimeMachine(m, pStreams[m], Lengths[m], Events);
+            if (Time[m] < Best[m]) {
+                Best[m] = Time[m];
+            }
+        }
+    }
+    printf("machine  ns/event  Mevents/s\n");
+    for (m = 0; m < 2; m++) {
+        printf("%-7s  %8.1f  %9.2f\n", Machines[m].Name, Best[m] * 1e9 / Events,
+                Events / Best[m] / 1e6);
+    }
+    printf("tables take %.2fx the time per event of switch\n", Best[TABLES] / Best[REFERENCE]);
+    free(pStreams[REFERENCE]);
+    free(pStreams[TABLES]);
+    return BenchDeepHsm();
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+static double Now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// makes the machine's robot and board current
+static void Select(uint8_t Machine) {
+    ES_CurrentContext = &Bots[Machine].Framework;
+    HostBoard_Select(&Boards[Machine]);
+    Running = Machine;
+}
+
+// fresh board, timer and recalls, then the machine's own init
+static void Reset(uint8_t Machine) {
+    Select(Machine);
+    BOARD_Init();
+    PWM_Init();
+    motors_Init();
+    Timers[Machine] = (BenchTimer_t) {0, 0, 0, FALSE};
+    NumPending[Machine] = 0;
+    Machines[Machine].Init();
+}
+
+// xorshift32
+static uint32_t Random(void) {
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return Seed;
+}
+
+// the next event for each machine: a recalled one, or the next of the stream;
+// the reference gets ES_NO_EVENT for a timeout of a state that is not active
+static void NextEvents(ES_Event Events[2]) {
+    static const uint16_t TapeParams[] = {FRONT_BOTH, FRONT_LEFT, FRONT_RIGHT, REAR_BOTH};
+    static const uint16_t BumperParams[] = {0b1100, 0b1000, 0b0100, 0b0000};
+    ES_Event ThisEvent = {ES_NO_EVENT, 0};
+    uint32_t r;
+    uint8_t m;
+
+    if (NumPending[TABLES] > 0) {
+        Events[REFERENCE] = Pending[REFERENCE][0];
+        Events[TABLES] = Pending[TABLES][0];
+        for (m = 0; m < 2; m++) {
+            NumPending[m]--;
+            memmove(&Pending[m][0], &Pending[m][1], NumPending[m] * sizeof (ES_Event));
+        }
+        return;
+    }
+    r = Random();
+    switch (r % 16) {
+    case 0: case 1: case 2: case 3: case 4:
+        ThisEvent.EventType = ES_TIMEOUT;
+        if (Timers[TABLES].Running && ((r >> 8) % 8 != 0)) {
+            for (m = 0; m < 2; m++) {
+                Events[m] = (ES_Event) {ES_TIMEOUT, Timers[m].Param};
+                Timers[m].Running = FALSE;
+            }
+        } else {
+            Events[REFERENCE] = (ES_Event) {ES_NO_EVENT, 0};
+            Events[TABLES] = (ES_Event) {ES_TIMEOUT, StrayTimeout(r)};
+        }
+        return;
+    case 5: case 6:
+        ThisEvent.EventType = TAPE_SENSED;
+        ThisEvent.EventParam = TapeParams[(r >> 8) % 4];
+        SetTape(ThisEvent.EventParam);
+        break;
+    case 7:
+        ThisEvent.EventType = TAPE_NOT_SENSED;
+        SetTape(0);
+        break;
+    case 8: case 9:
+        ThisEvent.EventType = BUMPER_CHANGED;
+        ThisEvent.EventParam = BumperParams[(r >> 8) % 4];
+        break;
+    case 10:
+        ThisEvent.EventType = TOP_BUMPER_CHANGED;
+        break;
+    case 11:
+        ThisEvent.EventType = ((r >> 8) & 1) ? WALL_FOUND : WALL_NOT_FOUND;
+        break;
+    case 12:
+        ThisEvent.EventType = ((r >> 8) & 1) ? OTHER_WALL_FOUND : OTHER_WALL_NOT_FOUND;
+        break;
+    case 13:
+        ThisEvent.EventType = TRACK_WIRE_FOUND;
+        break;
+    case 14:
+        ThisEvent.EventType = ES_EXIT;
+        break;
+    default:
+        ThisEvent.EventType = ES_ENTRY;
+        break;
+    }
+    Events[REFERENCE] = ThisEvent;
+    Events[TABLES] = ThisEvent;
+}
+
+// the timeout param of a state of the tables that is neither the current
+// state nor encloses it
+static uint16_t StrayTimeout(uint32_t r) {
+    ES_Hsm_t const *pHsm = &Bots[TABLES].Collection1.Hsm;
+    uint8_t Stray = (r >> 8) % pHsm->NumStates;
+    uint8_t s = pHsm->Current;
+
+    while (s != ES_HSM_NONE) {
+        if (s == Stray) {
+            Stray = (Stray + 1) % pHsm->NumStates;
+            s = pHsm->Current;
+        } else {
+            s = pHsm->pStates[s].Parent;
+        }
+    }
+    return pHsm->TimerBase + Stray;
+}
+
+// the tape sensors of both boards read what the last tape event says, as on
+// the robot, so a deferred tape event is recalled only if no other came after it
+static void SetTape(uint16_t Tape) {
+    uint8_t m;
+
+    for (m = 0; m < 2; m++) {
+        HostBoard_Select(&Boards[m]);
+        PORTX05_BIT = (Tape >> 3) & 1;
+        PORTX04_BIT = (Tape >> 2) & 1;
+        PORTX03_BIT = (Tape >> 1) & 1;
+        PORTX06_BIT = Tape & 1;
+    }
+}
+
+// the motor duty cycles and every output latch of the current board folded
+// into one word
+static uint32_t Outputs(void) {
+    uint32_t Hash = 2166136261u;
+    int i;
+
+    Hash = (Hash ^ PWM_GetDutyCycle(PWM_PORTZ06)) * 16777619u;
+    Hash = (Hash ^ PWM_GetDutyCycle(PWM_PORTY04)) * 16777619u;
+    Hash = (Hash ^ PWM_GetDutyCycle(PWM_PORTX11)) * 16777619u;
+    Hash = (Hash ^ PWM_GetDutyCycle(PWM_PORTY10)) * 16777619u;
+    for (i = 0; i < IO_NUM_PINS; i++) {
+        Hash = (Hash ^ IO_HostPins[i].LAT) * 16777619u;
+    }
+    return Hash;
+}
+
+// runs the reference and the tables side by side, keeping the events each
+// machine was given for the timing; FALSE at the first difference
+static int CheckCollection1(ES_Event *pStreams[2], long Lengths[2]) {
+    ES_Event Events[2], Returned[2], Given;
+    uint32_t Out[2];
+    uint32_t Strays = 0, Deferred = 0, Recalled = 0;
+    int Same;
+    uint8_t m, i;
+
+    Reset(REFERENCE);
+    Reset(TABLES);
+    Seed = 1;
+    Lengths[REFERENCE] = 0;
+    Lengths[TABLES] = 0;
+    Checking = TRUE;
+    for (Step = 0; Step < STREAM_EVENTS; Step++) {
+        if (NumPending[TABLES] > 0) {
+            Recalled++;
+        }
+        NextEvents(Events);
+        Select(REFERENCE);
+        if (Events[REFERENCE].EventType == ES_NO_EVENT) {
+            Returned[REFERENCE] = Events[TABLES]; // to be handed back
+            Strays++;
+        } else {
+            Returned[REFERENCE] = RunCollection1Reference(Events[REFERENCE], &Given);
+            if (Given.EventType != ES_NO_EVENT) {
+                pStreams[REFERENCE][Lengths[REFERENCE]++] = Given;
+            } else {
+                Deferred++;
+            }
+        }
+        Out[REFERENCE] = Outputs();
+        Select(TABLES);
+        Returned[TABLES] = RunCollection1SubHSM(Events[TABLES]);
+        pStreams[TABLES][Lengths[TABLES]++] = Events[TABLES];
+        Out[TABLES] = Outputs();
+
+        // a timeout handed back carries the param each machine gave it, and
+        // ES_NO_EVENT none
+        Same = (Returned[REFERENCE].EventType == Returned[TABLES].EventType)
+                && ((Returned[TABLES].EventType == ES_TIMEOUT)
+                || (Returned[TABLES].EventType == ES_NO_EVENT)
+                || (Returned[REFERENCE].EventParam == Returned[TABLES].EventParam))
+                && (Out[REFERENCE] == Out[TABLES])
+                && (Timers[REFERENCE].Ticks == Timers[TABLES].Ticks)
+                && (Timers[REFERENCE].Started == Timers[TABLES].Started)
+                && (Timers[REFERENCE].Running == Timers[TABLES].Running)
+                && (NumPending[REFERENCE] == NumPending[TABLES]);
+        for (i = 0; Same && (i < NumPending[TABLES]); i++) {
+            Same = (Pending[REFERENCE][i].EventType == Pending[TABLES][i].EventType)
+                    && (Pending[REFERENCE][i].EventParam == Pending[TABLES][i].EventParam);
+        }
+        if (!Same) {
+            fprintf(stderr, "event %lu (%s, 0x%04X):", (unsigned long) Step,
+                    EventNames[Events[TABLES].EventType], Events[TABLES].EventParam);
+            for (m = 0; m < 2; m++) {
+                fprintf(stderr, "%s %s returned %s, outputs 0x%08X, timer %lu ms from event %lu%s,"
+                        " %u recalled", (m == 0) ? "" : ";", Machines[m].Name,
+                        EventNames[Returned[m].EventType], Out[m],
+                        (unsigned long) Timers[m].Ticks, (unsigned long) Timers[m].Started,
+                        Timers[m].Running ? "" : " stopped", NumPending[m]);
+            }
+            fprintf(stderr, "\n");
+            return FALSE;
+        }
+    }
+    Checking = FALSE;
+    if (Recalled == 0) {
+        fprintf(stderr, "Collection1SubHSM: no deferred event was ever recalled\n");
+        return FALSE;
+    }
+    printf("Collection1SubHSM: %d events as the baseline switch does them, %lu timeouts of"
+            " inactive states handed back, %lu tape events deferred, %lu recalled\n",
+            STREAM_EVENTS, (unsigned long) Strays, (unsigned long) Deferred,
+            (unsigned long) Recalled);
+    return TRUE;
+}
+
+// Events events of the machine's stream, from the start each time round
+static double TimeMachine(uint8_t Machine, const ES_Event *pEvents, long Length, long Events) {
+    ES_Event (*Run)(ES_Event) = Machines[Machine].Run;
+    uint32_t Total = 0;
+    double Start;
+    long e;
+    long i;
+
+    Start = Now();
+    for (e = 0; e < Events; e += Length) {
+        Reset(Machine);
+        for (i = 0; (i < Length) && (e + i < Events); i++) {
+            Total += Run(pEvents[i]).EventType;
+        }
+    }
+    Sink = Total;
+    return Now() - Start;
+}
+
+// Runs ThisEvent through DeepHsm, FALSE if the hooks are not Expected
+static int CheckHooks(ES_Event ThisEvent, const char *Expected) {
+    char Hooks[MAX_HOOK_TEXT];
+
+    RunDeepHsm(ThisEvent);
+    DeepHsmHooks(Hooks, sizeof (Hooks));
+    if (strcmp(Hooks, Expected) != 0) {
+        fprintf(stderr, "DeepHsm, %s: ran %s, not %s\n", EventNames[ThisEvent.EventType],
+                Hooks, Expected);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// checks then times DeepHsm's transitions
+static int BenchDeepHsm(void) {
+    static const ES_Event Exit = {ES_EXIT, 0}, Entry = {ES_ENTRY, 0};
+    char Hooks[MAX_HOOK_TEXT];
+    ES_Event ThisEvent = {ES_NO_EVENT, 0};
+    double Start, Time, Best;
+    uint32_t Total = 0;
+    long i;
+    int t, r;
+
+    if (InitDeepHsm() != TRUE) {
+        fprintf(stderr, "DeepHsm: ES_HsmInit() refused the tables\n");
+        return EXIT_FAILURE;
+    }
+    DeepHsmHooks(Hooks, sizeof (Hooks));
+    if ((strcmp(Hooks, "-Init +A +B +C +D") != 0) || (CheckHooks(Exit, "-D -C -B -A") != TRUE)
+            || (CheckHooks(Entry, "+A +B +C +D") != TRUE)) {
+        fprintf(stderr, "DeepHsm: wrong hooks entering or leaving the machine\n");
+        return EXIT_FAILURE;
+    }
+    for (t = 0; t < (int) NUM_DEEP_TRIPS; t++) {
+        ThisEvent.EventType = DeepTrips[t].Event;
+        if ((CheckHooks(ThisEvent, DeepTrips[t].There) != TRUE)
+                || (CheckHooks(ThisEvent, DeepTrips[t].Back) != TRUE)) {
+            return EXIT_FAILURE;
+        }
+    }
+    for (t = 0; t < (int) NUM_HISTORY_TRIPS; t++) {
+        ThisEvent.EventType = HistoryTrips[t].Event;
+        if (CheckHooks(ThisEvent, HistoryTrips[t].There) != TRUE) {
+            return EXIT_FAILURE;
+        }
+    }
+    printf("DeepHsm: hooks in order for every transition, at most %d states on the path\n",
+            ES_HSM_MAX_DEPTH);
+
+    printf("ancestor  hooks  ns/transition\n");
+    for (t = 0; t < (int) NUM_DEEP_TRIPS; t++) {
+        ThisEvent.EventType = DeepTrips[t].Event;
+        Best = 1e9;
+        for (r = 0; r < ROUNDS; r++) {
+            Start = Now();
+            for (i = 0; i < DEEP_ROUND_TRIPS; i++) {
+                Total += RunDeepHsm(ThisEvent).EventType;
+                Total += RunDeepHsm(ThisEvent).EventType;
+                DeepHsmHooks(Hooks, 0);
+            }
+            Time = Now() - Start;
+            if (Time < Best) {
+                Best = Time;
+            }
+        }
+        printf("%-8s  %5d  %13.1f\n", DeepTrips[t].Ancestor,
+                (int) (strlen(DeepTrips[t].There) + 1) / 3, Best * 1e9 / (2 * DEEP_ROUND_TRIPS));
+    }
+    Sink = Total;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+/*
+ * File: HsmBench.h
+ *
+ * The reference the HSM benchmark checks the table driven Collection1SubHSM
+ * against: the switch version as it was before the tables, with the changes
+ * made to its behaviour since spelled out around it, see Collection1Reference.c.
+ */
+
+#ifndef HSMBENCH_H
+#define HSMBENCH_H
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+
+// the baseline's InitCollection1SubHSM() and RunCollection1SubHSM(), unchanged
+uint8_t InitCollection1Baseline(void);
+ES_Event RunCollection1Baseline(ES_Event ThisEvent);
+
+/**
+ * @Function InitCollection1Reference(void)
+ * @return what InitCollection1Baseline() returns
+ * @brief Starts the baseline over, its variables and the parked events
+ *        included. */
+uint8_t InitCollection1Reference(void);
+
+/**
+ * @Function RunCollection1Reference(ES_Event ThisEvent, ES_Event *pGiven)
+ * @param ThisEvent - the event the table version is given too
+ * @param pGiven - gets the event handed to the baseline, ES_NO_EVENT if it was
+ *                 parked instead
+ * @return what the table version is expected to return
+ * @brief The baseline with tape deferred during the reverses and turns;
+ *        recalled events are posted through PostTopHSM(). */
+ES_Event RunCollection1Reference(ES_Event ThisEvent, ES_Event *pGiven);
+
+#endif /* HSMBENCH_H */
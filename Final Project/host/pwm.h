@@ -0,0 +1,41 @@
+/*
+ * File: pwm.h
+ *
+ * Linux host stand-in for the Uno32 PWM library. Duty cycles are kept in
+ * memory so the host harness can read back what the application commanded.
+ */
+
+#ifndef PWM_H
+#define PWM_H
+
+#include <stdint.h>
+
+#define PWM_PORTZ06 ((uint16_t)(1 << 0))
+#define PWM_PORTY12 ((uint16_t)(1 << 1))
+#define PWM_PORTY10 ((uint16_t)(1 << 2))
+#define PWM_PORTY04 ((uint16_t)(1 << 3))
+#define PWM_PORTX11 ((uint16_t)(1 << 4))
+
+#define PWM_NUM_PINS 5
+
+#define MIN_PWM 0
+#define MAX_PWM 1000
+#define PWM_DEFAULT_FREQUENCY 1000
+
+char PWM_Init(void);
+
+char PWM_SetFrequency(unsigned int NewFrequency);
+
+unsigned int PWM_GetFrequency(void);
+
+char PWM_AddPins(unsigned short int AddPins);
+
+char PWM_RemovePins(unsigned short int RemovePins);
+
+char PWM_SetDutyCycle(unsigned char Channel, unsigned int Duty);
+
+unsigned int PWM_GetDutyCycle(unsigned char Channel);
+
+char PWM_End(void);
+
+#endif /* PWM_H */
@@ -0,0 +1,21 @@
+/*
+ * File: serial.h
+ *
+ * Linux host stand-in for the Uno32 serial library. The console is the
+ * process's stdout, and the transmit buffer is never full.
+ */
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+void SERIAL_Init(void);
+
+void PutChar(char ch);
+
+char GetChar(void);
+
+char IsTransmitEmpty(void);
+
+char IsReceiveEmpty(void);
+
+#endif /* SERIAL_H */
@@ -0,0 +1,141 @@
+/*
+ * File: QueueTest.c
+ *
+ * Host test of the queue's latest-wins update, ES_UpdateQueued(), which
+ * ES_PostToService() uses for the COALESCED_EVENTS. A coalesced post may only
+ * merge into the newest queued event: merged into an older one it would jump
+ * the events of other types queued after it. CheckTape posts TAPE_SENSED and
+ * TAPE_NOT_SENSED alternately, and with TAPE_SENSED coalesced a merge past a
+ * TAPE_NOT_SENSED left the state machine believing the tape was gone while
+ * the sensors still saw it.
+ *
+ *   es_queue_test
+ *     prints each case and exits with failure if any of them fails
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Configure.h"
+#include "ES_Queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+#define QUEUE_SIZE 8
+#define MAX_EVENTS 8
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    const char *Name;
+    uint8_t NumQueued; // events queued before the post
+    ES_Event Queued[MAX_EVENTS];
+    ES_Event Posted;
+    uint8_t Merged; // what ES_UpdateQueued() must return
+    uint8_t NumExpected; // events dequeued after the post
+    ES_Event Expected[MAX_EVENTS];
+} QueueCase_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES                                                           *
+ ******************************************************************************/
+
+static const QueueCase_t Cases[] = {
+    {"merge past an event of another type",
+        3, {{ES_TIMEOUT, 0}, {TAPE_SENSED, 1}, {TAPE_NOT_SENSED, 0}},
+        {TAPE_SENSED, 2}, FALSE,
+        4, {{ES_TIMEOUT, 0}, {TAPE_SENSED, 1}, {TAPE_NOT_SENSED, 0}, {TAPE_SENSED, 2}}},
+    {"merge into the newest event",
+        2, {{ES_TIMEOUT, 0}, {TAPE_SENSED, 1}},
+        {TAPE_SENSED, 2}, TRUE,
+        2, {{ES_TIMEOUT, 0}, {TAPE_SENSED, 2}}},
+    {"merge into the oldest event",
+        1, {{TAPE_SENSED, 1}},
+        {TAPE_SENSED, 2}, FALSE,
+        2, {{TAPE_SENSED, 1}, {TAPE_SENSED, 2}}},
+    {"merge into an empty queue",
+        0, {{ES_NO_EVENT, 0}},
+        {TAPE_SENSED, 2}, FALSE,
+        1, {{TAPE_SENSED, 2}}},
+};
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static int RunCase(const QueueCase_t *pCase, uint8_t Start);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(void) {
+    int Failed = 0;
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_SIZE(Cases); i++) {
+        // once from the start of the ring and once across its wrap
+        if (!RunCase(&Cases[i], 0) || !RunCase(&Cases[i], QUEUE_SIZE - 2)) {
+            Failed++;
+        }
+    }
+    printf("%d of %u cases failed\n", Failed, (unsigned) ARRAY_SIZE(Cases));
+    return (Failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// queues the case's events with Start entries already gone through the ring,
+// posts the way ES_PostToService() does and checks what comes off the queue
+static int RunCase(const QueueCase_t *pCase, uint8_t Start) {
+    ES_Event Queue[1 + QUEUE_SIZE];
+    ES_Event Event;
+    uint8_t Merged;
+    uint8_t i;
+
+    ES_InitQueue(Queue, ARRAY_SIZE(Queue));
+    for (i = 0; i < Start; i++) {
+        ES_EnQueueFIFO(Queue, (ES_Event) {ES_NO_EVENT, 0});
+        ES_DeQueue(Queue, &Event);
+    }
+    for (i = 0; i < pCase->NumQueued; i++) {
+        ES_EnQueueFIFO(Queue, pCase->Queued[i]);
+    }
+    Merged = ES_UpdateQueued(Queue, pCase->Posted);
+    if (!Merged) {
+        ES_EnQueueFIFO(Queue, pCase->Posted);
+    }
+    if (Merged != pCase->Merged) {
+        printf("FAIL %s: %s\n", pCase->Name, Merged ? "merged" : "not merged");
+        return FALSE;
+    }
+    for (i = 0; i < pCase->NumExpected; i++) {
+        ES_DeQueue(Queue, &Event);
+        if ((Event.EventType != pCase->Expected[i].EventType)
+                || (Event.EventParam != pCase->Expected[i].EventParam)) {
+            printf("FAIL %s: event %u is %s(%u), not %s(%u)\n", pCase->Name, i,
+                    EventNames[Event.EventType], Event.EventParam,
+                    EventNames[pCase->Expected[i].EventType], pCase->Expected[i].EventParam);
+            return FALSE;
+        }
+    }
+    if (!ES_IsQueueEmpty(Queue)) {
+        printf("FAIL %s: more events than expected\n", pCase->Name);
+        return FALSE;
+    }
+    if (Start == 0) {
+        printf("ok   %s\n", pCase->Name);
+    }
+    return TRUE;
+}
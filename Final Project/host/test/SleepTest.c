@@ -0,0 +1,226 @@
+/*
+ * File: SleepTest.c
+ *
+ * Host test of the Uno32 port's tickless sleep, ES_Port_Sleep() in
+ * ES_Port_PIC32.c, built against the register stand-ins in pic32/. The port
+ * stretches the Timer 1 period over the ticks it may sleep and, once woken,
+ * works out from TMR1 how many whole ticks went by. TMR1 used to be corrected
+ * with the timer running, which lost the counts that went by between reading
+ * it and writing it back. The model here lets time go by at every access to
+ * the timer and fails a case that writes TMR1 while it runs, or that counts
+ * other than one tick per TickPeriod counts.
+ *
+ *   es_sleep_test
+ *     prints each case and exits with failure if any of them fails
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include <xc.h>
+#include "BOARD.h"
+#include "serial.h"
+#include "ES_Port.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define ARRAY_SIZE(x) (sizeof (x) / sizeof ((x)[0]))
+#define TICK_PERIOD (PB_FREQ / 8 / 1000) // Timer 1 counts per tick, as the port has it
+#define NEVER 1000000 // no other interrupt ends the WAIT
+
+/*******************************************************************************
+ * PRIVATE TYPEDEFS                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    const char *Name;
+    uint32_t Start; // TMR1 when the run loop goes to sleep
+    uint32_t Ticks; // what it asks ES_Port_Sleep() for
+    uint32_t AccessCounts; // counts that go by at every access while running
+    uint32_t WaitCounts; // counts until another interrupt ends the WAIT
+    uint32_t Stretch; // ticks PR1 must cover during the WAIT, 0 for no WAIT
+} SleepCase_t;
+
+/*******************************************************************************
+ * PRIVATE VARIABLES                                                           *
+ ******************************************************************************/
+
+static const SleepCase_t Cases[] = {
+    {"woken inside the stretch", 100, 10, 1, 12345, 10},
+    {"woken a count before a tick", 100, 10, 0, 3 * TICK_PERIOD - 101, 10},
+    {"woken at the end of the stretch", 2000, 5, 2, NEVER, 5},
+    {"stretch limited to 16 bits", 0, 1000, 1, NEVER, 0xFFFF / TICK_PERIOD},
+    {"one tick is not stretched", 200, 1, 1, 50, 1},
+    {"tick ending before the stretch", TICK_PERIOD - 1, 5, 1, NEVER, 0},
+};
+
+// Timer 1 as the model runs it
+static struct {
+    PicT1Con_t Con;
+    uint32_t Count; // TMR1
+    uint32_t Known; // TMR1 as the model last left it
+    uint32_t AccessCounts;
+    uint32_t WaitCounts;
+    uint32_t Elapsed; // counts gone by since the case started
+    uint32_t WaitPeriod; // counts to a match during the WAIT, 0 if there was none
+    uint8_t WrittenRunning;
+} Timer1;
+
+uint32_t PR1;
+PicIpc1_t IPC1bits;
+PicIfs0_t IFS0bits;
+PicIec0_t IEC0bits;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+void ES_Port_Timer1Handler(void);
+
+static int RunCase(const SleepCase_t *pCase);
+static void Sync(void);
+static void Advance(uint32_t Counts);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(void) {
+    int Failed = 0;
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_SIZE(Cases); i++) {
+        if (!RunCase(&Cases[i])) {
+            Failed++;
+        }
+    }
+    printf("%d of %u cases failed\n", Failed, (unsigned) ARRAY_SIZE(Cases));
+    return (Failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+PicT1Con_t *Pic_T1Con(void) {
+    Sync();
+    if (Timer1.Con.ON) {
+        Advance(Timer1.AccessCounts);
+    }
+    return &Timer1.Con;
+}
+
+uint32_t *Pic_Tmr1(void) {
+    Sync();
+    if (Timer1.Con.ON) {
+        Advance(Timer1.AccessCounts);
+    }
+    return &Timer1.Count;
+}
+
+// the WAIT ends at the first interrupt, the Timer 1 one or another
+void Pic_Wait(void) {
+    uint32_t i;
+
+    Sync();
+    Timer1.WaitPeriod = PR1 + 1;
+    for (i = 0; Timer1.Con.ON && (i < Timer1.WaitCounts) && !IFS0bits.T1IF; i++) {
+        Advance(1);
+    }
+}
+
+unsigned int BOARD_GetPBClock(void) {
+    return PB_FREQ;
+}
+
+char IsReceiveEmpty(void) {
+    return TRUE;
+}
+
+char GetChar(void) {
+    return 0;
+}
+
+char IsTransmitEmpty(void) {
+    return TRUE;
+}
+
+void PutChar(char ch) {
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// sleeps once from the case's TMR1 and checks the ticks counted against the
+// counts that went by
+static int RunCase(const SleepCase_t *pCase) {
+    uint32_t Total;
+    uint32_t Ticks;
+
+    ES_Port_Init();
+    IFS0bits.T1IF = 0;
+    Timer1.Count = pCase->Start;
+    Timer1.Known = pCase->Start;
+    Timer1.AccessCounts = pCase->AccessCounts;
+    Timer1.WaitCounts = pCase->WaitCounts;
+    Timer1.Elapsed = 0;
+    Timer1.WaitPeriod = 0;
+    Timer1.WrittenRunning = FALSE;
+
+    ES_Port_Sleep(pCase->Ticks);
+    Sync();
+    // the run loop unmasks interrupts
+    if (IFS0bits.T1IF) {
+        ES_Port_Timer1Handler();
+    }
+    Ticks = ES_Port_TicksElapsed();
+    Total = pCase->Start + Timer1.Elapsed;
+
+    if (Timer1.WrittenRunning) {
+        printf("FAIL %s: TMR1 written while Timer 1 was running\n", pCase->Name);
+        return FALSE;
+    }
+    if (Timer1.WaitPeriod != ((pCase->Stretch == 0) ? 0 : pCase->Stretch * TICK_PERIOD)) {
+        printf("FAIL %s: slept with a period of %u counts, not %u ticks\n", pCase->Name,
+                (unsigned) Timer1.WaitPeriod, (unsigned) pCase->Stretch);
+        return FALSE;
+    }
+    if ((Ticks != Total / TICK_PERIOD) || (Timer1.Count != Total % TICK_PERIOD)) {
+        printf("FAIL %s: %u ticks and %u counts after %u counts\n", pCase->Name,
+                (unsigned) Ticks, (unsigned) Timer1.Count, (unsigned) Total);
+        return FALSE;
+    }
+    if ((PR1 != TICK_PERIOD - 1) || !Timer1.Con.ON) {
+        printf("FAIL %s: Timer 1 not back at one tick a period\n", pCase->Name);
+        return FALSE;
+    }
+    printf("ok   %s\n", pCase->Name);
+    return TRUE;
+}
+
+// a TMR1 that is not as the model left it was written since the last access,
+// with the timer as it is now
+static void Sync(void) {
+    if (Timer1.Count != Timer1.Known) {
+        if (Timer1.Con.ON) {
+            Timer1.WrittenRunning = TRUE;
+        }
+        Timer1.Known = Timer1.Count;
+    }
+}
+
+// TMR1 starts over on the count after it matches PR1
+static void Advance(uint32_t Counts) {
+    while (Counts-- > 0) {
+        if (Timer1.Count == PR1) {
+            Timer1.Count = 0;
+            IFS0bits.T1IF = 1;
+        } else {
+            Timer1.Count++;
+        }
+        Timer1.Elapsed++;
+    }
+    Timer1.Known = Timer1.Count;
+}
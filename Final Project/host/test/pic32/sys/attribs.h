@@ -0,0 +1,13 @@
+/*
+ * File: attribs.h
+ *
+ * Stand-in for the XC32 interrupt attributes, see ../xc.h. The test calls the
+ * handler itself.
+ */
+
+#ifndef ATTRIBS_H
+#define ATTRIBS_H
+
+#define __ISR(Vector, Priority)
+
+#endif /* ATTRIBS_H */
@@ -0,0 +1,60 @@
+/*
+ * File: xc.h
+ *
+ * Stand-in for the XC32 device header that lets SleepTest.c build
+ * ES_Port_PIC32.c on the host. Timer 1 is modelled in SleepTest.c: it counts
+ * only when its test says time goes by, and every access to T1CON or TMR1
+ * notes whether TMR1 was written while the timer was running. The other
+ * registers the port touches are plain variables.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include <stdint.h>
+
+#define _TIMER_1_VECTOR 4
+
+typedef union {
+    uint32_t w;
+    struct {
+        unsigned : 4;
+        unsigned TCKPS : 2;
+        unsigned : 9;
+        unsigned ON : 1;
+    };
+} PicT1Con_t;
+
+typedef struct {
+    unsigned T1IS : 2;
+    unsigned T1IP : 3;
+} PicIpc1_t;
+
+typedef struct {
+    unsigned T1IF : 1;
+} PicIfs0_t;
+
+typedef struct {
+    unsigned T1IE : 1;
+} PicIec0_t;
+
+// the accesses the model sees, see SleepTest.c
+PicT1Con_t *Pic_T1Con(void);
+uint32_t *Pic_Tmr1(void);
+void Pic_Wait(void);
+
+extern uint32_t PR1;
+extern PicIpc1_t IPC1bits;
+extern PicIfs0_t IFS0bits;
+extern PicIec0_t IEC0bits;
+
+#define T1CON (Pic_T1Con()->w)
+#define T1CONbits (*Pic_T1Con())
+#define TMR1 (*Pic_Tmr1())
+
+#define _wait() Pic_Wait()
+#define _CP0_GET_COUNT() 0u
+#define __builtin_disable_interrupts() 1u
+#define __builtin_enable_interrupts() ((void) 0)
+
+#endif /* XC_H */
@@ -0,0 +1,1082 @@
+/*
+ * File: StateChart.c
+ *
+ * es_chart, the state chart compiler. Each .chart file describes either the
+ * application's events or one state machine, and es_chart writes the C for it
+ * between the "es_chart begin" and "es_chart end" lines of the source file it
+ * belongs to: the ES_EventTyp_t enum and EventNames[] of ES_Configure.h, and
+ * for a machine its state enum, StateNames[], ES_TRACE_ID and, unless it keeps
+ * its own switch, the ES_Hsm.h transition tables. A machine's header gets the
+ * number of states between the same two lines, as NAME_NUM_STATES in capitals,
+ * for the arrays of the context struct the machine keeps its variables in. The
+ * enums, the names the trace decoder reads and the tables all come from one
+ * place and cannot drift apart. Everything outside the two lines is left
+ * alone, and the file keeps its line endings.
+ *
+ * The tables of a machine are shared by every robot, its ES_Hsm_t is not: the
+ * generated code takes it to be the Hsm member of the context Me points to,
+ * which the machine #defines, with ES_Timer_t StateTimers[] and uint8_t
+ * LastSubstates[] of NAME_NUM_STATES next to it if it has timers or a row
+ * resumes a state, and ES_Event Deferred[NAME_DEFERRED + 1] if it defers. The
+ * machine's Init sets Hsm to HSM_MACHINE before ES_HsmInit().
+ *
+ * A chart is a list of lines, # starts a comment:
+ *
+ *   events                      the application's events, for ES_Configure.h
+ *   event NAME                  one per line, numbered after the framework's
+ *
+ *   machine NAME                a state machine, for NAME.c, whose states are
+ *                               a NAME##State_t
+ *   trace TRACE_ID              its entry in ES_TraceMachine_t
+ *   dispatch switch|tables      switch: only the state enum and names, the
+ *                               machine keeps its own Run function (the
+ *                               default is tables)
+ *   timers BASE POSTFUNC        one ES_Timer_t per state, posting to POSTFUNC
+ *                               an ES_TIMEOUT whose param is BASE + state
+ *   resume deep|shallow|restart how ES_ENTRY from the enclosing machine
+ *                               re-enters this one (the default is deep)
+ *   defer SIZE [GUARD]          room for SIZE deferred events, a power of two
+ *                               up to 128; recalled events go out through
+ *                               the POSTFUNC of the timers line, those that
+ *                               fail uint8_t GUARD(ES_Event) are dropped
+ *   state NAME [in PARENT] [timeout TICKS]
+ *                               a state, in enum order; a timeout is started
+ *                               on entry and stopped on exit. A substate
+ *                               comes after its PARENT
+ *     initial NAME              the substate entered after this one, which
+ *                               every state with substates names
+ *     entry FUNC                void FUNC(void)
+ *     exit FUNC                 void FUNC(void)
+ *     always FUNC               void FUNC(ES_Event), on every event
+ *     EVENT [GUARD] / ACTION -> TARGET [H|H*]
+ *                               uint8_t GUARD(ES_Event) and void
+ *                               ACTION(ES_Event) are optional, TARGET is a
+ *                               state, internal, pass or defer, see
+ *                               ES_Hsm.h; an
+ *                               event a state has no row for goes on to
+ *                               the state it is in. H resumes a TARGET
+ *                               with substates in the one it was left from,
+ *                               H* in the whole chain it was left from
+ *
+ *   file NAME                   write into NAME instead of NAME.c, and a
+ *                               machine's header into NAME with .h for .c
+ *
+ * Each state's rows are sorted by event number, rows for the same event
+ * keeping their order, and the events that it and the states enclosing it
+ * have rows for are listed with the state as ES_HSM_EVENT() bits, so that the
+ * engine hands back an event no row is for without scanning the rows. The
+ * events are checked against the events chart,
+ * which must be one of the charts given. The functions named in a chart are
+ * declared static by the generated code and written by hand below it.
+ *
+ *   es_chart [-c] chart...
+ *     -c  only check that the generated code is up to date, exit 1 if not
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define MAX_NAME 64
+#define MAX_TOKENS 16
+#define MAX_EVENTS 254 // event ids are one byte in the trace, less NUMBEROFEVENTS
+#define MAX_STATES 250 // below ES_HSM_PASS and ES_HSM_INTERNAL
+#define MAX_ROWS 64
+#define MAX_FUNCS 256
+#define MAX_DEPTH 8 // ES_HSM_MAX_DEPTH
+
+#define BEGIN_MARK "es_chart begin"
+#define END_MARK "es_chart end"
+
+typedef enum {
+    ROLE_NONE,
+    ROLE_HOOK, // void (void)
+    ROLE_ALWAYS, // void (ES_Event)
+    ROLE_GUARD, // uint8_t (ES_Event)
+    ROLE_ACTION, // void (ES_Event)
+    NUM_ROLES,
+} Role_t;
+
+typedef struct {
+    char Event[MAX_NAME];
+    char Guard[MAX_NAME]; // empty for none
+    char Action[MAX_NAME]; // empty for none
+    char Target[MAX_NAME];
+    const char *History; // ES_HSM_SHALLOW or ES_HSM_DEEP, NULL for neither
+    int EventId;
+    int Line;
+} Row_t;
+
+typedef struct {
+    char Name[MAX_NAME];
+    char Entry[MAX_NAME];
+    char Exit[MAX_NAME];
+    char Always[MAX_NAME];
+    char Timeout[MAX_NAME]; // C expression, empty for none
+    char Initial[MAX_NAME]; // empty for a leaf
+    int Parent; // -1 at the top level
+    int Depth;
+    int NumChildren;
+    Row_t Rows[MAX_ROWS];
+    int NumRows;
+} State_t;
+
+typedef struct {
+    char Name[MAX_NAME];
+    Role_t Role;
+} Func_t;
+
+typedef struct {
+    const char *Path;
+    char Target[1024]; // the source file the chart writes into
+    char Header[1024]; // the header a machine's state count goes into
+    int IsEvents;
+    char Name[MAX_NAME];
+    char Trace[MAX_NAME];
+    char TimerBase[MAX_NAME];
+    char TimerPost[MAX_NAME];
+    int Tables;
+    const char *Resume;
+    int HasHistory; // a row resumes its target
+    int DeferSize; // from the defer line, 0 without one
+    char DeferGuard[MAX_NAME]; // the Recall guard of the defer line, empty for none
+    State_t *pStates;
+    int NumStates;
+    Func_t Funcs[MAX_FUNCS];
+    int NumFuncs;
+} Chart_t;
+
+typedef struct {
+    char *pText;
+    size_t Length;
+    size_t Size;
+} Buffer_t;
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// the framework's own events, ahead of the application's in ES_EventTyp_t
+static const char *const FrameworkEvents[][2] = {
+    {"ES_NO_EVENT", NULL},
+    {"ES_ERROR", "used to indicate an error from the service"},
+    {"ES_INIT", "used to transition from initial pseudo-state"},
+    {"ES_ENTRY", "used to enter a state"},
+    {"ES_EXIT", "used to exit a state"},
+    {"ES_KEYINPUT", "used to signify a key has been pressed"},
+    {"ES_LISTEVENTS", "used to list events in keyboard input, does not get posted to fsm"},
+    {"ES_TIMEOUT", "signals that the timer has expired"},
+    {"ES_TIMERACTIVE", "signals that a timer has become active"},
+    {"ES_TIMERSTOPPED", "signals that a timer has stopped"},
+};
+
+#define NUM_FRAMEWORK_EVENTS (sizeof (FrameworkEvents) / sizeof (FrameworkEvents[0]))
+
+static const char *const RoleComments[NUM_ROLES] = {
+    NULL,
+    "entry and exit hooks",
+    "always hooks",
+    "guards",
+    "transition actions",
+};
+
+static char Events[NUM_FRAMEWORK_EVENTS + MAX_EVENTS][MAX_NAME];
+static int NumEvents; // framework and application events
+static int HaveEvents; // an events chart was given
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static int LoadChart(const char *Path, Chart_t *pChart);
+static int ParseLine(Chart_t *pChart, char **pTokens, int NumTokens, int Line);
+static int ParseState(Chart_t *pChart, char **pTokens, int NumTokens, int Line);
+static int ParseRow(Chart_t *pChart, State_t *pState, char **pTokens, int NumTokens, int Line);
+static int CheckChart(Chart_t *pChart);
+static int AddFunc(Chart_t *pChart, const char *Name, Role_t Role, int Line);
+static int FindState(const Chart_t *pChart, const char *Name);
+static int FindEvent(const char *Name);
+static int IsIdentifier(const char *Name);
+static void SortRows(State_t *pState);
+static void GenerateEvents(const Chart_t *pChart, Buffer_t *pOut);
+static void GenerateMachine(const Chart_t *pChart, Buffer_t *pOut);
+static void AppendEvents(const Chart_t *pChart, const State_t *pState, Buffer_t *pOut);
+static void GenerateHeader(const Chart_t *pChart, Buffer_t *pOut);
+static int Splice(const Chart_t *pChart, const char *Target, const Buffer_t *pCode, int CheckOnly);
+static void Append(Buffer_t *pOut, const char *Format, ...);
+static const char *BaseName(const char *Path);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(int argc, char **argv) {
+    Chart_t *pCharts;
+    Buffer_t Code;
+    int NumCharts = 0;
+    int CheckOnly = FALSE;
+    int Failed = FALSE;
+    int i, c;
+
+    pCharts = calloc(argc, sizeof (Chart_t));
+    if (pCharts == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            CheckOnly = TRUE;
+        } else if (argv[i][0] != '-') {
+            pCharts[NumCharts++].Path = argv[i];
+        } else {
+            NumCharts = 0;
+            break;
+        }
+    }
+    if (NumCharts == 0) {
+        fprintf(stderr, "usage: %s [-c] chart...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < (int) NUM_FRAMEWORK_EVENTS; i++) {
+        strcpy(Events[NumEvents++], FrameworkEvents[i][0]);
+    }
+    for (c = 0; c < NumCharts; c++) {
+        if (LoadChart(pCharts[c].Path, &pCharts[c]) != TRUE) {
+            return EXIT_FAILURE;
+        }
+    }
+    // the machines once all the events are known
+    for (c = 0; c < NumCharts; c++) {
+        if (!pCharts[c].IsEvents && (CheckChart(&pCharts[c]) != TRUE)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (c = 0; c < NumCharts; c++) {
+        memset(&Code, 0, sizeof (Code));
+        if (pCharts[c].IsEvents) {
+            GenerateEvents(&pCharts[c], &Code);
+        } else {
+            GenerateMachine(&pCharts[c], &Code);
+        }
+        switch (Splice(&pCharts[c], pCharts[c].Target, &Code, CheckOnly)) {
+        case TRUE:
+            break;
+        case FALSE:
+            Failed = TRUE;
+            break;
+        default:
+            return EXIT_FAILURE;
+        }
+        free(Code.pText);
+        if (pCharts[c].IsEvents) {
+            continue;
+        }
+        memset(&Code, 0, sizeof (Code));
+        GenerateHeader(&pCharts[c], &Code);
+        switch (Splice(&pCharts[c], pCharts[c].Header, &Code, CheckOnly)) {
+        case TRUE:
+            break;
+        case FALSE:
+            Failed = TRUE;
+            break;
+        default:
+            return EXIT_FAILURE;
+        }
+        free(Code.pText);
+    }
+    return Failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// reads and parses one chart; events charts add to Events[] straight away
+static int LoadChart(const char *Path, Chart_t *pChart) {
+    FILE *pFile = fopen(Path, "r");
+    char Text[1024];
+    char *pTokens[MAX_TOKENS];
+    char *p;
+    size_t Length;
+    int NumTokens;
+    int Line = 0;
+
+    if (pFile == NULL) {
+        perror(Path);
+        return FALSE;
+    }
+    pChart->Tables = TRUE;
+    pChart->pStates = calloc(MAX_STATES, sizeof (State_t));
+    if (pChart->pStates == NULL) {
+        fprintf(stderr, "out of memory\n");
+        fclose(pFile);
+        return FALSE;
+    }
+    while (fgets(Text, sizeof (Text), pFile) != NULL) {
+        Line++;
+        p = strchr(Text, '#');
+        if (p != NULL) {
+            *p = '\0';
+        }
+        NumTokens = 0;
+        for (p = strtok(Text, " \t\r\n"); p != NULL; p = strtok(NULL, " \t\r\n")) {
+            if (NumTokens == MAX_TOKENS) {
+                fprintf(stderr, "%s:%d: line too long\n", Path, Line);
+                fclose(pFile);
+                return FALSE;
+            }
+            pTokens[NumTokens++] = p;
+        }
+        if ((NumTokens > 0) && (ParseLine(pChart, pTokens, NumTokens, Line) != TRUE)) {
+            fclose(pFile);
+            return FALSE;
+        }
+    }
+    fclose(pFile);
+
+    if (!pChart->IsEvents && (pChart->Name[0] == '\0')) {
+        fprintf(stderr, "%s: neither events nor a machine\n", Path);
+        return FALSE;
+    }
+    if (pChart->Target[0] == '\0') {
+        if (pChart->IsEvents) {
+            fprintf(stderr, "%s: an events chart needs a file line\n", Path);
+            return FALSE;
+        }
+        snprintf(pChart->Target, sizeof (pChart->Target), "%s.c", pChart->Name);
+    }
+    // the target is next to the chart
+    p = strrchr(Path, '/');
+    if (p != NULL) {
+        Length = p + 1 - Path;
+        if (Length + strlen(pChart->Target) >= sizeof (pChart->Target)) {
+            fprintf(stderr, "%s: path too long\n", Path);
+            return FALSE;
+        }
+        memmove(pChart->Target + Length, pChart->Target, strlen(pChart->Target) + 1);
+        memcpy(pChart->Target, Path, Length);
+    }
+    if (!pChart->IsEvents) {
+        Length = strlen(pChart->Target);
+        if ((Length < 2) || (strcmp(pChart->Target + Length - 2, ".c") != 0)) {
+            fprintf(stderr, "%s: %s is not a .c file with a header\n", Path, pChart->Target);
+            return FALSE;
+        }
+        strcpy(pChart->Header, pChart->Target);
+        pChart->Header[Length - 1] = 'h';
+    }
+    return TRUE;
+}
+
+static int ParseLine(Chart_t *pChart, char **pTokens, int NumTokens, int Line) {
+    const char *Path = pChart->Path;
+    State_t *pState = (pChart->NumStates > 0) ? &pChart->pStates[pChart->NumStates - 1] : NULL;
+    const char *Keyword = pTokens[0];
+    char *pTarget;
+    size_t Length;
+
+    if (strcmp(Keyword, "events") == 0) {
+        if ((NumTokens != 1) || (pChart->Name[0] != '\0')) {
+            fprintf(stderr, "%s:%d: events takes nothing and is a chart of its own\n", Path, Line);
+            return FALSE;
+        }
+        if (HaveEvents) {
+            fprintf(stderr, "%s:%d: more than one events chart\n", Path, Line);
+            return FALSE;
+        }
+        pChart->IsEvents = TRUE;
+        HaveEvents = TRUE;
+        return TRUE;
+    }
+    if (strcmp(Keyword, "file") == 0) {
+        if (NumTokens != 2) {
+            fprintf(stderr, "%s:%d: file takes a file name\n", Path, Line);
+            return FALSE;
+        }
+        snprintf(pChart->Target, sizeof (pChart->Target), "%s", pTokens[1]);
+        return TRUE;
+    }
+    if (pChart->IsEvents) {
+        if ((strcmp(Keyword, "event") != 0) || (NumTokens != 2) || !IsIdentifier(pTokens[1])) {
+            fprintf(stderr, "%s:%d: expected event NAME\n", Path, Line);
+            return FALSE;
+        }
+        if (FindEvent(pTokens[1]) >= 0) {
+            fprintf(stderr, "%s:%d: event %s is already defined\n", Path, Line, pTokens[1]);
+            return FALSE;
+        }
+        if (NumEvents == (int) NUM_FRAMEWORK_EVENTS + MAX_EVENTS) {
+            fprintf(stderr, "%s:%d: more than %d events\n", Path, Line, MAX_EVENTS);
+            return FALSE;
+        }
+        strcpy(Events[NumEvents++], pTokens[1]);
+        return TRUE;
+    }
+
+    if (strcmp(Keyword, "machine") == 0) {
+        if ((NumTokens != 2) || !IsIdentifier(pTokens[1]) || (pChart->Name[0] != '\0')) {
+            fprintf(stderr, "%s:%d: expected one machine NAME\n", Path, Line);
+            return FALSE;
+        }
+        strcpy(pChart->Name, pTokens[1]);
+        return TRUE;
+    }
+    if (pChart->Name[0] == '\0') {
+        fprintf(stderr, "%s:%d: expected events or machine first\n", Path, Line);
+        return FALSE;
+    }
+    if (strcmp(Keyword, "trace") == 0) {
+        if ((NumTokens != 2) || !IsIdentifier(pTokens[1])) {
+            fprintf(stderr, "%s:%d: expected trace TRACE_ID\n", Path, Line);
+            return FALSE;
+        }
+        strcpy(pChart->Trace, pTokens[1]);
+    } else if (strcmp(Keyword, "dispatch") == 0) {
+        if ((NumTokens != 2)
+                || ((strcmp(pTokens[1], "switch") != 0) && (strcmp(pTokens[1], "tables") != 0))) {
+            fprintf(stderr, "%s:%d: expected dispatch switch or dispatch tables\n", Path, Line);
+            return FALSE;
+        }
+        pChart->Tables = (strcmp(pTokens[1], "tables") == 0);
+    } else if (strcmp(Keyword, "resume") == 0) {
+        if ((NumTokens != 2) || ((strcmp(pTokens[1], "deep") != 0)
+                && (strcmp(pTokens[1], "shallow") != 0) && (strcmp(pTokens[1], "restart") != 0))) {
+            fprintf(stderr, "%s:%d: expected resume deep, shallow or restart\n", Path, Line);
+            return FALSE;
+        }
+        pChart->Resume = (pTokens[1][0] == 'd') ? "ES_HSM_DEEP"
+                : (pTokens[1][0] == 's') ? "ES_HSM_SHALLOW" : "ES_HSM_RESTART";
+    } else if (strcmp(Keyword, "timers") == 0) {
+        if ((NumTokens != 3) || (strlen(pTokens[1]) >= MAX_NAME) || !IsIdentifier(pTokens[2])) {
+            fprintf(stderr, "%s:%d: expected timers BASE POSTFUNC\n", Path, Line);
+            return FALSE;
+        }
+        strcpy(pChart->TimerBase, pTokens[1]);
+        strcpy(pChart->TimerPost, pTokens[2]);
+    } else if (strcmp(Keyword, "defer") == 0) {
+        pChart->DeferSize = ((NumTokens == 2) || (NumTokens == 3)) ? atoi(pTokens[1]) : 0;
+        if ((pChart->DeferSize <= 0) || (pChart->DeferSize > 128)
+                || ((pChart->DeferSize & (pChart->DeferSize - 1)) != 0)) {
+            fprintf(stderr, "%s:%d: expected defer SIZE [GUARD], SIZE a power of two up to 128\n",
+                    Path, Line);
+            return FALSE;
+        }
+        if (NumTokens == 3) {
+            Length = strlen(pTokens[2]);
+            if ((Length < 3) || (Length > MAX_NAME) || (pTokens[2][0] != '[')
+                    || (pTokens[2][Length - 1] != ']')) {
+                fprintf(stderr, "%s:%d: expected defer SIZE [GUARD]\n", Path, Line);
+                return FALSE;
+            }
+            memcpy(pChart->DeferGuard, pTokens[2] + 1, Length - 2);
+            if (AddFunc(pChart, pChart->DeferGuard, ROLE_GUARD, Line) != TRUE) {
+                return FALSE;
+            }
+        }
+    } else if (strcmp(Keyword, "state") == 0) {
+        return ParseState(pChart, pTokens, NumTokens, Line);
+    } else if (strcmp(Keyword, "initial") == 0) {
+        if ((pState == NULL) || (NumTokens != 2) || !IsIdentifier(pTokens[1])) {
+            fprintf(stderr, "%s:%d: expected initial NAME inside a state\n", Path, Line);
+            return FALSE;
+        }
+        if (pState->Initial[0] != '\0') {
+            fprintf(stderr, "%s:%d: %s has two initial substates\n", Path, Line, pState->Name);
+            return FALSE;
+        }
+        strcpy(pState->Initial, pTokens[1]);
+    } else if ((strcmp(Keyword, "entry") == 0) || (strcmp(Keyword, "exit") == 0)
+            || (strcmp(Keyword, "always") == 0)) {
+        if ((pState == NULL) || (NumTokens != 2)) {
+            fprintf(stderr, "%s:%d: expected %s FUNC inside a state\n", Path, Line, Keyword);
+            return FALSE;
+        }
+        pTarget = (Keyword[0] == 'a') ? pState->Always : (Keyword[1] == 'n') ? pState->Entry : pState->Exit;
+        if (pTarget[0] != '\0') {
+            fprintf(stderr, "%s:%d: %s has two %s hooks\n", Path, Line, pState->Name, Keyword);
+            return FALSE;
+        }
+        if (AddFunc(pChart, pTokens[1], (Keyword[0] == 'a') ? ROLE_ALWAYS : ROLE_HOOK, Line) != TRUE) {
+            return FALSE;
+        }
+        strcpy(pTarget, pTokens[1]);
+    } else if (pState != NULL) {
+        return ParseRow(pChart, pState, pTokens, NumTokens, Line);
+    } else {
+        fprintf(stderr, "%s:%d: unknown %s\n", Path, Line, Keyword);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// state NAME [in PARENT] [timeout TICKS]
+static int ParseState(Chart_t *pChart, char **pTokens, int NumTokens, int Line) {
+    const char *Path = pChart->Path;
+    State_t *pState;
+    State_t *pParent;
+    int i;
+
+    if ((NumTokens % 2 != 0) || !IsIdentifier(pTokens[1])) {
+        goto Syntax;
+    }
+    if (FindState(pChart, pTokens[1]) >= 0) {
+        fprintf(stderr, "%s:%d: state %s is already defined\n", Path, Line, pTokens[1]);
+        return FALSE;
+    }
+    if (pChart->NumStates == MAX_STATES) {
+        fprintf(stderr, "%s:%d: more than %d states\n", Path, Line, MAX_STATES);
+        return FALSE;
+    }
+    pState = &pChart->pStates[pChart->NumStates++];
+    strcpy(pState->Name, pTokens[1]);
+    pState->Parent = -1;
+    for (i = 2; i < NumTokens; i += 2) {
+        if ((strcmp(pTokens[i], "in") == 0) && (pState->Parent < 0)) {
+            pState->Parent = FindState(pChart, pTokens[i + 1]);
+            if (pState->Parent < 0) {
+                fprintf(stderr, "%s:%d: no state %s before %s\n", Path, Line, pTokens[i + 1],
+                        pState->Name);
+                return FALSE;
+            }
+            pParent = &pChart->pStates[pState->Parent];
+            pState->Depth = pParent->Depth + 1;
+            pParent->NumChildren++;
+            if (pState->Depth >= MAX_DEPTH) {
+                fprintf(stderr, "%s:%d: %s nests more than %d deep\n", Path, Line, pState->Name,
+                        MAX_DEPTH);
+                return FALSE;
+            }
+        } else if ((strcmp(pTokens[i], "timeout") == 0) && (pState->Timeout[0] == '\0')) {
+            if ((strlen(pTokens[i + 1]) >= MAX_NAME) || (strtol(pTokens[i + 1], NULL, 0) < 0)
+                    || (strtol(pTokens[i + 1], NULL, 0) > 0xFFFF)) {
+                fprintf(stderr, "%s:%d: timeout %s does not fit 16 bits\n", Path, Line, pTokens[i + 1]);
+                return FALSE;
+            }
+            strcpy(pState->Timeout, pTokens[i + 1]);
+        } else {
+            goto Syntax;
+        }
+    }
+    return TRUE;
+
+Syntax:
+    fprintf(stderr, "%s:%d: expected state NAME [in PARENT] [timeout TICKS]\n", Path, Line);
+    return FALSE;
+}
+
+// EVENT [GUARD] / ACTION -> TARGET
+static int ParseRow(Chart_t *pChart, State_t *pState, char **pTokens, int NumTokens, int Line) {
+    Row_t *pRow = &pState->Rows[pState->NumRows];
+    size_t Length;
+    int i = 1;
+
+    if (pState->NumRows == MAX_ROWS) {
+        fprintf(stderr, "%s:%d: more than %d rows in %s\n", pChart->Path, Line, MAX_ROWS, pState->Name);
+        return FALSE;
+    }
+    memset(pRow, 0, sizeof (*pRow));
+    pRow->Line = Line;
+    if (!IsIdentifier(pTokens[0])) {
+        goto Syntax;
+    }
+    strcpy(pRow->Event, pTokens[0]);
+    if ((i < NumTokens) && (pTokens[i][0] == '[')) {
+        Length = strlen(pTokens[i]);
+        if ((Length < 3) || (Length > MAX_NAME) || (pTokens[i][Length - 1] != ']')) {
+            goto Syntax;
+        }
+        memcpy(pRow->Guard, pTokens[i] + 1, Length - 2);
+        if (AddFunc(pChart, pRow->Guard, ROLE_GUARD, Line) != TRUE) {
+            return FALSE;
+        }
+        i++;
+    }
+    if ((i + 1 < NumTokens) && (strcmp(pTokens[i], "/") == 0)) {
+        if (AddFunc(pChart, pTokens[i + 1], ROLE_ACTION, Line) != TRUE) {
+            return FALSE;
+        }
+        strcpy(pRow->Action, pTokens[i + 1]);
+        i += 2;
+    }
+    if ((i + 2 > NumTokens) || (i + 3 < NumTokens) || (strcmp(pTokens[i], "->") != 0)
+            || !IsIdentifier(pTokens[i + 1])) {
+        goto Syntax;
+    }
+    strcpy(pRow->Target, pTokens[i + 1]);
+    if (i + 3 == NumTokens) {
+        if (strcmp(pTokens[i + 2], "H") == 0) {
+            pRow->History = "ES_HSM_SHALLOW";
+        } else if (strcmp(pTokens[i + 2], "H*") == 0) {
+            pRow->History = "ES_HSM_DEEP";
+        } else {
+            goto Syntax;
+        }
+        pChart->HasHistory = TRUE;
+    }
+    pState->NumRows++;
+    return TRUE;
+
+Syntax:
+    fprintf(stderr, "%s:%d: expected EVENT [GUARD] / ACTION -> TARGET [H|H*]\n", pChart->Path, Line);
+    return FALSE;
+}
+
+// the checks that need the whole chart and the events
+static int CheckChart(Chart_t *pChart) {
+    State_t *pState;
+    Row_t *pRow;
+    int s, r;
+
+    if (pChart->NumStates == 0) {
+        fprintf(stderr, "%s: no states\n", pChart->Path);
+        return FALSE;
+    }
+    if (pChart->Trace[0] == '\0') {
+        fprintf(stderr, "%s: no trace line\n", pChart->Path);
+        return FALSE;
+    }
+    if ((pChart->DeferSize > 0) && (pChart->TimerBase[0] == '\0')) {
+        fprintf(stderr, "%s: a defer line needs a timers line, whose POSTFUNC recalls\n",
+                pChart->Path);
+        return FALSE;
+    }
+    for (s = 0; s < pChart->NumStates; s++) {
+        pState = &pChart->pStates[s];
+        if (!pChart->Tables && ((pState->NumRows > 0) || (pState->Entry[0] != '\0')
+                || (pState->Exit[0] != '\0') || (pState->Always[0] != '\0')
+                || (pState->Timeout[0] != '\0') || (pState->Parent >= 0)
+                || (pChart->Resume != NULL))) {
+            fprintf(stderr, "%s: %s has a table but the machine is dispatch switch\n",
+                    pChart->Path, pState->Name);
+            return FALSE;
+        }
+        if ((pState->NumChildren > 0) != (pState->Initial[0] != '\0')) {
+            fprintf(stderr, "%s: %s needs an initial line exactly when it has substates\n",
+                    pChart->Path, pState->Name);
+            return FALSE;
+        }
+        if ((pState->Initial[0] != '\0')
+                && ((FindState(pChart, pState->Initial) < 0)
+                || (pChart->pStates[FindState(pChart, pState->Initial)].Parent != s))) {
+            fprintf(stderr, "%s: initial %s is not a substate of %s\n", pChart->Path,
+                    pState->Initial, pState->Name);
+            return FALSE;
+        }
+        if ((pState->Timeout[0] != '\0') && (pChart->TimerBase[0] == '\0')) {
+            fprintf(stderr, "%s: %s has a timeout but the machine has no timers line\n",
+                    pChart->Path, pState->Name);
+            return FALSE;
+        }
+        for (r = 0; r < pState->NumRows; r++) {
+            pRow = &pState->Rows[r];
+            if (!HaveEvents) {
+                fprintf(stderr, "%s: no events chart to check %s against\n", pChart->Path, pRow->Event);
+                return FALSE;
+            }
+            pRow->EventId = FindEvent(pRow->Event);
+            if ((pRow->EventId < 0) || (strcmp(pRow->Event, "ES_ENTRY") == 0)
+                    || (strcmp(pRow->Event, "ES_EXIT") == 0)) {
+                fprintf(stderr, "%s:%d: %s is not an event a row can take\n",
+                        pChart->Path, pRow->Line, pRow->Event);
+                return FALSE;
+            }
+            if ((strcmp(pRow->Target, "internal") != 0) && (strcmp(pRow->Target, "pass") != 0)
+                    && (strcmp(pRow->Target, "defer") != 0)
+                    && (FindState(pChart, pRow->Target) < 0)) {
+                fprintf(stderr, "%s:%d: no state %s\n", pChart->Path, pRow->Line, pRow->Target);
+                return FALSE;
+            }
+            if ((strcmp(pRow->Target, "defer") == 0) && (pChart->DeferSize == 0)) {
+                fprintf(stderr, "%s:%d: the machine has no defer line\n", pChart->Path, pRow->Line);
+                return FALSE;
+            }
+            if ((pRow->History != NULL) && ((FindState(pChart, pRow->Target) < 0)
+                    || (pChart->pStates[FindState(pChart, pRow->Target)].NumChildren == 0))) {
+                fprintf(stderr, "%s:%d: %s has no substates to resume\n", pChart->Path, pRow->Line,
+                        pRow->Target);
+                return FALSE;
+            }
+        }
+        SortRows(pState);
+    }
+    return TRUE;
+}
+
+// remembers a function named in the chart, each has one signature
+static int AddFunc(Chart_t *pChart, const char *Name, Role_t Role, int Line) {
+    int i;
+
+    if (!IsIdentifier(Name)) {
+        fprintf(stderr, "%s:%d: %s is not a C name\n", pChart->Path, Line, Name);
+        return FALSE;
+    }
+    for (i = 0; i < pChart->NumFuncs; i++) {
+        if (strcmp(pChart->Funcs[i].Name, Name) == 0) {
+            if (pChart->Funcs[i].Role != Role) {
+                fprintf(stderr, "%s:%d: %s is already one of the %s\n", pChart->Path, Line,
+                        Name, RoleComments[pChart->Funcs[i].Role]);
+                return FALSE;
+            }
+            return TRUE;
+        }
+    }
+    if (pChart->NumFuncs == MAX_FUNCS) {
+        fprintf(stderr, "%s:%d: more than %d functions\n", pChart->Path, Line, MAX_FUNCS);
+        return FALSE;
+    }
+    strcpy(pChart->Funcs[pChart->NumFuncs].Name, Name);
+    pChart->Funcs[pChart->NumFuncs++].Role = Role;
+    return TRUE;
+}
+
+static int FindState(const Chart_t *pChart, const char *Name) {
+    int s;
+
+    for (s = 0; s < pChart->NumStates; s++) {
+        if (strcmp(pChart->pStates[s].Name, Name) == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+static int FindEvent(const char *Name) {
+    int e;
+
+    for (e = 0; e < NumEvents; e++) {
+        if (strcmp(Events[e], Name) == 0) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+static int IsIdentifier(const char *Name) {
+    const char *p = Name;
+
+    if ((strlen(Name) >= MAX_NAME) || !(isalpha((unsigned char) *p) || (*p == '_'))) {
+        return FALSE;
+    }
+    for (p++; *p != '\0'; p++) {
+        if (!(isalnum((unsigned char) *p) || (*p == '_'))) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// insertion sort, stable, the rows of a state are few
+static void SortRows(State_t *pState) {
+    Row_t Row;
+    int i, j;
+
+    for (i = 1; i < pState->NumRows; i++) {
+        Row = pState->Rows[i];
+        for (j = i; (j > 0) && (pState->Rows[j - 1].EventId > Row.EventId); j--) {
+            pState->Rows[j] = pState->Rows[j - 1];
+        }
+        pState->Rows[j] = Row;
+    }
+}
+
+static void GenerateEvents(const Chart_t *pChart, Buffer_t *pOut) {
+    int e;
+
+    Append(pOut, "typedef enum {\n");
+    for (e = 0; e < NumEvents; e++) {
+        if (e == (int) NUM_FRAMEWORK_EVENTS) {
+            Append(pOut, "    /* User-defined events start here */\n");
+        }
+        if ((e < (int) NUM_FRAMEWORK_EVENTS) && (FrameworkEvents[e][1] != NULL)) {
+            Append(pOut, "    %s, /* %s */\n", Events[e], FrameworkEvents[e][1]);
+        } else {
+            Append(pOut, "    %s,\n", Events[e]);
+        }
+    }
+    Append(pOut, "    /* User-defined events end here */\n");
+    Append(pOut, "    NUMBEROFEVENTS,\n");
+    Append(pOut, "} ES_EventTyp_t;\n\n");
+    Append(pOut, "static const char *const EventNames[] = {\n");
+    for (e = 0; e < NumEvents; e++) {
+        Append(pOut, "\t\"%s\",\n", Events[e]);
+    }
+    Append(pOut, "\t\"NUMBEROFEVENTS\",\n");
+    Append(pOut, "};\n");
+}
+
+static void GenerateMachine(const Chart_t *pChart, Buffer_t *pOut) {
+    const State_t *pState;
+    const Row_t *pRow;
+    const char *Target;
+    const char *Resume;
+    Role_t Role;
+    int s, r, f, First;
+
+    Append(pOut, "// this machine in the state machine trace, see ES_TattleTale.h\n");
+    Append(pOut, "#define ES_TRACE_ID %s\n\n", pChart->Trace);
+    Append(pOut, "typedef enum {\n");
+    for (s = 0; s < pChart->NumStates; s++) {
+        Append(pOut, "    %s,\n", pChart->pStates[s].Name);
+    }
+    Append(pOut, "} %sState_t;\n\n", pChart->Name);
+    Append(pOut, "static const char *const StateNames[] ES_TRACE_NAMES = {\n");
+    for (s = 0; s < pChart->NumStates; s++) {
+        Append(pOut, "\t\"%s\",\n", pChart->pStates[s].Name);
+    }
+    Append(pOut, "};\n");
+    if (!pChart->Tables) {
+        return;
+    }
+
+    Append(pOut, "\n// the machine in this robot's context, see HSM_MACHINE\n");
+    Append(pOut, "#define Hsm (Me->Hsm)\n");
+    Append(pOut, "\n// the state the machine is in, for ES_Trace()\n");
+    Append(pOut, "#define CurrentState ((%sState_t) Hsm.Current)\n", pChart->Name);
+    for (Role = ROLE_HOOK; Role < NUM_ROLES; Role++) {
+        First = TRUE;
+        for (f = 0; f < pChart->NumFuncs; f++) {
+            if (pChart->Funcs[f].Role != Role) {
+                continue;
+            }
+            if (First) {
+                Append(pOut, "\n// %s\n", RoleComments[Role]);
+                First = FALSE;
+            }
+            Append(pOut, "static %s %s(%s);\n", (Role == ROLE_GUARD) ? "uint8_t" : "void",
+                    pChart->Funcs[f].Name, (Role == ROLE_HOOK) ? "void" : "ES_Event ThisEvent");
+        }
+    }
+
+    for (s = 0; s < pChart->NumStates; s++) {
+        pState = &pChart->pStates[s];
+        if (pState->NumRows == 0) {
+            continue;
+        }
+        Append(pOut, "\nstatic ES_HsmTransition_t const %sRows[] = {\n", pState->Name);
+        for (r = 0; r < pState->NumRows; r++) {
+            pRow = &pState->Rows[r];
+            Target = pRow->Target;
+            if (strcmp(Target, "internal") == 0) {
+                Target = "ES_HSM_INTERNAL";
+            } else if (strcmp(Target, "pass") == 0) {
+                Target = "ES_HSM_PASS";
+            } else if (strcmp(Target, "defer") == 0) {
+                Target = "ES_HSM_DEFER";
+            }
+            Append(pOut, "    {%s, %s, %s, %s", pRow->Event,
+                    (pRow->Guard[0] != '\0') ? pRow->Guard : "NULL",
+                    (pRow->Action[0] != '\0') ? pRow->Action : "NULL", Target);
+            Append(pOut, (pRow->History != NULL) ? ", %s},\n" : "},\n", pRow->History);
+        }
+        Append(pOut, "};\n");
+    }
+
+    Append(pOut, "\n// in %sState_t order: entry, exit, always, timeout, rows, parent, depth,\n",
+            pChart->Name);
+    Append(pOut, "// initial substate, the events it and the states enclosing it have rows for\n");
+    Append(pOut, "static ES_HsmState_t const States[] = {\n");
+    for (s = 0; s < pChart->NumStates; s++) {
+        pState = &pChart->pStates[s];
+        Append(pOut, "    [%s] = {%s, %s, %s, %s, ", pState->Name,
+                (pState->Entry[0] != '\0') ? pState->Entry : "NULL",
+                (pState->Exit[0] != '\0') ? pState->Exit : "NULL",
+                (pState->Always[0] != '\0') ? pState->Always : "NULL",
+                (pState->Timeout[0] != '\0') ? pState->Timeout : "0");
+        if (pState->NumRows > 0) {
+            Append(pOut, "ES_HSM_ROWS(%sRows), ", pState->Name);
+        } else {
+            Append(pOut, "ES_HSM_NO_ROWS, ");
+        }
+        Append(pOut, "%s, %d, %s,\n            ",
+                (pState->Parent >= 0) ? pChart->pStates[pState->Parent].Name : "ES_HSM_NONE",
+                pState->Depth, (pState->Initial[0] != '\0') ? pState->Initial : "ES_HSM_NONE");
+        AppendEvents(pChart, pState, pOut);
+        Append(pOut, "},\n");
+    }
+    Append(pOut, "};\n\n");
+    Resume = (pChart->Resume != NULL) ? pChart->Resume : "ES_HSM_DEEP";
+    Append(pOut, "// the initializer of Hsm, whose arrays are in the same context\n");
+    if (pChart->TimerBase[0] != '\0') {
+        Append(pOut, "#define HSM_MACHINE ES_HSM_TIMED_MACHINE(States, ES_TRACE_ID, %s, %s, \\\n",
+                pChart->HasHistory ? "Me->LastSubstates" : "NULL", Resume);
+        Append(pOut, "        Me->StateTimers, %s, %s, ", pChart->TimerBase, pChart->TimerPost);
+        if (pChart->DeferSize > 0) {
+            Append(pOut, "ES_HSM_DEFER_QUEUE(Me->Deferred, %s))\n",
+                    (pChart->DeferGuard[0] != '\0') ? pChart->DeferGuard : "NULL");
+        } else {
+            Append(pOut, "ES_HSM_NO_DEFER)\n");
+        }
+    } else {
+        Append(pOut, "#define HSM_MACHINE ES_HSM_MACHINE(States, ES_TRACE_ID, %s, %s)\n",
+                pChart->HasHistory ? "Me->LastSubstates" : "NULL", Resume);
+    }
+}
+
+// the Events of the state's ES_HsmState_t: every event it or a state enclosing
+// it has rows for, in event order, or all of them if one has an Always hook
+static void AppendEvents(const Chart_t *pChart, const State_t *pState, Buffer_t *pOut) {
+    char Listed[NUM_FRAMEWORK_EVENTS + MAX_EVENTS] = {FALSE};
+    const State_t *pEnclosing;
+    int First = TRUE;
+    int e, r;
+
+    for (pEnclosing = pState; pEnclosing != NULL; pEnclosing = (pEnclosing->Parent >= 0)
+            ? &pChart->pStates[pEnclosing->Parent] : NULL) {
+        if (pEnclosing->Always[0] != '\0') {
+            Append(pOut, "ES_HSM_ALL_EVENTS");
+            return;
+        }
+        for (r = 0; r < pEnclosing->NumRows; r++) {
+            Listed[pEnclosing->Rows[r].EventId] = TRUE;
+        }
+    }
+    for (e = 0; e < NumEvents; e++) {
+        if (Listed[e]) {
+            Append(pOut, "%sES_HSM_EVENT(%s)", First ? "" : " | ", Events[e]);
+            First = FALSE;
+        }
+    }
+    if (First) {
+        Append(pOut, "0");
+    }
+}
+
+static void GenerateHeader(const Chart_t *pChart, Buffer_t *pOut) {
+    char Upper[MAX_NAME];
+    int i;
+
+    for (i = 0; pChart->Name[i] != '\0'; i++) {
+        Upper[i] = toupper((unsigned char) pChart->Name[i]);
+    }
+    Upper[i] = '\0';
+    Append(pOut, "// the states of the machine, for the arrays of its context\n");
+    Append(pOut, "#define %s_NUM_STATES %d\n", Upper, pChart->NumStates);
+    if (pChart->DeferSize > 0) {
+        Append(pOut, "// the events it can hold deferred, its Deferred[] has one more\n");
+        Append(pOut, "#define %s_DEFERRED %d\n", Upper, pChart->DeferSize);
+    }
+}
+
+/* Puts the generated code between the marker lines of Target, the chart's
+ * source file or header, in the target's line endings. Returns TRUE if the
+ * target is up to date or was brought up to date, FALSE if it is out of date
+ * and CheckOnly is set, -1 on an error. */
+static int Splice(const Chart_t *pChart, const char *Target, const Buffer_t *pCode, int CheckOnly) {
+    FILE *pFile = fopen(Target, "rb");
+    Buffer_t New = {NULL, 0, 0};
+    const char *Eol;
+    char *pText, *pBegin, *pEnd, *p;
+    long Size;
+    int Same;
+
+    if (pFile == NULL) {
+        perror(Target);
+        return -1;
+    }
+    fseek(pFile, 0, SEEK_END);
+    Size = ftell(pFile);
+    rewind(pFile);
+    pText = malloc(Size + 1);
+    if ((pText == NULL) || (fread(pText, 1, Size, pFile) != (size_t) Size)) {
+        fprintf(stderr, "%s: cannot read\n", Target);
+        fclose(pFile);
+        return -1;
+    }
+    fclose(pFile);
+    pText[Size] = '\0';
+
+    pBegin = strstr(pText, BEGIN_MARK);
+    pEnd = (pBegin != NULL) ? strstr(pBegin, END_MARK) : NULL;
+    if (pEnd == NULL) {
+        fprintf(stderr, "%s: no %s ... %s lines for %s\n", Target, BEGIN_MARK,
+                END_MARK, pChart->Path);
+        free(pText);
+        return -1;
+    }
+    while ((pBegin > pText) && (pBegin[-1] != '\n')) {
+        pBegin--;
+    }
+    p = strchr(pBegin, '\n');
+    Eol = ((p != NULL) && (p > pBegin) && (p[-1] == '\r')) ? "\r\n" : "\n";
+    pEnd = strchr(pEnd, '\n');
+    pEnd = (pEnd != NULL) ? pEnd + 1 : pText + Size;
+
+    Append(&New, "%.*s", (int) (pBegin - pText), pText);
+    Append(&New, "/* %s: generated from %s by es_chart, edit the chart and run"
+            " make -C host charts */%s", BEGIN_MARK, BaseName(pChart->Path), Eol);
+    for (p = pCode->pText; *p != '\0'; p++) {
+        if (*p == '\n') {
+            Append(&New, "%s", Eol);
+        } else {
+            Append(&New, "%c", *p);
+        }
+    }
+    Append(&New, "/* %s */%s", END_MARK, Eol);
+    Append(&New, "%s", pEnd);
+
+    Same = (New.Length == (size_t) Size) && (memcmp(New.pText, pText, Size) == 0);
+    free(pText);
+    if (Same) {
+        free(New.pText);
+        return TRUE;
+    }
+    if (CheckOnly) {
+        fprintf(stderr, "%s: out of date with %s, run make -C host charts\n",
+                Target, pChart->Path);
+        free(New.pText);
+        return FALSE;
+    }
+    pFile = fopen(Target, "wb");
+    if ((pFile == NULL) || (fwrite(New.pText, 1, New.Length, pFile) != New.Length)) {
+        perror(Target);
+        if (pFile != NULL) {
+            fclose(pFile);
+        }
+        free(New.pText);
+        return -1;
+    }
+    fclose(pFile);
+    printf("es_chart: wrote %s\n", Target);
+    free(New.pText);
+    return TRUE;
+}
+
+static void Append(Buffer_t *pOut, const char *Format, ...) {
+    va_list Args;
+    int Length;
+
+    va_start(Args, Format);
+    Length = vsnprintf(NULL, 0, Format, Args);
+    va_end(Args);
+    if (pOut->Length + Length + 1 > pOut->Size) {
+        pOut->Size = 2 * (pOut->Length + Length + 1) + 1024;
+        pOut->pText = realloc(pOut->pText, pOut->Size);
+        if (pOut->pText == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    va_start(Args, Format);
+    vsnprintf(pOut->pText + pOut->Length, Length + 1, Format, Args);
+    va_end(Args);
+    pOut->Length += Length;
+}
+
+static const char *BaseName(const char *Path) {
+    const char *p = strrchr(Path, '/');
+
+    return (p != NULL) ? p + 1 : Path;
+}
@@ -0,0 +1,706 @@
+/*
+ * File: TraceDecode.c
+ *
+ * Decodes a state machine trace written by ES_TattleTale.c, as captured from
+ * the Uno32's serial port or written by es_host -T, into per-machine state
+ * timelines. The ids in the records are mapped back to names by reading the
+ * application sources: EventNames[] and the ES_TraceMachine_t list from
+ * ES_Configure.h, and StateNames[] from each .c file that defines an
+ * ES_TRACE_ID.
+ *
+ * The trace is read in a single pass through a one-frame window and every
+ * state interval is written out as soon as it closes, so memory does not grow
+ * with the length of the trace. Bytes that are not part of a frame with a
+ * good sum, console text for instance, are skipped.
+ *
+ * A capture of a Uno32 built with USE_SENSOR_RECORD also holds the frames of
+ * SensorRecord.h. With -r their data is written out as a recording for
+ * es_host -P, from the first frame of a recording up to the first gap.
+ *
+ *   es_trace [-s <src dir>] [-f csv|stats|transitions|json] [-o <file>]
+ *            [-r <file>] [trace]
+ *     -s  application sources (default ../src)
+ *     -f  csv          one row per state interval (default)
+ *         stats        dwell time per state
+ *         transitions  count of every transition taken
+ *         json         Chrome trace, open in chrome://tracing or Perfetto
+ *     -o  output file (default stdout)
+ *     -r  write the sensor recording in the capture to a file
+ *
+ * Times are the framework's 1 ms ticks, which on the host are virtual time.
+ * Run-to-completion budget overruns are not part of any machine's timeline;
+ * they are counted, and marked on the whole trace in the json format.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_TattleTale.h"
+#include "SensorRecord.h"
+#include "SensorTrace.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define MAX_IDS 256 // machine, state and event ids are all one byte
+#define MAX_NAME 64
+#define MAX_FRAME ((ES_TRACE_FRAME_SIZE > SENSOR_RECORD_FRAME_SIZE) \
+        ? ES_TRACE_FRAME_SIZE : SENSOR_RECORD_FRAME_SIZE)
+
+typedef enum {
+    FORMAT_CSV,
+    FORMAT_STATS,
+    FORMAT_TRANSITIONS,
+    FORMAT_JSON,
+} Format_t;
+
+typedef struct {
+    char Name[MAX_NAME]; // source file without .c, empty until found
+    char *StateNames[MAX_IDS];
+    uint8_t Seen; // a record of this machine has been decoded in this run
+    uint8_t Announced; // named in the output, runs after the first one are not
+    uint8_t State; // state since Since
+    uint32_t Since;
+    uint8_t Trigger; // last event the machine was called with, not counting entry and exit
+    // summary, only allocated for the stats and transitions formats
+    uint32_t *pVisits;
+    uint64_t *pDwell;
+    uint32_t *pMaxDwell;
+    uint32_t *pTransitions; // [from * MAX_IDS + to]
+} Machine_t;
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+static Machine_t Machines[MAX_IDS];
+static char *EventList[MAX_IDS]; // EventNames[] as read from the sources
+static Format_t Format = FORMAT_CSV;
+static FILE *Out;
+static int JsonCount;
+static uint32_t LastTick;
+
+static uint32_t Frames;
+static uint32_t Lost;
+static uint32_t Skipped;
+static uint32_t Overruns;
+static uint16_t WorstOverrun; // us
+// the sensor recording, see -r
+static FILE *Recording;
+static uint32_t SensorFrames;
+static uint32_t SensorBytes;
+static uint8_t SensorSeq; // of the next frame
+static uint8_t SensorStarted;
+static uint8_t SensorGap; // the recording ended at a lost frame
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static char *ReadSource(const char *Path);
+static int ParseNames(const char *pText, const char *Array, char **pNames);
+static int ParseMachineIds(const char *pText, char Ids[MAX_IDS][MAX_NAME]);
+static int LoadNames(const char *SrcDir);
+static void Decode(FILE *In);
+static int FrameSize(const uint8_t *pFrame, int Filled);
+static void HandleTraceFrame(const uint8_t *p);
+static void HandleRecord(const ES_TraceRecord_t *pRecord);
+static void HandleSensorFrame(const uint8_t *pFrame);
+static void EnterState(uint8_t Id, uint8_t State, uint32_t Tick);
+static void CloseState(uint8_t Id, uint8_t NewState, uint32_t Tick);
+static void EndRun(void);
+static void PrintSummary(void);
+static const char *StateName(uint8_t Id, uint8_t State, char *pBuffer);
+static const char *EventName(uint8_t Event, char *pBuffer);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+int main(int argc, char **argv) {
+    const char *SrcDir = "../src";
+    const char *InPath = NULL;
+    FILE *In = stdin;
+    int i;
+
+    Out = stdout;
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+            SrcDir = argv[++i];
+        } else if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc)) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) {
+                Format = FORMAT_CSV;
+            } else if (strcmp(argv[i], "stats") == 0) {
+                Format = FORMAT_STATS;
+            } else if (strcmp(argv[i], "transitions") == 0) {
+                Format = FORMAT_TRANSITIONS;
+            } else if (strcmp(argv[i], "json") == 0) {
+                Format = FORMAT_JSON;
+            } else {
+                fprintf(stderr, "unknown format %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc)) {
+            Out = fopen(argv[++i], "w");
+            if (Out == NULL) {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc)) {
+            Recording = fopen(argv[++i], "wb");
+            if (Recording == NULL) {
+                perror(argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if ((argv[i][0] != '-') && (InPath == NULL)) {
+            InPath = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-s <src dir>] [-f csv|stats|transitions|json] "
+                    "[-o <file>] [-r <file>] [trace]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (LoadNames(SrcDir) != TRUE) {
+        return EXIT_FAILURE;
+    }
+    if (InPath != NULL) {
+        In = fopen(InPath, "rb");
+        if (In == NULL) {
+            perror(InPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (Format == FORMAT_CSV) {
+        fprintf(Out, "machine,state,start_ms,end_ms,dwell_ms,trigger\n");
+    } else if (Format == FORMAT_JSON) {
+        fprintf(Out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    }
+    Decode(In);
+    EndRun();
+    if (Format == FORMAT_JSON) {
+        fprintf(Out, "\n]}\n");
+    } else if (Format != FORMAT_CSV) {
+        PrintSummary();
+    }
+    fflush(Out);
+
+    fprintf(stderr, "%lu records", (unsigned long) Frames);
+    if (Lost > 0) {
+        fprintf(stderr, ", %lu lost to a full ring", (unsigned long) Lost);
+    }
+    if (Skipped > 0) {
+        fprintf(stderr, ", %lu bytes of other output skipped", (unsigned long) Skipped);
+    }
+    if (Overruns > 0) {
+        fprintf(stderr, ", %lu run budget overruns, worst %u us", (unsigned long) Overruns,
+                WorstOverrun);
+    }
+    if (SensorFrames > 0) {
+        fprintf(stderr, ", %lu sensor frames", (unsigned long) SensorFrames);
+    }
+    fprintf(stderr, "\n");
+    if (Recording != NULL) {
+        fprintf(stderr, "%lu bytes of sensor recording%s\n", (unsigned long) SensorBytes,
+                SensorGap ? ", ended at a lost frame" : "");
+        if (!SensorStarted) {
+            fprintf(stderr, "no sensor recording starts in the capture\n");
+        }
+        if ((fclose(Recording) != 0) || !SensorStarted) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// the whole file with its comments blanked out, NULL if it cannot be read
+static char *ReadSource(const char *Path) {
+    FILE *pFile = fopen(Path, "rb");
+    char *pText;
+    long Size;
+    long i;
+
+    if (pFile == NULL) {
+        return NULL;
+    }
+    fseek(pFile, 0, SEEK_END);
+    Size = ftell(pFile);
+    rewind(pFile);
+    pText = malloc(Size + 1);
+    if ((pText == NULL) || (fread(pText, 1, Size, pFile) != (size_t) Size)) {
+        fclose(pFile);
+        free(pText);
+        return NULL;
+    }
+    fclose(pFile);
+    pText[Size] = '\0';
+
+    for (i = 0; i < Size; i++) {
+        if (pText[i] == '"') {
+            for (i++; (i < Size) && (pText[i] != '"'); i++) {
+                if (pText[i] == '\\') {
+                    i++;
+                }
+            }
+        } else if ((pText[i] == '/') && (pText[i + 1] == '/')) {
+            for (; (i < Size) && (pText[i] != '\n'); i++) {
+                pText[i] = ' ';
+            }
+        } else if ((pText[i] == '/') && (pText[i + 1] == '*')) {
+            for (; (i < Size) && !((pText[i] == '*') && (pText[i + 1] == '/')); i++) {
+                if (pText[i] != '\n') {
+                    pText[i] = ' ';
+                }
+            }
+            if (i < Size) {
+                pText[i++] = ' ';
+                pText[i] = ' ';
+            }
+        }
+    }
+    return pText;
+}
+
+// fills pNames from the string array initializer "Array[] = {...}"
+static int ParseNames(const char *pText, const char *Array, char **pNames) {
+    const char *p = strstr(pText, Array);
+    const char *pEnd;
+    int Count = 0;
+    size_t Length;
+
+    if (p == NULL) {
+        return 0;
+    }
+    p = strchr(p, '{');
+    if (p == NULL) {
+        return 0;
+    }
+    for (p++; (*p != '\0') && (*p != '}') && (Count < MAX_IDS); p++) {
+        if (*p != '"') {
+            continue;
+        }
+        pEnd = strchr(p + 1, '"');
+        if (pEnd == NULL) {
+            break;
+        }
+        Length = pEnd - p - 1;
+        pNames[Count] = malloc(Length + 1);
+        memcpy(pNames[Count], p + 1, Length);
+        pNames[Count][Length] = '\0';
+        Count++;
+        p = pEnd;
+    }
+    return Count;
+}
+
+// the enumerators of ES_TraceMachine_t by value
+static int ParseMachineIds(const char *pText, char Ids[MAX_IDS][MAX_NAME]) {
+    const char *pEnd = strstr(pText, "ES_TraceMachine_t;");
+    const char *p;
+    char Name[MAX_NAME];
+    long Value = 0;
+    int Length;
+    int Count = 0;
+
+    if (pEnd == NULL) {
+        return 0;
+    }
+    for (p = pEnd; (p > pText) && (strncmp(p, "enum", 4) != 0); p--) {
+    }
+    p = strchr(p, '{');
+    while ((p != NULL) && (p < pEnd)) {
+        p++;
+        while (isspace((unsigned char) *p)) {
+            p++;
+        }
+        if ((*p == '}') || (sscanf(p, "%63[A-Za-z0-9_]%n", Name, &Length) != 1)) {
+            break;
+        }
+        p += Length;
+        while (isspace((unsigned char) *p)) {
+            p++;
+        }
+        if (*p == '=') {
+            Value = strtol(p + 1, NULL, 0);
+        }
+        if ((Value >= 0) && (Value < MAX_IDS)) {
+            strcpy(Ids[Value], Name);
+            Count++;
+        }
+        Value++;
+        p = strchr(p, ',');
+    }
+    return Count;
+}
+
+static int LoadNames(const char *SrcDir) {
+    static char Ids[MAX_IDS][MAX_NAME];
+    char Path[1024];
+    char Id[MAX_NAME];
+    char *pText;
+    char *p;
+    DIR *pDir;
+    struct dirent *pEntry;
+    size_t Length;
+    int i;
+
+    snprintf(Path, sizeof (Path), "%s/ES_Configure.h", SrcDir);
+    pText = ReadSource(Path);
+    if (pText == NULL) {
+        perror(Path);
+        return FALSE;
+    }
+    if (ParseNames(pText, "EventNames[]", EventList) == 0) {
+        fprintf(stderr, "%s: no EventNames[]\n", Path);
+    }
+    ParseMachineIds(pText, Ids);
+    free(pText);
+
+    pDir = opendir(SrcDir);
+    if (pDir == NULL) {
+        perror(SrcDir);
+        return FALSE;
+    }
+    while ((pEntry = readdir(pDir)) != NULL) {
+        Length = strlen(pEntry->d_name);
+        if ((Length < 3) || (strcmp(pEntry->d_name + Length - 2, ".c") != 0)) {
+            continue;
+        }
+        snprintf(Path, sizeof (Path), "%s/%s", SrcDir, pEntry->d_name);
+        pText = ReadSource(Path);
+        if (pText == NULL) {
+            continue;
+        }
+        p = strstr(pText, "#define ES_TRACE_ID");
+        if ((p != NULL) && (sscanf(p + strlen("#define ES_TRACE_ID"), " %63s", Id) == 1)) {
+            for (i = 0; i < MAX_IDS; i++) {
+                if (strcmp(Ids[i], Id) == 0) {
+                    snprintf(Machines[i].Name, MAX_NAME, "%.*s", (int) (Length - 2), pEntry->d_name);
+                    ParseNames(pText, "StateNames[]", Machines[i].StateNames);
+                    break;
+                }
+            }
+            if (i == MAX_IDS) {
+                fprintf(stderr, "%s: %s is not in ES_TraceMachine_t\n", Path, Id);
+            }
+        }
+        free(pText);
+    }
+    closedir(pDir);
+    strcpy(Machines[0].Name, "ES_Framework");
+    return TRUE;
+}
+
+// slides a one-frame window over the input, byte by byte until it syncs
+static void Decode(FILE *In) {
+    uint8_t Frame[MAX_FRAME];
+    uint8_t Sum;
+    int Filled = 0;
+    int Size;
+    int c, i;
+
+    while ((c = getc(In)) != EOF) {
+        Frame[Filled++] = (uint8_t) c;
+        while (Filled > 0) {
+            Size = FrameSize(Frame, Filled);
+            if ((Size > 0) && (Filled >= Size)) {
+                Sum = 0;
+                for (i = 2; i < Size; i++) {
+                    Sum += Frame[i];
+                }
+                Size = (Sum == 0) ? Size : -1;
+            }
+            if (Size < 0) {
+                // not the start of a frame, drop a byte and look again
+                memmove(Frame, Frame + 1, --Filled);
+                Skipped++;
+                continue;
+            }
+            if ((Size == 0) || (Filled < Size)) {
+                break;
+            }
+            if (Frame[1] == SENSOR_RECORD_SYNC2) {
+                HandleSensorFrame(&Frame[2]);
+            } else {
+                HandleTraceFrame(&Frame[2]);
+            }
+            memmove(Frame, Frame + Size, Filled - Size);
+            Filled -= Size;
+        }
+    }
+    Skipped += Filled;
+}
+
+// the size of the frame the window starts with, 0 while that is not known
+// yet, -1 if it does not start with one
+static int FrameSize(const uint8_t *pFrame, int Filled) {
+    if (pFrame[0] != ES_TRACE_SYNC1) {
+        return -1;
+    }
+    if (Filled < 2) {
+        return 0;
+    }
+    if (pFrame[1] == ES_TRACE_SYNC2) {
+        return ES_TRACE_FRAME_SIZE;
+    }
+    if (pFrame[1] != SENSOR_RECORD_SYNC2) {
+        return -1;
+    }
+    if (Filled < 4) {
+        return 0;
+    }
+    if ((pFrame[3] == 0) || (pFrame[3] > SENSOR_RECORD_MAX_DATA)) {
+        return -1;
+    }
+    return pFrame[3] + 5;
+}
+
+// a trace frame from its Tick on
+static void HandleTraceFrame(const uint8_t *p) {
+    ES_TraceRecord_t Record;
+
+    Record.Tick = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+    p += 4;
+    Record.Stamp = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+    p += 4;
+    Record.Seq = p[0] | (p[1] << 8);
+    p += 2;
+    Record.Param = p[0] | (p[1] << 8);
+    p += 2;
+    Record.Kind = *p++;
+    Record.Machine = *p++;
+    Record.State = *p++;
+    Record.Event = *p++;
+    HandleRecord(&Record);
+}
+
+// a sensor frame from its Seq on; the first recording in the capture goes to
+// -r up to the first frame lost
+static void HandleSensorFrame(const uint8_t *pFrame) {
+    static const uint8_t Header[SENSOR_TRACE_HEADER_LENGTH] = {'E', 'S', 'S', 'L',
+        SENSOR_TRACE_VERSION};
+    uint8_t Seq = pFrame[0];
+    uint8_t Length = pFrame[1];
+
+    SensorFrames++;
+    if ((Recording == NULL) || SensorGap) {
+        return;
+    }
+    if (!SensorStarted) {
+        // a capture started part way through a recording cannot be decoded
+        if (Seq != 0) {
+            return;
+        }
+        fwrite(Header, 1, SENSOR_TRACE_HEADER_LENGTH, Recording);
+        SensorStarted = TRUE;
+    } else if (Seq != SensorSeq) {
+        SensorGap = TRUE;
+        return;
+    }
+    fwrite(&pFrame[2], 1, Length, Recording);
+    SensorBytes += Length;
+    SensorSeq = Seq + 1;
+}
+
+static void HandleRecord(const ES_TraceRecord_t *pRecord) {
+    static uint16_t NextSeq;
+    static uint8_t Synced;
+    Machine_t *pMachine = &Machines[pRecord->Machine];
+    char StateBuffer[16], EventBuffer[16];
+
+    Frames++;
+    if (pRecord->Kind == ES_TRACE_START) {
+        EndRun(); // the robot was reset, close what the last run left open
+        Synced = TRUE;
+        NextSeq = pRecord->Seq + 1;
+        LastTick = pRecord->Tick;
+        return;
+    }
+    // a capture started part way through a run has no ES_TRACE_START
+    if (Synced) {
+        Lost += (uint16_t) (pRecord->Seq - NextSeq);
+    }
+    Synced = TRUE;
+    NextSeq = pRecord->Seq + 1;
+    LastTick = pRecord->Tick;
+
+    // Machine is the service, State the state it reported
+    if (pRecord->Kind == ES_TRACE_OVERRUN) {
+        Overruns++;
+        if (pRecord->Param > WorstOverrun) {
+            WorstOverrun = pRecord->Param;
+        }
+        if (Format == FORMAT_JSON) {
+            fprintf(Out, ",\n{\"name\":\"overrun %u us\",\"cat\":\"budget\",\"ph\":\"i\","
+                    "\"s\":\"g\",\"ts\":%lu,\"pid\":1,\"tid\":0,\"args\":{\"service\":%u,"
+                    "\"state\":%u,\"event\":\"%s\"}}", pRecord->Param,
+                    (unsigned long) pRecord->Tick * 1000, pRecord->Machine, pRecord->State,
+                    EventName(pRecord->Event, EventBuffer));
+        }
+        return;
+    }
+
+    if (!pMachine->Seen && !pMachine->Announced) {
+        pMachine->Announced = TRUE;
+        if (pMachine->Name[0] == '\0') {
+            snprintf(pMachine->Name, MAX_NAME, "machine%u", pRecord->Machine);
+        }
+        if (Format == FORMAT_JSON) {
+            fprintf(Out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":\"%s\"}}", JsonCount++ ? "," : "",
+                    pRecord->Machine, pMachine->Name);
+        }
+        if ((Format == FORMAT_STATS) || (Format == FORMAT_TRANSITIONS)) {
+            pMachine->pVisits = calloc(MAX_IDS, sizeof (uint32_t));
+            pMachine->pDwell = calloc(MAX_IDS, sizeof (uint64_t));
+            pMachine->pMaxDwell = calloc(MAX_IDS, sizeof (uint32_t));
+            pMachine->pTransitions = calloc(MAX_IDS * MAX_IDS, sizeof (uint32_t));
+        }
+    }
+    if (!pMachine->Seen) {
+        pMachine->Seen = TRUE;
+        pMachine->Trigger = pRecord->Event;
+        EnterState(pRecord->Machine, pRecord->State, pRecord->Tick);
+    } else if (pRecord->State != pMachine->State) {
+        CloseState(pRecord->Machine, pRecord->State, pRecord->Tick);
+        EnterState(pRecord->Machine, pRecord->State, pRecord->Tick);
+    }
+    if ((pRecord->Kind == ES_TRACE_ENTER) && (pRecord->Event != ES_ENTRY)
+            && (pRecord->Event != ES_EXIT)) {
+        pMachine->Trigger = pRecord->Event;
+    }
+    if ((pRecord->Kind == ES_TRACE_MARK) && (Format == FORMAT_JSON)) {
+        fprintf(Out, ",\n{\"name\":\"%s.c:%u\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                "\"ts\":%lu,\"pid\":1,\"tid\":%u,\"args\":{\"state\":\"%s\",\"event\":\"%s\"}}",
+                pMachine->Name, pRecord->Param, pMachine->Name,
+                (unsigned long) pRecord->Tick * 1000, pRecord->Machine,
+                StateName(pRecord->Machine, pRecord->State, StateBuffer),
+                EventName(pRecord->Event, EventBuffer));
+    }
+}
+
+static void EnterState(uint8_t Id, uint8_t State, uint32_t Tick) {
+    Machines[Id].State = State;
+    Machines[Id].Since = Tick;
+    if (Machines[Id].pVisits != NULL) {
+        Machines[Id].pVisits[State]++;
+    }
+}
+
+// NewState is only used for the transition counts
+static void CloseState(uint8_t Id, uint8_t NewState, uint32_t Tick) {
+    Machine_t *pMachine = &Machines[Id];
+    uint32_t Dwell = Tick - pMachine->Since;
+    char StateBuffer[16], EventBuffer[16];
+
+    switch (Format) {
+        case FORMAT_CSV:
+            fprintf(Out, "%s,%s,%lu,%lu,%lu,%s\n", pMachine->Name,
+                    StateName(Id, pMachine->State, StateBuffer), (unsigned long) pMachine->Since,
+                    (unsigned long) Tick, (unsigned long) Dwell,
+                    EventName(pMachine->Trigger, EventBuffer));
+            break;
+        case FORMAT_JSON:
+            fprintf(Out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,"
+                    "\"pid\":1,\"tid\":%u,\"args\":{\"exit\":\"%s\"}}",
+                    StateName(Id, pMachine->State, StateBuffer), pMachine->Name,
+                    (unsigned long) pMachine->Since * 1000, (unsigned long) Dwell * 1000, Id,
+                    EventName(pMachine->Trigger, EventBuffer));
+            break;
+        default:
+            pMachine->pDwell[pMachine->State] += Dwell;
+            if (Dwell > pMachine->pMaxDwell[pMachine->State]) {
+                pMachine->pMaxDwell[pMachine->State] = Dwell;
+            }
+            if (NewState != pMachine->State) {
+                pMachine->pTransitions[pMachine->State * MAX_IDS + NewState]++;
+            }
+            break;
+    }
+}
+
+// closes the open interval of every machine at the last tick seen
+static void EndRun(void) {
+    int i;
+
+    for (i = 0; i < MAX_IDS; i++) {
+        if (Machines[i].Seen) {
+            CloseState(i, Machines[i].State, LastTick);
+            Machines[i].Seen = FALSE;
+            Machines[i].Since = LastTick;
+        }
+    }
+}
+
+static void PrintSummary(void) {
+    Machine_t *pMachine;
+    char FromBuffer[16], ToBuffer[16];
+    uint64_t Total;
+    int i, s, t;
+
+    if (Format == FORMAT_STATS) {
+        fprintf(Out, "machine,state,visits,total_ms,max_ms,share_pct\n");
+    } else {
+        fprintf(Out, "machine,from,to,count\n");
+    }
+    for (i = 0; i < MAX_IDS; i++) {
+        pMachine = &Machines[i];
+        if (pMachine->pVisits == NULL) {
+            continue;
+        }
+        Total = 0;
+        for (s = 0; s < MAX_IDS; s++) {
+            Total += pMachine->pDwell[s];
+        }
+        for (s = 0; s < MAX_IDS; s++) {
+            if (Format == FORMAT_STATS) {
+                if (pMachine->pVisits[s] == 0) {
+                    continue;
+                }
+                fprintf(Out, "%s,%s,%lu,%llu,%lu,%.1f\n", pMachine->Name,
+                        StateName(i, s, FromBuffer), (unsigned long) pMachine->pVisits[s],
+                        (unsigned long long) pMachine->pDwell[s],
+                        (unsigned long) pMachine->pMaxDwell[s],
+                        Total ? 100.0 * pMachine->pDwell[s] / Total : 0.0);
+                continue;
+            }
+            for (t = 0; t < MAX_IDS; t++) {
+                if (pMachine->pTransitions[s * MAX_IDS + t] > 0) {
+                    fprintf(Out, "%s,%s,%s,%lu\n", pMachine->Name, StateName(i, s, FromBuffer),
+                            StateName(i, t, ToBuffer),
+                            (unsigned long) pMachine->pTransitions[s * MAX_IDS + t]);
+                }
+            }
+        }
+    }
+}
+
+// names that are not in the sources come out as numbers
+static const char *StateName(uint8_t Id, uint8_t State, char *pBuffer) {
+    if (Machines[Id].StateNames[State] != NULL) {
+        return Machines[Id].StateNames[State];
+    }
+    sprintf(pBuffer, "state%u", State);
+    return pBuffer;
+}
+
+static const char *EventName(uint8_t Event, char *pBuffer) {
+    if (EventList[Event] != NULL) {
+        return EventList[Event];
+    }
+    sprintf(pBuffer, "event%u", Event);
+    return pBuffer;
+}
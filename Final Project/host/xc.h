@@ -0,0 +1,11 @@
+/*
+ * File: xc.h
+ *
+ * Linux host stand-in for the XC32 device header. The application only needs
+ * it to exist; every register it touches goes through the stand-in libraries.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#endif /* XC_H */
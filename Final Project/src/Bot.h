@@ -0,0 +1,101 @@
+/*
+ * File: Bot.h
+ *
+ * Everything one robot keeps between events: the framework's queues, timers
+ * and checker state, and the variables of each of its services and machines.
+ * The modules reach their own part through ES_CurrentContext, which ES_Main.c
+ * points at the one Bot_t of the board and the host simulator at the Bot_t of
+ * the robot each thread runs, so any number of robots can run in one process.
+ */
+
+#ifndef BOT_H
+#define BOT_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "TopHSM.h"
+#include "Collection1SubHSM.h"
+#include "Collection2SubHSM.h"
+#include "SearchForBeaconSubHSM.h"
+#include "DepositSubHSM.h"
+#include "BotService.h"
+#include "BotEventChecker.h"
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// the robot whose events are being run
+#define THIS_BOT ((Bot_t *) ES_CurrentContext)
+
+// one of the robot's maneuver timings, in ms: on the host the one in its
+// BotTimings_t, or Default, the timing as built, where that is 0; the board
+// only ever has Default
+#ifdef ES_HOST
+#define BOT_TIMING(Field, Default) \
+        ((THIS_BOT->Timings.Field != 0) ? THIS_BOT->Timings.Field : (Default))
+#else
+#define BOT_TIMING(Field, Default) (Default)
+#endif
+
+// one of the robot's speeds or thresholds, the same way from its BotTuning_t;
+// the defaults are in BotTuned.h, and all the board has
+#ifdef ES_HOST
+#define BOT_TUNING(Field, Default) \
+        ((THIS_BOT->Tuning.Field != 0) ? THIS_BOT->Tuning.Field : (Default))
+#else
+#define BOT_TUNING(Field, Default) (Default)
+#endif
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+// the timings the machines read through BOT_TIMING() on the host, all 0
+// unless the host's sweep tries others; the board has none
+typedef struct {
+    uint16_t Collection1Reverse;
+    uint16_t Collection2Reverse;
+    uint16_t Collection2Turn90;
+    uint16_t DepositDump; // the trap door held open
+    uint16_t SearchSpin;
+    uint16_t SearchReverse;
+    uint16_t SearchTurn;
+    uint16_t SearchShortDrive;
+    uint16_t SearchTurn90;
+    uint16_t SearchInfinity;
+    uint16_t SearchPark;
+} BotTimings_t;
+
+// the speeds and thresholds read through BOT_TUNING() on the host, left 0
+// the same way; the host's es_tune searches them
+typedef struct {
+    uint16_t DriveSpeed;
+    uint16_t SpinSpeed;
+    uint16_t RollerSpeed;
+    uint16_t BeaconFound;
+    uint16_t BeaconLost;
+    uint16_t TrackWireFound;
+    uint16_t TrackWireLost;
+} BotTuning_t;
+
+typedef struct {
+    ES_Context_t Framework; // first, so the framework's context is the robot's
+    TopHSMContext_t TopHSM;
+    Collection1SubHSMContext_t Collection1;
+    Collection2SubHSMContext_t Collection2;
+    SearchForBeaconSubHSMContext_t SearchForBeacon;
+    DepositSubHSMContext_t Deposit;
+    BotServiceContext_t BotService;
+    BotEventCheckerContext_t EventChecker;
+#ifdef ES_HOST
+    BotTimings_t Timings;
+    BotTuning_t Tuning;
+#endif
+} Bot_t;
+
+#endif /* BOT_H */
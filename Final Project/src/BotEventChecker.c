@@ -30,12 +30,14 @@
 #include "ES_Configure.h"
 #include "BotEventChecker.h"
 #include "ES_Events.h"
+#include "ES_Framework.h"
 #include "serial.h"
 #include "AD.h"
 #include "motors.h"
 #include "sensors.h"
 #include "BotService.h"
 #include "TopHSM.h"
+#include "Bot.h"
 
 /*******************************************************************************
  * MODULE #DEFINES                                                             *
@@ -65,8 +67,8 @@ static ES_Event storedEvent;
  * PRIVATE MODULE VARIABLES                                                    *
  ******************************************************************************/
 
-static uint16_t lastParam = 0b0000;
-static uint16_t lastBump = 0x0000;
+// this robot's checkers, see BotEventCheckerContext_t
+#define Me (&THIS_BOT->EventChecker)
 
 /* Any private module level variable that you might need for keeping track of
    events would be placed here. Private variables should be STATIC so that they
@@ -76,6 +78,21 @@ static uint16_t lastBump = 0x0000;
  * PUBLIC FUNCTIONS                                                            *
  ******************************************************************************/
 
+/**
+ * @Function InitBotEventChecker(void)
+ * @param none
+ * @return None
+ * @brief Sets what the checkers last saw to the values they start from, for
+ *        the robot being initialized. */
+void InitBotEventChecker(void) {
+    Me->lastBattery = BATTERY_DISCONNECTED;
+    Me->lastTape = TAPE_NOT_SENSED;
+    Me->lastWall = WALL_NOT_FOUND;
+    Me->lastOtherWall = OTHER_WALL_NOT_FOUND;
+    Me->lastParam = 0b0000;
+    Me->lastBump = 0x0000;
+}
+
 /**
  * @Function CheckBattery(void)
  * @param none
@@ -91,7 +108,6 @@ static uint16_t lastBump = 0x0000;
  * @author Gabriel H Elkaim, 2013.09.27 09:18
  * @modified Gabriel H Elkaim/Max Dunne, 2016.09.12 20:08 */
 uint8_t CheckBattery(void) {
-    static ES_EventTyp_t lastEvent = BATTERY_DISCONNECTED;
     ES_EventTyp_t curEvent;
     ES_Event thisEvent;
     uint8_t returnVal = FALSE;
@@ -102,14 +118,14 @@ uint8_t CheckBattery(void) {
     } else {
         curEvent = BATTERY_DISCONNECTED;
     }
-    if (curEvent != lastEvent) { // check for change from last time
+    if (curEvent != Me->lastBattery) { // check for change from last time
         thisEvent.EventType = curEvent;
         thisEvent.EventParam = batVoltage;
         returnVal = TRUE;
-        lastEvent = curEvent; // update history
+        Me->lastBattery = curEvent; // update history
 #ifndef EVENTCHECKER_TEST           // keep this as is for test harness
         //PostTemplateService(thisEvent);
-        PostTopHSM(thisEvent);
+        ES_Publish(thisEvent);
 #else
         SaveEvent(thisEvent);
 #endif   
@@ -126,7 +142,6 @@ uint8_t CheckBattery(void) {
  * @author Aleida Diaz-Roque adiazroq
  */
 uint8_t CheckTape(void) {
-    static ES_EventTyp_t lastEvent = TAPE_NOT_SENSED;
     ES_EventTyp_t curEvent;
     ES_Event thisEvent;
     uint8_t returnVal = FALSE;
@@ -139,15 +154,15 @@ uint8_t CheckTape(void) {
     } else {
         curEvent = TAPE_SENSED;
     }
-    if (curEvent != lastEvent | tapeValue != lastParam) { // check for change from last time
+    if ((curEvent != Me->lastTape) || (tapeValue != Me->lastParam)) { // check for change from last time
         thisEvent.EventType = curEvent;
         thisEvent.EventParam = tapeValue;
         returnVal = TRUE;
-        lastEvent = curEvent; // update history
-        lastParam = tapeValue;
+        Me->lastTape = curEvent; // update history
+        Me->lastParam = tapeValue;
 #ifndef EVENTCHECKER_TEST           // keep this as is for test harness
         //PostTemplateService(thisEvent);
-        PostTopHSM(thisEvent);
+        ES_Publish(thisEvent);
 #else
         SaveEvent(thisEvent);
 #endif   
@@ -164,7 +179,6 @@ uint8_t CheckTape(void) {
  * @author Aleida Diaz-Roque adiazroq
  */
 uint8_t CheckWall(void) {
-    static ES_EventTyp_t lastWall = WALL_NOT_FOUND;
     ES_EventTyp_t curWall;
     ES_Event thisWall;
     uint8_t returnVal = FALSE;
@@ -175,13 +189,13 @@ uint8_t CheckWall(void) {
     } else {
         curWall = WALL_FOUND;
     }
-    if (curWall != lastWall) {
+    if (curWall != Me->lastWall) {
         thisWall.EventType = curWall;
         returnVal = TRUE;
-        lastWall = curWall;
+        Me->lastWall = curWall;
 #ifndef EVENTCHECKER_TEST           // keep this as is for test harness
         //PostTemplateService(thisEvent);
-        PostTopHSM(thisWall);
+        ES_Publish(thisWall);
 #else
         SaveEvent(thisWall);
 #endif
@@ -198,7 +212,6 @@ uint8_t CheckWall(void) {
  * @author Aleida Diaz-Roque adiazroq
  */
 uint8_t CheckOtherWall(void) {
-    static ES_EventTyp_t lastWall = OTHER_WALL_NOT_FOUND;
     ES_EventTyp_t curWall;
     ES_Event thisWall;
     uint8_t returnVal = FALSE;
@@ -209,13 +222,13 @@ uint8_t CheckOtherWall(void) {
     } else {
         curWall = OTHER_WALL_FOUND;
     }
-    if (curWall != lastWall) {
+    if (curWall != Me->lastOtherWall) {
         thisWall.EventType = curWall;
         returnVal = TRUE;
-        lastWall = curWall;
+        Me->lastOtherWall = curWall;
 #ifndef EVENTCHECKER_TEST           // keep this as is for test harness
         //PostTemplateService(thisEvent);
-        PostTopHSM(thisWall);
+        ES_Publish(thisWall);
 #else
         SaveEvent(thisWall);
 #endif
@@ -253,9 +266,13 @@ static uint8_t(*EventList[])(void) = {EVENT_CHECK_LIST};
 void PrintEvent(void);
 
 void main(void) {
+    static Bot_t TheBot;
+
+    ES_SetContext(&TheBot.Framework);
     BOARD_Init();
     /* user initialization code goes here */
     sensors_Init();
+    InitBotEventChecker();
     // Do not alter anything below this line
     int i;
 
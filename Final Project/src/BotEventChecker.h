@@ -39,11 +39,28 @@
  * PUBLIC TYPEDEFS                                                             *
  ******************************************************************************/
 
+// the last value each checker saw, one set per robot, see Bot.h
+typedef struct {
+    ES_EventTyp_t lastBattery;
+    ES_EventTyp_t lastTape;
+    ES_EventTyp_t lastWall;
+    ES_EventTyp_t lastOtherWall;
+    uint16_t lastParam;
+    uint16_t lastBump;
+} BotEventCheckerContext_t;
 
 /*******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES                                                  *
  ******************************************************************************/
 
+/**
+ * @Function InitBotEventChecker(void)
+ * @param none
+ * @return None
+ * @brief Sets what the checkers last saw to the values they start from, for
+ *        the robot being initialized. */
+void InitBotEventChecker(void);
+
 uint8_t CheckBattery(void);
 
 uint8_t CheckTape(void);
@@ -23,6 +23,7 @@
 #include "ES_Configure.h"
 #include "ES_Framework.h"
 #include "BotService.h"
+#include "Bot.h"
 #include "sensors.h"
 #include <stdio.h>
 
@@ -33,6 +34,12 @@
 #define BATTERY_DISCONNECT_THRESHOLD 175
 #define BEACON_TIMER_TICKS 5
 
+// the robot's own hysteresis, see BotTuned.h
+#define BEACON_FOUND_LEVEL BOT_TUNING(BeaconFound, TUNED_BEACON_FOUND)
+#define BEACON_LOST_LEVEL BOT_TUNING(BeaconLost, TUNED_BEACON_LOST)
+#define TRACK_WIRE_FOUND_LEVEL BOT_TUNING(TrackWireFound, TUNED_TRACK_WIRE_FOUND)
+#define TRACK_WIRE_LOST_LEVEL BOT_TUNING(TrackWireLost, TUNED_TRACK_WIRE_LOST)
+
 
 /*******************************************************************************
  * PRIVATE FUNCTION PROTOTYPES                                                 *
@@ -46,12 +53,23 @@
 /* You will need MyPriority and maybe a state variable; you may need others
  * as well. */
 
-static uint8_t MyPriority;
-#define BUMPER_BUFFER_SIZE 8
-static uint8_t lastTrackWireParam = 0x00;
-uint8_t trackParamR = 0;
-uint8_t trackParamL = 0;
-uint8_t trackWireParam = 0;
+// this robot's service, see BotServiceContext_t
+#define Me (&THIS_BOT->BotService)
+#define MyPriority (Me->MyPriority)
+#define lastTrackWireParam (Me->lastTrackWireParam)
+#define trackParamR (Me->trackParamR)
+#define trackParamL (Me->trackParamL)
+#define trackWireParam (Me->trackWireParam)
+#define lastBeaconEvent (Me->lastBeaconEvent)
+#define lastBumperEvent (Me->lastBumperEvent)
+#define prevBumperValue (Me->prevBumperValue)
+#define bumperValues (Me->bumperValues)
+#define bumperIndex (Me->bumperIndex)
+#define lastTopBumperEvent (Me->lastTopBumperEvent)
+#define prevTopBumperValue (Me->prevTopBumperValue)
+#define TopBumperValues (Me->TopBumperValues)
+#define Topindex (Me->Topindex)
+#define lastTrackWireEvent (Me->lastTrackWireEvent)
 /*******************************************************************************
  * PUBLIC FUNCTIONS                                                            *
  ******************************************************************************/
@@ -72,6 +90,12 @@ uint8_t InitBotService(uint8_t Priority) {
     ES_Event ThisEvent;
 
     MyPriority = Priority;
+    lastBeaconEvent = BEACON_NOT_FOUND;
+    lastBumperEvent = BUMPER_CHANGED;
+    lastTopBumperEvent = TOP_BUMPER_CHANGED;
+    lastTrackWireEvent = TRACK_WIRE_NOT_FOUND;
+    // the event checkers have no init of their own
+    InitBotEventChecker();
     sensors_Init();
     ThisEvent.EventType = ES_INIT;
 
@@ -114,28 +138,16 @@ ES_Event RunBotService(ES_Event ThisEvent) {
     ReturnEvent.EventType = ES_NO_EVENT; // assume no errors
    
     // BEACON
-    static ES_EventTyp_t lastBeaconEvent = BEACON_NOT_FOUND;
     ES_EventTyp_t curBeaconEvent;
     int beaconStatus = beaconVal(); // read the battery voltage
     
     // BUMPER
-    static ES_EventTyp_t lastBumperEvent = BUMPER_CHANGED;
-    ES_EventTyp_t curBumperEvent;
-    static unsigned char prevBumperValue = 0x0;
-    static unsigned char bumperValues [BUMPER_BUFFER_SIZE];
-    static int index = 0;
     unsigned char bumperValue = botReadBumpers();
     
     // TOP BUMPER
-    static ES_EventTyp_t lastTopBumperEvent = TOP_BUMPER_CHANGED;
-    ES_EventTyp_t curTopBumperEvent;
-    static unsigned char prevTopBumperValue = 0x0;
-    static unsigned char TopBumperValues [BUMPER_BUFFER_SIZE];
-    static int Topindex = 0;
     unsigned char TopBumperValue = botReadBumpers();
 
     // TRACK WIRE
-    static ES_EventTyp_t lastTrackWireEvent = TRACK_WIRE_NOT_FOUND;
     ES_EventTyp_t curTrackWireEvent;
     int trackWireRValue = trackWireR(); // read the track wire value
     int trackWireLValue = trackWireL(); // read the track wire value
@@ -159,9 +171,9 @@ ES_Event RunBotService(ES_Event ThisEvent) {
             // BEACON SERVICE --------------------------------------------------            
             //printf("beaconStatus:%d\r\n", beaconStatus);
             beaconStatus = beaconVal();
-            if (beaconStatus > 750) { // is battery connected?
+            if (beaconStatus > BEACON_FOUND_LEVEL) { // is battery connected?
                 curBeaconEvent = BEACON_FOUND;
-            } else if (beaconStatus < 350) {
+            } else if (beaconStatus < BEACON_LOST_LEVEL) {
                 curBeaconEvent = BEACON_NOT_FOUND;
             } else {
                 curBeaconEvent = lastBeaconEvent;
@@ -169,8 +181,8 @@ ES_Event RunBotService(ES_Event ThisEvent) {
 
             // BUMPER SERVICE --------------------------------------------------
             bumperValue = botReadBumpers();
-            bumperValues[index] = bumperValue;
-            index = (index + 1) % BUMPER_BUFFER_SIZE;
+            bumperValues[bumperIndex] = bumperValue;
+            bumperIndex = (bumperIndex + 1) % BUMPER_BUFFER_SIZE;
             //printf("\r\n bumper values: %d\r\n",bumperValue);
 
             // check that every value in array is same
@@ -201,20 +213,20 @@ ES_Event RunBotService(ES_Event ThisEvent) {
             trackWireRValue = trackWireR();
             trackWireLValue = trackWireL();
             //printf("\r\n track wire R value: %d\r\n track wire L value: %d\r\n", trackWireRValue, trackWireLValue);
-            if (trackWireRValue > 400 || trackWireLValue > 400) {
+            if (trackWireRValue > TRACK_WIRE_FOUND_LEVEL || trackWireLValue > TRACK_WIRE_FOUND_LEVEL) {
                 curTrackWireEvent = TRACK_WIRE_FOUND;
-                if (trackWireRValue > 400) {
+                if (trackWireRValue > TRACK_WIRE_FOUND_LEVEL) {
                     trackParamR = 1;
-                } else if (trackWireRValue < 300) {
+                } else if (trackWireRValue < TRACK_WIRE_LOST_LEVEL) {
                     trackParamR = 0;
                 }
-                if (trackWireLValue > 400) {
+                if (trackWireLValue > TRACK_WIRE_FOUND_LEVEL) {
                     trackParamL = 2;
-                } else if (trackWireLValue < 300) {
+                } else if (trackWireLValue < TRACK_WIRE_LOST_LEVEL) {
                     trackParamL = 0;
                 }
                 trackWireParam = trackParamR | trackParamL;
-            } else if (trackWireRValue < 300 && trackWireLValue < 300) {
+            } else if (trackWireRValue < TRACK_WIRE_LOST_LEVEL && trackWireLValue < TRACK_WIRE_LOST_LEVEL) {
                 curTrackWireEvent = TRACK_WIRE_NOT_FOUND;
             } else {
                 curTrackWireEvent = lastTrackWireEvent;
@@ -228,7 +240,7 @@ ES_Event RunBotService(ES_Event ThisEvent) {
                 lastBeaconEvent = curBeaconEvent; // update history
 
 #ifndef SIMPLESERVICE_TEST           // keep this as is for test harness
-                PostTopHSM(ReturnEvent);
+                ES_Publish(ReturnEvent);
 #else
                 PostBotService(ReturnEvent);
 #endif   
@@ -245,7 +257,7 @@ ES_Event RunBotService(ES_Event ThisEvent) {
 
 
 #ifndef SIMPLESERVICE_TEST           // keep this as is for test harness
-                PostTopHSM(ReturnEvent);
+                ES_Publish(ReturnEvent);
 #else
                 PostBotService(ReturnEvent);
 #endif   
@@ -262,7 +274,7 @@ ES_Event RunBotService(ES_Event ThisEvent) {
 
 
 #ifndef SIMPLESERVICE_TEST           // keep this as is for test harness
-                PostTopHSM(ReturnEvent);
+                ES_Publish(ReturnEvent);
 #else
                 PostBotService(ReturnEvent);
 #endif   
@@ -277,7 +289,7 @@ ES_Event RunBotService(ES_Event ThisEvent) {
                 lastTrackWireParam = trackWireParam;
 
 #ifndef SIMPLESERVICE_TEST           // keep this as is for test harness
-                PostTopHSM(ReturnEvent);
+                ES_Publish(ReturnEvent);
 #else
                 PostBotService(ReturnEvent);
 #endif   
@@ -295,6 +307,9 @@ ES_Event RunBotService(ES_Event ThisEvent) {
             printf("\r\nEvent: %s\tParam: 0x%d",
                     EventNames[ThisEvent.EventType], ThisEvent.EventParam);
             break;
+#else
+        default:
+            break;
 #endif
     }
 
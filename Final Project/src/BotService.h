@@ -28,11 +28,31 @@
  * PUBLIC #DEFINES                                                             *
  ******************************************************************************/
 
+#define BUMPER_BUFFER_SIZE 8
 
 /*******************************************************************************
  * PUBLIC TYPEDEFS                                                             *
  ******************************************************************************/
 
+// the service's variables, one set per robot, see Bot.h
+typedef struct {
+    uint8_t MyPriority;
+    uint8_t lastTrackWireParam;
+    uint8_t trackParamR;
+    uint8_t trackParamL;
+    uint8_t trackWireParam;
+    // what RunBotService last saw of each sensor
+    ES_EventTyp_t lastBeaconEvent;
+    ES_EventTyp_t lastBumperEvent;
+    unsigned char prevBumperValue;
+    unsigned char bumperValues[BUMPER_BUFFER_SIZE];
+    int bumperIndex;
+    ES_EventTyp_t lastTopBumperEvent;
+    unsigned char prevTopBumperValue;
+    unsigned char TopBumperValues[BUMPER_BUFFER_SIZE];
+    int Topindex;
+    ES_EventTyp_t lastTrackWireEvent;
+} BotServiceContext_t;
 
 /*******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES                                                  *
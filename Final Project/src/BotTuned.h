@@ -0,0 +1,27 @@
+/*
+ * File: BotTuned.h
+ *
+ * The drive speeds and sensor thresholds the robot is built with. The host's
+ * es_tune writes a file just like this one with the values it found best in
+ * the simulated arena; copy it over this one to build them in. The machines
+ * read the values through BOT_TUNING(), which on the board is the value
+ * here, as a constant, and on the host lets es_tune try others without a
+ * rebuild.
+ */
+
+#ifndef BOTTUNED_H
+#define BOTTUNED_H
+
+// motor duty, out of 1000
+#define TUNED_DRIVE_SPEED 900
+#define TUNED_SPIN_SPEED 600
+#define TUNED_ROLLER_SPEED 400
+
+// the hysteresis of BotService on beaconVal() and the track wire coils: found
+// above the first, lost below the second
+#define TUNED_BEACON_FOUND 750
+#define TUNED_BEACON_LOST 350
+#define TUNED_TRACK_WIRE_FOUND 400
+#define TUNED_TRACK_WIRE_LOST 300
+
+#endif /* BOTTUNED_H */
@@ -27,6 +27,7 @@
 #include "BOARD.h"
 #include "TopHSM.h"
 #include "Collection1SubHSM.h"
+#include "Bot.h"
 #include "sensors.h"
 #include "motors.h"
 #include <stdio.h>
@@ -34,6 +35,17 @@
 /*******************************************************************************
  * MODULE #DEFINES                                                             *
  ******************************************************************************/
+
+#define REVERSE_TIMER_TICKS BOT_TIMING(Collection1Reverse, 400)
+#define TURN_90_TIMER_TICKS 600
+
+// this robot's machine, see Collection1SubHSMContext_t
+#define Me (&THIS_BOT->Collection1)
+
+/* es_chart begin: generated from Collection1SubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_COLLECTION1
+
 typedef enum {
     InitPSubState,
     Reverse,
@@ -43,6 +55,7 @@ typedef enum {
     Turn90Right,
     Turn45Left,
     Turn45Right,
+    WallFollowing,
     WallFollow,
     WallAdjust,
     OtherWallFollow,
@@ -54,13 +67,9 @@ typedef enum {
     AdjustingLeft,
     AdjustingRight,
     AlignReverse,
-
-
-
-
 } Collection1SubHSMState_t;
 
-static const char *StateNames[] = {
+static const char *const StateNames[] ES_TRACE_NAMES = {
 	"InitPSubState",
 	"Reverse",
 	"CollisionReverse",
@@ -69,6 +78,7 @@ static const char *StateNames[] = {
 	"Turn90Right",
 	"Turn45Left",
 	"Turn45Right",
+	"WallFollowing",
 	"WallFollow",
 	"WallAdjust",
 	"OtherWallFollow",
@@ -82,31 +92,236 @@ static const char *StateNames[] = {
 	"AlignReverse",
 };
 
-#define REVERSE_TIMER_TICKS 400
-#define TURN_90_TIMER_TICKS 600
+// the machine in this robot's context, see HSM_MACHINE
+#define Hsm (Me->Hsm)
+
+// the state the machine is in, for ES_Trace()
+#define CurrentState ((Collection1SubHSMState_t) Hsm.Current)
+
+// entry and exit hooks
+static void EnterReverse(void);
+static void ExitStopTimer(void);
+static void EnterCollisionReverse(void);
+static void EnterTurn90Left(void);
+static void EnterTurn90Right(void);
+static void EnterTurn45Left(void);
+static void EnterTurn45Right(void);
+static void EnterWallFollow(void);
+static void EnterWallAdjust(void);
+static void EnterOtherWallFollow(void);
+static void EnterOtherWallAdjust(void);
+static void EnterDriveForward(void);
+static void EnterAlignReverse(void);
+
+// always hooks
+static void AlwaysAdjustingLeft(ES_Event ThisEvent);
+static void AlwaysAdjustingRight(ES_Event ThisEvent);
+
+// guards
+static uint8_t IsTapeCurrent(ES_Event ThisEvent);
+static uint8_t IsSpinStart(ES_Event ThisEvent);
+static uint8_t IsSpinLeft(ES_Event ThisEvent);
+static uint8_t IsSpinRight(ES_Event ThisEvent);
+static uint8_t IsFromWall(ES_Event ThisEvent);
+static uint8_t IsTapeFront(ES_Event ThisEvent);
+static uint8_t IsTapeLeft(ES_Event ThisEvent);
+static uint8_t IsTapeRight(ES_Event ThisEvent);
+static uint8_t IsBumpFront(ES_Event ThisEvent);
+static uint8_t IsBumpLeft(ES_Event ThisEvent);
+static uint8_t IsBumpRight(ES_Event ThisEvent);
+static uint8_t IsFromBumpLeft(ES_Event ThisEvent);
+static uint8_t IsFromBumpRight(ES_Event ThisEvent);
+static uint8_t IsFromTapeRight(ES_Event ThisEvent);
+static uint8_t IsFromTapeLeft(ES_Event ThisEvent);
+
+// transition actions
+static void StartCollection(ES_Event ThisEvent);
+static void SetFromWall(ES_Event ThisEvent);
+static void TapeFront(ES_Event ThisEvent);
+static void TapeLeft(ES_Event ThisEvent);
+static void TapeRight(ES_Event ThisEvent);
+static void DriveTimedOut(ES_Event ThisEvent);
+static void BumpFront(ES_Event ThisEvent);
+static void BumpLeft(ES_Event ThisEvent);
+static void BumpRight(ES_Event ThisEvent);
+static void StopAlignTimer(ES_Event ThisEvent);
+
+static ES_HsmTransition_t const InitPSubStateRows[] = {
+    {ES_INIT, NULL, StartCollection, Reverse},
+};
+
+static ES_HsmTransition_t const ReverseRows[] = {
+    {ES_TIMEOUT, IsSpinStart, NULL, Turn90Left},
+    {ES_TIMEOUT, IsSpinLeft, NULL, Adjust90Left},
+    {ES_TIMEOUT, IsSpinRight, NULL, Turn90Right},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const CollisionReverseRows[] = {
+    {ES_TIMEOUT, IsSpinLeft, NULL, Turn45Right},
+    {ES_TIMEOUT, IsSpinRight, NULL, Turn45Left},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const StuckReverseRows[] = {
+    {ES_TIMEOUT, IsSpinLeft, SetFromWall, Turn90Right},
+    {ES_TIMEOUT, IsSpinRight, NULL, Turn90Left},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const Turn90LeftRows[] = {
+    {ES_TIMEOUT, NULL, NULL, WallFollow},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const Turn90RightRows[] = {
+    {ES_TIMEOUT, IsFromWall, NULL, OtherWallFollow},
+    {ES_TIMEOUT, NULL, NULL, DriveForward},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const Turn45LeftRows[] = {
+    {ES_TIMEOUT, NULL, NULL, WallFollow},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const Turn45RightRows[] = {
+    {ES_TIMEOUT, NULL, NULL, OtherWallFollow},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const WallFollowingRows[] = {
+    {TAPE_SENSED, IsTapeFront, TapeFront, Reverse},
+    {TAPE_SENSED, IsTapeLeft, TapeLeft, AlignReverse},
+    {TAPE_SENSED, IsTapeRight, TapeRight, AlignReverse},
+    {TOP_BUMPER_CHANGED, NULL, NULL, CollisionReverse},
+};
+
+static ES_HsmTransition_t const WallFollowRows[] = {
+    {ES_TIMEOUT, NULL, NULL, Reverse},
+    {BUMPER_CHANGED, NULL, NULL, WallAdjust},
+    {WALL_FOUND, NULL, NULL, WallAdjust},
+};
+
+static ES_HsmTransition_t const WallAdjustRows[] = {
+    {WALL_NOT_FOUND, NULL, NULL, WallFollow},
+};
+
+static ES_HsmTransition_t const OtherWallFollowRows[] = {
+    {ES_TIMEOUT, NULL, NULL, Reverse},
+    {BUMPER_CHANGED, NULL, NULL, OtherWallAdjust},
+    {OTHER_WALL_FOUND, NULL, NULL, OtherWallAdjust},
+};
+
+static ES_HsmTransition_t const OtherWallAdjustRows[] = {
+    {OTHER_WALL_NOT_FOUND, NULL, NULL, OtherWallFollow},
+};
+
+static ES_HsmTransition_t const Adjust90LeftRows[] = {
+    {ES_TIMEOUT, IsFromWall, NULL, WallFollow},
+    {ES_TIMEOUT, NULL, NULL, DriveForward},
+    {TAPE_SENSED, NULL, NULL, ES_HSM_DEFER},
+};
+
+static ES_HsmTransition_t const DriveForwardRows[] = {
+    {ES_TIMEOUT, NULL, DriveTimedOut, Reverse},
+    {BUMPER_CHANGED, IsBumpFront, BumpFront, Reverse},
+    {BUMPER_CHANGED, IsBumpLeft, BumpLeft, AlignReverse},
+    {BUMPER_CHANGED, IsBumpRight, BumpRight, AlignReverse},
+};
+
+static ES_HsmTransition_t const AdjustingLeftRows[] = {
+    {TAPE_SENSED, IsTapeFront, TapeFront, Reverse},
+    {TAPE_SENSED, IsTapeRight, TapeRight, AlignReverse},
+    {BUMPER_CHANGED, IsBumpFront, BumpFront, Reverse},
+    {BUMPER_CHANGED, IsBumpLeft, BumpLeft, AlignReverse},
+    {BUMPER_CHANGED, IsBumpRight, BumpRight, AlignReverse},
+};
+
+static ES_HsmTransition_t const AdjustingRightRows[] = {
+    {TAPE_SENSED, IsTapeFront, TapeFront, Reverse},
+    {TAPE_SENSED, IsTapeLeft, TapeLeft, AlignReverse},
+    {BUMPER_CHANGED, IsBumpFront, BumpFront, Reverse},
+    {BUMPER_CHANGED, IsBumpLeft, BumpLeft, AlignReverse},
+    {BUMPER_CHANGED, IsBumpRight, BumpRight, AlignReverse},
+};
+
+static ES_HsmTransition_t const AlignReverseRows[] = {
+    {ES_TIMEOUT, IsFromBumpLeft, StopAlignTimer, AdjustingLeft},
+    {ES_TIMEOUT, IsFromBumpRight, StopAlignTimer, AdjustingRight},
+    {TAPE_NOT_SENSED, IsFromTapeRight, NULL, AdjustingRight},
+    {TAPE_NOT_SENSED, IsFromTapeLeft, NULL, AdjustingLeft},
+};
+
+// in Collection1SubHSMState_t order: entry, exit, always, timeout, rows, parent, depth,
+// initial substate, the events it and the states enclosing it have rows for
+static ES_HsmState_t const States[] = {
+    [InitPSubState] = {NULL, NULL, NULL, 0, ES_HSM_ROWS(InitPSubStateRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_INIT)},
+    [Reverse] = {EnterReverse, ExitStopTimer, NULL, 0, ES_HSM_ROWS(ReverseRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [CollisionReverse] = {EnterCollisionReverse, ExitStopTimer, NULL, 0, ES_HSM_ROWS(CollisionReverseRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [StuckReverse] = {EnterCollisionReverse, ExitStopTimer, NULL, 0, ES_HSM_ROWS(StuckReverseRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [Turn90Left] = {EnterTurn90Left, NULL, NULL, 1000, ES_HSM_ROWS(Turn90LeftRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [Turn90Right] = {EnterTurn90Right, NULL, NULL, 1000, ES_HSM_ROWS(Turn90RightRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [Turn45Left] = {EnterTurn45Left, NULL, NULL, 500, ES_HSM_ROWS(Turn45LeftRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [Turn45Right] = {EnterTurn45Right, NULL, NULL, 500, ES_HSM_ROWS(Turn45RightRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [WallFollowing] = {NULL, NULL, NULL, 0, ES_HSM_ROWS(WallFollowingRows), ES_HSM_NONE, 0, WallFollow,
+            ES_HSM_EVENT(TAPE_SENSED) | ES_HSM_EVENT(TOP_BUMPER_CHANGED)},
+    [WallFollow] = {EnterWallFollow, NULL, NULL, 0, ES_HSM_ROWS(WallFollowRows), WallFollowing, 1, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED) | ES_HSM_EVENT(TOP_BUMPER_CHANGED) | ES_HSM_EVENT(BUMPER_CHANGED) | ES_HSM_EVENT(WALL_FOUND)},
+    [WallAdjust] = {EnterWallAdjust, NULL, NULL, 0, ES_HSM_ROWS(WallAdjustRows), WallFollowing, 1, ES_HSM_NONE,
+            ES_HSM_EVENT(TAPE_SENSED) | ES_HSM_EVENT(TOP_BUMPER_CHANGED) | ES_HSM_EVENT(WALL_NOT_FOUND)},
+    [OtherWallFollow] = {EnterOtherWallFollow, NULL, NULL, 0, ES_HSM_ROWS(OtherWallFollowRows), WallFollowing, 1, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED) | ES_HSM_EVENT(TOP_BUMPER_CHANGED) | ES_HSM_EVENT(BUMPER_CHANGED) | ES_HSM_EVENT(OTHER_WALL_FOUND)},
+    [OtherWallAdjust] = {EnterOtherWallAdjust, NULL, NULL, 0, ES_HSM_ROWS(OtherWallAdjustRows), WallFollowing, 1, ES_HSM_NONE,
+            ES_HSM_EVENT(TAPE_SENSED) | ES_HSM_EVENT(TOP_BUMPER_CHANGED) | ES_HSM_EVENT(OTHER_WALL_NOT_FOUND)},
+    [RightAlign] = {NULL, NULL, NULL, 0, ES_HSM_NO_ROWS, ES_HSM_NONE, 0, ES_HSM_NONE,
+            0},
+    [TapeFollowRight] = {NULL, NULL, NULL, 0, ES_HSM_NO_ROWS, ES_HSM_NONE, 0, ES_HSM_NONE,
+            0},
+    [Adjust90Left] = {EnterTurn90Left, NULL, NULL, 1000, ES_HSM_ROWS(Adjust90LeftRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_SENSED)},
+    [DriveForward] = {EnterDriveForward, NULL, NULL, 1000, ES_HSM_ROWS(DriveForwardRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(BUMPER_CHANGED)},
+    [AdjustingLeft] = {NULL, NULL, AlwaysAdjustingLeft, 0, ES_HSM_ROWS(AdjustingLeftRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [AdjustingRight] = {NULL, NULL, AlwaysAdjustingRight, 0, ES_HSM_ROWS(AdjustingRightRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_ALL_EVENTS},
+    [AlignReverse] = {EnterAlignReverse, ExitStopTimer, NULL, 0, ES_HSM_ROWS(AlignReverseRows), ES_HSM_NONE, 0, ES_HSM_NONE,
+            ES_HSM_EVENT(ES_TIMEOUT) | ES_HSM_EVENT(TAPE_NOT_SENSED)},
+};
+
+// the initializer of Hsm, whose arrays are in the same context
+#define HSM_MACHINE ES_HSM_TIMED_MACHINE(States, ES_TRACE_ID, NULL, ES_HSM_DEEP, \
+        Me->StateTimers, COLLECTION1_TIMERS, PostTopHSM, ES_HSM_DEFER_QUEUE(Me->Deferred, IsTapeCurrent))
+/* es_chart end */
 
 /*******************************************************************************
  * PRIVATE FUNCTION PROTOTYPES                                                 *
  ******************************************************************************/
-/* Prototypes for private functions for this machine. They should be functions
-   relevant to the behavior of this state machine */
+/* The hooks, guards and actions named in Collection1SubHSM.chart are declared
+   by the generated code above. */
 
 /*******************************************************************************
  * PRIVATE MODULE VARIABLES                                                            *
  ******************************************************************************/
-/* You will need MyPriority and the state variable; you may need others as well.
- * The type of state variable should match that of enum in header file. */
-
-static Collection1SubHSMState_t CurrentState = InitPSubState; // <- change name to match ENUM
-static uint8_t MyPriority;
+/* The machine and the variables below are the robot's own, see
+ * Collection1SubHSMContext_t. */
 
-static int collisionFrom = START;
-static int spinDirection;
-static int alignCounter = 0;
-static int bumperCounter = 0;
-static int rightBumped = 0;
-static int leftBumped = 0;
-static int fromWall;
+#define collisionFrom (Me->collisionFrom)
+#define spinDirection (Me->spinDirection)
+#define alignCounter (Me->alignCounter)
+#define bumperCounter (Me->bumperCounter)
+#define rightBumped (Me->rightBumped)
+#define leftBumped (Me->leftBumped)
+#define fromWall (Me->fromWall)
 
 
 /*******************************************************************************
@@ -124,7 +339,15 @@ static int fromWall;
 uint8_t InitCollection1SubHSM(void) {
     ES_Event returnEvent;
 
-    CurrentState = InitPSubState;
+    collisionFrom = START;
+    alignCounter = 0;
+    bumperCounter = 0;
+    rightBumped = 0;
+    leftBumped = 0;
+    Hsm = (ES_Hsm_t) HSM_MACHINE;
+    if (ES_HsmInit(&Hsm, InitPSubState) != TRUE) {
+        return FALSE;
+    }
     returnEvent = RunCollection1SubHSM(INIT_EVENT);
     if (returnEvent.EventType == ES_NO_EVENT) {
         return TRUE;
@@ -135,923 +358,246 @@ uint8_t InitCollection1SubHSM(void) {
 /**
  * @Function RunCollection1SubHSM(ES_Event ThisEvent)
  * @param ThisEvent - the event (type and param) to be responded.
- * @return Event - return event (type and param), in general should be ES_NO_EVENT
- * @brief This function is where you implement the whole of the heirarchical state
- *        machine, as this is called any time a new event is passed to the event
- *        queue. This function will be called recursively to implement the correct
- *        order for a state transition to be: exit current state -> enter next state
- *        using the ES_EXIT and ES_ENTRY events.
- * @note The lower level state machines are run first, to see if the event is dealt
- *       with there rather than at the current level. ES_EXIT and ES_ENTRY events are
- *       not consumed as these need to pass pack to the higher level state machine.
+ * @return Event - return event (type and param), ES_NO_EVENT if it was consumed
+ * @brief Hands the event to the current state through the transition tables
+ *        generated from Collection1SubHSM.chart, see ES_Hsm.h. ES_EXIT and
+ *        ES_ENTRY events from the top level run the current state's exit and
+ *        entry hooks and are not consumed, nor is any event the current state
+ *        has no row for, nor a timeout for another state.
  * @author Aleida Diaz-Roque */
 ES_Event RunCollection1SubHSM(ES_Event ThisEvent) {
-    uint8_t makeTransition = FALSE; // use to flag transition
-    Collection1SubHSMState_t nextState; // <- change type to correct enum
-
-    ES_Tattle(); // trace call stack
-
-    switch (CurrentState) {
-        case InitPSubState: // If current state is initial Psedudo State
-            if (ThisEvent.EventType == ES_INIT)// only respond to ES_Init
-            {
-                // this is where you would put any actions associated with the
-                // transition from the initial pseudo-state into the actual
-                // initial state
-		    
-                // now put the machine into the actual initial state
-                collisionFrom = START;
-                spinDirection = START;
-                nextState = Reverse;
-                makeTransition = TRUE;
-                ThisEvent.EventType = ES_NO_EVENT;
-            }
-            break;
-            ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case Reverse:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    if (spinDirection == START || spinDirection == RIGHT) {
-                        turnSlugLeft(-DRIVE_SPEED);
-                    } else {
-                        turnSlugRight(-DRIVE_SPEED);
-                    }
-                    if (collisionFrom == TAPE) {
-                        ES_Timer_InitTimer(CHECK_TIMER, REVERSE_TIMER_TICKS);
-                    } else {
-                        ES_Timer_InitTimer(CHECK_TIMER, REVERSE_TIMER_TICKS - 200);
-                    }
-
-                    printf("\r\nCollection1: Reverse");
-                    break;
-
-                case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == CHECK_TIMER) {
-                        if (spinDirection == START) {
-                            nextState = Turn90Left;
-                        } else if (spinDirection == LEFT) {
-                            nextState = Adjust90Left;
-                        } else if (spinDirection == RIGHT) {
-                            nextState = Turn90Right;
-                        }
-                    }
-
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(CHECK_TIMER);
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case CollisionReverse:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    moveSlug(-DRIVE_SPEED);
-                    ES_Timer_InitTimer(REVERSE_TIMER, REVERSE_TIMER_TICKS - 200);
-                    printf("\r\nCollection1: CollisionReverse");
-                    break;
-
-                case ES_TIMEOUT:
-                    if (spinDirection == LEFT) {
-                        nextState = Turn45Right;
-                    } else if (spinDirection == RIGHT) {
-                        nextState = Turn45Left;
-                    }
-
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(REVERSE_TIMER);
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-            
-        case StuckReverse:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    moveSlug(-DRIVE_SPEED);
-                    ES_Timer_InitTimer(CHECK_TIMER, REVERSE_TIMER_TICKS - 200);
-                    printf("\r\nCollection1: CollisionReverse");
-                    break;
-
-                case ES_TIMEOUT:
-                    if (spinDirection == LEFT) {
-                        fromWall = TRUE;
-                        nextState = Turn90Right;
-                    } else if (spinDirection == RIGHT) {
-                        nextState = Turn90Left;
-                    }
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(CHECK_TIMER);
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-
-        case Turn90Left:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 1000);
-                    spinSlug(LEFT, SPIN_SPEED);
-                    break;
-
-                case ES_TIMEOUT:
-                    nextState = WallFollow;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-
-                case TAPE_SENSED:
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case Adjust90Left:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 1000);
-                    spinSlug(LEFT, SPIN_SPEED);
-                    break;
-
-                case ES_TIMEOUT:
-                    if (fromWall == TRUE) {
-                        nextState = WallFollow;
-                    } else {
-                        nextState = DriveForward;
-                    }
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case Turn45Left:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 500);
-                    spinSlug(LEFT, SPIN_SPEED);
-                    break;
-
-                case ES_TIMEOUT:
-                    nextState = WallFollow;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case Turn45Right:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 500);
-                    spinSlug(RIGHT, SPIN_SPEED);
-                    break;
-
-                case ES_TIMEOUT:
-                    nextState = OtherWallFollow;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-
-        case WallFollow:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    spinDirection = RIGHT;
-                    fromWall = FALSE;
-                    dragSlug(DRIVE_SPEED, DRIVE_SPEED - 200);
-                    ES_Timer_InitTimer(COLLISION_TIMER, 5000);
-                    printf("\r\nwall follow");
-                    break;
-
-                case WALL_FOUND:
-                    nextState = WallAdjust;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case BUMPER_CHANGED:
-                    nextState = WallAdjust;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TOP_BUMPER_CHANGED:
-                    nextState = CollisionReverse;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    if (ThisEvent.EventParam == FRONT_LEFT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
-                        collisionFrom = FRONT_LEFT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: RIGHT");
-                        collisionFrom = FRONT_RIGHT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-
-                    }
-                    break;
-
-                case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == COLLISION_TIMER) {
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    break;
-
-                case ES_EXIT:
-                    //                    ES_Timer_StopTimer(COLLISION_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case WallAdjust:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    spinSlug(LEFT, DRIVE_SPEED - 100);
-                    printf("\r\nwall adjust");
-                    break;
-
-                case TOP_BUMPER_CHANGED:
-                    nextState = CollisionReverse;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case WALL_NOT_FOUND:
-                    nextState = WallFollow;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    if (ThisEvent.EventParam == FRONT_LEFT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
-                        collisionFrom = FRONT_LEFT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: RIGHT");
-                        collisionFrom = FRONT_RIGHT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-
-                    }
-                    break;
-
-                case ES_EXIT:
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case Turn90Right:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 1000);
-                    spinSlug(RIGHT, SPIN_SPEED);
-                    break;
-
-                case ES_TIMEOUT:
-                    if (fromWall == TRUE) {
-                        nextState = OtherWallFollow;
-                    } else {
-                        nextState = DriveForward;
-                    }
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case OtherWallFollow:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    spinDirection = LEFT;
-                    fromWall = FALSE;
-                    dragSlug(DRIVE_SPEED - 400, DRIVE_SPEED);
-                    ES_Timer_InitTimer(COLLISION_TIMER, 5000);
-                    printf("\r\n other wall follow");
-                    break;
-
-                case OTHER_WALL_FOUND:
-                    nextState = OtherWallAdjust;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case BUMPER_CHANGED:
-                    nextState = OtherWallAdjust;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TOP_BUMPER_CHANGED:
-                    nextState = CollisionReverse;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    if (ThisEvent.EventParam == FRONT_LEFT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
-                        collisionFrom = FRONT_LEFT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: RIGHT");
-                        collisionFrom = FRONT_RIGHT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    break;
-
-                case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == COLLISION_TIMER) {
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    break;
-
-                case ES_EXIT:
-                    //                    ES_Timer_StopTimer(COLLISION_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case OtherWallAdjust:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    spinSlug(RIGHT, DRIVE_SPEED - 300);
-                    printf("\r\n other wall adjust");
-                    break;
-
-                case OTHER_WALL_NOT_FOUND:
-                    nextState = OtherWallFollow;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TOP_BUMPER_CHANGED:
-                    nextState = CollisionReverse;
-                    makeTransition = TRUE;
-                    ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-
-                case TAPE_SENSED:
-                    if (ThisEvent.EventParam == FRONT_LEFT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
-                        collisionFrom = FRONT_LEFT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: RIGHT");
-                        collisionFrom = FRONT_RIGHT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    break;
-
-                case ES_EXIT:
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-
-        case DriveForward:
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    moveSlug(DRIVE_SPEED);
-                    ES_Timer_InitTimer(FOLLOW_TIMER, 1000);
-                    printf("\r\n drive forward");
-                    break;
-
-                case BUMPER_CHANGED:
-                    printf("\r\n    BUMP SENSED: %d", ThisEvent.EventParam);
-
-                    if (ThisEvent.EventParam == 0b1000) {
-                        // LEFT bump hit
-                        printf("\r\n    Bump: LEFT");
-                        collisionFrom = FRONT_LEFT_BUMP;
-                        leftBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if (ThisEvent.EventParam == 0b0100) {
-                        // LEFT bump hit
-                        printf("\r\n    Bump: RIGHT");
-                        collisionFrom = FRONT_RIGHT_BUMP;
-                        rightBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == 0b1100) || (bumperCounter > 2)) {
-                        printf("\r\n    Bump: FRONT");
-                        // BOTH FRONT tape hit
-                        bumperCounter = 0;
-                        leftBumped = 0;
-                        rightBumped = 0;
-                        fromWall = TRUE;
-                        collisionFrom = WALL;
-
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-                    }
-                    break;
-
-                case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == FOLLOW_TIMER) {
-                        bumperCounter = 0;
-                        leftBumped = 0;
-                        rightBumped = 0;
-                        fromWall = TRUE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    break;
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
-                    break;
-                case ES_NO_EVENT:
-                    break;
-                default:
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case AdjustingRight: // in the first state, replace this with correct names
-            printf("\r\nCollection2: In Adjusting Right");
-            turnSlugSharpRight(DRIVE_SPEED - 75);
-
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    break;
-
-
-                case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
-
-                    if (ThisEvent.EventParam == FRONT_LEFT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
-                        collisionFrom = FRONT_LEFT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-
-                    }
-                    break;
-
-                case BUMPER_CHANGED:
-                    printf("\r\n    BUMP SENSED: %d", ThisEvent.EventParam);
-
-                    if (ThisEvent.EventParam == 0b1000) {
-                        // LEFT tape hit
-                        printf("\r\n    Bump: LEFT");
-                        collisionFrom = FRONT_LEFT_BUMP;
-                        leftBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if (ThisEvent.EventParam == 0b0100) {
-                        // LEFT tape hit
-                        printf("\r\n    Bump: RIGHT");
-                        collisionFrom = FRONT_RIGHT_BUMP;
-                        rightBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == 0b1100) || (bumperCounter > 2)) {
-                        printf("\r\n    Bump: FRONT");
-                        // BOTH FRONT tape hit
-                        bumperCounter = 0;
-                        leftBumped = 0;
-                        rightBumped = 0;
-                        fromWall = TRUE;
-                        collisionFrom = WALL;
-
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-                    }
-                    break;
-
-                case ES_EXIT:
-                    //moveSlug(DRIVE_SPEED);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                case TRACK_WIRE_FOUND:
-                    //ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-                default: // all unhandled events pass the event back up to the next level
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case AdjustingLeft: // in the first state, replace this with correct names
-            printf("\r\nCollection2: In Adjusting Right");
-            turnSlugSharpLeft(DRIVE_SPEED - 75);
-
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    break;
-
-
-                case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
-
-                    if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        // LEFT tape hit
-                        printf("\r\n    Tape: RIGHT");
-                        collisionFrom = FRONT_RIGHT;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
-                        // BOTH FRONT tape hit
-                        alignCounter = 0;
-                        collisionFrom = TAPE;
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-                    break;
-
-                case BUMPER_CHANGED:
-                    printf("\r\n    BUMP SENSED: %d", ThisEvent.EventParam);
-
-                    if (ThisEvent.EventParam == 0b1000) {
-                        // LEFT tape hit
-                        printf("\r\n    Bump: LEFT");
-                        collisionFrom = FRONT_LEFT_BUMP;
-                        leftBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if (ThisEvent.EventParam == 0b0100) {
-                        // LEFT tape hit
-                        printf("\r\n    Bump: RIGHT");
-                        collisionFrom = FRONT_RIGHT_BUMP;
-                        rightBumped = 1;
-                        nextState = AlignReverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                    }
-
-                    if ((ThisEvent.EventParam == 0b1100) || (bumperCounter > 2)) {
-                        printf("\r\n    Bump: FRONT");
-                        // BOTH FRONT tape hit
-                        bumperCounter = 0;
-                        leftBumped = 0;
-                        rightBumped = 0;
-                        fromWall = TRUE;
-                        collisionFrom = WALL;
-
-                        nextState = Reverse;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-
-                    }
-                    break;
-
-                case ES_EXIT:
-                    //moveSlug(DRIVE_SPEED);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-                case TRACK_WIRE_FOUND:
-                    //ThisEvent.EventType = ES_NO_EVENT;
-                    break;
-                default: // all unhandled events pass the event back up to the next level
-                    break;
-            }
-            break;
-	    ///////////////////////////////////////////////////////////////////////////
-            ////////////////////////////////////////////////////////////////////////////
-
-        case AlignReverse:
-
-            switch (ThisEvent.EventType) {
-                case ES_ENTRY:
-                    // the timer will depend on ig coming from a tape or wall or track wire detection
-                    printf("\r\nCollection1: In Align Reverse");
-                    moveSlug(-DRIVE_SPEED);
-                    alignCounter++;
-                    if ((leftBumped == 1) && (rightBumped == 1)) {
-                        bumperCounter++;
-                    }
-                    if ((collisionFrom == FRONT_RIGHT_BUMP) || (collisionFrom == FRONT_LEFT_BUMP)) {
-                        ES_Timer_InitTimer(REVERSE_TIMER, 100);
-                        printf("\r\n timer started");
-                    }
-                    break;
-
-                case TAPE_NOT_SENSED:
-                    printf("\r\n tape not sensed");
-                    if (collisionFrom == FRONT_RIGHT) {
-                        nextState = AdjustingRight;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\n alignreverseright");
-
-                    } else if (collisionFrom == FRONT_LEFT) {
-                        nextState = AdjustingLeft;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\n alignreverseleft");
-                    }
-                    break;
-
-                case ES_TIMEOUT:
-                    if (collisionFrom == FRONT_LEFT_BUMP) {
-                        ES_Timer_StopTimer(REVERSE_TIMER);
-
-                        nextState = AdjustingLeft;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\nalignreverseleft");
-                    } else if (collisionFrom == FRONT_RIGHT_BUMP) {
-                        ES_Timer_StopTimer(REVERSE_TIMER);
-                        nextState = AdjustingRight;
-                        makeTransition = TRUE;
-                        ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\nalignreverseleft");
-                    }
-                    break;
-
-
-
-                case ES_EXIT:
-                    ES_Timer_StopTimer(REVERSE_TIMER);
-                    break;
-
-                case ES_NO_EVENT:
-                    break;
-
-                case TRACK_WIRE_FOUND:
-                    //ThisEvent.EventType = ES_NO_EVENT;
-                    // consume track wire event here
-                    break;
-                default: // all unhandled events pass the event back up to the next level
-                    break;
-            }
-            break;
-
-        default:
-            break;
+    return ES_HsmDispatch(&Hsm, ThisEvent);
+}
 
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+/// entry, exit and always hooks, the fixed timeouts are in the chart -------
+
+static void EnterReverse(void) {
+    if (spinDirection == START || spinDirection == RIGHT) {
+        turnSlugLeft(-DRIVE_SPEED);
+    } else {
+        turnSlugRight(-DRIVE_SPEED);
+    }
+    if (collisionFrom == TAPE) {
+        ES_HsmStartTimer(&Hsm, REVERSE_TIMER_TICKS);
+    } else {
+        ES_HsmStartTimer(&Hsm, REVERSE_TIMER_TICKS - 200);
     }
 
-    // end switch on Current State
+    ES_Trace(ENTRY_EVENT); // Collection1: Reverse
+}
+
+// CollisionReverse and StuckReverse
+static void EnterCollisionReverse(void) {
+    ES_HsmStartTimer(&Hsm, REVERSE_TIMER_TICKS - 200);
+    moveSlug(-DRIVE_SPEED);
+    ES_Trace(ENTRY_EVENT); // Collection1: CollisionReverse
+}
 
-    if (makeTransition == TRUE) { // making a state transition, send EXIT and ENTRY
-        // recursively call the current state with an exit event
-        RunCollection1SubHSM(EXIT_EVENT); // <- rename to your own Run function
-        CurrentState = nextState;
-        RunCollection1SubHSM(ENTRY_EVENT); // <- rename to your own Run function
+// Turn90Left and Adjust90Left
+static void EnterTurn90Left(void) {
+    spinSlug(LEFT, SPIN_SPEED);
+}
+
+static void EnterTurn90Right(void) {
+    spinSlug(RIGHT, SPIN_SPEED);
+}
+
+static void EnterTurn45Left(void) {
+    spinSlug(LEFT, SPIN_SPEED);
+}
+
+static void EnterTurn45Right(void) {
+    spinSlug(RIGHT, SPIN_SPEED);
+}
+
+static void EnterWallFollow(void) {
+    spinDirection = RIGHT;
+    fromWall = FALSE;
+    dragSlug(DRIVE_SPEED, DRIVE_SPEED - 200);
+    ES_HsmStartTimer(&Hsm, 5000);
+    ES_Trace(ENTRY_EVENT); // wall follow
+}
+
+static void EnterWallAdjust(void) {
+    spinSlug(LEFT, DRIVE_SPEED - 100);
+    ES_Trace(ENTRY_EVENT); // wall adjust
+}
+
+static void EnterOtherWallFollow(void) {
+    spinDirection = LEFT;
+    fromWall = FALSE;
+    dragSlug(DRIVE_SPEED - 400, DRIVE_SPEED);
+    ES_HsmStartTimer(&Hsm, 5000);
+    ES_Trace(ENTRY_EVENT); // other wall follow
+}
+
+static void EnterOtherWallAdjust(void) {
+    spinSlug(RIGHT, DRIVE_SPEED - 300);
+    ES_Trace(ENTRY_EVENT); // other wall adjust
+}
+
+static void EnterDriveForward(void) {
+    moveSlug(DRIVE_SPEED);
+    ES_Trace(ENTRY_EVENT); // drive forward
+}
+
+static void EnterAlignReverse(void) {
+    // the timer will depend on ig coming from a tape or wall or track wire detection
+    ES_Trace(ENTRY_EVENT); // Collection1: In Align Reverse
+    moveSlug(-DRIVE_SPEED);
+    alignCounter++;
+    if ((leftBumped == 1) && (rightBumped == 1)) {
+        bumperCounter++;
     }
+    if ((collisionFrom == FRONT_RIGHT_BUMP) || (collisionFrom == FRONT_LEFT_BUMP)) {
+        ES_HsmStartTimer(&Hsm, 100);
+        ES_Trace(ENTRY_EVENT); // timer started
+    }
+}
 
-    ES_Tail(); // trace call stack end
-    return ThisEvent;
+static void ExitStopTimer(void) {
+    ES_HsmStopTimer(&Hsm);
 }
 
+// keeps turning on every event, entry and exit included
+static void AlwaysAdjustingLeft(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Collection1: In Adjusting Left
+    turnSlugSharpLeft(DRIVE_SPEED - 75);
+}
 
-/*******************************************************************************
- * PRIVATE FUNCTIONS                                                           *
- ******************************************************************************/
+static void AlwaysAdjustingRight(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Collection1: In Adjusting Right
+    turnSlugSharpRight(DRIVE_SPEED - 75);
+}
+
+/// guards ---------------------------------------------------------------------
+
+// a recalled tape event still reads what the tape sensors read now
+static uint8_t IsTapeCurrent(ES_Event ThisEvent) {
+    if ((ThisEvent.EventType != TAPE_SENSED) && (ThisEvent.EventType != TAPE_NOT_SENSED)) {
+        return TRUE;
+    }
+    return (ThisEvent.EventParam == botReadTape());
+}
+
+static uint8_t IsSpinStart(ES_Event ThisEvent) {
+    return (spinDirection == START);
+}
+
+static uint8_t IsSpinLeft(ES_Event ThisEvent) {
+    return (spinDirection == LEFT);
+}
+
+static uint8_t IsSpinRight(ES_Event ThisEvent) {
+    return (spinDirection == RIGHT);
+}
+
+static uint8_t IsFromWall(ES_Event ThisEvent) {
+    return (fromWall == TRUE);
+}
+
+// both front tape sensors, or stuck aligning
+static uint8_t IsTapeFront(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == FRONT_BOTH) || (alignCounter > 2);
+}
+
+static uint8_t IsTapeLeft(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == FRONT_LEFT);
+}
+
+static uint8_t IsTapeRight(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == FRONT_RIGHT);
+}
 
+// both front bumpers, or stuck aligning
+static uint8_t IsBumpFront(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == 0b1100) || (bumperCounter > 2);
+}
+
+static uint8_t IsBumpLeft(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == 0b1000);
+}
+
+static uint8_t IsBumpRight(ES_Event ThisEvent) {
+    return (ThisEvent.EventParam == 0b0100);
+}
+
+static uint8_t IsFromTapeLeft(ES_Event ThisEvent) {
+    return (collisionFrom == FRONT_LEFT);
+}
+
+static uint8_t IsFromTapeRight(ES_Event ThisEvent) {
+    return (collisionFrom == FRONT_RIGHT);
+}
+
+static uint8_t IsFromBumpLeft(ES_Event ThisEvent) {
+    return (collisionFrom == FRONT_LEFT_BUMP);
+}
+
+static uint8_t IsFromBumpRight(ES_Event ThisEvent) {
+    return (collisionFrom == FRONT_RIGHT_BUMP);
+}
+
+/// transition actions ---------------------------------------------------------
+
+static void StartCollection(ES_Event ThisEvent) {
+    collisionFrom = START;
+    spinDirection = START;
+}
+
+static void SetFromWall(ES_Event ThisEvent) {
+    fromWall = TRUE;
+}
+
+static void TapeFront(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Tape: FRONT
+    alignCounter = 0;
+    collisionFrom = TAPE;
+}
+
+static void TapeLeft(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Tape: LEFT
+    collisionFrom = FRONT_LEFT;
+}
+
+static void TapeRight(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Tape: RIGHT
+    collisionFrom = FRONT_RIGHT;
+}
+
+static void BumpFront(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Bump: FRONT
+    bumperCounter = 0;
+    leftBumped = 0;
+    rightBumped = 0;
+    fromWall = TRUE;
+    collisionFrom = WALL;
+}
+
+static void BumpLeft(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Bump: LEFT
+    collisionFrom = FRONT_LEFT_BUMP;
+    leftBumped = 1;
+}
+
+static void BumpRight(ES_Event ThisEvent) {
+    ES_Trace(ThisEvent); // Bump: RIGHT
+    collisionFrom = FRONT_RIGHT_BUMP;
+    rightBumped = 1;
+}
+
+static void DriveTimedOut(ES_Event ThisEvent) {
+    bumperCounter = 0;
+    leftBumped = 0;
+    rightBumped = 0;
+    fromWall = TRUE;
+}
+
+static void StopAlignTimer(ES_Event ThisEvent) {
+    ES_HsmStopTimer(&Hsm);
+}
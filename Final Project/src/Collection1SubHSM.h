@@ -25,16 +25,37 @@
  ******************************************************************************/
 
 #include "ES_Configure.h"   // defines ES_Event, INIT_EVENT, ENTRY_EVENT, and EXIT_EVENT
+#include "ES_Hsm.h"         // ES_Hsm_t and ES_Timer_t, for the context
 
 /*******************************************************************************
  * PUBLIC #DEFINES                                                             *
  ******************************************************************************/
 
+/* es_chart begin: generated from Collection1SubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// the states of the machine, for the arrays of its context
+#define COLLECTION1SUBHSM_NUM_STATES 20
+// the events it can hold deferred, its Deferred[] has one more
+#define COLLECTION1SUBHSM_DEFERRED 4
+/* es_chart end */
+
 
 /*******************************************************************************
  * PUBLIC TYPEDEFS                                                             *
  ******************************************************************************/
 
+// the machine's variables, one set per robot, see Bot.h
+typedef struct {
+    ES_Hsm_t Hsm;
+    ES_Timer_t StateTimers[COLLECTION1SUBHSM_NUM_STATES];
+    ES_Event Deferred[COLLECTION1SUBHSM_DEFERRED + 1]; // an ES_Queue.h block
+    int collisionFrom;
+    int spinDirection;
+    int alignCounter;
+    int bumperCounter;
+    int rightBumped;
+    int leftBumped;
+    int fromWall;
+} Collection1SubHSMContext_t;
 
 /*******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES                                                  *
@@ -31,6 +31,7 @@
 #include "BOARD.h"
 #include "TopHSM.h"
 #include "Collection2SubHSM.h"
+#include "Bot.h"
 #include "motors.h"
 #include "LED.h"
 #include <stdio.h>
@@ -38,6 +39,11 @@
 /*******************************************************************************
  * MODULE #DEFINES                                                             *
  ******************************************************************************/
+
+/* es_chart begin: generated from Collection2SubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_COLLECTION2
+
 typedef enum {
     InitPSubState,
     DriveForward,
@@ -53,12 +59,9 @@ typedef enum {
     TapeFollowRight,
     RightAlign,
     FollowReverse,
-
-
-
 } Collection2SubHSMState_t;
 
-static const char *StateNames[] = {
+static const char *const StateNames[] ES_TRACE_NAMES = {
 	"InitPSubState",
 	"DriveForward",
 	"AlignReverse",
@@ -74,6 +77,10 @@ static const char *StateNames[] = {
 	"RightAlign",
 	"FollowReverse",
 };
+/* es_chart end */
+
+// each state's ES_TIMEOUT carries COLLECTION2_TIMERS plus the state's number
+#define STATE_TIMER(State) (COLLECTION2_TIMERS + (State))
 
 /*******************************************************************************
  * PRIVATE FUNCTION PROTOTYPES                                                 *
@@ -81,25 +88,31 @@ static const char *StateNames[] = {
 /* Prototypes for private functions for this machine. They should be functions
    relevant to the behavior of this state machine */
 
+static void StartStateTimer(uint32_t Ticks);
+static void StopStateTimer(Collection2SubHSMState_t State);
+
 
 /*******************************************************************************
  * PRIVATE MODULE VARIABLES                                                            *
  ******************************************************************************/
-/* You will need MyPriority and the state variable; you may need others as well.
- * The type of state variable should match that of enum in header file. */
+/* The state and the variables below are the robot's own, see
+ * Collection2SubHSMContext_t. */
+
+#define Me (&THIS_BOT->Collection2)
+#define CurrentState (Me->CurrentState)
 
-static Collection2SubHSMState_t CurrentState = InitPSubState; // <- change name to match ENUM
-static uint8_t MyPriority;
+// one timer per state, see STATE_TIMER()
+#define StateTimers (Me->StateTimers)
 
-static int collisionFrom = START;
-static int alignCounter = 0;
-static int bumperCounter = 0;
-static int rightBumped = 0;
-static int leftBumped = 0;
+#define collisionFrom (Me->collisionFrom)
+#define alignCounter (Me->alignCounter)
+#define bumperCounter (Me->bumperCounter)
+#define rightBumped (Me->rightBumped)
+#define leftBumped (Me->leftBumped)
 
 
-#define REVERSE_TIMER_TICKS 600
-#define TURN_90_TIMER_TICKS 650
+#define REVERSE_TIMER_TICKS BOT_TIMING(Collection2Reverse, 600)
+#define TURN_90_TIMER_TICKS BOT_TIMING(Collection2Turn90, 650)
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS                                                            *
@@ -118,6 +131,11 @@ static int leftBumped = 0;
 uint8_t InitCollection2SubHSM(void) {
     ES_Event returnEvent;
 
+    collisionFrom = START;
+    alignCounter = 0;
+    bumperCounter = 0;
+    rightBumped = 0;
+    leftBumped = 0;
     CurrentState = InitPSubState;
     returnEvent = RunCollection2SubHSM(INIT_EVENT);
     if (returnEvent.EventType == ES_NO_EVENT) {
@@ -143,7 +161,12 @@ uint8_t InitCollection2SubHSM(void) {
  * @author Aleida Diaz-Roque Spring 2024*/
 ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
     uint8_t makeTransition = FALSE; // use to flag transition
-    Collection2SubHSMState_t nextState; // <- change type to correct enum
+    Collection2SubHSMState_t nextState = CurrentState; // <- change type to correct enum
+
+    // a timeout meant for another state, or another machine, is not ours
+    if ((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam != STATE_TIMER(CurrentState))) {
+        return ThisEvent;
+    }
 
     ES_Tattle(); // trace call stack
 
@@ -171,10 +194,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(SPIN_TIMER); // from RightAlign
-                    ES_Timer_StopTimer(COLLISION_TIMER); // from Turn90Right/Left & Turn180
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from Reverse
-                    printf("\r\nCollection2: In Drive Forward");
+                    ES_Trace(ThisEvent); // Collection2: In Drive Forward
                     moveSlug(DRIVE_SPEED);
                     break;
 
@@ -182,9 +202,9 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
                     if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                         collisionFrom = FRONT_RIGHT;
 
                         nextState = AlignReverse;
@@ -193,7 +213,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
 
                     } else if (ThisEvent.EventParam == FRONT_LEFT) {
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                         collisionFrom = FRONT_LEFT;
 
                         nextState = AlignReverse;
@@ -202,7 +222,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
 
                     } else if ((ThisEvent.EventParam == REAR_LEFT) || (ThisEvent.EventParam == REAR_RIGHT)) {
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                         collisionFrom = REAR_BOTH;
 
                         nextState = AlignReverse;
@@ -211,7 +231,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     }
 
                     if ((ThisEvent.EventParam == FRONT_BOTH) || (alignCounter == 3)) {
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                         collisionFrom = TAPE;
                         alignCounter = 0;
 
@@ -226,7 +246,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                 case BUMPER_CHANGED:
                     // change parameter if statement later
                     if (ThisEvent.EventParam == FRONT_LEFT) {
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                         collisionFrom = FRONT_LEFT_BUMP;
 
                         nextState = AlignReverse;
@@ -234,7 +254,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         ThisEvent.EventType = ES_NO_EVENT;
 
                     } else if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         collisionFrom = FRONT_RIGHT_BUMP;
 
                         nextState = AlignReverse;
@@ -242,7 +262,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         ThisEvent.EventType = ES_NO_EVENT;
 
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                         collisionFrom = WALL;
                         nextState = Reverse;
                         makeTransition = TRUE;
@@ -276,10 +296,8 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(SPIN_TIMER); // from RightAlign
-                    ES_Timer_StopTimer(COLLISION_TIMER); // from Turn90Right/Left & Turn45Left
                     turnSlugRight(DRIVE_SPEED);
-                    printf("\r\n COlleciton2: Tape Follow Right");
+                    ES_Trace(ThisEvent); // COlleciton2: Tape Follow Right
 
                     break;
 
@@ -307,7 +325,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
                 case BUMPER_CHANGED:
                     if (ThisEvent.EventParam == FRONT_LEFT) {
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                         collisionFrom = FRONT_LEFT_BUMP;
 
                         nextState = AlignReverse;
@@ -315,7 +333,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         ThisEvent.EventType = ES_NO_EVENT;
 
                     } else if (ThisEvent.EventParam == FRONT_RIGHT) {
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         collisionFrom = FRONT_RIGHT_BUMP;
 
                         nextState = AlignReverse;
@@ -323,7 +341,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         ThisEvent.EventType = ES_NO_EVENT;
 
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                         collisionFrom = WALL;
                         nextState = Reverse;
                         makeTransition = TRUE;
@@ -353,7 +371,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     spinSlug(LEFT, DRIVE_SPEED);
                     //turnSlugSharpRight(-DRIVE_SPEED);
                     if (collisionFrom == DEAD_BOT) {
-                        ES_Timer_InitTimer(SPIN_TIMER, TURN_90_TIMER_TICKS * 2);
+                        StartStateTimer(TURN_90_TIMER_TICKS * 2);
                     }
                     break;
 
@@ -401,7 +419,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     ThisEvent.EventType = ES_NO_EVENT;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(SPIN_TIMER);
+                    StopStateTimer(CurrentState);
 
                 default:
                     break;
@@ -414,9 +432,8 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
         case FollowReverse:
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(SPIN_TIMER); // from RightAlign
                     moveSlug(-DRIVE_SPEED);
-                    ES_Timer_InitTimer(FOLLOW_TIMER, REVERSE_TIMER_TICKS - 200);
+                    StartStateTimer(REVERSE_TIMER_TICKS - 200);
                     break;
 
                 case ES_TIMEOUT:
@@ -437,7 +454,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(FOLLOW_TIMER);
+                    StopStateTimer(CurrentState);
 
                 default:
                     break;
@@ -452,7 +469,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                 case ES_ENTRY:
                     // the timer will depend on ig coming from a tape or wall or track wire detection
                     moveSlug(NO_SPEED);
-                    printf("\r\nCollection2: Stop");
+                    ES_Trace(ThisEvent); // Collection2: Stop
                     ThisEvent.EventType = READY_TO_DEPOSIT;
                     return ThisEvent;
                     break;
@@ -488,12 +505,12 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         bumperCounter++;
                     }
 
-                    printf("\r\nCollection2: In Align Reverse");
+                    ES_Trace(ThisEvent); // Collection2: In Align Reverse
 
                     //// bumpers
                     if ((collisionFrom == FRONT_RIGHT_BUMP) || (collisionFrom == FRONT_LEFT_BUMP)) {
-                        ES_Timer_InitTimer(REVERSE_TIMER, 100);
-                        printf("\r\n timer started");
+                        StartStateTimer(100);
+                        ES_Trace(ThisEvent); // timer started
                     }
 
                     /////// 
@@ -501,18 +518,18 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_NOT_SENSED:
-                    printf("\r\n tape not sensed");
+                    ES_Trace(ThisEvent); // tape not sensed
                     if (collisionFrom == FRONT_RIGHT) {
                         nextState = AdjustingRight;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\n alignreverseright");
+                        ES_Trace(ThisEvent); // alignreverseright
 
                     } else if (collisionFrom == FRONT_LEFT) {
                         nextState = AdjustingLeft;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\n alignreverseleft");
+                        ES_Trace(ThisEvent); // alignreverseleft
                     }
                     break;
 
@@ -530,18 +547,18 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                         nextState = AdjustingLeft;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\nalignreverseleft");
+                        ES_Trace(ThisEvent); // alignreverseleft
                     } else if (collisionFrom == FRONT_RIGHT_BUMP) {
                         nextState = AdjustingRight;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
-                        printf("\r\nalignreverseleft");
+                        ES_Trace(ThisEvent); // alignreverseleft
                     }
                     break;
 
                 case ES_EXIT:
                     //moveSlug(DRIVE_SPEED);
-                    ES_Timer_StopTimer(REVERSE_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case ES_NO_EVENT:
@@ -567,12 +584,12 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
                     // the timer will depend on ig coming from a tape or wall or track wire detection
                     if (collisionFrom == DEAD_BOT || collisionFrom == DEAD_BOT_MIDDLE) {
-                        ES_Timer_InitTimer(REVERSE_TIMER, REVERSE_TIMER_TICKS);
+                        StartStateTimer(REVERSE_TIMER_TICKS);
                     } else {
-                        ES_Timer_InitTimer(REVERSE_TIMER, 200);
+                        StartStateTimer(200);
                     }
 
-                    printf("\r\nCollection2: In Reverse");
+                    ES_Trace(ThisEvent); // Collection2: In Reverse
                     break;
 
                 case ES_TIMEOUT:
@@ -595,11 +612,11 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
                     makeTransition = TRUE;
                     ThisEvent.EventType = ES_NO_EVENT;
-                    ES_Timer_StopTimer(REVERSE_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(REVERSE_TIMER);
+                    StopStateTimer(CurrentState);
                     //moveSlug(DRIVE_SPEED);
                     break;
 
@@ -631,10 +648,8 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from Reverse
-                    ES_Timer_StopTimer(COLLISION_TIMER);
-                    ES_Timer_InitTimer(COLLISION_TIMER, TURN_90_TIMER_TICKS);
-                    printf("\r\nCollection2: In Turn90 Right");
+                    StartStateTimer(TURN_90_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // Collection2: In Turn90 Right
                     break;
 
                 case ES_TIMEOUT:
@@ -648,7 +663,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     //moveSlug(DRIVE_SPEED);
                     break;
 
@@ -670,11 +685,9 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from Reverse
-                    ES_Timer_StopTimer(FOLLOW_TIMER); // from FollowReverse
                     //ES_Timer_StopTimer(COLLISION_TIMER);
-                    ES_Timer_InitTimer(COLLISION_TIMER, TURN_90_TIMER_TICKS);
-                    printf("\r\nCollection2: In Turn90 Left");
+                    StartStateTimer(TURN_90_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // Collection2: In Turn90 Left
                     break;
 
                 case ES_TIMEOUT:
@@ -688,7 +701,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     //moveSlug(DRIVE_SPEED);
                     break;
 
@@ -712,10 +725,8 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from Reverse
-                    ES_Timer_StopTimer(COLLISION_TIMER);
-                    ES_Timer_InitTimer(COLLISION_TIMER, TURN_90_TIMER_TICKS / 2);
-                    printf("\r\nCollection2: In Turn45 Left");
+                    StartStateTimer(TURN_90_TIMER_TICKS / 2);
+                    ES_Trace(ThisEvent); // Collection2: In Turn45 Left
                     break;
 
                 case ES_TIMEOUT:
@@ -725,7 +736,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     //moveSlug(DRIVE_SPEED);
                     break;
 
@@ -746,10 +757,8 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from Reverse
-                    ES_Timer_StopTimer(COLLISION_TIMER);
-                    ES_Timer_InitTimer(COLLISION_TIMER, TURN_90_TIMER_TICKS * 2);
-                    printf("\r\nCollection2: In Turn180");
+                    StartStateTimer(TURN_90_TIMER_TICKS * 2);
+                    ES_Trace(ThisEvent); // Collection2: In Turn180
                     break;
 
                 case ES_TIMEOUT:
@@ -758,7 +767,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     ThisEvent.EventType = ES_NO_EVENT;
                     break;
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     //moveSlug(DRIVE_SPEED);
                     break;
 
@@ -776,20 +785,19 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
 
         case AdjustingRight: // in the first state, replace this with correct names
-            printf("\r\nCollection2: In Adjusting Right");
+            ES_Trace(ThisEvent); // Collection2: In Adjusting Right
             turnSlugSharpRight(DRIVE_SPEED - 75);
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from AlignReverse
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    BUMP SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // BUMP SENSED
 
                     if (ThisEvent.EventParam == 0b1000) {
                         // LEFT tape hit
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                         collisionFrom = FRONT_LEFT_BUMP;
                         leftBumped = 1;
                         nextState = AlignReverse;
@@ -799,7 +807,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 
                     if (ThisEvent.EventParam == 0b0100) {
                         // LEFT tape hit
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         collisionFrom = FRONT_RIGHT_BUMP;
                         rightBumped = 1;
                         nextState = AlignReverse;
@@ -808,7 +816,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     }
 
                     if ((ThisEvent.EventParam == 0b1100) || (bumperCounter > 3)) {
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                         // BOTH FRONT tape hit
                         bumperCounter = 0;
                         leftBumped = 0;
@@ -823,11 +831,11 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
 
                     if (ThisEvent.EventParam == 0b1000) {
                         // LEFT tape hit
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                         collisionFrom = FRONT_LEFT;
 
                         nextState = AlignReverse;
@@ -838,7 +846,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     }
 
                     if ((ThisEvent.EventParam == 0b1100) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                         // BOTH FRONT tape hit
                         alignCounter = 0;
                         collisionFrom = TAPE;
@@ -867,20 +875,19 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
 	    ////////////////////////////////////////////////////////////////////
 
         case AdjustingLeft: // in the first state, replace this with correct names
-            printf("\r\nCollection2: In Adjusting Left");
+            ES_Trace(ThisEvent); // Collection2: In Adjusting Left
             turnSlugSharpLeft(DRIVE_SPEED - 75);
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_StopTimer(REVERSE_TIMER); // from AlignReverse
                     //turnSlugSharpLeft(DRIVE_SPEED - 75);
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    TAPE_SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE_SENSED
 
                     if (ThisEvent.EventParam == 0b0100) {
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         // RIGHT tape hit
                         collisionFrom = FRONT_RIGHT_BUMP;
                         rightBumped = 1;
@@ -893,7 +900,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     }
 
                     if (ThisEvent.EventParam == 0b1000) {
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         // RIGHT tape hit
                         collisionFrom = FRONT_LEFT_BUMP;
                         leftBumped = 1;
@@ -908,7 +915,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     // 
 
                     if ((ThisEvent.EventParam == 0b1100) || (bumperCounter > 3)) {
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                         // BOTH FRONT tape hit
                         bumperCounter = 0;
                         leftBumped = 0;
@@ -923,10 +930,10 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE_SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE_SENSED
 
                     if (ThisEvent.EventParam == 0b0100) {
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                         // RIGHT tape hit
                         collisionFrom = FRONT_RIGHT;
 
@@ -938,7 +945,7 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
                     }
 
                     if ((ThisEvent.EventParam == 0b1100) || (alignCounter > 2)) {
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                         // BOTH FRONT tape hit
                         alignCounter = 0;
                         collisionFrom = TAPE;
@@ -986,3 +993,20 @@ ES_Event RunCollection2SubHSM(ES_Event ThisEvent) {
  * PRIVATE FUNCTIONS                                                           *
  ******************************************************************************/
 
+/**
+ * @Function StartStateTimer(uint32_t Ticks)
+ * @param Ticks - milliseconds until the current state gets its ES_TIMEOUT
+ * @return None
+ * @brief (Re)starts the current state's own timer. */
+static void StartStateTimer(uint32_t Ticks) {
+    ES_Timer_Start(&StateTimers[CurrentState], Ticks, PostTopHSM, STATE_TIMER(CurrentState));
+}
+
+/**
+ * @Function StopStateTimer(Collection2SubHSMState_t State)
+ * @param State - the state whose timer to cancel
+ * @return None */
+static void StopStateTimer(Collection2SubHSMState_t State) {
+    ES_Timer_Cancel(&StateTimers[State]);
+}
+
@@ -35,26 +35,35 @@
 #include "LED.h"
 #include <stdio.h>
 #include "DepositSubHSM.h"
+#include "Bot.h"
 
 /*******************************************************************************
  * MODULE #DEFINES                                                             *
  ******************************************************************************/
+
+/* es_chart begin: generated from DepositSubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_DEPOSIT
+
 typedef enum {
     InitPSubState,
     DriveForward2,
     Stop,
     ReverseRoll,
     AlignReverse,
-
 } DepositSubHSMState_t;
 
-static const char *StateNames[] = {
+static const char *const StateNames[] ES_TRACE_NAMES = {
 	"InitPSubState",
 	"DriveForward2",
 	"Stop",
 	"ReverseRoll",
 	"AlignReverse",
 };
+/* es_chart end */
+
+// each state's ES_TIMEOUT carries DEPOSIT_TIMERS plus the state's number
+#define STATE_TIMER(State) (DEPOSIT_TIMERS + (State))
 
 
 
@@ -64,19 +73,26 @@ static const char *StateNames[] = {
 /* Prototypes for private functions for this machine. They should be functions
    relevant to the behavior of this state machine */
 
+static void StartStateTimer(uint32_t Ticks);
+static void StopStateTimer(DepositSubHSMState_t State);
+
 /*******************************************************************************
  * PRIVATE MODULE VARIABLES                                                            *
  ******************************************************************************/
-/* You will need MyPriority and the state variable; you may need others as well.
- * The type of state variable should match that of enum in header file. */
+/* The state and the variables below are the robot's own, see
+ * DepositSubHSMContext_t. */
 
-static DepositSubHSMState_t CurrentState = InitPSubState; // <- change name to match ENUM
-static uint8_t MyPriority;
+#define Me (&THIS_BOT->Deposit)
+#define CurrentState (Me->CurrentState)
 
-static int collisionFrom = START;
+// one timer per state, see STATE_TIMER()
+#define StateTimers (Me->StateTimers)
+
+#define collisionFrom (Me->collisionFrom)
 
 #define REVERSE_TIMER_TICKS 500
 #define TURN_90_TIMER_TICKS 600
+#define DUMP_TIMER_TICKS BOT_TIMING(DepositDump, 9500)
 
 
 /*******************************************************************************
@@ -96,6 +112,7 @@ static int collisionFrom = START;
 uint8_t InitDepositSubHSM(void) {
     ES_Event returnEvent;
 
+    collisionFrom = START;
     CurrentState = InitPSubState;
     returnEvent = RunDepositSubHSM(INIT_EVENT);
     if (returnEvent.EventType == ES_NO_EVENT) {
@@ -121,7 +138,12 @@ uint8_t InitDepositSubHSM(void) {
  * @author Gabriel H Elkaim, 2011.10.23 19:25 */
 ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
     uint8_t makeTransition = FALSE; // use to flag transition
-    DepositSubHSMState_t nextState; // <- change type to correct enum
+    DepositSubHSMState_t nextState = CurrentState; // <- change type to correct enum
+
+    // a timeout meant for another state, or another machine, is not ours
+    if ((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam != STATE_TIMER(CurrentState))) {
+        return ThisEvent;
+    }
 
     ES_Tattle(); // trace call stack
 
@@ -141,7 +163,7 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
             break;
 
         case DriveForward2: // in the first state, replace this with correct names
-            printf("\r\nDeposit: DriveForward");
+            ES_Trace(ThisEvent); // Deposit: DriveForward
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
@@ -160,8 +182,8 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
 
                 case BUMPER_CHANGED:
                     // change parameter if statement later
-                    printf("\r\n Deposit: In Drive Forward");
-                    ES_Timer_InitTimer(DEPOSIT_TIMER, 9500);
+                    ES_Trace(ThisEvent); // Deposit: In Drive Forward
+                    StartStateTimer(DUMP_TIMER_TICKS);
                     moveMotor(WALL, 700);
                     moveSlug(NO_SPEED);
 //                    if (ThisEvent.EventParam == FRONT_BOTH) {
@@ -209,13 +231,16 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
                         turnSlugRight(-DRIVE_SPEED);
                     }
 
-                    ES_Timer_InitTimer(DEPOSIT_TIMER, 500);
+                    StartStateTimer(500);
                     break;
                 case ES_TIMEOUT:
                     nextState = DriveForward2;
                     makeTransition = TRUE;
                     ThisEvent.EventType = ES_NO_EVENT;
                     break;
+
+                default: // all unhandled events pass the event back up to the next level
+                    break;
             }
             break;
 
@@ -225,7 +250,7 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
                 case ES_ENTRY:
                     moveMotor(ROLLER, -ROLLER_SPEED);
                     moveMotor(WALL, 0);
-                    ES_Timer_InitTimer(DEPOSIT_TIMER, 2500);
+                    StartStateTimer(2500);
                     break;
 
                 case ES_TIMEOUT:
@@ -237,7 +262,7 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(DEPOSIT_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
                     ;
 
@@ -251,10 +276,9 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
                     // the timer will depend on ig coming from a tape or wall or track wire detection
-                    ES_Timer_StopTimer(DEPOSIT_TIMER);
-                    ES_Timer_InitTimer(DEPOSIT_TIMER, 7000);
+                    StartStateTimer(7000);
                     moveSlug(NO_SPEED);
-                    printf("\r\nDeposit: Stop");
+                    ES_Trace(ThisEvent); // Deposit: Stop
                     break;
 
                 case TRACK_WIRE_NOT_FOUND:
@@ -269,7 +293,7 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(DEPOSIT_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case ES_NO_EVENT:
@@ -301,3 +325,20 @@ ES_Event RunDepositSubHSM(ES_Event ThisEvent) {
  * PRIVATE FUNCTIONS                                                           *
  ******************************************************************************/
 
+/**
+ * @Function StartStateTimer(uint32_t Ticks)
+ * @param Ticks - milliseconds until the current state gets its ES_TIMEOUT
+ * @return None
+ * @brief (Re)starts the current state's own timer. */
+static void StartStateTimer(uint32_t Ticks) {
+    ES_Timer_Start(&StateTimers[CurrentState], Ticks, PostTopHSM, STATE_TIMER(CurrentState));
+}
+
+/**
+ * @Function StopStateTimer(DepositSubHSMState_t State)
+ * @param State - the state whose timer to cancel
+ * @return None */
+static void StopStateTimer(DepositSubHSMState_t State) {
+    ES_Timer_Cancel(&StateTimers[State]);
+}
+
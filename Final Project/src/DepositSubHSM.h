@@ -22,16 +22,28 @@
  ******************************************************************************/
 
 #include "ES_Configure.h"   // defines ES_Event, INIT_EVENT, ENTRY_EVENT, and EXIT_EVENT
+#include "ES_Hsm.h"         // ES_Hsm_t and ES_Timer_t, for the context
 
 /*******************************************************************************
  * PUBLIC #DEFINES                                                             *
  ******************************************************************************/
 
+/* es_chart begin: generated from DepositSubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// the states of the machine, for the arrays of its context
+#define DEPOSITSUBHSM_NUM_STATES 5
+/* es_chart end */
+
 
 /*******************************************************************************
  * PUBLIC TYPEDEFS                                                             *
  ******************************************************************************/
 
+// the machine's variables, one set per robot, see Bot.h
+typedef struct {
+    uint8_t CurrentState;
+    ES_Timer_t StateTimers[DEPOSITSUBHSM_NUM_STATES];
+    int collisionFrom;
+} DepositSubHSMContext_t;
 
 /*******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES                                                  *
@@ -30,21 +30,44 @@
 //uncomment to suppress the entry and exit events
 //#define SUPPRESS_EXIT_ENTRY_IN_TATTLE
 
+// the state machines in the trace, each sets its ES_TRACE_ID to one of these
+typedef enum {
+    TRACE_TOP_HSM = 1, // 0 is the framework itself
+    TRACE_SEARCH_FOR_BEACON,
+    TRACE_COLLECTION1,
+    TRACE_COLLECTION2,
+    TRACE_DEPOSIT,
+} ES_TraceMachine_t;
+
+// uncomment to record the sensors every tick on the Uno32 and send the
+// samples beside the trace, see SensorRecord.h; the host records with -R
+//#define USE_SENSOR_RECORD
+
+// a function the Uno32 run loop calls every tick, before the timers of the
+// tick expire, declared in ES_TICK_HOOK_HEADER; the host port has
+// ES_Port_SetTickHook() instead
+#ifdef USE_SENSOR_RECORD
+#define ES_TICK_HOOK_HEADER "SensorRecord.h"
+#define ES_TICK_HOOK SensorRecord_Tick
+#endif
+
 /****************************************************************************/
 // Name/define the events of interest
 // Universal events occupy the lowest entries, followed by user-defined events
 
 /****************************************************************************/
+/* es_chart begin: generated from ES_Configure.chart by es_chart, edit the chart and run make -C host charts */
 typedef enum {
-    ES_NO_EVENT, ES_ERROR, /* used to indicate an error from the service */
+    ES_NO_EVENT,
+    ES_ERROR, /* used to indicate an error from the service */
     ES_INIT, /* used to transition from initial pseudo-state */
-    ES_ENTRY, /* used to enter a state*/
-    ES_EXIT, /* used to exit a state*/
-    ES_KEYINPUT, /* used to signify a key has been pressed*/
-    ES_LISTEVENTS, /* used to list events in keyboard input, does not get posted to fsm*/
+    ES_ENTRY, /* used to enter a state */
+    ES_EXIT, /* used to exit a state */
+    ES_KEYINPUT, /* used to signify a key has been pressed */
+    ES_LISTEVENTS, /* used to list events in keyboard input, does not get posted to fsm */
     ES_TIMEOUT, /* signals that the timer has expired */
     ES_TIMERACTIVE, /* signals that a timer has become active */
-    ES_TIMERSTOPPED, /* signals that a timer has stopped*/
+    ES_TIMERSTOPPED, /* signals that a timer has stopped */
     /* User-defined events start here */
     BATTERY_CONNECTED,
     BATTERY_DISCONNECTED,
@@ -68,7 +91,7 @@ typedef enum {
     NUMBEROFEVENTS,
 } ES_EventTyp_t;
 
-static const char *EventNames[] = {
+static const char *const EventNames[] = {
 	"ES_NO_EVENT",
 	"ES_ERROR",
 	"ES_INIT",
@@ -99,6 +122,7 @@ static const char *EventNames[] = {
 	"OTHER_WALL_NOT_FOUND",
 	"NUMBEROFEVENTS",
 };
+/* es_chart end */
 
 
 
@@ -110,25 +134,84 @@ static const char *EventNames[] = {
 #define EVENT_CHECK_HEADER "BotEventChecker.h"
 
 /****************************************************************************/
-// This is the list of event checking functions
+// This is the list of event checking functions. Each must be a pure edge
+// detector over the inputs, with no time-based state of its own; see the
+// contract in ES_CheckEvents.h, which make VERIFY=1 on the host checks
 #define EVENT_CHECK_LIST  CheckBattery , CheckTape, CheckWall, CheckOtherWall,
 //#define EVENT_CHECK_LIST 
 
+/****************************************************************************/
+// How often to run each checker above, in ms and in the same order. Checkers
+// with the same period are run together as a rate group; 0 means on every pass
+// of the run loop. The tape and wall sensors want the fastest rate the 1 ms
+// tick allows, the battery changes slowly and reads the A/D, 10 times a second
+// is plenty.
+#define EVENT_CHECK_PERIODS 100, 1, 1, 1,
+
+/****************************************************************************/
+// Tickless idle. Instead of going straight round the run loop, sleep until the
+// next checker group is due, waking early for a timer or an interrupt. Comment
+// out to poll continuously; the CPU load in the queue statistics shows the
+// difference.
+#define USE_TICKLESS_IDLE
+
+/****************************************************************************/
+// Events that report a state rather than a change. A post of one of these to
+// a queue whose newest event is one of the same type overwrites that event's
+// param instead of taking another entry, so the state machine acts on the
+// freshest reading without events of other types changing places. Comma
+// separated, may be left empty.
+#define COALESCED_EVENTS TAPE_SENSED,
+
+/****************************************************************************/
+// Run-to-completion budget. Every call of a Run function is timed and one
+// longer than this many microseconds is counted as an overrun, traced with
+// USE_TATTLETALE. A busy-wait such as the DELAY()s of swingWall() stalls
+// every service, so anything near a 1 ms tick is a bug.
+#define ES_RUN_BUDGET_US 1000
+// uncomment to stop the framework on an overrun, as if the service had
+// returned ES_ERROR
+//#define ES_RUN_BUDGET_FATAL
+
+// Post to dispatch latency histograms, ES_LATENCY_BUCKETS saturating uint16_t
+// counters for every event type in every context, see
+// ES_GetLatencyHistogram(): 448 bytes with the events below, so kept on the
+// board as well.
+#define USE_LATENCY_HISTOGRAMS
+
+// The queue statistics by event type, a saturating uint8_t count and a
+// uint16_t worst wait in microseconds for every event type in every queue,
+// see ES_QueueStats_t: three bytes an event type, 84 a queue with the events
+// below, so kept on the board as well.
+#define USE_QUEUE_TYPE_STATS
+
+// The state each service is in, for the worst Run times the framework keeps
+// by state and event type. Name each service at most once, with a function
+// returning its state as a uint8_t. Services left out are always in state 0.
+#define ES_SERVICE_STATES \
+    ES_SERVICE_STATE(1, QueryTopHSM)
+// The table of those worst times, a uint16_t for every state and event type
+// of every service, see ES_RunStats_t. Kept on the host only; the longest call
+// of each service is always kept.
+#ifdef ES_HOST
+#define USE_RUN_WORST_CASES
+#endif
+
 /****************************************************************************/
 // These are the definitions for the post functions to be executed when the
 // corresponding timer expires. All 16 must be defined. If you are not using
 // a timers, then you can use TIMER_UNUSED
 #define TIMER_UNUSED ((pPostFunc)0)
 #define TIMER0_RESP_FUNC PostBotService
-#define TIMER1_RESP_FUNC PostTopHSM
-#define TIMER2_RESP_FUNC PostTopHSM
-#define TIMER3_RESP_FUNC PostTopHSM
-#define TIMER4_RESP_FUNC PostTopHSM
-#define TIMER5_RESP_FUNC PostTopHSM
-#define TIMER6_RESP_FUNC PostTopHSM
-#define TIMER7_RESP_FUNC PostTopHSM
-#define TIMER8_RESP_FUNC PostTopHSM
-#define TIMER9_RESP_FUNC PostTopHSM
+#define TIMER1_RESP_FUNC TIMER_UNUSED
+#define TIMER2_RESP_FUNC TIMER_UNUSED
+#define TIMER3_RESP_FUNC TIMER_UNUSED
+#define TIMER4_RESP_FUNC TIMER_UNUSED
+#define TIMER5_RESP_FUNC TIMER_UNUSED
+#define TIMER6_RESP_FUNC TIMER_UNUSED
+#define TIMER7_RESP_FUNC TIMER_UNUSED
+#define TIMER8_RESP_FUNC TIMER_UNUSED
+#define TIMER9_RESP_FUNC TIMER_UNUSED
 #define TIMER10_RESP_FUNC TIMER_UNUSED
 #define TIMER11_RESP_FUNC TIMER_UNUSED
 #define TIMER12_RESP_FUNC TIMER_UNUSED
@@ -144,22 +227,24 @@ static const char *EventNames[] = {
 // the timer number matches where the timer event will be routed
 
 #define BEACON_CHECK_TIMER 0 /*make sure this is enabled above and posting to the correct state machine*/
-#define SPIN_TIMER 1
-#define COLLISION_TIMER 2
-#define INFINITY_TIMER 3
-#define TAPE_CHECK_TIMER 4
-#define FOLLOW_TIMER 5
-#define DEPOSIT_TIMER 6
-#define REVERSE_TIMER 7
-#define CHECK_TIMER 8
-#define FINISH_TIMER 9
+
+
+/****************************************************************************/
+// The state machines keep their own ES_Timer_t timers, one per state, and
+// start them with ES_Timer_Start(). Each machine numbers its timeouts from its
+// own base, clear of the numbered timers above and of every other machine, so
+// a timeout can always be traced back to the state that asked for it.
+#define SEARCH_FOR_BEACON_TIMERS 0x100
+#define COLLECTION1_TIMERS 0x200
+#define COLLECTION2_TIMERS 0x300
+#define DEPOSIT_TIMERS 0x400
 
 
 /****************************************************************************/
 // The maximum number of services sets an upper bound on the number of 
-// services that the framework will handle. Reasonable values are 8 and 16
-// HOWEVER: at this time only a value of 8 is supported.
-#define MAX_NUM_SERVICES 8
+// services that the framework will handle. The ready set allows up to 32
+// services on the Uno32 and 64 on the host build.
+#define MAX_NUM_SERVICES 32
 
 /****************************************************************************/
 // This macro determines that nuber of services that are *actually* used in
@@ -177,8 +262,8 @@ static const char *EventNames[] = {
 #define SERV_0_INIT InitKeyboardInput
 // the name of the run function
 #define SERV_0_RUN RunKeyboardInput
-// How big should this service's Queue be?
-#define SERV_0_QUEUE_SIZE 9
+// How big should this service's Queue be? (a power of two, up to 128)
+#define SERV_0_QUEUE_SIZE 8
 
 /****************************************************************************/
 // These are the definitions for Service 1
@@ -190,7 +275,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_1_RUN RunTopHSM //RunBotService
 // How big should this services Queue be?
-#define SERV_1_QUEUE_SIZE 3
+#define SERV_1_QUEUE_SIZE 4
 #endif
 
 // These are the definitions for Service 2
@@ -202,7 +287,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_2_RUN RunBotService
 // How big should this services Queue be?
-#define SERV_2_QUEUE_SIZE 3
+#define SERV_2_QUEUE_SIZE 4
 #endif
 
 
@@ -217,7 +302,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_3_RUN TestServiceRun
 // How big should this services Queue be?
-#define SERV_3_QUEUE_SIZE 3
+#define SERV_3_QUEUE_SIZE 4
 #endif
 
 /****************************************************************************/
@@ -230,7 +315,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_4_RUN TestServiceRun
 // How big should this services Queue be?
-#define SERV_4_QUEUE_SIZE 3
+#define SERV_4_QUEUE_SIZE 4
 #endif
 
 /****************************************************************************/
@@ -243,7 +328,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_5_RUN TestServiceRun
 // How big should this services Queue be?
-#define SERV_5_QUEUE_SIZE 3
+#define SERV_5_QUEUE_SIZE 4
 #endif
 
 /****************************************************************************/
@@ -256,7 +341,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_6_RUN TestServiceRun
 // How big should this services Queue be?
-#define SERV_6_QUEUE_SIZE 3
+#define SERV_6_QUEUE_SIZE 4
 #endif
 
 /****************************************************************************/
@@ -269,7 +354,7 @@ static const char *EventNames[] = {
 // the name of the run function
 #define SERV_7_RUN TestServiceRun
 // How big should this services Queue be?
-#define SERV_7_QUEUE_SIZE 3
+#define SERV_7_QUEUE_SIZE 4
 #endif
 
 /****************************************************************************/
@@ -281,34 +366,28 @@ static const char *EventNames[] = {
 
 
 /****************************************************************************/
-// These are the definitions for the Distribution lists. Each definition
-// should be a comma seperated list of post functions to indicate which
-// services are on that distribution list.
-#define NUM_DIST_LISTS 0
-#if NUM_DIST_LISTS > 0 
-#define DIST_LIST0 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 1 
-#define DIST_LIST1 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 2 
-#define DIST_LIST2 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 3 
-#define DIST_LIST3 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 4 
-#define DIST_LIST4 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 5 
-#define DIST_LIST5 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 6 
-#define DIST_LIST6 PostTemplateFSM
-#endif
-#if NUM_DIST_LISTS > 7 
-#define DIST_LIST7 PostTemplateFSM
-#endif
+// Publish/subscribe routing. ES_Publish() posts an event to every service
+// subscribed to its type, so a new consumer of sensor events, such as a logger
+// or a safety service, only needs adding here. Name each event type at most
+// once, with the ES_SERVICE_BIT() of each subscribing service OR-ed together.
+// Types that are not listed are published to nobody.
+#define TOP_HSM_SUBSCRIBER ES_SERVICE_BIT(1)
+
+#define ES_SUBSCRIPTIONS \
+    ES_SUBSCRIBE(BATTERY_CONNECTED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(BATTERY_DISCONNECTED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(TAPE_NOT_SENSED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(TAPE_SENSED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(BEACON_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(BEACON_NOT_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(TOP_BUMPER_CHANGED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(BUMPER_CHANGED, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(TRACK_WIRE_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(TRACK_WIRE_NOT_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(WALL_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(WALL_NOT_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(OTHER_WALL_FOUND, TOP_HSM_SUBSCRIBER) \
+    ES_SUBSCRIBE(OTHER_WALL_NOT_FOUND, TOP_HSM_SUBSCRIBER)
 
 
 
@@ -7,6 +7,10 @@
 #include "motors.h"
 #include "pwm.h"
 #include "LED.h"
+#include "Bot.h"
+#ifdef USE_SENSOR_RECORD
+#include "SensorRecord.h"
+#endif
 
 //#define MAIN_TEST
 
@@ -15,8 +19,10 @@
 //commented this out
 
 void main(void) {
+    static Bot_t TheBot; // the one robot on this board
     ES_Return_t ErrorType;
 
+    ES_SetContext(&TheBot.Framework);
     BOARD_Init();
     PWM_Init();
     motors_Init(); 
@@ -35,6 +41,10 @@ void main(void) {
     LED_OnBank(LED_BANK3, 0xF);
 
 
+#ifdef USE_SENSOR_RECORD
+    SensorRecord_Start();
+#endif
+
     // now initialize the Events and Services Framework and start it running
     ErrorType = ES_Initialize();
     if (ErrorType == Success) {
@@ -30,6 +30,7 @@
 #include "BOARD.h"
 #include "TopHSM.h"
 #include "SearchForBeaconSubHSM.h"
+#include "Bot.h"
 #include "sensors.h"
 #include "motors.h"
 #include "stdio.h"
@@ -38,6 +39,11 @@
 /*******************************************************************************
  * MODULE #DEFINES                                                             *
  ******************************************************************************/
+
+/* es_chart begin: generated from SearchForBeaconSubHSM.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_SEARCH_FOR_BEACON
+
 typedef enum {
     InitPSubState,
     RotateSearch,
@@ -50,7 +56,7 @@ typedef enum {
     ShortDrive,
 } SearchForBeaconSubHSMState_t;
 
-static const char *StateNames[] = {
+static const char *const StateNames[] ES_TRACE_NAMES = {
 	"InitPSubState",
 	"RotateSearch",
 	"InfinitySearchRight",
@@ -61,19 +67,26 @@ static const char *StateNames[] = {
 	"Turning",
 	"ShortDrive",
 };
+/* es_chart end */
+
+// each state's ES_TIMEOUT carries SEARCH_FOR_BEACON_TIMERS plus the state's number
+#define STATE_TIMER(State) (SEARCH_FOR_BEACON_TIMERS + (State))
+// started on entering InfinitySearchRight, gives up on the beacon search
+#define FINISH_TIMER (SEARCH_FOR_BEACON_TIMERS + 0xFF)
+#define FINISH_TIMER_TICKS 30000
 
 // CONSUME TRACK WIRE EVENTS
 
 // collision values
 
 
-#define SPIN_TIMER_TICKS 3000
-#define REVERSE_TIMER_TICKS 750
-#define TURN_TIMER_TICKS 1000
-#define SHORT_DRIVE_TIMER_TICKS 1000
-#define TURN_90_TIMER_TICKS 1000
-#define INFINITY_TIMER_TICKS 4500
-#define PARK_TIMER_TICKS 4000
+#define SPIN_TIMER_TICKS BOT_TIMING(SearchSpin, 3000)
+#define REVERSE_TIMER_TICKS BOT_TIMING(SearchReverse, 750)
+#define TURN_TIMER_TICKS BOT_TIMING(SearchTurn, 1000)
+#define SHORT_DRIVE_TIMER_TICKS BOT_TIMING(SearchShortDrive, 1000)
+#define TURN_90_TIMER_TICKS BOT_TIMING(SearchTurn90, 1000)
+#define INFINITY_TIMER_TICKS BOT_TIMING(SearchInfinity, 4500)
+#define PARK_TIMER_TICKS BOT_TIMING(SearchPark, 4000)
 
 
 /*******************************************************************************
@@ -82,15 +95,22 @@ static const char *StateNames[] = {
 /* Prototypes for private functions for this machine. They should be functions
    relevant to the behavior of this state machine */
 
+static void StartStateTimer(uint32_t Ticks);
+static void StopStateTimer(SearchForBeaconSubHSMState_t State);
+
 /*******************************************************************************
  * PRIVATE MODULE VARIABLES                                                            *
  ******************************************************************************/
-/* You will need MyPriority and the state variable; you may need others as well.
- * The type of state variable should match that of enum in header file. */
+/* The state and the variables below are the robot's own, see
+ * SearchForBeaconSubHSMContext_t. */
 
-static SearchForBeaconSubHSMState_t CurrentState = InitPSubState; // <- change name to match ENUM
-static uint8_t MyPriority;
-static int collisionFrom = START;
+#define Me (&THIS_BOT->SearchForBeacon)
+#define CurrentState (Me->CurrentState)
+
+// one timer per state, see STATE_TIMER()
+#define StateTimers (Me->StateTimers)
+#define FinishTimer (Me->FinishTimer)
+#define collisionFrom (Me->collisionFrom)
 
 
 /*******************************************************************************
@@ -110,6 +130,7 @@ static int collisionFrom = START;
 uint8_t InitSearchForBeaconSubHSM(void) {
     ES_Event returnEvent;
 
+    collisionFrom = START;
     CurrentState = InitPSubState;
     returnEvent = RunSearchForBeaconSubHSM(INIT_EVENT);
     if (returnEvent.EventType == ES_NO_EVENT) {
@@ -135,7 +156,12 @@ uint8_t InitSearchForBeaconSubHSM(void) {
  * @author Aleida Diaz-Roque */
 ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
     uint8_t makeTransition = FALSE; // use to flag transition
-    SearchForBeaconSubHSMState_t nextState; // <- change type to correct enum
+    SearchForBeaconSubHSMState_t nextState = CurrentState; // <- change type to correct enum
+
+    // a timeout meant for another state, or another machine, is not ours
+    if ((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam != STATE_TIMER(CurrentState)) && (ThisEvent.EventParam != FINISH_TIMER)) {
+        return ThisEvent;
+    }
 
     ES_Tattle(); // trace call stack
 
@@ -154,8 +180,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                 ThisEvent.EventType = ES_NO_EVENT;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case RotateSearch: // in the first state, replace this with correct names
 
@@ -164,8 +190,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
-                    ES_Timer_InitTimer(SPIN_TIMER, SPIN_TIMER_TICKS);
-                    printf("\r\n SearchForBeacon: In rotate search");
+                    StartStateTimer(SPIN_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // SearchForBeacon: In rotate search
                     break;
 
                 case ES_TIMEOUT:
@@ -181,7 +207,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(SPIN_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case TRACK_WIRE_FOUND:
@@ -192,8 +218,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case InfinitySearchRight: // in the first state, replace this with correct names
 
@@ -203,19 +229,19 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
 
                 case ES_ENTRY:
                     //ES_Timer_StopTimer(COLLISION_TIMER);
-                    ES_Timer_InitTimer(INFINITY_TIMER, INFINITY_TIMER_TICKS);
-                    printf("\r\n SearchForBeacon: In Infinity Search Right");
+                    StartStateTimer(INFINITY_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // SearchForBeacon: In Infinity Search Right
                     collisionFrom = START;
-                    ES_Timer_InitTimer(FINISH_TIMER, 30000);
+                    ES_Timer_Start(&FinishTimer, FINISH_TIMER_TICKS, PostTopHSM, FINISH_TIMER);
                     break;
 
                 case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == INFINITY_TIMER) {
+                    if (ThisEvent.EventParam == STATE_TIMER(CurrentState)) {
                         nextState = InfinitySearchLeft;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
                     } else if (ThisEvent.EventParam == FINISH_TIMER) {
-                        ES_Timer_StopTimer(INFINITY_TIMER);
+                        StopStateTimer(CurrentState);
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
@@ -225,17 +251,17 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
 
                     if (ThisEvent.EventParam == FRONT_RIGHT) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                     } else if (ThisEvent.EventParam == FRONT_LEFT) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                     }
 
                     nextState = Reverse;
@@ -244,17 +270,17 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    BUMPER CHANGED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // BUMPER CHANGED
 
                     if (ThisEvent.EventParam == FRONT_RIGHT) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                     } else if (ThisEvent.EventParam == FRONT_LEFT) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                     } else {
                         ThisEvent.EventType = ES_NO_EVENT;
                     }
@@ -278,7 +304,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(INFINITY_TIMER);
+                    StopStateTimer(CurrentState);
 
                     break;
 
@@ -288,8 +314,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case InfinitySearchLeft: // in the first state, replace this with correct names
 
@@ -299,19 +325,19 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
 
                 case ES_ENTRY:
                     //ES_Timer_StopTimer(INFINITY_TIMER);
-                    ES_Timer_InitTimer(SPIN_TIMER, INFINITY_TIMER_TICKS);
-                    printf("\r\n SearchForBeacon: In Infinity Search Left");
+                    StartStateTimer(INFINITY_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // SearchForBeacon: In Infinity Search Left
                     collisionFrom = START;
                     break;
 
                 case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == SPIN_TIMER) {
+                    if (ThisEvent.EventParam == STATE_TIMER(CurrentState)) {
 
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
                     } else if (ThisEvent.EventParam == FINISH_TIMER) {
-                        ES_Timer_StopTimer(SPIN_TIMER);
+                        StopStateTimer(CurrentState);
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
@@ -319,18 +345,18 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
 
                     if (ThisEvent.EventParam == FRONT_RIGHT) {
 
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                     } else if (ThisEvent.EventParam == FRONT_LEFT) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                     }
 
                     nextState = Reverse;
@@ -339,17 +365,17 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    BUMPER CHANGED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // BUMPER CHANGED
 
                     if (ThisEvent.EventParam == FRONT_RIGHT) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                     } else if (ThisEvent.EventParam == FRONT_LEFT) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                     } else if (ThisEvent.EventParam == FRONT_BOTH) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                     } else {
                         ThisEvent.EventType = ES_NO_EVENT;
                     }
@@ -378,7 +404,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(SPIN_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case TRACK_WIRE_FOUND:
@@ -390,8 +416,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case DriveToBeacon: // in the first state, replace this with correct names
             moveSlug(DRIVE_SPEED);
@@ -399,22 +425,22 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                 case ES_ENTRY:
                     // start driving forward
                     collisionFrom = START;
-                    printf("\r\n SearchForBeacon: In DriveToBeacon");
+                    ES_Trace(ThisEvent); // SearchForBeacon: In DriveToBeacon
                     moveSlug(DRIVE_SPEED);
                     break;
 
                 case BUMPER_CHANGED:
 
                     if (ThisEvent.EventParam == FRONT_RIGHT) { // FR Bumper
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                         collisionFrom = FRONT_RIGHT;
 
                     } else if (ThisEvent.EventParam == FRONT_LEFT) { // FL Bumper
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                         collisionFrom = FRONT_LEFT;
 
                     } else if (ThisEvent.EventParam == FRONT_BOTH) { // Both front bumpers
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                         collisionFrom = FRONT_BOTH;
 
                     } else {
@@ -444,20 +470,20 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case Park:
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
-                    printf("\r\n SearchForBeacon: In Park");
-                    ES_Timer_InitTimer(INFINITY_TIMER, PARK_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // SearchForBeacon: In Park
+                    StartStateTimer(PARK_TIMER_TICKS);
                     moveSlug(NO_SPEED);
                     break;
 
                 case ES_TIMEOUT:
-                    if (ThisEvent.EventParam == INFINITY_TIMER) {
+                    if (ThisEvent.EventParam == STATE_TIMER(CurrentState)) {
                         //Ready to Collect
                         ThisEvent.EventType = READY_TO_DEPOSIT;
                         ThisEvent.EventParam = 0;
@@ -467,7 +493,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
 
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(INFINITY_TIMER);
+                    StopStateTimer(CurrentState);
                     moveSlug(NO_SPEED);
                     break;
 
@@ -481,8 +507,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case Reverse:
 
@@ -490,18 +516,18 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    ES_Timer_InitTimer(COLLISION_TIMER, REVERSE_TIMER_TICKS);
-                    printf("\r\n SearchForBeacon: In Reverse");
+                    StartStateTimer(REVERSE_TIMER_TICKS);
+                    ES_Trace(ThisEvent); // SearchForBeacon: In Reverse
                     break;
 
                 case ES_TIMEOUT:
                     if (ThisEvent.EventParam == FINISH_TIMER) {
-                        ES_Timer_StopTimer(COLLISION_TIMER);
+                        StopStateTimer(CurrentState);
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
                     } else {
-                        ES_Timer_StopTimer(COLLISION_TIMER);
+                        StopStateTimer(CurrentState);
                         nextState = Turning;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
@@ -509,7 +535,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     }
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case ES_NO_EVENT:
@@ -518,17 +544,17 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                 case BUMPER_CHANGED:
                     if (ThisEvent.EventParam == 0b0010) {
                         // rear left bump
-                        printf("\r\n    bump: REAR LEFT");
+                        ES_Trace(ThisEvent); // bump: REAR LEFT
                     } else if (ThisEvent.EventParam == 0b0001) {
-                        printf("\r\n    bumped REAR RIGHT");
+                        ES_Trace(ThisEvent); // bumped REAR RIGHT
                     } else if (ThisEvent.EventParam == 0b0011) {
-                        printf("\r\n    bumped REAR BOTH");
+                        ES_Trace(ThisEvent); // bumped REAR BOTH
                     }
 
                     nextState = Turning;
                     makeTransition = TRUE;
                     ThisEvent.EventType = ES_NO_EVENT;
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
 
                     break;
 
@@ -537,7 +563,7 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                         nextState = Turning;
                         makeTransition = TRUE;
                         ThisEvent.EventType = ES_NO_EVENT;
-                        ES_Timer_StopTimer(COLLISION_TIMER);
+                        StopStateTimer(CurrentState);
                     }
 
                     break;
@@ -550,8 +576,8 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
 
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case Turning: // in the first state, replace this with correct names
 
@@ -560,36 +586,36 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
-                    printf("\r\n SearchForBeacon: In Turning");
+                    ES_Trace(ThisEvent); // SearchForBeacon: In Turning
                     if (collisionFrom == FRONT_RIGHT) {
-                        printf("\r\n    Turning RIGHT");
-                        ES_Timer_InitTimer(COLLISION_TIMER, TURN_TIMER_TICKS);
+                        ES_Trace(ThisEvent); // Turning RIGHT
+                        StartStateTimer(TURN_TIMER_TICKS);
                         turnSlugSharpLeft(DRIVE_SPEED);
 
                     } else if (collisionFrom == FRONT_LEFT) {
-                        printf("\r\n    Turning LEFT");
-                        ES_Timer_InitTimer(COLLISION_TIMER, TURN_TIMER_TICKS);
+                        ES_Trace(ThisEvent); // Turning LEFT
+                        StartStateTimer(TURN_TIMER_TICKS);
                         turnSlugSharpRight(DRIVE_SPEED);
 
                     } else if ((collisionFrom == FRONT_BOTH) || (collisionFrom == DEAD_BOT)) {
-                        printf("\r\n    Turning RIGHT 90");
-                        ES_Timer_InitTimer(COLLISION_TIMER, TURN_90_TIMER_TICKS);
+                        ES_Trace(ThisEvent); // Turning RIGHT 90
+                        StartStateTimer(TURN_90_TIMER_TICKS);
                         turnSlugSharpRight(DRIVE_SPEED);
                     }
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
                     if (ThisEvent.EventParam == 0b0100) {
 
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                     } else if (ThisEvent.EventParam == 0b1000) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                     } else if (ThisEvent.EventParam == 0b1100) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                     }
 
                     nextState = Reverse;
@@ -598,16 +624,16 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    BUMPER CHANGED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // BUMPER CHANGED
                     if (ThisEvent.EventParam == 0b0100) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                     } else if (ThisEvent.EventParam == 0b1000) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                     } else if (ThisEvent.EventParam == 0b1100) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                     } else {
                         ThisEvent.EventType = ES_NO_EVENT;
                     }
@@ -627,13 +653,13 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     //ES_Timer_InitTimer(COLLISION_TIMER, SHORT_DRIVE_TIMER_TICKS);
                     break;
 
                 case ES_TIMEOUT:
                     if (ThisEvent.EventParam == FINISH_TIMER) {
-                        ES_Timer_StopTimer(COLLISION_TIMER);
+                        StopStateTimer(CurrentState);
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
@@ -652,29 +678,29 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case ShortDrive: // in the first state, replace this with correct names
             switch (ThisEvent.EventType) {
 
                 case ES_ENTRY:
-                    ES_Timer_InitTimer(COLLISION_TIMER, SHORT_DRIVE_TIMER_TICKS);
+                    StartStateTimer(SHORT_DRIVE_TIMER_TICKS);
                     moveSlug(DRIVE_SPEED);
-                    printf("\r\n SearchForBeacon: In ShortDrive");
+                    ES_Trace(ThisEvent); // SearchForBeacon: In ShortDrive
                     break;
 
                 case TAPE_SENSED:
-                    printf("\r\n    TAPE SENSED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // TAPE SENSED
                     if (ThisEvent.EventParam == 0b0100) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Tape: RIGHT");
+                        ES_Trace(ThisEvent); // Tape: RIGHT
                     } else if (ThisEvent.EventParam == 0b1000) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Tape: LEFT");
+                        ES_Trace(ThisEvent); // Tape: LEFT
                     } else if (ThisEvent.EventParam == 0b1100) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Tape: FRONT");
+                        ES_Trace(ThisEvent); // Tape: FRONT
                     }
 
                     nextState = Reverse;
@@ -683,16 +709,16 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case BUMPER_CHANGED:
-                    printf("\r\n    BUMPER_CHANGED: %d", ThisEvent.EventParam);
+                    ES_Trace(ThisEvent); // BUMPER_CHANGED
                     if (ThisEvent.EventParam == 0b0100) {
                         collisionFrom = FRONT_RIGHT;
-                        printf("\r\n    Bump: RIGHT");
+                        ES_Trace(ThisEvent); // Bump: RIGHT
                     } else if (ThisEvent.EventParam == 0b1000) {
                         collisionFrom = FRONT_LEFT;
-                        printf("\r\n    Bump: LEFT");
+                        ES_Trace(ThisEvent); // Bump: LEFT
                     } else if (ThisEvent.EventParam == 0b1100) {
                         collisionFrom = FRONT_BOTH;
-                        printf("\r\n    Bump: FRONT");
+                        ES_Trace(ThisEvent); // Bump: FRONT
                     } else {
                         ThisEvent.EventType = ES_NO_EVENT;
                     }
@@ -712,12 +738,12 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
                     break;
 
                 case ES_EXIT:
-                    ES_Timer_StopTimer(COLLISION_TIMER);
+                    StopStateTimer(CurrentState);
                     break;
 
                 case ES_TIMEOUT:
                     if (ThisEvent.EventParam == FINISH_TIMER) {
-                        ES_Timer_StopTimer(COLLISION_TIMER);
+                        StopStateTimer(CurrentState);
                         ThisEvent.EventType = AT_BEACON_TOWER;
                         ThisEvent.EventParam = 0;
                         return ThisEvent;
@@ -759,3 +785,20 @@ ES_Event RunSearchForBeaconSubHSM(ES_Event ThisEvent) {
  * PRIVATE FUNCTIONS                                                           *
  ******************************************************************************/
 
+/**
+ * @Function StartStateTimer(uint32_t Ticks)
+ * @param Ticks - milliseconds until the current state gets its ES_TIMEOUT
+ * @return None
+ * @brief (Re)starts the current state's own timer. */
+static void StartStateTimer(uint32_t Ticks) {
+    ES_Timer_Start(&StateTimers[CurrentState], Ticks, PostTopHSM, STATE_TIMER(CurrentState));
+}
+
+/**
+ * @Function StopStateTimer(SearchForBeaconSubHSMState_t State)
+ * @param State - the state whose timer to cancel
+ * @return None */
+static void StopStateTimer(SearchForBeaconSubHSMState_t State) {
+    ES_Timer_Cancel(&StateTimers[State]);
+}
+
@@ -0,0 +1,220 @@
+/*
+ * File: SensorLog.c
+ *
+ * Reads, encodes and decodes the sensor samples of SensorLog.h.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "AD.h"
+#include "sensors.h"
+#include "SensorLog.h"
+#include <string.h>
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define RUN_FLAG 0x80
+#define MAX_RUN 128 // samples in one run record
+
+// the fields of a change record, in the order they follow the header
+#define TRACK_WIRE_R_CHANGED 0x01
+#define TRACK_WIRE_L_CHANGED 0x02
+#define BEACON_CHANGED 0x04
+#define BATTERY_CHANGED 0x08
+#define TAPE_BUMPERS_CHANGED 0x10
+#define TOP_WALLS_CHANGED 0x20
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static uint8_t PutDelta(uint16_t From, uint16_t To, uint8_t *pOut);
+static int GetDelta(uint16_t *pValue, const uint8_t *pIn, int Length);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void SensorLog_Read(SensorSample_t *pSample) {
+    pSample->TrackWireR = trackWireR();
+    pSample->TrackWireL = trackWireL();
+    pSample->Beacon = beaconVal();
+    pSample->Battery = AD_ReadADPin(BAT_VOLTAGE);
+    pSample->Tape = botReadTape();
+    pSample->Bumpers = botReadBumpers();
+    pSample->TopBumpers = botReadTopBumpers();
+    pSample->Walls = wallTape() | (otherWallTape() << 1);
+}
+
+void SensorLog_Begin(SensorLog_t *pLog) {
+    memset(pLog, 0, sizeof (SensorLog_t));
+}
+
+uint8_t SensorLog_Encode(SensorLog_t *pLog, const SensorSample_t *pSample, uint8_t *pOut) {
+    const SensorSample_t *pLast = &pLog->Last;
+    uint8_t Header = 0;
+    uint8_t Length;
+
+    if (pSample->TrackWireR != pLast->TrackWireR) {
+        Header |= TRACK_WIRE_R_CHANGED;
+    }
+    if (pSample->TrackWireL != pLast->TrackWireL) {
+        Header |= TRACK_WIRE_L_CHANGED;
+    }
+    if (pSample->Beacon != pLast->Beacon) {
+        Header |= BEACON_CHANGED;
+    }
+    if (pSample->Battery != pLast->Battery) {
+        Header |= BATTERY_CHANGED;
+    }
+    if ((pSample->Tape != pLast->Tape) || (pSample->Bumpers != pLast->Bumpers)) {
+        Header |= TAPE_BUMPERS_CHANGED;
+    }
+    if ((pSample->TopBumpers != pLast->TopBumpers) || (pSample->Walls != pLast->Walls)) {
+        Header |= TOP_WALLS_CHANGED;
+    }
+
+    if (Header == 0) {
+        if (++pLog->Repeats < MAX_RUN) {
+            return 0;
+        }
+        return SensorLog_Flush(pLog, pOut);
+    }
+    // the run this sample ends, then the change
+    Length = SensorLog_Flush(pLog, pOut);
+    pOut[Length++] = Header;
+    if (Header & TRACK_WIRE_R_CHANGED) {
+        Length += PutDelta(pLast->TrackWireR, pSample->TrackWireR, &pOut[Length]);
+    }
+    if (Header & TRACK_WIRE_L_CHANGED) {
+        Length += PutDelta(pLast->TrackWireL, pSample->TrackWireL, &pOut[Length]);
+    }
+    if (Header & BEACON_CHANGED) {
+        Length += PutDelta(pLast->Beacon, pSample->Beacon, &pOut[Length]);
+    }
+    if (Header & BATTERY_CHANGED) {
+        Length += PutDelta(pLast->Battery, pSample->Battery, &pOut[Length]);
+    }
+    if (Header & TAPE_BUMPERS_CHANGED) {
+        pOut[Length++] = (pSample->Tape << 4) | (pSample->Bumpers & 0x0F);
+    }
+    if (Header & TOP_WALLS_CHANGED) {
+        pOut[Length++] = (pSample->TopBumpers << 2) | (pSample->Walls & 0x03);
+    }
+    pLog->Last = *pSample;
+    return Length;
+}
+
+uint8_t SensorLog_Flush(SensorLog_t *pLog, uint8_t *pOut) {
+    if (pLog->Repeats == 0) {
+        return 0;
+    }
+    pOut[0] = RUN_FLAG | (pLog->Repeats - 1);
+    pLog->Repeats = 0;
+    return 1;
+}
+
+int SensorLog_Decode(SensorLog_t *pLog, const uint8_t *pIn, int Length,
+        SensorSample_t *pSample) {
+    SensorSample_t Next = pLog->Last;
+    uint8_t Header;
+    int Used, i;
+
+    if (pLog->Repeats > 0) {
+        pLog->Repeats--;
+        *pSample = pLog->Last;
+        return 0;
+    }
+    if (Length < 1) {
+        return -1;
+    }
+    Header = pIn[0];
+    if (Header & RUN_FLAG) {
+        pLog->Repeats = Header & ~RUN_FLAG; // this sample is the first of the run
+        *pSample = pLog->Last;
+        return 1;
+    }
+
+    Used = 1;
+    if (Header & TRACK_WIRE_R_CHANGED) {
+        i = GetDelta(&Next.TrackWireR, &pIn[Used], Length - Used);
+        Used = (i < 0) ? -1 : Used + i;
+    }
+    if ((Used > 0) && (Header & TRACK_WIRE_L_CHANGED)) {
+        i = GetDelta(&Next.TrackWireL, &pIn[Used], Length - Used);
+        Used = (i < 0) ? -1 : Used + i;
+    }
+    if ((Used > 0) && (Header & BEACON_CHANGED)) {
+        i = GetDelta(&Next.Beacon, &pIn[Used], Length - Used);
+        Used = (i < 0) ? -1 : Used + i;
+    }
+    if ((Used > 0) && (Header & BATTERY_CHANGED)) {
+        i = GetDelta(&Next.Battery, &pIn[Used], Length - Used);
+        Used = (i < 0) ? -1 : Used + i;
+    }
+    if ((Used > 0) && (Header & TAPE_BUMPERS_CHANGED)) {
+        if (Used >= Length) {
+            return -1;
+        }
+        Next.Tape = pIn[Used] >> 4;
+        Next.Bumpers = pIn[Used++] & 0x0F;
+    }
+    if ((Used > 0) && (Header & TOP_WALLS_CHANGED)) {
+        if (Used >= Length) {
+            return -1;
+        }
+        Next.TopBumpers = pIn[Used] >> 2;
+        Next.Walls = pIn[Used++] & 0x03;
+    }
+    if (Used < 0) {
+        return -1;
+    }
+    pLog->Last = Next;
+    *pSample = Next;
+    return Used;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+// To - From, zigzag so small changes either way take one byte; the number of
+// bytes written
+static uint8_t PutDelta(uint16_t From, uint16_t To, uint8_t *pOut) {
+    int32_t Delta = (int32_t) To - From;
+    uint32_t Zigzag = (Delta < 0) ? ((uint32_t) -Delta << 1) - 1 : (uint32_t) Delta << 1;
+    uint8_t Length = 0;
+
+    while (Zigzag >= 0x80) {
+        pOut[Length++] = (Zigzag & 0x7F) | 0x80;
+        Zigzag >>= 7;
+    }
+    pOut[Length++] = Zigzag;
+    return Length;
+}
+
+// applies a delta to *pValue; the number of bytes read, or -1 if it is cut short
+static int GetDelta(uint16_t *pValue, const uint8_t *pIn, int Length) {
+    uint32_t Zigzag = 0;
+    int Used = 0;
+    int Shift = 0;
+
+    do {
+        if ((Used >= Length) || (Shift > 21)) {
+            return -1;
+        }
+        Zigzag |= (uint32_t) (pIn[Used] & 0x7F) << Shift;
+        Shift += 7;
+    } while (pIn[Used++] & 0x80);
+    if (Zigzag & 1) {
+        *pValue -= (uint16_t) ((Zigzag + 1) >> 1);
+    } else {
+        *pValue += (uint16_t) (Zigzag >> 1);
+    }
+    return Used;
+}
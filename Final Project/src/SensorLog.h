@@ -0,0 +1,102 @@
+/*
+ * File: SensorLog.h
+ *
+ * The raw inputs BotService and the event checkers read, one sample a tick,
+ * and a compact delta-encoded form of a run of samples, so a run can be
+ * recorded and fed back through the same code to get the same events.
+ *
+ * A record starts with a header byte. With its high bit set it stands for
+ * (header & 0x7F) + 1 more samples the same as the last. Otherwise each of
+ * its low six bits flags a field that changed, and the changes follow in bit
+ * order: the four A/D readings as zigzag deltas in 7-bit groups, low group
+ * first with the high bit set on all but the last, then the tape and bumper
+ * byte and the top bumper and wall byte as they now read. A sample with no
+ * change from the last costs nothing until the run of them is written.
+ * Samples are encoded against, and decoded from, a log whose last sample
+ * starts all 0.
+ */
+
+#ifndef SENSORLOG_H
+#define SENSORLOG_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+// the longest record SensorLog_Encode() or SensorLog_Flush() writes
+#define SENSOR_LOG_MAX_RECORD 16
+
+/*******************************************************************************
+ * PUBLIC TYPEDEFS                                                             *
+ ******************************************************************************/
+
+typedef struct {
+    uint16_t TrackWireR; // trackWireR()
+    uint16_t TrackWireL; // trackWireL()
+    uint16_t Beacon; // beaconVal()
+    uint16_t Battery; // AD_ReadADPin(BAT_VOLTAGE)
+    uint8_t Tape; // botReadTape()
+    uint8_t Bumpers; // botReadBumpers()
+    uint8_t TopBumpers; // botReadTopBumpers()
+    uint8_t Walls; // wallTape() in bit 0, otherWallTape() in bit 1
+} SensorSample_t;
+
+// one end of a log, writing or reading
+typedef struct {
+    SensorSample_t Last;
+    uint8_t Repeats; // of Last, not yet written or not yet read
+} SensorLog_t;
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function SensorLog_Read(SensorSample_t *pSample)
+ * @param pSample - filled with what the sensors read now
+ * @return None */
+void SensorLog_Read(SensorSample_t *pSample);
+
+/**
+ * @Function SensorLog_Begin(SensorLog_t *pLog)
+ * @param pLog - a log to start writing or reading
+ * @return None */
+void SensorLog_Begin(SensorLog_t *pLog);
+
+/**
+ * @Function SensorLog_Encode(SensorLog_t *pLog, const SensorSample_t *pSample,
+ *           uint8_t *pOut)
+ * @param pLog - the log being written
+ * @param pSample - the next sample
+ * @param pOut - room for SENSOR_LOG_MAX_RECORD bytes
+ * @return the number of bytes written to pOut, 0 while the sample only makes
+ *         a run of unchanged samples longer */
+uint8_t SensorLog_Encode(SensorLog_t *pLog, const SensorSample_t *pSample, uint8_t *pOut);
+
+/**
+ * @Function SensorLog_Flush(SensorLog_t *pLog, uint8_t *pOut)
+ * @param pLog - the log being written
+ * @param pOut - room for SENSOR_LOG_MAX_RECORD bytes
+ * @return the number of bytes of the run still held back, written to pOut;
+ *         call it once the last sample is encoded */
+uint8_t SensorLog_Flush(SensorLog_t *pLog, uint8_t *pOut);
+
+/**
+ * @Function SensorLog_Decode(SensorLog_t *pLog, const uint8_t *pIn, int Length,
+ *           SensorSample_t *pSample)
+ * @param pLog - the log being read
+ * @param pIn - the bytes not yet read
+ * @param Length - how many of them there are
+ * @param pSample - set to the next sample
+ * @return the number of bytes used, 0 for a sample of a run already read, or
+ *         -1 at the end of the log or in a record cut short */
+int SensorLog_Decode(SensorLog_t *pLog, const uint8_t *pIn, int Length,
+        SensorSample_t *pSample);
+
+#endif /* SENSORLOG_H */
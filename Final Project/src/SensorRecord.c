@@ -0,0 +1,117 @@
+/*
+ * File: SensorRecord.c
+ *
+ * Records the sensor samples of SensorLog.h on the Uno32 and sends them on
+ * the console serial port, see SensorRecord.h.
+ */
+
+/*******************************************************************************
+ * MODULE #INCLUDE                                                             *
+ ******************************************************************************/
+
+#include "BOARD.h"
+#include "ES_Port.h"
+#include "SensorLog.h"
+#include "SensorRecord.h"
+
+/*******************************************************************************
+ * MODULE #DEFINES                                                             *
+ ******************************************************************************/
+
+#define RING_SIZE 256 // bytes of records waiting for the port, a power of two
+
+/*******************************************************************************
+ * PRIVATE MODULE VARIABLES                                                    *
+ ******************************************************************************/
+
+// the one recording of the board
+static SensorLog_t Log;
+static uint8_t Ring[RING_SIZE];
+static uint16_t Head; // free running count of bytes added
+static uint16_t Tail; // free running count of bytes sent
+static uint8_t Seq;
+static uint8_t Stopped;
+
+/*******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES                                                 *
+ ******************************************************************************/
+
+static void Add(const SensorSample_t *pSample);
+static void Send(void);
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS                                                            *
+ ******************************************************************************/
+
+void SensorRecord_Start(void) {
+    SensorSample_t Sample;
+
+    SensorLog_Begin(&Log);
+    Head = 0;
+    Tail = 0;
+    Seq = 0;
+    Stopped = FALSE;
+    SensorLog_Read(&Sample);
+    Add(&Sample);
+}
+
+void SensorRecord_Tick(void) {
+    SensorSample_t Sample;
+
+    if (!Stopped) {
+        SensorLog_Read(&Sample);
+        Add(&Sample);
+    }
+    Send();
+}
+
+uint8_t SensorRecord_Stopped(void) {
+    return Stopped;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS                                                           *
+ ******************************************************************************/
+
+static void Add(const SensorSample_t *pSample) {
+    uint8_t Record[SENSOR_LOG_MAX_RECORD];
+    uint8_t Length = SensorLog_Encode(&Log, pSample, Record);
+    uint8_t i;
+
+    // every later record is a delta on this one, a recording without it
+    // would play back wrong rather than stop
+    if ((uint16_t) (Head - Tail) > RING_SIZE - Length) {
+        Stopped = TRUE;
+        return;
+    }
+    for (i = 0; i < Length; i++) {
+        Ring[Head++ & (RING_SIZE - 1)] = Record[i];
+    }
+}
+
+// one frame of what is waiting, if the port takes it without waiting
+static void Send(void) {
+    uint8_t Frame[SENSOR_RECORD_FRAME_SIZE];
+    uint16_t Waiting = Head - Tail;
+    uint8_t Length = (Waiting < SENSOR_RECORD_MAX_DATA) ? Waiting : SENSOR_RECORD_MAX_DATA;
+    uint8_t Sum;
+    uint8_t i;
+
+    if (Length == 0) {
+        return;
+    }
+    Frame[0] = SENSOR_RECORD_SYNC1;
+    Frame[1] = SENSOR_RECORD_SYNC2;
+    Frame[2] = Seq;
+    Frame[3] = Length;
+    Sum = Seq + Length;
+    for (i = 0; i < Length; i++) {
+        Frame[4 + i] = Ring[(Tail + i) & (RING_SIZE - 1)];
+        Sum += Frame[4 + i];
+    }
+    Frame[4 + Length] = -Sum;
+    if (ES_Port_TraceWrite(Frame, Length + 5)) {
+        Tail += Length;
+        Seq++;
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * File: SensorRecord.h
+ *
+ * Sensor recordings on the Uno32. With USE_SENSOR_RECORD defined in
+ * ES_Configure.h the run loop calls SensorRecord_Tick() every tick, which
+ * reads the sensors and encodes the sample as SensorLog.h has it, into a RAM
+ * ring that goes out on the console serial port through ES_Port_TraceWrite(),
+ * beside the state machine trace. es_trace -r picks the frames out of a
+ * capture of the port and writes them as a recording es_host -P plays back,
+ * see SensorTrace.h.
+ *
+ * On the wire each frame is
+ *
+ *   0xA5 0x5B  Seq Length Data[Length]  Sum
+ *
+ * with Seq counting the frames of the recording from 0, Data the next Length
+ * bytes of its records, at most SENSOR_RECORD_MAX_DATA, and Sum chosen so
+ * that the bytes from Seq on and Sum add up to 0 mod 256. The first sync byte
+ * is the trace's, the second tells the frames apart. Every record is a delta
+ * on the ones before it, so a recording cannot go on past a lost record: once
+ * the ring is too full for the next one the recording stops, and a decoder
+ * stops at the first gap in Seq. A run of unchanged samples only goes out once
+ * it ends.
+ */
+
+#ifndef SENSORRECORD_H
+#define SENSORRECORD_H
+
+/*******************************************************************************
+ * PUBLIC #INCLUDES                                                            *
+ ******************************************************************************/
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * PUBLIC #DEFINES                                                             *
+ ******************************************************************************/
+
+#define SENSOR_RECORD_SYNC1 0xA5
+#define SENSOR_RECORD_SYNC2 0x5B
+#define SENSOR_RECORD_MAX_DATA 32
+#define SENSOR_RECORD_FRAME_SIZE (SENSOR_RECORD_MAX_DATA + 5)
+
+/*******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES                                                  *
+ ******************************************************************************/
+
+/**
+ * @Function SensorRecord_Start(void)
+ * @return None
+ * @brief Starts a recording with what the sensors read now. Call it once the
+ *        sensors are initialised, just before ES_Initialize(). */
+void SensorRecord_Start(void);
+
+/**
+ * @Function SensorRecord_Tick(void)
+ * @return None
+ * @brief Records what the sensors read through one tick and sends what the
+ *        port will take. The ES_TICK_HOOK of ES_Configure.h. */
+void SensorRecord_Tick(void);
+
+/**
+ * @Function SensorRecord_Stopped(void)
+ * @return TRUE once the ring was too full for a record and the recording
+ *         stopped, FALSE while it goes on */
+uint8_t SensorRecord_Stopped(void);
+
+#endif /* SENSORRECORD_H */
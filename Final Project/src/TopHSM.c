@@ -30,6 +30,7 @@
 #include "ES_Framework.h"
 #include "BOARD.h"
 #include "TopHSM.h"
+#include "Bot.h"
 #include "SearchForBeaconSubHSM.h" //#include all sub state machines called
 #include "Collection1SubHSM.h"
 #include "Collection2SubHSM.h"
@@ -45,6 +46,9 @@
  * MODULE #DEFINES                                                             *
  ******************************************************************************/
 
+/* es_chart begin: generated from TopHSM.chart by es_chart, edit the chart and run make -C host charts */
+// this machine in the state machine trace, see ES_TattleTale.h
+#define ES_TRACE_ID TRACE_TOP_HSM
 
 typedef enum {
     InitPState,
@@ -52,16 +56,16 @@ typedef enum {
     Collection1,
     Collection2,
     Deposit,
-
 } TopHSMState_t;
 
-static const char *StateNames[] = {
+static const char *const StateNames[] ES_TRACE_NAMES = {
 	"InitPState",
 	"SearchForBeacon",
 	"Collection1",
 	"Collection2",
 	"Deposit",
 };
+/* es_chart end */
 
 
 /*******************************************************************************
@@ -73,11 +77,11 @@ static const char *StateNames[] = {
 /*******************************************************************************
  * PRIVATE MODULE VARIABLES                                                            *
  ******************************************************************************/
-/* You will need MyPriority and the state variable; you may need others as well.
- * The type of state variable should match that of enum in header file. */
+/* The state and the priority are the robot's own, see TopHSMContext_t. */
 
-static TopHSMState_t CurrentState = InitPState; // <- change enum name to match ENUM
-static uint8_t MyPriority;
+#define Me (&THIS_BOT->TopHSM)
+#define CurrentState (Me->CurrentState)
+#define MyPriority (Me->MyPriority)
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS                                                            *
@@ -118,6 +122,15 @@ uint8_t PostTopHSM(ES_Event ThisEvent) {
     return ES_PostToService(MyPriority, ThisEvent);
 }
 
+/**
+ * @Function QueryTopHSM(void)
+ * @return the top level state the machine is in
+ * @brief Named in ES_SERVICE_STATES (ES_Configure.h), so that the framework
+ *        keeps the worst Run time of each top level state apart. */
+uint8_t QueryTopHSM(void) {
+    return CurrentState;
+}
+
 /**
  * @Function RunTopHSM(ES_Event ThisEvent)
  * @param ThisEvent - the event (type and param) to be responded.
@@ -136,7 +149,7 @@ uint8_t PostTopHSM(ES_Event ThisEvent) {
  * @author Aleida Diaz-Roque */
 ES_Event RunTopHSM(ES_Event ThisEvent) {
     uint8_t makeTransition = FALSE; // use to flag transition
-    TopHSMState_t nextState; // <- change type to correct enum
+    TopHSMState_t nextState = CurrentState; // <- change type to correct enum
 
     ES_Tattle(); // trace call stack
 
@@ -167,8 +180,8 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
                 ;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case SearchForBeacon: 
             ThisEvent = RunSearchForBeaconSubHSM(ThisEvent);
@@ -198,8 +211,8 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case Collection1: 
 		
@@ -224,8 +237,8 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
         case Collection2:
 
@@ -240,7 +253,7 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
 
                 case READY_TO_DEPOSIT:
                   
-                    printf("\r\n Deposit Transition");
+                    ES_Trace(ThisEvent); // Deposit Transition
                     nextState = Deposit;
                     makeTransition = TRUE;
                     ThisEvent.EventType = ES_NO_EVENT;
@@ -254,8 +267,8 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
                     break;
             }
             break;
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
-	    \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
+	    //////////////////////////////////////////////////////////////////////
+	    //////////////////////////////////////////////////////////////////////
 
             
         case Deposit: 
@@ -264,7 +277,7 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
 
             switch (ThisEvent.EventType) {
                 case ES_ENTRY:
-                    printf("/r/n ES ENTRY TOP LEVEL DEPOSIT");
+                    ES_Trace(ThisEvent); // ES ENTRY TOP LEVEL DEPOSIT
 
                     break;
 
@@ -272,7 +285,7 @@ ES_Event RunTopHSM(ES_Event ThisEvent) {
                     break;
                     
                 case READY_TO_SWEEP:
-                    printf("\r\n Deposit to sweep Transition");
+                    ES_Trace(ThisEvent); // Deposit to sweep Transition
                     nextState = Collection1;
                     makeTransition = TRUE;
                     ThisEvent.EventType = ES_NO_EVENT;
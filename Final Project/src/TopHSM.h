@@ -23,11 +23,17 @@
  ******************************************************************************/
 
 #include "ES_Configure.h"   // defines ES_Event, INIT_EVENT, ENTRY_EVENT, and EXIT_EVENT
+#include "BotTuned.h"
 
 /*******************************************************************************
  * PUBLIC #DEFINES                                                             *
  ******************************************************************************/
 
+/* es_chart begin: generated from TopHSM.chart by es_chart, edit the chart and run make -C host charts */
+// the states of the machine, for the arrays of its context
+#define TOPHSM_NUM_STATES 5
+/* es_chart end */
+
 #define FRONT_BOTH 0b1100
 #define FRONT_RIGHT 0b0100
 #define FRONT_LEFT 0b1000
@@ -61,11 +67,12 @@
 #define TRACK_LEFT 0b10
 #define TRACK_BOTH 0b11
 
-// speed values
+// speed values, the robot's own through BOT_TUNING() on the host, BotTuned.h's
+// constants on the board (Bot.h)
 #define NO_SPEED 0
-#define SPIN_SPEED 600
-#define ROLLER_SPEED 400
-#define DRIVE_SPEED 900
+#define SPIN_SPEED BOT_TUNING(SpinSpeed, TUNED_SPIN_SPEED)
+#define ROLLER_SPEED BOT_TUNING(RollerSpeed, TUNED_ROLLER_SPEED)
+#define DRIVE_SPEED BOT_TUNING(DriveSpeed, TUNED_DRIVE_SPEED)
 
 
 #define FORWARD 1
@@ -81,6 +88,11 @@
  * PUBLIC TYPEDEFS                                                             *
  ******************************************************************************/
 
+// the machine's variables, one set per robot, see Bot.h
+typedef struct {
+    uint8_t CurrentState;
+    uint8_t MyPriority;
+} TopHSMContext_t;
 
 /*******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES                                                  *
@@ -110,6 +122,13 @@ uint8_t InitTopHSM(uint8_t Priority);
  * @author Aleida Diaz-Roque */
 uint8_t PostTopHSM(ES_Event ThisEvent);
 
+/**
+ * @Function QueryTopHSM(void)
+ * @return the top level state the machine is in
+ * @brief Named in ES_SERVICE_STATES (ES_Configure.h), so that the framework
+ *        keeps the worst Run time of each top level state apart. */
+uint8_t QueryTopHSM(void);
+
 
 
 
@@ -12,7 +12,7 @@
 #include <stdio.h>
 #include <xc.h>
 #include <stdint.h>
-#include "RC_servo.h"
+#include "RC_Servo.h"
 
 void sensors_Init() {
 
@@ -42,15 +42,15 @@ void sensors_Init() {
 }
 
 int trackWireR() {
-    AD_ReadADPin(AD_PORTV3);
+    return AD_ReadADPin(AD_PORTV3);
 }
 
 int trackWireL() {
-    AD_ReadADPin(AD_PORTV4);
+    return AD_ReadADPin(AD_PORTV4);
 }
 
 int beaconVal() {
-    AD_ReadADPin(AD_PORTW8);
+    return AD_ReadADPin(AD_PORTW8);
 }
 
 int beaconFound() {